@@ -0,0 +1,116 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/assets/asset_index.h"
+
+#include <cstring>
+
+#include "flutter/fml/logging.h"
+
+namespace flutter {
+
+static constexpr fml::MappedHashTable::Format kFormat = {
+    .signature = 0x58444941,  // "AIDX"
+    .version = 1,
+    .entry_size = sizeof(uint64_t) + 2 * sizeof(uint32_t) + sizeof(uint64_t),
+};
+
+namespace {
+
+struct EntryData {
+  uint32_t name_offset;
+  uint32_t name_length;
+  uint64_t length;
+};
+
+}  // namespace
+
+using Table = fml::MappedHashTable;
+
+static EntryData ReadEntry(const uint8_t* entry) {
+  return {
+      .name_offset = Table::Read<uint32_t>(entry),
+      .name_length = Table::Read<uint32_t>(entry + 4),
+      .length = Table::Read<uint64_t>(entry + 8),
+  };
+}
+
+std::unique_ptr<AssetIndex> AssetIndex::Create(
+    std::unique_ptr<fml::Mapping> mapping) {
+  if (!mapping || !mapping->GetMapping()) {
+    return nullptr;
+  }
+  auto index = std::unique_ptr<AssetIndex>(new AssetIndex(std::move(mapping)));
+  if (!index->Validate()) {
+    FML_LOG(ERROR) << "Asset index is invalid and will be ignored.";
+    return nullptr;
+  }
+  return index;
+}
+
+std::vector<uint8_t> AssetIndex::Serialize(const std::vector<Entry>& entries) {
+  size_t names_size = 0;
+  for (const auto& entry : entries) {
+    names_size += entry.name.size();
+  }
+
+  Table::Builder builder(kFormat, entries.size(), names_size);
+  if (!builder.IsValid()) {
+    FML_LOG(ERROR) << "Too many assets to index.";
+    return {};
+  }
+
+  uint8_t* names = builder.GetPayload();
+  uint32_t name_offset = 0;
+  for (uint32_t i = 0; i < entries.size(); i++) {
+    const auto& entry = entries[i];
+    uint8_t* data = builder.AddEntry(i, fml::FNV1aHash(entry.name));
+    Table::Write<uint32_t>(data, name_offset);
+    Table::Write<uint32_t>(data + 4, static_cast<uint32_t>(entry.name.size()));
+    Table::Write<uint64_t>(data + 8, entry.length);
+    std::memcpy(names + name_offset, entry.name.data(), entry.name.size());
+    name_offset += static_cast<uint32_t>(entry.name.size());
+  }
+
+  return builder.Take();
+}
+
+AssetIndex::AssetIndex(std::unique_ptr<fml::Mapping> mapping)
+    : mapping_(std::move(mapping)) {}
+
+AssetIndex::~AssetIndex() = default;
+
+bool AssetIndex::Validate() {
+  const uint8_t* data = mapping_->GetMapping();
+  const size_t size = mapping_->GetSize();
+  if (!table_.Init(kFormat, data, size)) {
+    return false;
+  }
+  names_ = data + table_.GetPayloadOffset();
+
+  const size_t names_size = size - table_.GetPayloadOffset();
+  for (uint32_t i = 0; i < table_.GetEntryCount(); i++) {
+    const auto entry = ReadEntry(table_.GetEntry(i));
+    if (static_cast<size_t>(entry.name_offset) + entry.name_length >
+        names_size) {
+      return false;
+    }
+  }
+  return true;
+}
+
+std::optional<uint64_t> AssetIndex::FindAsset(std::string_view name) const {
+  auto index = table_.Find(fml::FNV1aHash(name), [&](uint32_t i) {
+    const auto entry = ReadEntry(table_.GetEntry(i));
+    return std::string_view(
+               reinterpret_cast<const char*>(names_) + entry.name_offset,
+               entry.name_length) == name;
+  });
+  if (!index.has_value()) {
+    return std::nullopt;
+  }
+  return ReadEntry(table_.GetEntry(index.value())).length;
+}
+
+}  // namespace flutter
@@ -0,0 +1,82 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_ASSETS_ASSET_INDEX_H_
+#define FLUTTER_ASSETS_ASSET_INDEX_H_
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapped_hash_table.h"
+#include "flutter/fml/mapping.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      A prebuilt index of the assets in an asset bundle. Resolvers
+///             that have an index can reject lookups of assets they do not
+///             contain without touching the file system.
+///
+///             The index is a |fml::MappedHashTable| keyed by the asset
+///             names. Each entry holds the uint64 name hash, uint32 name
+///             offset, uint32 name length and uint64 asset length. The
+///             payload holds the asset names, which are addressed relative to
+///             its start.
+///
+class AssetIndex {
+ public:
+  /// The name of the index file in the root of an asset bundle.
+  static constexpr const char* kFileName = "AssetIndex.bin";
+
+  struct Entry {
+    std::string name;
+    uint64_t length = 0;
+  };
+
+  //----------------------------------------------------------------------------
+  /// @brief      Validates and wraps a serialized index.
+  ///
+  /// @return     The index or null if the mapping is not a valid index.
+  ///
+  static std::unique_ptr<AssetIndex> Create(
+      std::unique_ptr<fml::Mapping> mapping);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Serializes an index of the given assets. This is used by
+  ///             tooling that packages asset bundles.
+  ///
+  static std::vector<uint8_t> Serialize(const std::vector<Entry>& entries);
+
+  ~AssetIndex();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Looks up an asset.
+  ///
+  /// @return     The length of the asset in bytes, or std::nullopt if the
+  ///             asset is not in the index.
+  ///
+  std::optional<uint64_t> FindAsset(std::string_view name) const;
+
+  size_t GetAssetCount() const { return table_.GetEntryCount(); }
+
+ private:
+  const std::unique_ptr<fml::Mapping> mapping_;
+  fml::MappedHashTable table_;
+  const uint8_t* names_ = nullptr;
+
+  explicit AssetIndex(std::unique_ptr<fml::Mapping> mapping);
+
+  bool Validate();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(AssetIndex);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_ASSETS_ASSET_INDEX_H_
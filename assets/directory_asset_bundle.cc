@@ -23,6 +23,8 @@ DirectoryAssetBundle::DirectoryAssetBundle(
   }
   is_valid_after_asset_manager_change_ = is_valid_after_asset_manager_change;
   is_valid_ = true;
+  index_ = AssetIndex::Create(
+      fml::FileMapping::CreateReadOnly(descriptor_, AssetIndex::kFileName));
 }
 
 DirectoryAssetBundle::~DirectoryAssetBundle() = default;
@@ -50,6 +52,14 @@ std::unique_ptr<fml::Mapping> DirectoryAssetBundle::GetAsMapping(
     return nullptr;
   }
 
+  std::optional<uint64_t> indexed_length;
+  if (index_) {
+    indexed_length = index_->FindAsset(asset_name);
+    if (!indexed_length.has_value()) {
+      return nullptr;
+    }
+  }
+
   auto mapping = std::make_unique<fml::FileMapping>(fml::OpenFile(
       descriptor_, asset_name.c_str(), false, fml::FilePermission::kRead));
 
@@ -57,6 +67,12 @@ std::unique_ptr<fml::Mapping> DirectoryAssetBundle::GetAsMapping(
     return nullptr;
   }
 
+  if (indexed_length.has_value() &&
+      indexed_length.value() != mapping->GetSize()) {
+    FML_DLOG(WARNING) << "Asset index is out of date for asset: "
+                      << asset_name;
+  }
+
   return mapping;
 }
 
@@ -6,6 +6,7 @@
 #define FLUTTER_ASSETS_DIRECTORY_ASSET_BUNDLE_H_
 
 #include <optional>
+#include "flutter/assets/asset_index.h"
 #include "flutter/assets/asset_resolver.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_counted.h"
@@ -24,6 +25,9 @@ class DirectoryAssetBundle : public AssetResolver {
   const fml::UniqueFD descriptor_;
   bool is_valid_ = false;
   bool is_valid_after_asset_manager_change_ = false;
+  // The prebuilt index of the bundle if it has one. Lookups of assets missing
+  // from the index fail without opening files.
+  std::unique_ptr<AssetIndex> index_;
 
   // |AssetResolver|
   bool IsValid() const override;
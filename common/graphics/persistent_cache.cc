@@ -4,12 +4,17 @@
 
 #include "flutter/common/graphics/persistent_cache.h"
 
+#include <algorithm>
+#include <functional>
 #include <future>
+#include <iterator>
 #include <memory>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <utility>
 
+#include "flutter/common/graphics/persistent_cache_pack.h"
 #include "flutter/fml/base32.h"
 #include "flutter/fml/file.h"
 #include "flutter/fml/hex_codec.h"
@@ -17,6 +22,8 @@
 #include "flutter/fml/make_copyable.h"
 #include "flutter/fml/mapping.h"
 #include "flutter/fml/paths.h"
+#include "flutter/fml/synchronization/count_down_latch.h"
+#include "flutter/fml/time/time_point.h"
 #include "flutter/fml/trace_event.h"
 #include "flutter/shell/version/version.h"
 #include "openssl/sha.h"
@@ -26,6 +33,44 @@
 
 namespace flutter {
 
+struct PersistentCache::PackState {
+  // Held while the pack and its log are written, so that the writes of
+  // different workers are applied one after the other to the latest state.
+  std::mutex write_mutex;
+  // Guards the members below.
+  std::mutex mutex;
+  std::shared_ptr<const PersistentCachePack> pack;
+  // The values of the objects in the log, by key, and the size of the log.
+  std::unordered_map<std::string, sk_sp<SkData>> log_values;
+  size_t log_size = 0;
+  std::vector<std::unique_ptr<fml::Mapping>> pending_objects;
+  bool is_flush_scheduled = false;
+};
+
+void PersistentCache::LoadPackLog(const fml::UniqueFD& cache_directory,
+                                  PackState& pack_state,
+                                  bool read_only) {
+  auto file = fml::OpenFile(
+      cache_directory, PersistentCachePack::kLogFileName, false,
+      read_only ? fml::FilePermission::kRead : fml::FilePermission::kReadWrite);
+  if (!file.is_valid()) {
+    return;
+  }
+  fml::FileMapping mapping(file);
+  const size_t log_size = PersistentCachePack::ReadLog(
+      mapping, [&pack_state](std::string_view key, const uint8_t* value,
+                             size_t value_size) {
+        pack_state.log_values[std::string(key)] =
+            SkData::MakeWithCopy(value, value_size);
+      });
+  pack_state.log_size = log_size;
+  // Drop a record whose append was interrupted, so that the records appended
+  // after it can be read.
+  if (log_size < mapping.GetSize() && !read_only) {
+    fml::TruncateFile(file, log_size);
+  }
+}
+
 std::string PersistentCache::cache_base_path_;
 
 std::shared_ptr<AssetManager> PersistentCache::asset_manager_;
@@ -85,8 +130,16 @@ bool PersistentCache::Purge() {
   FML_CHECK(GetWorkerTaskRunner());
 
   std::promise<bool> removed;
-  GetWorkerTaskRunner()->PostTask([&removed,
-                                   cache_directory = cache_directory_]() {
+  GetWorkerTaskRunner()->PostTask([&removed, cache_directory = cache_directory_,
+                                   pack_state = pack_state_]() {
+    std::scoped_lock write_lock(pack_state->write_mutex);
+    {
+      std::scoped_lock lock(pack_state->mutex);
+      pack_state->pack = nullptr;
+      pack_state->log_values.clear();
+      pack_state->log_size = 0;
+      pack_state->pending_objects.clear();
+    }
     if (cache_directory->is_valid()) {
       // Only remove files but not directories.
       FML_LOG(INFO) << "Purge persistent cache.";
@@ -191,57 +244,149 @@ sk_sp<SkData> ParseBase64(const std::string& input) {
   return data;
 }
 
-size_t PersistentCache::PrecompileKnownSkSLs(GrDirectContext* context) const {
+size_t PersistentCache::PrecompileKnownSkSLs(GrDirectContext* context,
+                                             bool defer_non_critical) const {
+  size_t critical_count = 0;
   // clang-tidy has trouble reasoning about some of the complicated array and
   // pointer-arithmetic code in rapidjson.
   // NOLINTNEXTLINE(clang-analyzer-cplusplus.PlacementNew)
-  auto known_sksls = LoadSkSLs();
+  auto known_sksls = LoadSkSLs(&critical_count);
   // A trace must be present even if no precompilations have been completed.
   FML_TRACE_EVENT("flutter", "PersistentCache::PrecompileKnownSkSLs", "count",
-                  known_sksls.size());
+                  known_sksls.size(), "critical", critical_count);
 
   if (context == nullptr) {
     return 0;
   }
 
+  const size_t compile_count =
+      defer_non_critical ? critical_count : known_sksls.size();
+
   size_t precompiled_count = 0;
-  for (const auto& sksl : known_sksls) {
+  for (size_t i = 0; i < compile_count; i++) {
     TRACE_EVENT0("flutter", "PrecompilingSkSL");
-    if (context->precompileShader(*sksl.key, *sksl.value)) {
+    if (i < critical_count) {
+      // Skia does not look up the shaders it has precompiled, and so would
+      // not record the use of the critical shaders.
+      RecordFirstUse(SkKeyToFilePath(*known_sksls[i].key));
+    }
+    if (context->precompileShader(*known_sksls[i].key,
+                                  *known_sksls[i].value)) {
       precompiled_count++;
     }
   }
 
+  {
+    std::scoped_lock lock(deferred_sksls_mutex_);
+    deferred_sksls_context_ = context;
+    deferred_sksls_.assign(known_sksls.begin() + compile_count,
+                           known_sksls.end());
+    // Deferred SkSLs are compiled from the back.
+    std::reverse(deferred_sksls_.begin(), deferred_sksls_.end());
+  }
+
   FML_TRACE_COUNTER("flutter", "PersistentCache::PrecompiledSkSLs",
                     reinterpret_cast<int64_t>(this),  // Trace Counter ID
                     "Successful", precompiled_count);
   return precompiled_count;
 }
 
-std::vector<PersistentCache::SkSLCache> PersistentCache::LoadSkSLs() const {
-  TRACE_EVENT0("flutter", "PersistentCache::LoadSkSLs");
-  std::vector<PersistentCache::SkSLCache> result;
-  fml::FileVisitor visitor = [&result](const fml::UniqueFD& directory,
-                                       const std::string& filename) {
-    SkSLCache cache = LoadFile(directory, filename, true);
-    if (cache.key != nullptr && cache.value != nullptr) {
-      result.push_back(cache);
-    } else {
-      FML_LOG(ERROR) << "Failed to load: " << filename;
+size_t PersistentCache::PrecompileDeferredSkSLs(GrDirectContext* context,
+                                                fml::TimeDelta budget) const {
+  std::scoped_lock lock(deferred_sksls_mutex_);
+  if (context == nullptr || context != deferred_sksls_context_) {
+    return 0;
+  }
+  TRACE_EVENT0("flutter", "PersistentCache::PrecompileDeferredSkSLs");
+  const fml::TimePoint deadline = fml::TimePoint::Now() + budget;
+  do {
+    if (deferred_sksls_.empty()) {
+      break;
     }
-    return true;
-  };
+    const auto& sksl = deferred_sksls_.back();
+    context->precompileShader(*sksl.key, *sksl.value);
+    deferred_sksls_.pop_back();
+  } while (fml::TimePoint::Now() < deadline);
+  return deferred_sksls_.size();
+}
+
+std::vector<std::string> PersistentCache::LoadFirstUseOrder() const {
+  std::vector<std::string> result;
+  if (!IsValid()) {
+    return result;
+  }
+  auto file = fml::OpenFileReadOnly(*cache_directory_, kFirstUseFileName);
+  if (!file.is_valid()) {
+    return result;
+  }
+  fml::FileMapping mapping(file);
+  std::string_view contents(
+      reinterpret_cast<const char*>(mapping.GetMapping()), mapping.GetSize());
+  while (!contents.empty()) {
+    size_t end = contents.find('\n');
+    if (end == std::string_view::npos) {
+      end = contents.size();
+    }
+    if (end > 0) {
+      result.emplace_back(contents.substr(0, end));
+    }
+    contents.remove_prefix(std::min(end + 1, contents.size()));
+  }
+  return result;
+}
+
+// Runs |load| for every index in [0, count), spread across the task runner if
+// there is one.
+static void LoadInParallel(
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& task_runner,
+    size_t count,
+    const std::function<void(size_t)>& load) {
+  // Each task loads a range of SkSLs to amortize the cost of posting tasks.
+  constexpr size_t kSkSLsPerTask = 16;
+  if (!task_runner || count <= kSkSLsPerTask) {
+    for (size_t i = 0; i < count; i++) {
+      load(i);
+    }
+    return;
+  }
+  const size_t task_count = (count + kSkSLsPerTask - 1) / kSkSLsPerTask;
+  fml::CountDownLatch latch(task_count);
+  for (size_t task = 0; task < task_count; task++) {
+    task_runner->PostTask([&latch, &load, task, count]() {
+      const size_t end = std::min(count, (task + 1) * kSkSLsPerTask);
+      for (size_t i = task * kSkSLsPerTask; i < end; i++) {
+        load(i);
+      }
+      latch.CountDown();
+    });
+  }
+  latch.Wait();
+}
+
+std::vector<PersistentCache::SkSLCache> PersistentCache::LoadSkSLs(
+    size_t* critical_count) const {
+  TRACE_EVENT0("flutter", "PersistentCache::LoadSkSLs");
+  std::shared_ptr<fml::ConcurrentTaskRunner> task_runner;
+  {
+    std::scoped_lock lock(worker_task_runners_mutex_);
+    task_runner = concurrent_task_runner_;
+  }
 
   // Only visit sksl_cache_directory_ if this persistent cache is valid.
   // However, we'd like to continue visit the asset dir even if this persistent
   // cache is invalid.
+  fml::UniqueFD fresh_dir;
+  std::vector<std::string> file_names;
   if (IsValid()) {
     // In case `rewinddir` doesn't work reliably, load SkSLs from a freshly
     // opened directory (https://github.com/flutter/flutter/issues/65258).
-    fml::UniqueFD fresh_dir =
-        fml::OpenDirectoryReadOnly(*cache_directory_, kSkSLSubdirName);
+    fresh_dir = fml::OpenDirectoryReadOnly(*cache_directory_, kSkSLSubdirName);
     if (fresh_dir.is_valid()) {
-      fml::VisitFiles(fresh_dir, visitor);
+      fml::VisitFiles(fresh_dir, [&file_names](const fml::UniqueFD& directory,
+                                               const std::string& filename) {
+        file_names.push_back(filename);
+        return true;
+      });
     }
   }
 
@@ -249,11 +394,12 @@ std::vector<PersistentCache::SkSLCache> PersistentCache::LoadSkSLs() const {
   if (asset_manager_ != nullptr) {
     mapping = asset_manager_->GetAsMapping(kAssetFileName);
   }
+  rapidjson::Document json_doc;
+  std::vector<const rapidjson::Value::Member*> asset_items;
   if (mapping == nullptr) {
     FML_LOG(INFO) << "No sksl asset found.";
   } else {
     FML_LOG(INFO) << "Found sksl asset. Loading SkSLs from it...";
-    rapidjson::Document json_doc;
     rapidjson::ParseResult parse_result =
         json_doc.Parse(reinterpret_cast<const char*>(mapping->GetMapping()),
                        mapping->GetSize());
@@ -261,16 +407,73 @@ std::vector<PersistentCache::SkSLCache> PersistentCache::LoadSkSLs() const {
       FML_LOG(ERROR) << "Failed to parse json file: " << kAssetFileName;
     } else {
       for (auto& item : json_doc["data"].GetObject()) {
-        sk_sp<SkData> key = ParseBase32(item.name.GetString());
-        sk_sp<SkData> sksl = ParseBase64(item.value.GetString());
-        if (key != nullptr && sksl != nullptr) {
-          result.push_back({key, sksl});
-        } else {
-          FML_LOG(ERROR) << "Failed to load: " << item.name.GetString();
+        asset_items.push_back(&item);
+      }
+    }
+  }
+
+  // Decode the files and the bundled SkSLs in parallel. Each slot is written
+  // by a single task.
+  std::vector<SkSLCache> loaded(file_names.size() + asset_items.size());
+  LoadInParallel(task_runner, loaded.size(), [&](size_t i) {
+    if (i < file_names.size()) {
+      loaded[i] = LoadFile(fresh_dir, file_names[i], true);
+      return;
+    }
+    const auto& item = *asset_items[i - file_names.size()];
+    sk_sp<SkData> key = ParseBase32(item.name.GetString());
+    sk_sp<SkData> sksl = ParseBase64(item.value.GetString());
+    if (key != nullptr && sksl != nullptr) {
+      loaded[i] = {key, sksl};
+    }
+  });
+
+  // The SkSLs used before the first frame of the last run go first, in the
+  // order of their first use. Until a run has recorded them, the SkSLs
+  // bundled with the application, which are usually captured while it starts
+  // up, stand in for them.
+  std::unordered_map<std::string, size_t> first_use_rank;
+  for (const auto& file_name : LoadFirstUseOrder()) {
+    first_use_rank.emplace(file_name, first_use_rank.size());
+  }
+  const bool has_first_use_order = !first_use_rank.empty();
+  const size_t unranked = std::max<size_t>(first_use_rank.size(), 1);
+
+  std::vector<std::pair<size_t, SkSLCache>> ranked;
+  ranked.reserve(loaded.size());
+  for (size_t i = 0; i < loaded.size(); i++) {
+    if (loaded[i].key != nullptr && loaded[i].value != nullptr) {
+      size_t rank = unranked;
+      if (has_first_use_order) {
+        auto found = first_use_rank.find(SkKeyToFilePath(*loaded[i].key));
+        if (found != first_use_rank.end()) {
+          rank = found->second;
         }
+      } else if (i >= file_names.size()) {
+        rank = 0;
       }
+      ranked.emplace_back(rank, std::move(loaded[i]));
+    } else if (i < file_names.size()) {
+      FML_LOG(ERROR) << "Failed to load: " << file_names[i];
+    } else {
+      FML_LOG(ERROR) << "Failed to load: "
+                     << asset_items[i - file_names.size()]->name.GetString();
     }
   }
+  std::stable_sort(
+      ranked.begin(), ranked.end(),
+      [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  std::vector<PersistentCache::SkSLCache> result;
+  result.reserve(ranked.size());
+  size_t critical = 0;
+  for (auto& [rank, sksl] : ranked) {
+    critical += rank < unranked;
+    result.push_back(std::move(sksl));
+  }
+  if (critical_count != nullptr) {
+    *critical_count = critical;
+  }
 
   return result;
 }
@@ -279,11 +482,15 @@ PersistentCache::PersistentCache(bool read_only)
     : is_read_only_(read_only),
       cache_directory_(MakeCacheDirectory(cache_base_path_, read_only, false)),
       sksl_cache_directory_(
-          MakeCacheDirectory(cache_base_path_, read_only, true)) {
+          MakeCacheDirectory(cache_base_path_, read_only, true)),
+      pack_state_(std::make_shared<PackState>()) {
   if (!IsValid()) {
     FML_LOG(WARNING) << "Could not acquire the persistent cache directory. "
                         "Caching of GPU resources on disk is disabled.";
+    return;
   }
+  pack_state_->pack = PersistentCachePack::Open(*cache_directory_);
+  LoadPackLog(*cache_directory_, *pack_state_, read_only);
 }
 
 PersistentCache::~PersistentCache() = default;
@@ -336,8 +543,28 @@ sk_sp<SkData> PersistentCache::load(const SkData& key) {
   if (file_name.empty()) {
     return nullptr;
   }
-  auto result =
-      PersistentCache::LoadFile(*cache_directory_, file_name, false).value;
+  // Skia looks up every shader that it has not precompiled when it is first
+  // used.
+  RecordFirstUse(file_name);
+  sk_sp<SkData> result;
+  std::shared_ptr<const PersistentCachePack> pack;
+  {
+    std::scoped_lock lock(pack_state_->mutex);
+    auto logged = pack_state_->log_values.find(std::string(
+        static_cast<const char*>(key.data()), key.size()));
+    if (logged != pack_state_->log_values.end()) {
+      result = logged->second;
+    }
+    pack = pack_state_->pack;
+  }
+  // Caches written before the pack existed, and read-only caches shipped with
+  // the application, store each object in its own file.
+  if (result == nullptr) {
+    result = pack ? pack->Find(key)
+                  : PersistentCache::LoadFile(*cache_directory_, file_name,
+                                              false)
+                        .value;
+  }
   if (result != nullptr) {
     TRACE_EVENT0("flutter", "PersistentCacheLoadHit");
   }
@@ -418,9 +645,229 @@ void PersistentCache::store(const SkData& key, const SkData& data) {
     return;
   }
 
-  PersistentCacheStore(GetWorkerTaskRunner(),
-                       cache_sksl_ ? sksl_cache_directory_ : cache_directory_,
-                       std::move(file_name), std::move(mapping));
+  if (cache_sksl_) {
+    PersistentCacheStore(GetWorkerTaskRunner(), sksl_cache_directory_,
+                         std::move(file_name), std::move(mapping));
+  } else {
+    StoreInPack(GetWorkerTaskRunner(), cache_directory_, pack_state_,
+                std::move(mapping));
+  }
+}
+
+void PersistentCache::StoreInPack(
+    const fml::RefPtr<fml::TaskRunner>& worker,
+    const std::shared_ptr<fml::UniqueFD>& cache_directory,
+    const std::shared_ptr<PackState>& pack_state,
+    std::unique_ptr<fml::Mapping> object) {
+  {
+    std::scoped_lock lock(pack_state->mutex);
+    pack_state->pending_objects.push_back(std::move(object));
+    // Objects stored before a scheduled flush runs are written by it.
+    if (pack_state->is_flush_scheduled) {
+      return;
+    }
+    pack_state->is_flush_scheduled = true;
+  }
+
+  auto task = [cache_directory, pack_state]() {
+    FlushPack(*cache_directory, *pack_state);
+  };
+  if (!worker) {
+    FML_LOG(WARNING)
+        << "The persistent cache has no available workers. Performing the task "
+           "on the current thread. This slow operation is going to occur on a "
+           "frame workload.";
+    task();
+  } else {
+    worker->PostTask(std::move(task));
+  }
+}
+
+void PersistentCache::FlushPack(const fml::UniqueFD& cache_directory,
+                                PackState& pack_state) {
+  TRACE_EVENT0("flutter", "PersistentCacheFlushPack");
+  std::scoped_lock write_lock(pack_state.write_mutex);
+  std::vector<std::unique_ptr<fml::Mapping>> objects;
+  std::shared_ptr<const PersistentCachePack> pack;
+  {
+    std::scoped_lock lock(pack_state.mutex);
+    objects.swap(pack_state.pending_objects);
+    pack_state.is_flush_scheduled = false;
+    pack = pack_state.pack;
+  }
+  if (objects.empty()) {
+    return;
+  }
+
+  // The first objects are compacted into a new pack right away. Later
+  // objects are appended to the log.
+  if (pack == nullptr) {
+    CompactPack(cache_directory, pack_state, std::move(objects));
+    return;
+  }
+
+  std::vector<uint8_t> records = PersistentCachePack::BuildLogRecords(objects);
+  if (records.empty()) {
+    return;
+  }
+  if (!fml::AppendToFile(cache_directory, PersistentCachePack::kLogFileName,
+                         fml::DataMapping(records))) {
+    FML_LOG(WARNING) << "Could not write cache contents to persistent store.";
+    return;
+  }
+  size_t log_size = 0;
+  {
+    std::scoped_lock lock(pack_state.mutex);
+    PersistentCachePack::ReadLog(
+        fml::NonOwnedMapping(records.data(), records.size()),
+        [&pack_state](std::string_view key, const uint8_t* value,
+                      size_t value_size) {
+          pack_state.log_values[std::string(key)] =
+              SkData::MakeWithCopy(value, value_size);
+        });
+    pack_state.log_size += records.size();
+    log_size = pack_state.log_size;
+  }
+
+  // Compacting once the log is as large as the pack keeps the total size
+  // written proportional to the size of the cache.
+  if (log_size >=
+      std::max(PersistentCachePack::kMinLogSizeToCompact, pack->GetSize())) {
+    CompactPack(cache_directory, pack_state, {});
+  }
+}
+
+void PersistentCache::CompactPack(
+    const fml::UniqueFD& cache_directory,
+    PackState& pack_state,
+    std::vector<std::unique_ptr<fml::Mapping>> objects) {
+  TRACE_EVENT0("flutter", "PersistentCacheCompactPack");
+  std::vector<std::unique_ptr<fml::Mapping>> compacted;
+  std::shared_ptr<const PersistentCachePack> base;
+  {
+    std::scoped_lock lock(pack_state.mutex);
+    base = pack_state.pack;
+    for (const auto& [key, value] : pack_state.log_values) {
+      compacted.push_back(BuildCacheObject(
+          *SkData::MakeWithoutCopy(key.data(), key.size()), *value));
+    }
+  }
+
+  // The first pack takes in the objects stored in individual files, which are
+  // removed once the pack is written.
+  std::vector<std::string> object_files;
+  if (base == nullptr) {
+    std::vector<std::unique_ptr<fml::Mapping>> file_objects;
+    fml::VisitFiles(cache_directory, [&](const fml::UniqueFD& directory,
+                                         const std::string& filename) {
+      if (filename.size() != 2 * SHA_DIGEST_LENGTH ||
+          fml::IsDirectory(directory, filename.c_str())) {
+        return true;
+      }
+      auto file = fml::OpenFileReadOnly(directory, filename.c_str());
+      if (file.is_valid()) {
+        file_objects.push_back(std::make_unique<fml::FileMapping>(file));
+        object_files.push_back(filename);
+      }
+      return true;
+    });
+    compacted.insert(compacted.begin(),
+                     std::make_move_iterator(file_objects.begin()),
+                     std::make_move_iterator(file_objects.end()));
+  }
+  compacted.insert(compacted.end(), std::make_move_iterator(objects.begin()),
+                   std::make_move_iterator(objects.end()));
+
+  fml::DataMapping data(PersistentCachePack::Build(base.get(), compacted));
+  if (!fml::WriteAtomically(cache_directory, PersistentCachePack::kFileName,
+                            data)) {
+    FML_LOG(WARNING) << "Could not write cache contents to persistent store.";
+    return;
+  }
+  // If this is interrupted, the objects in the log are read again on the
+  // next launch, and they are the same as those in the pack.
+  fml::UnlinkFile(cache_directory, PersistentCachePack::kLogFileName);
+
+  auto pack = PersistentCachePack::Open(cache_directory);
+  {
+    std::scoped_lock lock(pack_state.mutex);
+    pack_state.pack = std::move(pack);
+    pack_state.log_values.clear();
+    pack_state.log_size = 0;
+  }
+
+  for (const auto& file_name : object_files) {
+    fml::UnlinkFile(cache_directory, file_name.c_str());
+  }
+}
+
+void PersistentCache::RecordFirstUse(const std::string& file_name) const {
+  std::scoped_lock lock(first_use_mutex_);
+  if (is_recording_first_use_ && first_use_set_.insert(file_name).second) {
+    first_use_order_.push_back(file_name);
+  }
+}
+
+void PersistentCache::MarkFirstFrameRasterized() {
+  std::vector<std::string> first_use_order;
+  {
+    std::scoped_lock lock(first_use_mutex_);
+    if (!is_recording_first_use_) {
+      return;
+    }
+    is_recording_first_use_ = false;
+    first_use_order = std::move(first_use_order_);
+    first_use_order_.clear();
+    first_use_set_.clear();
+  }
+
+  if (is_read_only_ || !IsValid() || first_use_order.empty()) {
+    return;
+  }
+
+  // The order of this run replaces that of the last run, so that shaders that
+  // are no longer used before the first frame, or no longer in the cache, drop
+  // out of it.
+  if (first_use_order.size() > kMaxFirstUseCount) {
+    first_use_order.resize(kMaxFirstUseCount);
+  }
+  if (first_use_order == LoadFirstUseOrder()) {
+    return;
+  }
+  std::string contents;
+  for (const auto& file_name : first_use_order) {
+    contents += file_name;
+    contents += '\n';
+  }
+
+  PersistentCacheStore(GetWorkerTaskRunner(), cache_directory_,
+                       kFirstUseFileName,
+                       std::make_unique<fml::DataMapping>(contents));
+}
+
+std::unique_ptr<fml::Mapping> PersistentCache::LoadData(
+    const std::string& file_name) const {
+  if (!IsValid()) {
+    return nullptr;
+  }
+  auto file = fml::OpenFileReadOnly(*cache_directory_, file_name.c_str());
+  if (!file.is_valid()) {
+    return nullptr;
+  }
+  auto mapping = std::make_unique<fml::FileMapping>(file);
+  if (mapping->GetSize() == 0) {
+    return nullptr;
+  }
+  return mapping;
+}
+
+void PersistentCache::StoreData(const std::string& file_name,
+                                std::unique_ptr<fml::Mapping> data) {
+  if (is_read_only_ || !IsValid() || !data) {
+    return;
+  }
+  PersistentCacheStore(GetWorkerTaskRunner(), cache_directory_, file_name,
+                       std::move(data));
 }
 
 void PersistentCache::DumpSkp(const SkData& data) {
@@ -447,6 +894,12 @@ void PersistentCache::AddWorkerTaskRunner(
   worker_task_runners_.insert(task_runner);
 }
 
+void PersistentCache::SetConcurrentTaskRunner(
+    std::shared_ptr<fml::ConcurrentTaskRunner> task_runner) {
+  std::scoped_lock lock(worker_task_runners_mutex_);
+  concurrent_task_runner_ = std::move(task_runner);
+}
+
 void PersistentCache::RemoveWorkerTaskRunner(
     const fml::RefPtr<fml::TaskRunner>& task_runner) {
   std::scoped_lock lock(worker_task_runners_mutex_);
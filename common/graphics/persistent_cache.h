@@ -8,10 +8,14 @@
 #include <memory>
 #include <mutex>
 #include <set>
+#include <string>
+#include <vector>
 
 #include "flutter/assets/asset_manager.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/task_runner.h"
+#include "flutter/fml/time/time_delta.h"
 #include "flutter/fml/unique_fd.h"
 #include "third_party/skia/include/gpu/GrContextOptions.h"
 
@@ -21,10 +25,16 @@ namespace testing {
 class ShellTest;
 }
 
+class PersistentCachePack;
+
 /// A cache of SkData that gets stored to disk.
 ///
 /// This is mainly used for Shaders but is also written to by Dart.  It is
 /// thread-safe for reading and writing from multiple threads.
+///
+/// Objects are stored in a |PersistentCachePack|. New objects are appended to
+/// its log on a worker and periodically compacted into it. SkSLs are stored in
+/// individual files instead, as they are also read by tooling.
 class PersistentCache : public GrContextOptions::PersistentCache {
  public:
   // Mutable static switch that can be set before GetCacheForProcess. If true,
@@ -72,6 +82,11 @@ class PersistentCache : public GrContextOptions::PersistentCache {
 
   void RemoveWorkerTaskRunner(const fml::RefPtr<fml::TaskRunner>& task_runner);
 
+  // Set the task runner used to load SkSLs in parallel. If none is set, they
+  // are loaded on the calling thread.
+  void SetConcurrentTaskRunner(
+      std::shared_ptr<fml::ConcurrentTaskRunner> task_runner);
+
   // Whether Skia tries to store any shader into this persistent cache after
   // |ResetStoredNewShaders| is called. This flag is usually reset before each
   // frame so we can know if Skia tries to compile new shaders in that frame.
@@ -93,8 +108,20 @@ class PersistentCache : public GrContextOptions::PersistentCache {
     sk_sp<SkData> value;
   };
 
-  /// Load all the SkSL shader caches in the right directory.
-  std::vector<SkSLCache> LoadSkSLs() const;
+  //----------------------------------------------------------------------------
+  /// @brief      Load all the SkSL shader caches in the right directory and the
+  ///             SkSLs bundled with the application.
+  ///
+  ///             The SkSLs that were used before the first frame of the last
+  ///             run are returned first, in the order of their first use.
+  ///             These are the critical SkSLs. Until a run has recorded which
+  ///             SkSLs it used, the SkSLs bundled with the application are the
+  ///             critical SkSLs.
+  ///
+  /// @param[out] critical_count  If not null, receives the number of critical
+  ///                             SkSLs at the start of the result.
+  ///
+  std::vector<SkSLCache> LoadSkSLs(size_t* critical_count = nullptr) const;
 
   //----------------------------------------------------------------------------
   /// @brief      Precompile SkSLs packaged with the application and gathered
@@ -105,11 +132,69 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   ///             recreated. The SkSLs must be precompiled again in the new
   ///             context.
   ///
-  /// @param      context  The rendering context to precompile shaders in.
+  /// @param      context             The rendering context to precompile
+  ///                                 shaders in.
+  /// @param      defer_non_critical  Whether to only precompile the critical
+  ///                                 SkSLs now. The remaining SkSLs are
+  ///                                 precompiled by calls to
+  ///                                 |PrecompileDeferredSkSLs| after the first
+  ///                                 frame, so that Skia looks up the ones
+  ///                                 the first frame uses and they are
+  ///                                 recorded as critical for the next run.
   ///
   /// @return     The number of SkSLs precompiled.
   ///
-  size_t PrecompileKnownSkSLs(GrDirectContext* context) const;
+  size_t PrecompileKnownSkSLs(GrDirectContext* context,
+                              bool defer_non_critical = false) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Precompile some of the SkSLs deferred by the last call to
+  ///             |PrecompileKnownSkSLs| in the given context.
+  ///
+  ///             SkSLs are precompiled one at a time until the time budget is
+  ///             used up. At least one SkSL is precompiled by every call so
+  ///             that progress is made even if a single compile takes longer
+  ///             than the budget.
+  ///
+  /// @param      context  The context passed to |PrecompileKnownSkSLs|.
+  ///                      Nothing is precompiled in any other context.
+  /// @param      budget   The time after which no further SkSL is started.
+  ///
+  /// @return     The number of deferred SkSLs left to precompile.
+  ///
+  size_t PrecompileDeferredSkSLs(GrDirectContext* context,
+                                 fml::TimeDelta budget) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Stop recording the order in which shaders are first used and
+  ///             store the shaders used so far as the critical SkSLs of the
+  ///             next run. Called when the first frame has been rasterized.
+  ///
+  ///             Skia does not look up the shaders it has precompiled, so the
+  ///             critical SkSLs precompiled in this run are recorded as used.
+  ///             The stored order replaces that of the last run and holds at
+  ///             most |kMaxFirstUseCount| shaders.
+  ///
+  void MarkFirstFrameRasterized();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Loads data that is not a shader, such as the fallback fonts
+  ///             found by the text engine, from a file in the cache directory.
+  ///             The file is purged and invalidated along with the shaders.
+  ///
+  /// @param[in]  file_name  The name of the file. It must not collide with
+  ///                        the names of cached shaders.
+  ///
+  /// @return     The contents of the file or null if there is none.
+  ///
+  std::unique_ptr<fml::Mapping> LoadData(const std::string& file_name) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Replaces the contents of a file in the cache directory on a
+  ///             worker thread. See |LoadData|.
+  ///
+  void StoreData(const std::string& file_name,
+                 std::unique_ptr<fml::Mapping> data);
 
   // Return mappings for all skp's accessible through the AssetManager
   std::vector<std::unique_ptr<fml::Mapping>> GetSkpsFromAssetManager() const;
@@ -129,6 +214,8 @@ class PersistentCache : public GrContextOptions::PersistentCache {
 
   static constexpr char kSkSLSubdirName[] = "sksl";
   static constexpr char kAssetFileName[] = "io.flutter.shaders.json";
+  static constexpr char kFirstUseFileName[] = "io.flutter.shaders.first_use";
+  static constexpr size_t kMaxFirstUseCount = 256;
 
  private:
   static std::string cache_base_path_;
@@ -151,8 +238,24 @@ class PersistentCache : public GrContextOptions::PersistentCache {
   const bool is_read_only_;
   const std::shared_ptr<fml::UniqueFD> cache_directory_;
   const std::shared_ptr<fml::UniqueFD> sksl_cache_directory_;
+  // The pack, its log and the objects waiting to be added to it. Shared with
+  // the tasks that write the pack.
+  struct PackState;
+  const std::shared_ptr<PackState> pack_state_;
   mutable std::mutex worker_task_runners_mutex_;
   std::multiset<fml::RefPtr<fml::TaskRunner>> worker_task_runners_;
+  std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner_;
+
+  // The cache file names of the shaders used before the first frame, in the
+  // order of their first use.
+  mutable std::mutex first_use_mutex_;
+  mutable bool is_recording_first_use_ = true;
+  mutable std::vector<std::string> first_use_order_;
+  mutable std::set<std::string> first_use_set_;
+
+  mutable std::mutex deferred_sksls_mutex_;
+  mutable GrDirectContext* deferred_sksls_context_ = nullptr;
+  mutable std::vector<SkSLCache> deferred_sksls_;
 
   bool stored_new_shaders_ = false;
   bool is_dumping_skp_ = false;
@@ -163,6 +266,10 @@ class PersistentCache : public GrContextOptions::PersistentCache {
 
   bool IsValid() const;
 
+  std::vector<std::string> LoadFirstUseOrder() const;
+
+  void RecordFirstUse(const std::string& file_name) const;
+
   explicit PersistentCache(bool read_only = false);
 
   // |GrContextOptions::PersistentCache|
@@ -170,6 +277,28 @@ class PersistentCache : public GrContextOptions::PersistentCache {
 
   fml::RefPtr<fml::TaskRunner> GetWorkerTaskRunner() const;
 
+  static void StoreInPack(const fml::RefPtr<fml::TaskRunner>& worker,
+                          const std::shared_ptr<fml::UniqueFD>& cache_directory,
+                          const std::shared_ptr<PackState>& pack_state,
+                          std::unique_ptr<fml::Mapping> object);
+
+  // Reads the log of the pack into |pack_state|.
+  static void LoadPackLog(const fml::UniqueFD& cache_directory,
+                          PackState& pack_state,
+                          bool read_only);
+
+  // Writes the objects queued by |StoreInPack|. Must be called with
+  // |PackState::write_mutex| unlocked.
+  static void FlushPack(const fml::UniqueFD& cache_directory,
+                        PackState& pack_state);
+
+  // Builds a new pack from the current one, the objects in the log and the
+  // given objects, and removes the log. Must be called with
+  // |PackState::write_mutex| locked.
+  static void CompactPack(const fml::UniqueFD& cache_directory,
+                          PackState& pack_state,
+                          std::vector<std::unique_ptr<fml::Mapping>> objects);
+
   friend class testing::ShellTest;
 
   FML_DISALLOW_COPY_AND_ASSIGN(PersistentCache);
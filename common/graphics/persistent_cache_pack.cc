@@ -0,0 +1,229 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/common/graphics/persistent_cache_pack.h"
+
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+
+#include "flutter/common/graphics/persistent_cache.h"
+#include "flutter/fml/file.h"
+#include "flutter/fml/logging.h"
+
+namespace flutter {
+
+using CacheObjectHeader = PersistentCache::CacheObjectHeader;
+
+using Table = fml::MappedHashTable;
+
+static constexpr Table::Format kFormat = {
+    .signature = PersistentCachePack::kSignature,
+    .version = PersistentCachePack::kVersion1,
+    .entry_size = 3 * sizeof(uint64_t),
+};
+
+namespace {
+
+struct EntryData {
+  uint64_t offset;
+  uint64_t size;
+};
+
+}  // namespace
+
+static EntryData ReadEntry(const uint8_t* entry) {
+  return {
+      .offset = Table::Read<uint64_t>(entry),
+      .size = Table::Read<uint64_t>(entry + 8),
+  };
+}
+
+// Returns the key of a cache object, or std::nullopt if the object is not a
+// valid cache object.
+static std::optional<std::string_view> GetObjectKey(const uint8_t* object,
+                                                    size_t size) {
+  if (object == nullptr || size < sizeof(CacheObjectHeader)) {
+    return std::nullopt;
+  }
+  CacheObjectHeader header(0);
+  std::memcpy(&header, object, sizeof(CacheObjectHeader));
+  if (header.signature != CacheObjectHeader::kSignature ||
+      header.version != CacheObjectHeader::kVersion1 ||
+      size - sizeof(CacheObjectHeader) < header.key_size) {
+    return std::nullopt;
+  }
+  return std::string_view(
+      reinterpret_cast<const char*>(object + sizeof(CacheObjectHeader)),
+      header.key_size);
+}
+
+std::unique_ptr<PersistentCachePack> PersistentCachePack::Open(
+    const fml::UniqueFD& directory) {
+  auto file = fml::OpenFileReadOnly(directory, kFileName);
+  if (!file.is_valid()) {
+    return nullptr;
+  }
+  return Create(std::make_unique<fml::FileMapping>(file));
+}
+
+std::unique_ptr<PersistentCachePack> PersistentCachePack::Create(
+    std::unique_ptr<fml::Mapping> mapping) {
+  if (!mapping || !mapping->GetMapping()) {
+    return nullptr;
+  }
+  auto pack = std::unique_ptr<PersistentCachePack>(
+      new PersistentCachePack(std::move(mapping)));
+  if (!pack->Validate()) {
+    FML_LOG(INFO) << "Persistent cache pack is corrupt and will be ignored.";
+    return nullptr;
+  }
+  return pack;
+}
+
+std::vector<uint8_t> PersistentCachePack::Build(
+    const PersistentCachePack* base,
+    const std::vector<std::unique_ptr<fml::Mapping>>& objects) {
+  struct Object {
+    const uint8_t* data;
+    size_t size;
+    std::string_view key;
+  };
+  std::vector<Object> packed;
+  std::unordered_map<std::string_view, size_t> key_indices;
+  auto add = [&packed, &key_indices](const uint8_t* data, size_t size) {
+    auto key = GetObjectKey(data, size);
+    if (!key.has_value()) {
+      return;
+    }
+    auto found = key_indices.find(key.value());
+    if (found != key_indices.end()) {
+      packed[found->second] = {data, size, key.value()};
+    } else {
+      key_indices.emplace(key.value(), packed.size());
+      packed.push_back({data, size, key.value()});
+    }
+  };
+  if (base != nullptr) {
+    const uint8_t* base_data = base->mapping_->GetMapping();
+    for (uint32_t i = 0; i < base->table_.GetEntryCount(); i++) {
+      const auto entry = ReadEntry(base->table_.GetEntry(i));
+      add(base_data + entry.offset, entry.size);
+    }
+  }
+  for (const auto& object : objects) {
+    if (object) {
+      add(object->GetMapping(), object->GetSize());
+    }
+  }
+
+  size_t objects_size = 0;
+  for (const auto& object : packed) {
+    objects_size += object.size;
+  }
+
+  Table::Builder builder(kFormat, packed.size(), objects_size);
+  if (!builder.IsValid()) {
+    FML_LOG(ERROR) << "Persistent cache objects are too large to pack.";
+    return {};
+  }
+
+  uint8_t* objects = builder.GetPayload();
+  size_t object_offset = builder.GetPayloadOffset();
+  for (uint32_t i = 0; i < packed.size(); i++) {
+    const auto& object = packed[i];
+    uint8_t* entry = builder.AddEntry(i, fml::FNV1aHash(object.key));
+    Table::Write<uint64_t>(entry, object_offset);
+    Table::Write<uint64_t>(entry + 8, object.size);
+    std::memcpy(objects, object.data, object.size);
+    objects += object.size;
+    object_offset += object.size;
+  }
+
+  return builder.Take();
+}
+
+std::vector<uint8_t> PersistentCachePack::BuildLogRecords(
+    const std::vector<std::unique_ptr<fml::Mapping>>& objects) {
+  std::vector<uint8_t> buffer;
+  for (const auto& object : objects) {
+    if (!object ||
+        !GetObjectKey(object->GetMapping(), object->GetSize()).has_value()) {
+      continue;
+    }
+    const size_t record_offset = buffer.size();
+    buffer.resize(record_offset + sizeof(uint64_t) + object->GetSize());
+    Table::Write<uint64_t>(buffer.data() + record_offset, object->GetSize());
+    std::memcpy(buffer.data() + record_offset + sizeof(uint64_t),
+                object->GetMapping(), object->GetSize());
+  }
+  return buffer;
+}
+
+size_t PersistentCachePack::ReadLog(const fml::Mapping& log,
+                                    const LogVisitor& visitor) {
+  const uint8_t* data = log.GetMapping();
+  const size_t size = data == nullptr ? 0 : log.GetSize();
+  size_t offset = 0;
+  while (size - offset >= sizeof(uint64_t)) {
+    const uint64_t object_size = Table::Read<uint64_t>(data + offset);
+    const size_t object_offset = offset + sizeof(uint64_t);
+    if (object_size > size - object_offset) {
+      break;
+    }
+    const uint8_t* object = data + object_offset;
+    auto key = GetObjectKey(object, object_size);
+    if (!key.has_value()) {
+      break;
+    }
+    const size_t value_offset = sizeof(CacheObjectHeader) + key->size();
+    visitor(key.value(), object + value_offset, object_size - value_offset);
+    offset = object_offset + object_size;
+  }
+  return offset;
+}
+
+PersistentCachePack::PersistentCachePack(std::unique_ptr<fml::Mapping> mapping)
+    : mapping_(std::move(mapping)) {}
+
+PersistentCachePack::~PersistentCachePack() = default;
+
+bool PersistentCachePack::Validate() {
+  const uint8_t* data = mapping_->GetMapping();
+  const size_t size = mapping_->GetSize();
+  if (!table_.Init(kFormat, data, size)) {
+    return false;
+  }
+
+  const size_t objects_offset = table_.GetPayloadOffset();
+  for (uint32_t i = 0; i < table_.GetEntryCount(); i++) {
+    const auto entry = ReadEntry(table_.GetEntry(i));
+    if (entry.offset < objects_offset || entry.offset > size ||
+        entry.size > size - entry.offset ||
+        !GetObjectKey(data + entry.offset, entry.size).has_value()) {
+      return false;
+    }
+  }
+  return true;
+}
+
+sk_sp<SkData> PersistentCachePack::Find(const SkData& key) const {
+  const std::string_view key_view(static_cast<const char*>(key.data()),
+                                  key.size());
+  const uint8_t* data = mapping_->GetMapping();
+  auto index = table_.Find(fml::FNV1aHash(key_view), [&](uint32_t i) {
+    const auto entry = ReadEntry(table_.GetEntry(i));
+    return GetObjectKey(data + entry.offset, entry.size) == key_view;
+  });
+  if (!index.has_value()) {
+    return nullptr;
+  }
+  const auto entry = ReadEntry(table_.GetEntry(index.value()));
+  const size_t value_offset = sizeof(CacheObjectHeader) + key.size();
+  return SkData::MakeWithCopy(data + entry.offset + value_offset,
+                              entry.size - value_offset);
+}
+
+}  // namespace flutter
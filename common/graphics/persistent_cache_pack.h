@@ -0,0 +1,133 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_COMMON_GRAPHICS_PERSISTENT_CACHE_PACK_H_
+#define FLUTTER_COMMON_GRAPHICS_PERSISTENT_CACHE_PACK_H_
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapped_hash_table.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/unique_fd.h"
+#include "third_party/skia/include/core/SkData.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      A single file holding many cache objects in the format built by
+///             |PersistentCache::BuildCacheObject|, with a hash table index
+///             that is used in place from the mapping of the file.
+///
+///             The pack is immutable. Objects stored after it was built are
+///             appended to a log next to it, and the log is compacted into a
+///             new pack once it has grown to the size of the pack. Building a
+///             pack drops objects whose keys have been stored again.
+///
+///             The index is a |fml::MappedHashTable| keyed by the cache keys.
+///             Each entry holds the uint64 key hash, uint64 object offset and
+///             uint64 object size. The payload holds the cache objects, each
+///             starting with a |PersistentCache::CacheObjectHeader|. Object
+///             offsets are relative to the start of the pack.
+///
+///             The log is a sequence of records, each holding the uint64 size
+///             of a cache object followed by the object.
+///
+class PersistentCachePack {
+ public:
+  /// The name of the pack in the persistent cache directory.
+  static constexpr char kFileName[] = "io.flutter.shaders.pack";
+
+  /// The name of the log in the persistent cache directory.
+  static constexpr char kLogFileName[] = "io.flutter.shaders.pack.log";
+
+  /// The log is not compacted before it reaches this size, so that a small
+  /// pack is not rewritten for every few objects.
+  static constexpr size_t kMinLogSizeToCompact = 256 * 1024;
+
+  /// Called with the key and value of a cache object read from a log.
+  using LogVisitor = std::function<void(std::string_view key,
+                                        const uint8_t* value,
+                                        size_t value_size)>;
+
+  // A prefix used to identify the pack file format.
+  static const uint32_t kSignature = 0x4B434150;  // "PACK"
+  static const uint32_t kVersion1 = 1;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Maps and validates the pack in the given directory.
+  ///
+  /// @return     The pack or null if there is no valid pack in the directory.
+  ///
+  static std::unique_ptr<PersistentCachePack> Open(
+      const fml::UniqueFD& directory);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Validates and wraps a serialized pack.
+  ///
+  /// @return     The pack or null if the mapping is not a valid pack.
+  ///
+  static std::unique_ptr<PersistentCachePack> Create(
+      std::unique_ptr<fml::Mapping> mapping);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Serializes a pack holding the objects of the base pack and
+  ///             the given cache objects. Objects later in the list replace
+  ///             earlier objects and objects of the base pack with the same
+  ///             key. Objects that are not valid cache objects are skipped.
+  ///
+  /// @param      base     The pack to start from. May be null.
+  /// @param      objects  The cache objects to add.
+  ///
+  static std::vector<uint8_t> Build(
+      const PersistentCachePack* base,
+      const std::vector<std::unique_ptr<fml::Mapping>>& objects);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Serializes cache objects as log records. Objects that are not
+  ///             valid cache objects are skipped.
+  ///
+  static std::vector<uint8_t> BuildLogRecords(
+      const std::vector<std::unique_ptr<fml::Mapping>>& objects);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Reads the records of a log, oldest first. Reading stops at
+  ///             the first record that is incomplete or invalid, such as one
+  ///             whose append was interrupted.
+  ///
+  /// @return     The size of the valid records at the start of the log.
+  ///
+  static size_t ReadLog(const fml::Mapping& log, const LogVisitor& visitor);
+
+  ~PersistentCachePack();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Looks up the value stored for a key.
+  ///
+  /// @return     A copy of the value or null if the key is not in the pack.
+  ///
+  sk_sp<SkData> Find(const SkData& key) const;
+
+  size_t GetObjectCount() const { return table_.GetEntryCount(); }
+
+  size_t GetSize() const { return mapping_->GetSize(); }
+
+ private:
+  const std::unique_ptr<fml::Mapping> mapping_;
+  fml::MappedHashTable table_;
+
+  explicit PersistentCachePack(std::unique_ptr<fml::Mapping> mapping);
+
+  bool Validate();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PersistentCachePack);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_COMMON_GRAPHICS_PERSISTENT_CACHE_PACK_H_
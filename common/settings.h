@@ -301,6 +301,10 @@ struct Settings {
   // Max bytes threshold of resource cache, or 0 for unlimited.
   size_t resource_cache_max_bytes_threshold = 0;
 
+  // Max bytes used by the cache of shaped words of the text layout engine, or
+  // 0 for the default.
+  size_t text_layout_cache_max_bytes = 0;
+
   /// The minimum number of samples to require in multipsampled anti-aliasing.
   ///
   /// Setting this value to 0 or 1 disables MSAA.
@@ -90,6 +90,13 @@ bool WriteAtomically(const fml::UniqueFD& base_directory,
                      const char* file_name,
                      const Mapping& mapping);
 
+/// Appends the contents of `mapping` to the file, creating it if necessary,
+/// and flushes it to storage. A failure may leave part of the contents
+/// appended.
+bool AppendToFile(const fml::UniqueFD& base_directory,
+                  const char* file_name,
+                  const Mapping& mapping);
+
 /// Signature of a callback on a file in `directory` with `filename` (relative
 /// to `directory`). The returned bool should be false if and only if further
 /// traversal should be stopped. For example, a file-search visitor may return
@@ -253,6 +253,25 @@ TEST(FileTest, AtomicWriteTest) {
   ASSERT_TRUE(fml::UnlinkFile(dir.fd(), "precious_data"));
 }
 
+TEST(FileTest, AppendToFileTest) {
+  fml::ScopedTemporaryDirectory dir;
+
+  const std::string first = "These are my contents.";
+  const std::string second = " These are more.";
+
+  // Create and append.
+  ASSERT_TRUE(fml::AppendToFile(dir.fd(), "log", fml::DataMapping(first)));
+  ASSERT_TRUE(fml::AppendToFile(dir.fd(), "log", fml::DataMapping(second)));
+
+  // Read and verify.
+  ASSERT_EQ(first + second,
+            ReadStringFromFile(fml::OpenFile(dir.fd(), "log", false,
+                                             fml::FilePermission::kRead)));
+
+  // Cleanup.
+  ASSERT_TRUE(fml::UnlinkFile(dir.fd(), "log"));
+}
+
 TEST(FileTest, IgnoreBaseDirWhenPathIsAbsolute) {
   fml::ScopedTemporaryDirectory dir;
 
@@ -0,0 +1,116 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/mapped_hash_table.h"
+
+#include <limits>
+
+#include "flutter/fml/logging.h"
+
+namespace fml {
+
+// Sections are addressed with 32-bit offsets by some users of the table, and
+// must be addressable with size_t on 32-bit targets.
+static constexpr size_t kMaxTableSize = std::numeric_limits<uint32_t>::max();
+
+MappedHashTable::Builder::Builder(const Format& format,
+                                  size_t entry_count,
+                                  size_t payload_size)
+    : entry_size_(format.entry_size) {
+  FML_DCHECK(entry_size_ >= sizeof(uint64_t));
+  // Each entry takes at most two buckets, as the bucket count is the smallest
+  // power of two that is at least twice the entry count.
+  if (entry_count > (kMaxTableSize - kHeaderSize) /
+                        (2 * kBucketSize + entry_size_)) {
+    return;
+  }
+  bucket_count_ = 1;
+  while (bucket_count_ < entry_count * 2) {
+    bucket_count_ <<= 1;
+  }
+  entries_offset_ = kHeaderSize + bucket_count_ * kBucketSize;
+  payload_offset_ = entries_offset_ + entry_count * entry_size_;
+  if (payload_size > kMaxTableSize - payload_offset_) {
+    return;
+  }
+  buffer_.resize(payload_offset_ + payload_size, 0);
+
+  uint8_t* header = buffer_.data();
+  Write<uint32_t>(header, format.signature);
+  Write<uint32_t>(header + 4, format.version);
+  Write<uint32_t>(header + 8, bucket_count_);
+  Write<uint32_t>(header + 12, static_cast<uint32_t>(entry_count));
+}
+
+MappedHashTable::Builder::~Builder() = default;
+
+uint8_t* MappedHashTable::Builder::AddEntry(uint32_t index, uint64_t hash) {
+  FML_DCHECK(IsValid());
+  uint8_t* entry = buffer_.data() + entries_offset_ + index * entry_size_;
+  Write<uint64_t>(entry, hash);
+
+  uint8_t* buckets = buffer_.data() + kHeaderSize;
+  uint32_t bucket = hash & (bucket_count_ - 1);
+  while (Read<uint32_t>(buckets + bucket * kBucketSize) != 0) {
+    bucket = (bucket + 1) & (bucket_count_ - 1);
+  }
+  Write<uint32_t>(buckets + bucket * kBucketSize, index + 1);
+  return entry + sizeof(uint64_t);
+}
+
+MappedHashTable::MappedHashTable() = default;
+
+MappedHashTable::~MappedHashTable() = default;
+
+bool MappedHashTable::Init(const Format& format,
+                           const uint8_t* data,
+                           size_t size) {
+  if (data == nullptr || size < kHeaderSize ||
+      Read<uint32_t>(data) != format.signature ||
+      Read<uint32_t>(data + 4) != format.version) {
+    return false;
+  }
+
+  const uint32_t bucket_count = Read<uint32_t>(data + 8);
+  const uint32_t entry_count = Read<uint32_t>(data + 12);
+  // Lookups terminate because there are more buckets than entries, and so
+  // there is always an empty bucket.
+  if (bucket_count == 0 || (bucket_count & (bucket_count - 1)) != 0 ||
+      entry_count >= bucket_count) {
+    return false;
+  }
+
+  // Bound the counts by the size of the data before computing the offsets,
+  // so that a corrupt header can not make them wrap around on 32-bit targets.
+  if (bucket_count > (size - kHeaderSize) / kBucketSize) {
+    return false;
+  }
+  const size_t entries_offset = kHeaderSize + bucket_count * kBucketSize;
+  if (entry_count > (size - entries_offset) / format.entry_size) {
+    return false;
+  }
+
+  const uint8_t* buckets = data + kHeaderSize;
+  uint32_t used_buckets = 0;
+  for (uint32_t i = 0; i < bucket_count; i++) {
+    const uint32_t slot = Read<uint32_t>(buckets + i * kBucketSize);
+    if (slot > entry_count) {
+      return false;
+    }
+    used_buckets += slot != 0;
+  }
+  if (used_buckets > entry_count) {
+    return false;
+  }
+
+  buckets_ = buckets;
+  entries_ = data + entries_offset;
+  entry_size_ = format.entry_size;
+  payload_offset_ = entries_offset + entry_count * format.entry_size;
+  bucket_count_ = bucket_count;
+  entry_count_ = entry_count;
+  return true;
+}
+
+}  // namespace fml
@@ -0,0 +1,203 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_FML_MAPPED_HASH_TABLE_H_
+#define FLUTTER_FML_MAPPED_HASH_TABLE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+
+namespace fml {
+
+//------------------------------------------------------------------------------
+/// @brief      Computes 64-bit FNV-1a hashes. This is the hash used for the
+///             keys of a |MappedHashTable|, and is stable across runs and
+///             platforms so that it can be stored.
+///
+class FNV1aHasher {
+ public:
+  FNV1aHasher() = default;
+
+  void Update(const void* data, size_t size) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < size; i++) {
+      hash_ ^= bytes[i];
+      hash_ *= kPrime;
+    }
+  }
+
+  void Update(std::string_view data) { Update(data.data(), data.size()); }
+
+  uint64_t GetHash() const { return hash_; }
+
+ private:
+  static constexpr uint64_t kOffsetBasis = 0xcbf29ce484222325;
+  static constexpr uint64_t kPrime = 0x100000001b3;
+
+  uint64_t hash_ = kOffsetBasis;
+};
+
+/// Returns the 64-bit FNV-1a hash of |data|.
+inline uint64_t FNV1aHash(std::string_view data) {
+  FNV1aHasher hasher;
+  hasher.Update(data);
+  return hasher.GetHash();
+}
+
+//------------------------------------------------------------------------------
+/// @brief      A hash table that is serialized into a buffer and used in place
+///             from a mapping of it, without being parsed. All values are
+///             little endian.
+///
+///             - Header: uint32 signature, version, bucket count and entry
+///               count.
+///             - Buckets: One uint32 per bucket holding the index of an entry
+///               plus one, or zero if the bucket is empty. The bucket count is
+///               a power of two and collisions are resolved by linear probing
+///               starting at the bucket selected by the key hash.
+///             - Entries: Fixed size entries, each starting with the uint64
+///               key hash. The rest of the entry is defined by the user of
+///               the table.
+///             - Payload: Data referenced by the entries, such as the keys.
+///
+class MappedHashTable {
+ public:
+  /// Describes a kind of table.
+  struct Format {
+    uint32_t signature = 0;
+    uint32_t version = 0;
+    /// The size of an entry including its key hash.
+    size_t entry_size = sizeof(uint64_t);
+  };
+
+  //----------------------------------------------------------------------------
+  /// @brief      Serializes a table. The entries are written by their index
+  ///             and the payload is written directly into the buffer.
+  ///
+  class Builder {
+   public:
+    //--------------------------------------------------------------------------
+    /// @brief      Allocates a table with space for the given number of
+    ///             entries and bytes of payload.
+    ///
+    Builder(const Format& format, size_t entry_count, size_t payload_size);
+
+    ~Builder();
+
+    //--------------------------------------------------------------------------
+    /// @brief      Whether the table could be allocated. Tables whose
+    ///             sections do not fit in 32-bit offsets are not supported.
+    ///
+    bool IsValid() const { return !buffer_.empty(); }
+
+    //--------------------------------------------------------------------------
+    /// @brief      Writes the key hash of an entry and adds the entry to the
+    ///             buckets. Each index must be added once.
+    ///
+    /// @return     The rest of the entry after the key hash.
+    ///
+    uint8_t* AddEntry(uint32_t index, uint64_t hash);
+
+    uint8_t* GetPayload() { return buffer_.data() + payload_offset_; }
+
+    /// The offset of the payload from the start of the table.
+    size_t GetPayloadOffset() const { return payload_offset_; }
+
+    /// Returns the serialized table. The builder can not be used afterwards.
+    std::vector<uint8_t> Take() { return std::move(buffer_); }
+
+   private:
+    const size_t entry_size_;
+    uint32_t bucket_count_ = 0;
+    size_t entries_offset_ = 0;
+    size_t payload_offset_ = 0;
+    std::vector<uint8_t> buffer_;
+
+    FML_DISALLOW_COPY_AND_ASSIGN(Builder);
+  };
+
+  MappedHashTable();
+
+  ~MappedHashTable();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Validates the layout of a serialized table and points this
+  ///             table at it. The data must outlive this table. The contents
+  ///             of the entries are left to the user of the table to
+  ///             validate.
+  ///
+  /// @return     Whether the data is a valid table of the given format.
+  ///
+  bool Init(const Format& format, const uint8_t* data, size_t size);
+
+  uint32_t GetEntryCount() const { return entry_count_; }
+
+  /// The offset of the payload from the start of the table.
+  size_t GetPayloadOffset() const { return payload_offset_; }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the rest of an entry after its key hash.
+  ///
+  const uint8_t* GetEntry(uint32_t index) const {
+    return entries_ + index * entry_size_ + sizeof(uint64_t);
+  }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Looks up the entry whose key hash is |hash| and for which
+  ///             |matches| returns true. |matches| is called with the index
+  ///             of each candidate entry and should compare the keys.
+  ///
+  /// @return     The index of the entry or std::nullopt if there is none.
+  ///
+  template <typename Matcher>
+  std::optional<uint32_t> Find(uint64_t hash, const Matcher& matches) const {
+    for (uint32_t bucket = hash & (bucket_count_ - 1);;
+         bucket = (bucket + 1) & (bucket_count_ - 1)) {
+      const uint32_t slot = Read<uint32_t>(buckets_ + bucket * kBucketSize);
+      if (slot == 0) {
+        return std::nullopt;
+      }
+      const uint32_t index = slot - 1;
+      if (Read<uint64_t>(entries_ + index * entry_size_) == hash &&
+          matches(index)) {
+        return index;
+      }
+    }
+  }
+
+  template <typename T>
+  static T Read(const uint8_t* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+  }
+
+  template <typename T>
+  static void Write(uint8_t* data, T value) {
+    std::memcpy(data, &value, sizeof(T));
+  }
+
+  static constexpr size_t kHeaderSize = 4 * sizeof(uint32_t);
+  static constexpr size_t kBucketSize = sizeof(uint32_t);
+
+ private:
+  const uint8_t* buckets_ = nullptr;
+  const uint8_t* entries_ = nullptr;
+  size_t entry_size_ = 0;
+  size_t payload_offset_ = 0;
+  uint32_t bucket_count_ = 0;
+  uint32_t entry_count_ = 0;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(MappedHashTable);
+};
+
+}  // namespace fml
+
+#endif  // FLUTTER_FML_MAPPED_HASH_TABLE_H_
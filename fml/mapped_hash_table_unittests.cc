@@ -0,0 +1,104 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/fml/mapped_hash_table.h"
+
+#include <string>
+
+#include "flutter/testing/testing.h"
+
+namespace fml {
+namespace testing {
+
+static constexpr MappedHashTable::Format kFormat = {
+    .signature = 0x54534554,  // "TEST"
+    .version = 1,
+    .entry_size = sizeof(uint64_t) + sizeof(uint32_t),
+};
+
+static std::vector<uint8_t> BuildTable(const std::vector<std::string>& keys) {
+  MappedHashTable::Builder builder(kFormat, keys.size(), 0);
+  EXPECT_TRUE(builder.IsValid());
+  for (uint32_t i = 0; i < keys.size(); i++) {
+    uint8_t* entry = builder.AddEntry(i, FNV1aHash(keys[i]));
+    MappedHashTable::Write<uint32_t>(entry, i * 10);
+  }
+  return builder.Take();
+}
+
+TEST(FNV1aHashTest, MatchesReferenceValues) {
+  ASSERT_EQ(FNV1aHash(""), 0xcbf29ce484222325u);
+  ASSERT_EQ(FNV1aHash("a"), 0xaf63dc4c8601ec8cu);
+  ASSERT_EQ(FNV1aHash("foobar"), 0x85944171f73967e8u);
+
+  FNV1aHasher hasher;
+  hasher.Update("foo");
+  hasher.Update("bar");
+  ASSERT_EQ(hasher.GetHash(), FNV1aHash("foobar"));
+}
+
+TEST(MappedHashTableTest, CanFindEntries) {
+  std::vector<std::string> keys;
+  for (int i = 0; i < 1000; i++) {
+    keys.push_back("key_" + std::to_string(i));
+  }
+  auto data = BuildTable(keys);
+
+  MappedHashTable table;
+  ASSERT_TRUE(table.Init(kFormat, data.data(), data.size()));
+  ASSERT_EQ(table.GetEntryCount(), keys.size());
+  ASSERT_EQ(table.GetPayloadOffset(), data.size());
+  for (uint32_t i = 0; i < keys.size(); i++) {
+    auto index = table.Find(FNV1aHash(keys[i]),
+                            [&](uint32_t candidate) { return candidate == i; });
+    ASSERT_EQ(index, i);
+    ASSERT_EQ(MappedHashTable::Read<uint32_t>(table.GetEntry(i)), i * 10);
+  }
+  ASSERT_FALSE(table.Find(FNV1aHash("key_1000"), [](uint32_t) { return true; })
+                   .has_value());
+}
+
+TEST(MappedHashTableTest, FindsCollidingEntries) {
+  MappedHashTable::Builder builder(kFormat, 3, 0);
+  ASSERT_TRUE(builder.IsValid());
+  builder.AddEntry(0, 7);
+  builder.AddEntry(1, 7);
+  builder.AddEntry(2, 7);
+  auto data = builder.Take();
+
+  MappedHashTable table;
+  ASSERT_TRUE(table.Init(kFormat, data.data(), data.size()));
+  ASSERT_EQ(table.Find(7, [](uint32_t index) { return index == 2; }), 2u);
+  ASSERT_FALSE(table.Find(7, [](uint32_t) { return false; }).has_value());
+  ASSERT_FALSE(table.Find(8, [](uint32_t) { return true; }).has_value());
+}
+
+TEST(MappedHashTableTest, RejectsInvalidTables) {
+  auto data = BuildTable({"a", "b", "c"});
+  MappedHashTable table;
+  ASSERT_FALSE(table.Init(kFormat, nullptr, 0));
+  ASSERT_FALSE(table.Init(kFormat, data.data(), data.size() - 1));
+  ASSERT_FALSE(table.Init({.signature = kFormat.signature,
+                           .version = 2,
+                           .entry_size = kFormat.entry_size},
+                          data.data(), data.size()));
+
+  // A header whose counts would wrap the section offsets around on 32-bit
+  // targets.
+  auto corrupt = data;
+  MappedHashTable::Write<uint32_t>(corrupt.data() + 8, 0x80000000);
+  MappedHashTable::Write<uint32_t>(corrupt.data() + 12, 0x7fffffff);
+  ASSERT_FALSE(table.Init(kFormat, corrupt.data(), corrupt.size()));
+
+  // A bucket referring to an entry past the end of the entries.
+  corrupt = data;
+  MappedHashTable::Write<uint32_t>(
+      corrupt.data() + MappedHashTable::kHeaderSize, 4);
+  ASSERT_FALSE(table.Init(kFormat, corrupt.data(), corrupt.size()));
+
+  ASSERT_TRUE(table.Init(kFormat, data.data(), data.size()));
+}
+
+}  // namespace testing
+}  // namespace fml
@@ -32,6 +32,11 @@ class Mapping {
   // Generally true for file-mapped memory and false for anonymous memory.
   virtual bool IsDontNeedSafe() const = 0;
 
+  // Whether the mapping is of a file whose contents can't change for the
+  // lifetime of the mapping, such as a file in an installed package. Memory
+  // from such a mapping may be referenced instead of copied.
+  virtual bool IsImmutableFile() const { return false; }
+
  private:
   FML_DISALLOW_COPY_AND_ASSIGN(Mapping);
 };
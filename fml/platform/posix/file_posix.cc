@@ -233,6 +233,42 @@ bool WriteAtomically(const fml::UniqueFD& base_directory,
                     base_directory.get(), file_name) == 0;
 }
 
+bool AppendToFile(const fml::UniqueFD& base_directory,
+                  const char* file_name,
+                  const Mapping& data) {
+  if (file_name == nullptr || data.GetMapping() == nullptr) {
+    return false;
+  }
+
+  auto file =
+      OpenFile(base_directory, file_name, true, FilePermission::kReadWrite);
+  if (!file.is_valid()) {
+    return false;
+  }
+
+  if (::lseek(file.get(), 0, SEEK_END) == -1) {
+    return false;
+  }
+
+  ssize_t remaining = data.GetSize();
+  ssize_t written = 0;
+  ssize_t offset = 0;
+
+  while (remaining > 0) {
+    written = FML_HANDLE_EINTR(
+        ::write(file.get(), data.GetMapping() + offset, remaining));
+
+    if (written == -1) {
+      return false;
+    }
+
+    remaining -= written;
+    offset += written;
+  }
+
+  return ::fsync(file.get()) == 0;
+}
+
 bool VisitFiles(const fml::UniqueFD& directory, const FileVisitor& visitor) {
   fml::UniqueFD dup_fd(dup(directory.get()));
   if (!dup_fd.is_valid()) {
@@ -411,6 +411,51 @@ bool WriteAtomically(const fml::UniqueFD& base_directory,
   return true;
 }
 
+bool AppendToFile(const fml::UniqueFD& base_directory,
+                  const char* file_name,
+                  const Mapping& mapping) {
+  if (file_name == nullptr || mapping.GetMapping() == nullptr) {
+    return false;
+  }
+
+  auto file =
+      OpenFile(base_directory, file_name, true, FilePermission::kReadWrite);
+  if (!file.is_valid()) {
+    FML_DLOG(ERROR) << "Could not open file: " << file_name << " "
+                    << GetLastErrorMessage();
+    return false;
+  }
+
+  LARGE_INTEGER distance = {};
+  if (!::SetFilePointerEx(file.get(), distance, nullptr, FILE_END)) {
+    FML_DLOG(ERROR) << "Could not seek to the end of the file. "
+                    << GetLastErrorMessage();
+    return false;
+  }
+
+  const uint8_t* bytes = mapping.GetMapping();
+  size_t remaining = mapping.GetSize();
+  while (remaining > 0) {
+    const DWORD chunk =
+        static_cast<DWORD>(std::min<size_t>(remaining, MAXDWORD));
+    DWORD written = 0;
+    if (!::WriteFile(file.get(), bytes, chunk, &written, nullptr)) {
+      FML_DLOG(ERROR) << "Could not write to the file. "
+                      << GetLastErrorMessage();
+      return false;
+    }
+    bytes += written;
+    remaining -= written;
+  }
+
+  if (!::FlushFileBuffers(file.get())) {
+    FML_DLOG(ERROR) << "Could not flush file buffers. "
+                    << GetLastErrorMessage();
+    return false;
+  }
+  return true;
+}
+
 bool VisitFiles(const fml::UniqueFD& directory, const FileVisitor& visitor) {
   std::string search_pattern = GetFullHandlePath(directory) + "\\*";
   WIN32_FIND_DATA find_file_data;
@@ -30,6 +30,15 @@ class AiksContext {
 
   bool Render(const Picture& picture, RenderTarget& render_target);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Mark the end of a frame. Offscreen render targets that were
+  ///             not used by any picture rendered during the frame are
+  ///             deallocated. Must be called once per frame by the owner of
+  ///             the render loop, after all of the pictures of the frame have
+  ///             been rendered.
+  ///
+  void EndFrame();
+
  private:
   std::shared_ptr<Context> context_;
   std::unique_ptr<ContentContext> content_context_;
@@ -32,7 +32,9 @@ bool AiksPlayground::OpenPlaygroundHere(AiksPlaygroundCallback callback) {
 
   return Playground::OpenPlaygroundHere(
       [&renderer, &callback](RenderTarget& render_target) -> bool {
-        return callback(renderer, render_target);
+        auto result = callback(renderer, render_target);
+        renderer.EndFrame();
+        return result;
       });
 }
 
@@ -319,6 +319,7 @@ void Canvas::DrawImageRect(const std::shared_ptr<Image>& image,
 Picture Canvas::EndRecordingAsPicture() {
   Picture picture;
   picture.pass = std::move(base_pass_);
+  picture.pass->ElideSubpasses();
 
   Reset();
   Initialize();
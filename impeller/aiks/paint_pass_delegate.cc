@@ -31,6 +31,16 @@ bool PaintPassDelegate::CanCollapseIntoParentPass() {
   return false;
 }
 
+// |EntityPassDelgate|
+std::optional<Scalar> PaintPassDelegate::GetFoldableOpacity() {
+  if (paint_.blend_mode != BlendMode::kSourceOver ||
+      paint_.mask_blur_descriptor.has_value() ||
+      paint_.image_filter.has_value() || paint_.color_filter.has_value()) {
+    return std::nullopt;
+  }
+  return paint_.color.alpha;
+}
+
 // |EntityPassDelgate|
 std::shared_ptr<Contents> PaintPassDelegate::CreateContentsForSubpassTarget(
     std::shared_ptr<Texture> target,
@@ -28,6 +28,9 @@ class PaintPassDelegate final : public EntityPassDelegate {
   // |EntityPassDelgate|
   bool CanCollapseIntoParentPass() override;
 
+  // |EntityPassDelgate|
+  std::optional<Scalar> GetFoldableOpacity() override;
+
   // |EntityPassDelgate|
   std::shared_ptr<Contents> CreateContentsForSubpassTarget(
       std::shared_ptr<Texture> target,
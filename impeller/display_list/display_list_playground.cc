@@ -43,7 +43,9 @@ bool DisplayListPlayground::OpenPlaygroundHere(
         list->Dispatch(dispatcher);
         auto picture = dispatcher.EndRecordingAsPicture();
 
-        return context.Render(picture, render_target);
+        auto result = context.Render(picture, render_target);
+        context.EndFrame();
+        return result;
       });
 }
 
@@ -6,6 +6,7 @@
 
 #include <sstream>
 
+#include "flutter/fml/trace_event.h"
 #include "impeller/entity/entity.h"
 #include "impeller/renderer/command_buffer.h"
 #include "impeller/renderer/formats.h"
@@ -146,7 +147,8 @@ static std::unique_ptr<PipelineT> CreateDefaultPipeline(
 ContentContext::ContentContext(std::shared_ptr<Context> context)
     : context_(std::move(context)),
       tessellator_(std::make_shared<Tessellator>()),
-      glyph_atlas_context_(std::make_shared<GlyphAtlasContext>()) {
+      glyph_atlas_context_(std::make_shared<GlyphAtlasContext>()),
+      render_target_pool_(std::make_unique<RenderTargetPool>(context_)) {
   if (!context_ || !context_->IsValid()) {
     return;
   }
@@ -248,9 +250,70 @@ ContentContext::ContentContext(std::shared_ptr<Context> context)
     return;
   }
 
+  if (context_->ShouldPrewarmPipelines()) {
+    PrewarmPipelines();
+  }
+
   is_valid_ = true;
 }
 
+void ContentContext::PrewarmPipelines() {
+  TRACE_EVENT0("impeller", "ContentContext::PrewarmPipelines");
+
+  std::vector<SampleCount> sample_counts = {SampleCount::kCount1};
+  if (context_->SupportsOffscreenMSAA()) {
+    sample_counts.push_back(SampleCount::kCount4);
+  }
+  const auto primitive_types = {PrimitiveType::kTriangle,
+                                PrimitiveType::kTriangleStrip};
+
+  std::vector<ContentContextOptions> draw_options;
+  std::vector<ContentContextOptions> clip_options;
+  for (auto sample_count : sample_counts) {
+    for (auto primitive_type : primitive_types) {
+      for (auto blend_mode : {BlendMode::kSourceOver, BlendMode::kSource}) {
+        draw_options.push_back({.sample_count = sample_count,
+                                .blend_mode = blend_mode,
+                                .primitive_type = primitive_type});
+      }
+      // Mirrors the options used by `ClipContents` and
+      // `ClipRestoreContents`.
+      clip_options.push_back(
+          {.sample_count = sample_count,
+           .stencil_compare = CompareFunction::kEqual,
+           .stencil_operation = StencilOperation::kIncrementClamp,
+           .primitive_type = primitive_type});
+      clip_options.push_back(
+          {.sample_count = sample_count,
+           .stencil_compare = CompareFunction::kEqual,
+           .stencil_operation = StencilOperation::kDecrementClamp,
+           .primitive_type = primitive_type});
+      clip_options.push_back(
+          {.sample_count = sample_count,
+           .stencil_compare = CompareFunction::kLess,
+           .stencil_operation = StencilOperation::kSetToReferenceValue,
+           .primitive_type = primitive_type});
+    }
+  }
+
+  PrewarmVariants(solid_fill_pipelines_, draw_options);
+  PrewarmVariants(texture_pipelines_, draw_options);
+  PrewarmVariants(tiled_texture_pipelines_, draw_options);
+  PrewarmVariants(linear_gradient_fill_pipelines_, draw_options);
+  PrewarmVariants(radial_gradient_fill_pipelines_, draw_options);
+  PrewarmVariants(sweep_gradient_fill_pipelines_, draw_options);
+  PrewarmVariants(rrect_blur_pipelines_, draw_options);
+  PrewarmVariants(glyph_atlas_pipelines_, draw_options);
+  PrewarmVariants(texture_blend_pipelines_, draw_options);
+  PrewarmVariants(gaussian_blur_pipelines_, draw_options);
+  PrewarmVariants(gaussian_blur_decal_pipelines_, draw_options);
+  PrewarmVariants(border_mask_blur_pipelines_, draw_options);
+  PrewarmVariants(color_matrix_color_filter_pipelines_, draw_options);
+  PrewarmVariants(geometry_color_pipelines_, draw_options);
+  PrewarmVariants(geometry_position_pipelines_, draw_options);
+  PrewarmVariants(clip_pipelines_, clip_options);
+}
+
 ContentContext::~ContentContext() = default;
 
 bool ContentContext::IsValid() const {
@@ -309,6 +372,10 @@ std::shared_ptr<GlyphAtlasContext> ContentContext::GetGlyphAtlasContext()
   return glyph_atlas_context_;
 }
 
+RenderTargetPool& ContentContext::GetRenderTargetPool() const {
+  return *render_target_pool_;
+}
+
 std::shared_ptr<Context> ContentContext::GetContext() const {
   return context_;
 }
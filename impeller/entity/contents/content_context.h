@@ -36,6 +36,7 @@
 #include "impeller/entity/color_matrix_color_filter.frag.h"
 #include "impeller/entity/color_matrix_color_filter.vert.h"
 #include "impeller/entity/entity.h"
+#include "impeller/entity/render_target_pool.h"
 #include "impeller/entity/gaussian_blur.frag.h"
 #include "impeller/entity/gaussian_blur.vert.h"
 #include "impeller/entity/gaussian_blur_decal.frag.h"
@@ -430,6 +431,10 @@ class ContentContext {
 
   std::shared_ptr<GlyphAtlasContext> GetGlyphAtlasContext() const;
 
+  /// @brief  The pool that `EntityPass` subpass render targets are allocated
+  ///         from. Reused across passes and frames.
+  RenderTargetPool& GetRenderTargetPool() const;
+
   const BackendFeatures& GetBackendFeatures() const;
 
   using SubpassCallback =
@@ -499,6 +504,36 @@ class ContentContext {
   mutable Variants<BlendScreenPipeline> blend_screen_pipelines_;
   mutable Variants<BlendSoftLightPipeline> blend_softlight_pipelines_;
 
+  /// @brief  Request pipeline variants for the options that nearly every
+  ///         frame uses so that they are compiled by the pipeline library in
+  ///         the background instead of on first use.
+  void PrewarmPipelines();
+
+  template <class TypedPipeline>
+  void PrewarmVariants(Variants<TypedPipeline>& container,
+                       const std::vector<ContentContextOptions>& options) {
+    auto prototype = container.find({});
+    if (prototype == container.end()) {
+      return;
+    }
+    // Don't wait on the prototype. Its descriptor is known upfront and is all
+    // that is needed to request the variants.
+    auto prototype_descriptor = prototype->second->GetDescriptor();
+    if (!prototype_descriptor.has_value()) {
+      return;
+    }
+    for (const auto& opts : options) {
+      if (container.find(opts) != container.end()) {
+        continue;
+      }
+      auto desc = prototype_descriptor.value();
+      opts.ApplyToPipelineDescriptor(desc);
+      desc.SetLabel(
+          SPrintF("%s V#%zu", desc.GetLabel().c_str(), container.size()));
+      container[opts] = std::make_unique<TypedPipeline>(*context_, desc);
+    }
+  }
+
   template <class TypedPipeline>
   std::shared_ptr<Pipeline<PipelineDescriptor>> GetPipeline(
       Variants<TypedPipeline>& container,
@@ -531,6 +566,7 @@ class ContentContext {
   bool is_valid_ = false;
   std::shared_ptr<Tessellator> tessellator_;
   std::shared_ptr<GlyphAtlasContext> glyph_atlas_context_;
+  std::unique_ptr<RenderTargetPool> render_target_pool_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(ContentContext);
 };
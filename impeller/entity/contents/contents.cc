@@ -6,6 +6,7 @@
 #include <optional>
 
 #include "fml/logging.h"
+#include "impeller/base/validation.h"
 #include "impeller/entity/contents/content_context.h"
 #include "impeller/renderer/command_buffer.h"
 #include "impeller/renderer/formats.h"
@@ -85,4 +86,13 @@ bool Contents::ShouldRender(const Entity& entity,
   return stencil_coverage->IntersectsWithRect(coverage.value());
 }
 
+bool Contents::CanInheritOpacity(const Entity& entity) const {
+  return false;
+}
+
+void Contents::SetInheritedOpacity(Scalar opacity) {
+  VALIDATION_LOG << "Contents::SetInheritedOpacity should never be called when "
+                    "Contents::CanInheritOpacity returns false.";
+}
+
 }  // namespace impeller
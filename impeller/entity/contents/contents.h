@@ -65,6 +65,15 @@ class Contents {
   virtual bool ShouldRender(const Entity& entity,
                             const std::optional<Rect>& stencil_coverage) const;
 
+  /// @brief  Whether or not the opacity of an enclosing subpass can be applied
+  ///         directly to this contents via `SetInheritedOpacity`, allowing
+  ///         the subpass to be elided.
+  virtual bool CanInheritOpacity(const Entity& entity) const;
+
+  /// @brief  Modulate the opacity of this contents by `opacity`. Only valid
+  ///         if `CanInheritOpacity` returned true.
+  virtual void SetInheritedOpacity(Scalar opacity);
+
  protected:
 
  private:
@@ -24,6 +24,14 @@ const Color& SolidColorContents::GetColor() const {
   return color_;
 }
 
+bool SolidColorContents::CanInheritOpacity(const Entity& entity) const {
+  return true;
+}
+
+void SolidColorContents::SetInheritedOpacity(Scalar opacity) {
+  color_ = color_.WithAlpha(color_.alpha * opacity);
+}
+
 void SolidColorContents::SetGeometry(std::unique_ptr<Geometry> geometry) {
   geometry_ = std::move(geometry);
 }
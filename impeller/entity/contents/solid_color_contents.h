@@ -42,6 +42,12 @@ class SolidColorContents final : public Contents {
   bool ShouldRender(const Entity& entity,
                     const std::optional<Rect>& stencil_coverage) const override;
 
+  // |Contents|
+  bool CanInheritOpacity(const Entity& entity) const override;
+
+  // |Contents|
+  void SetInheritedOpacity(Scalar opacity) override;
+
   // |Contents|
   bool Render(const ContentContext& renderer,
               const Entity& entity,
@@ -50,6 +50,14 @@ void TextContents::SetColor(Color color) {
   color_ = color;
 }
 
+bool TextContents::CanInheritOpacity(const Entity& entity) const {
+  return true;
+}
+
+void TextContents::SetInheritedOpacity(Scalar opacity) {
+  color_ = color_.WithAlpha(color_.alpha * opacity);
+}
+
 std::optional<Rect> TextContents::GetCoverage(const Entity& entity) const {
   auto bounds = frame_.GetBounds();
   if (!bounds.has_value()) {
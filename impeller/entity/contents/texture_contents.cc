@@ -53,6 +53,14 @@ void TextureContents::SetOpacity(Scalar opacity) {
   opacity_ = opacity;
 }
 
+bool TextureContents::CanInheritOpacity(const Entity& entity) const {
+  return true;
+}
+
+void TextureContents::SetInheritedOpacity(Scalar opacity) {
+  opacity_ *= opacity;
+}
+
 void TextureContents::SetStencilEnabled(bool enabled) {
   stencil_enabled_ = enabled;
 }
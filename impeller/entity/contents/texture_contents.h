@@ -55,6 +55,12 @@ class TextureContents final : public Contents {
   std::optional<Snapshot> RenderToSnapshot(const ContentContext& renderer,
                                            const Entity& entity) const override;
 
+  // |Contents|
+  bool CanInheritOpacity(const Entity& entity) const override;
+
+  // |Contents|
+  void SetInheritedOpacity(Scalar opacity) override;
+
   // |Contents|
   bool Render(const ContentContext& renderer,
               const Entity& entity,
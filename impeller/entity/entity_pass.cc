@@ -8,6 +8,7 @@
 #include <utility>
 #include <variant>
 
+#include "flutter/fml/closure.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/trace_event.h"
@@ -126,6 +127,124 @@ EntityPass* EntityPass::GetSuperpass() const {
   return superpass_;
 }
 
+/// The maximum number of elements of a translucent subpass that are checked
+/// for overlap when deciding whether its opacity can be folded into them.
+static constexpr size_t kMaxOpacityFoldElements = 8u;
+
+bool EntityPass::CanDropFromParentPass() const {
+  if (delegate_->CanElide()) {
+    return true;
+  }
+  return elements_.empty() && !backdrop_filter_proc_.has_value() &&
+         !cover_whole_screen_;
+}
+
+bool EntityPass::CanFoldIntoParentPass() const {
+  if (backdrop_filter_proc_.has_value() ||
+      blend_mode_ != BlendMode::kSourceOver || reads_from_pass_texture_ > 0) {
+    return false;
+  }
+
+  auto opacity = delegate_->GetFoldableOpacity();
+  if (!opacity.has_value()) {
+    return false;
+  }
+
+  // The subpass target is clipped to the delegate coverage, which rendering
+  // the elements straight into the parent would not do.
+  auto delegate_coverage = delegate_->GetCoverageRect();
+  if (delegate_coverage.has_value()) {
+    auto elements_coverage = GetElementsCoverage(std::nullopt);
+    if (elements_coverage.has_value() &&
+        !delegate_coverage->TransformBounds(xformation_)
+             .Contains(elements_coverage.value())) {
+      return false;
+    }
+  }
+  if (opacity.value() >= 1 - kEhCloseEnough) {
+    // The subpass target would be composited as-is, so its elements can be
+    // rendered straight into the parent.
+    return true;
+  }
+
+  // Applying the opacity to each element only matches compositing the subpass
+  // target if none of the visible elements overlap.
+  if (elements_.size() > kMaxOpacityFoldElements) {
+    return false;
+  }
+  std::vector<Rect> element_coverages;
+  for (const auto& element : elements_) {
+    auto entity = std::get_if<Entity>(&element);
+    if (!entity) {
+      return false;
+    }
+    if (entity->GetStencilCoverage(std::nullopt).type !=
+        Contents::StencilCoverage::Type::kNone) {
+      // Clips only touch the stencil and are unaffected by opacity.
+      continue;
+    }
+    if (entity->GetBlendMode() != BlendMode::kSourceOver ||
+        !entity->GetContents()->CanInheritOpacity(*entity)) {
+      return false;
+    }
+    auto coverage = entity->GetCoverage();
+    if (!coverage.has_value()) {
+      continue;
+    }
+    for (const auto& other : element_coverages) {
+      if (other.IntersectsWithRect(coverage.value())) {
+        return false;
+      }
+    }
+    element_coverages.push_back(coverage.value());
+  }
+  return true;
+}
+
+void EntityPass::ElideSubpasses() {
+  std::vector<Element> elements;
+  elements.reserve(elements_.size());
+
+  for (auto& element : elements_) {
+    auto subpass_ptr = std::get_if<std::unique_ptr<EntityPass>>(&element);
+    if (!subpass_ptr) {
+      elements.emplace_back(std::move(element));
+      continue;
+    }
+    auto& subpass = *subpass_ptr;
+
+    // Flatten bottom-up so that the checks below see the final shape of the
+    // subpass.
+    subpass->ElideSubpasses();
+
+    if (subpass->CanDropFromParentPass()) {
+      continue;
+    }
+
+    if (!subpass->CanFoldIntoParentPass()) {
+      elements.emplace_back(std::move(element));
+      continue;
+    }
+
+    auto opacity = subpass->delegate_->GetFoldableOpacity().value();
+    for (auto& subpass_element : subpass->elements_) {
+      if (auto entity = std::get_if<Entity>(&subpass_element)) {
+        if (opacity < 1 - kEhCloseEnough &&
+            entity->GetStencilCoverage(std::nullopt).type ==
+                Contents::StencilCoverage::Type::kNone) {
+          entity->GetContents()->SetInheritedOpacity(opacity);
+        }
+      } else if (auto nested = std::get_if<std::unique_ptr<EntityPass>>(
+                     &subpass_element)) {
+        nested->get()->superpass_ = this;
+      }
+      elements.emplace_back(std::move(subpass_element));
+    }
+  }
+
+  elements_ = std::move(elements);
+}
+
 EntityPass* EntityPass::AddSubpass(std::unique_ptr<EntityPass> pass) {
   if (!pass) {
     return nullptr;
@@ -143,51 +262,20 @@ EntityPass* EntityPass::AddSubpass(std::unique_ptr<EntityPass> pass) {
   return subpass_pointer;
 }
 
-static RenderTarget CreateRenderTarget(ContentContext& renderer,
-                                       ISize size,
-                                       bool readable) {
-  auto context = renderer.GetContext();
-
-  /// All of the load/store actions are managed by `InlinePassContext` when
-  /// `RenderPasses` are created, so we just set them to `kDontCare` here.
-  /// What's important is the `StorageMode` of the textures, which cannot be
-  /// changed for the lifetime of the textures.
-
-  if (context->SupportsOffscreenMSAA()) {
-    return RenderTarget::CreateOffscreenMSAA(
-        *context,                          // context
-        size,                              // size
-        "EntityPass",                      // label
-        StorageMode::kDeviceTransient,     // color_storage_mode
-        StorageMode::kDevicePrivate,       // color_resolve_storage_mode
-        LoadAction::kDontCare,             // color_load_action
-        StoreAction::kMultisampleResolve,  // color_store_action
-        readable ? StorageMode::kDevicePrivate
-                 : StorageMode::kDeviceTransient,  // stencil_storage_mode
-        LoadAction::kDontCare,                     // stencil_load_action
-        StoreAction::kDontCare                     // stencil_store_action
-    );
-  }
-
-  return RenderTarget::CreateOffscreen(
-      *context,                     // context
-      size,                         // size
-      "EntityPass",                 // label
-      StorageMode::kDevicePrivate,  // color_storage_mode
-      LoadAction::kDontCare,        // color_load_action
-      StoreAction::kDontCare,       // color_store_action
-      readable ? StorageMode::kDevicePrivate
-               : StorageMode::kDeviceTransient,  // stencil_storage_mode
-      LoadAction::kDontCare,                     // stencil_load_action
-      StoreAction::kDontCare                     // stencil_store_action
-  );
-}
-
 bool EntityPass::Render(ContentContext& renderer,
                         const RenderTarget& render_target) const {
+  auto& render_target_pool = renderer.GetRenderTargetPool();
+
   if (reads_from_pass_texture_ > 0) {
     auto offscreen_target =
-        CreateRenderTarget(renderer, render_target.GetRenderTargetSize(), true);
+        render_target_pool.Acquire(render_target.GetRenderTargetSize(), true);
+    fml::ScopedCleanupClosure release_offscreen_target(
+        [&render_target_pool, &offscreen_target]() {
+          render_target_pool.Release(offscreen_target);
+        });
+    if (!offscreen_target.IsValid()) {
+      return false;
+    }
     if (!OnRender(renderer, offscreen_target.GetRenderTargetSize(),
                   offscreen_target, Point(), Point(), 0)) {
       return false;
@@ -232,7 +320,8 @@ EntityPass::EntityResult EntityPass::GetEntityForElement(
     ISize root_pass_size,
     Point position,
     uint32_t pass_depth,
-    size_t stencil_depth_floor) const {
+    size_t stencil_depth_floor,
+    std::vector<RenderTarget>& subpass_targets) const {
   Entity element_entity;
 
   //--------------------------------------------------------------------------
@@ -285,7 +374,12 @@ EntityPass::EntityResult EntityPass::GetEntityForElement(
       // The subpass will need to read from the current pass texture when
       // rendering the backdrop, so if there's an active pass, end it prior to
       // rendering the subpass.
-      pass_context.EndPass();
+      if (!pass_context.EndPass()) {
+        return EntityPass::EntityResult::Failure();
+      }
+      // Every earlier subpass target has been composited now, so the targets
+      // can be reused by this subpass.
+      ReleaseSubpassTargets(renderer, subpass_targets, subpass_targets.size());
     }
 
     auto subpass_coverage =
@@ -322,10 +416,12 @@ EntityPass::EntityResult EntityPass::GetEntityForElement(
       return EntityPass::EntityResult::Skip();
     }
 
-    auto subpass_target =
-        CreateRenderTarget(renderer,                       //
-                           ISize(subpass_coverage->size),  //
-                           subpass->reads_from_pass_texture_ > 0);
+    auto subpass_target = renderer.GetRenderTargetPool().Acquire(
+        ISize(subpass_coverage->size), subpass->reads_from_pass_texture_ > 0);
+    if (!subpass_target.IsValid()) {
+      return EntityPass::EntityResult::Failure();
+    }
+    subpass_targets.push_back(subpass_target);
 
     auto subpass_texture = subpass_target.GetRenderTargetTexture();
 
@@ -369,6 +465,18 @@ EntityPass::EntityResult EntityPass::GetEntityForElement(
   return EntityPass::EntityResult::Success(element_entity);
 }
 
+void EntityPass::ReleaseSubpassTargets(
+    ContentContext& renderer,
+    std::vector<RenderTarget>& subpass_targets,
+    size_t count) {
+  FML_DCHECK(count <= subpass_targets.size());
+  for (size_t i = 0; i < count; i++) {
+    renderer.GetRenderTargetPool().Release(subpass_targets[i]);
+  }
+  subpass_targets.erase(subpass_targets.begin(),
+                        subpass_targets.begin() + count);
+}
+
 struct StencilLayer {
   std::optional<Rect> coverage;
   size_t stencil_depth;
@@ -385,6 +493,17 @@ bool EntityPass::OnRender(
     std::shared_ptr<Contents> backdrop_filter_contents) const {
   TRACE_EVENT0("impeller", "EntityPass::OnRender");
 
+  // Subpass targets are handed back to the pool once every command reading
+  // from them has been submitted, which happens whenever the active pass is
+  // ended. This is declared before `pass_context` so that it runs after the
+  // pass context has ended its final render pass.
+  std::vector<RenderTarget> subpass_targets;
+  fml::ScopedCleanupClosure release_subpass_targets(
+      [&renderer, &subpass_targets]() {
+        ReleaseSubpassTargets(renderer, subpass_targets,
+                              subpass_targets.size());
+      });
+
   auto context = renderer.GetContext();
   InlinePassContext pass_context(context, render_target,
                                  reads_from_pass_texture_);
@@ -488,9 +607,9 @@ bool EntityPass::OnRender(
   }
 
   for (const auto& element : elements_) {
-    EntityResult result =
-        GetEntityForElement(element, renderer, pass_context, root_pass_size,
-                            position, pass_depth, stencil_depth_floor);
+    EntityResult result = GetEntityForElement(
+        element, renderer, pass_context, root_pass_size, position, pass_depth,
+        stencil_depth_floor, subpass_targets);
 
     switch (result.status) {
       case EntityResult::kSuccess:
@@ -518,6 +637,12 @@ bool EntityPass::OnRender(
       if (!pass_context.EndPass()) {
         return false;
       }
+      // Every subpass target has been composited now except for the one the
+      // element may have just been rendered into.
+      const size_t element_target_count =
+          std::holds_alternative<std::unique_ptr<EntityPass>>(element) ? 1 : 0;
+      ReleaseSubpassTargets(renderer, subpass_targets,
+                            subpass_targets.size() - element_target_count);
 
       // Amend an advanced blend filter to the contents, attaching the pass
       // texture.
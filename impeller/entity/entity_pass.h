@@ -49,6 +49,18 @@ class EntityPass {
 
   EntityPass* GetSuperpass() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Plan the subpass tree before rendering. Subpasses that only
+  ///             apply a uniform opacity are merged into this pass, folding
+  ///             the opacity into their elements when that is equivalent to
+  ///             compositing an offscreen target. Subpasses that can never
+  ///             contribute to the frame are dropped.
+  ///
+  ///             This is applied recursively, bottom-up. It should be called
+  ///             once after recording has finished.
+  ///
+  void ElideSubpasses();
+
   bool Render(ContentContext& renderer,
               const RenderTarget& render_target) const;
 
@@ -93,13 +105,30 @@ class EntityPass {
     static EntityResult Skip() { return {{}, kSkip}; }
   };
 
-  EntityResult GetEntityForElement(const EntityPass::Element& element,
-                                   ContentContext& renderer,
-                                   InlinePassContext& pass_context,
-                                   ISize root_pass_size,
-                                   Point position,
-                                   uint32_t pass_depth,
-                                   size_t stencil_depth_floor) const;
+  EntityResult GetEntityForElement(
+      const EntityPass::Element& element,
+      ContentContext& renderer,
+      InlinePassContext& pass_context,
+      ISize root_pass_size,
+      Point position,
+      uint32_t pass_depth,
+      size_t stencil_depth_floor,
+      std::vector<RenderTarget>& subpass_targets) const;
+
+  /// @brief  Hands the first `count` subpass targets back to the render target
+  ///         pool. Must only be called once the commands compositing them
+  ///         have been submitted.
+  static void ReleaseSubpassTargets(ContentContext& renderer,
+                                    std::vector<RenderTarget>& subpass_targets,
+                                    size_t count);
+
+  /// @brief  Whether this subpass can be merged into its parent pass by
+  ///         `ElideSubpasses` without changing the rendered result.
+  bool CanFoldIntoParentPass() const;
+
+  /// @brief  Whether this subpass can be dropped because it will never
+  ///         contribute anything to its parent pass.
+  bool CanDropFromParentPass() const;
 
   bool OnRender(
       ContentContext& renderer,
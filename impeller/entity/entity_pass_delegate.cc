@@ -10,6 +10,10 @@ EntityPassDelegate::EntityPassDelegate() = default;
 
 EntityPassDelegate::~EntityPassDelegate() = default;
 
+std::optional<Scalar> EntityPassDelegate::GetFoldableOpacity() {
+  return std::nullopt;
+}
+
 class DefaultEntityPassDelegate final : public EntityPassDelegate {
  public:
   DefaultEntityPassDelegate() = default;
@@ -26,6 +26,12 @@ class EntityPassDelegate {
 
   virtual bool CanCollapseIntoParentPass() = 0;
 
+  /// @brief  If the only effect this delegate applies to the subpass target is
+  ///         a uniform opacity (source-over, no filters), return that opacity.
+  ///         `EntityPass::ElideSubpasses` may then apply it to the subpass
+  ///         elements directly instead of allocating an offscreen target.
+  virtual std::optional<Scalar> GetFoldableOpacity();
+
   virtual std::shared_ptr<Contents> CreateContentsForSubpassTarget(
       std::shared_ptr<Texture> target,
       const Matrix& effect_transform) = 0;
@@ -32,6 +32,7 @@
 #include "impeller/entity/entity_pass_delegate.h"
 #include "impeller/entity/entity_playground.h"
 #include "impeller/entity/geometry.h"
+#include "impeller/entity/render_target_pool.h"
 #include "impeller/geometry/color.h"
 #include "impeller/geometry/geometry_unittests.h"
 #include "impeller/geometry/path_builder.h"
@@ -61,8 +62,9 @@ TEST_P(EntityTest, CanCreateEntity) {
 
 class TestPassDelegate final : public EntityPassDelegate {
  public:
-  explicit TestPassDelegate(std::optional<Rect> coverage)
-      : coverage_(coverage) {}
+  explicit TestPassDelegate(std::optional<Rect> coverage,
+                            std::optional<Scalar> opacity = std::nullopt)
+      : coverage_(coverage), opacity_(opacity) {}
 
   // |EntityPassDelegate|
   ~TestPassDelegate() override = default;
@@ -76,6 +78,9 @@ class TestPassDelegate final : public EntityPassDelegate {
   // |EntityPassDelgate|
   bool CanCollapseIntoParentPass() override { return false; }
 
+  // |EntityPassDelgate|
+  std::optional<Scalar> GetFoldableOpacity() override { return opacity_; }
+
   // |EntityPassDelgate|
   std::shared_ptr<Contents> CreateContentsForSubpassTarget(
       std::shared_ptr<Texture> target,
@@ -85,6 +90,7 @@ class TestPassDelegate final : public EntityPassDelegate {
 
  private:
   const std::optional<Rect> coverage_;
+  const std::optional<Scalar> opacity_;
 };
 
 auto CreatePassWithRectPath(Rect rect, std::optional<Rect> bounds_hint) {
@@ -154,6 +160,108 @@ TEST_P(EntityTest, EntityPassCoverageRespectsCoverageLimit) {
   }
 }
 
+TEST_P(EntityTest, EntityPassFoldsOpacityIntoNonOverlappingElements) {
+  EntityPass pass;
+
+  auto subpass = std::make_unique<EntityPass>();
+  for (auto rect : {Rect::MakeLTRB(0, 0, 100, 100),
+                    Rect::MakeLTRB(200, 0, 300, 100)}) {
+    Entity entity;
+    entity.SetContents(SolidColorContents::Make(
+        PathBuilder{}.AddRect(rect).TakePath(), Color::Red()));
+    subpass->AddEntity(entity);
+  }
+  subpass->SetDelegate(std::make_unique<TestPassDelegate>(std::nullopt, 0.5));
+  pass.AddSubpass(std::move(subpass));
+  ASSERT_EQ(pass.GetSubpassesDepth(), 2u);
+
+  pass.ElideSubpasses();
+  ASSERT_EQ(pass.GetSubpassesDepth(), 1u);
+
+  size_t entity_count = 0u;
+  pass.IterateAllEntities([&entity_count](Entity& entity) {
+    auto contents =
+        std::static_pointer_cast<SolidColorContents>(entity.GetContents());
+    EXPECT_FLOAT_EQ(contents->GetColor().alpha, 0.5);
+    entity_count++;
+    return true;
+  });
+  ASSERT_EQ(entity_count, 2u);
+}
+
+TEST_P(EntityTest, EntityPassKeepsTranslucentSubpassWithOverlappingElements) {
+  EntityPass pass;
+
+  auto subpass = std::make_unique<EntityPass>();
+  for (auto rect :
+       {Rect::MakeLTRB(0, 0, 100, 100), Rect::MakeLTRB(50, 50, 150, 150)}) {
+    Entity entity;
+    entity.SetContents(SolidColorContents::Make(
+        PathBuilder{}.AddRect(rect).TakePath(), Color::Red()));
+    subpass->AddEntity(entity);
+  }
+  subpass->SetDelegate(std::make_unique<TestPassDelegate>(std::nullopt, 0.5));
+  pass.AddSubpass(std::move(subpass));
+
+  pass.ElideSubpasses();
+  ASSERT_EQ(pass.GetSubpassesDepth(), 2u);
+
+  // Opaque layers are always flattened.
+  auto opaque_subpass =
+      CreatePassWithRectPath(Rect::MakeLTRB(0, 0, 100, 100), std::nullopt);
+  opaque_subpass->SetDelegate(
+      std::make_unique<TestPassDelegate>(std::nullopt, 1.0));
+  EntityPass opaque_pass;
+  opaque_pass.AddSubpass(std::move(opaque_subpass));
+  opaque_pass.ElideSubpasses();
+  ASSERT_EQ(opaque_pass.GetSubpassesDepth(), 1u);
+}
+
+TEST_P(EntityTest, EntityPassKeepsSubpassClippedByDelegateCoverage) {
+  // The subpass target would clip the rect to the delegate coverage.
+  auto clipped_subpass =
+      CreatePassWithRectPath(Rect::MakeLTRB(0, 0, 100, 100), std::nullopt);
+  clipped_subpass->SetDelegate(std::make_unique<TestPassDelegate>(
+      Rect::MakeLTRB(0, 0, 50, 50), 1.0));
+  EntityPass clipped_pass;
+  clipped_pass.AddSubpass(std::move(clipped_subpass));
+  clipped_pass.ElideSubpasses();
+  ASSERT_EQ(clipped_pass.GetSubpassesDepth(), 2u);
+
+  auto unclipped_subpass =
+      CreatePassWithRectPath(Rect::MakeLTRB(0, 0, 100, 100), std::nullopt);
+  unclipped_subpass->SetDelegate(std::make_unique<TestPassDelegate>(
+      Rect::MakeLTRB(0, 0, 200, 200), 1.0));
+  EntityPass unclipped_pass;
+  unclipped_pass.AddSubpass(std::move(unclipped_subpass));
+  unclipped_pass.ElideSubpasses();
+  ASSERT_EQ(unclipped_pass.GetSubpassesDepth(), 1u);
+}
+
+TEST_P(EntityTest, RenderTargetPoolReusesReleasedTargets) {
+  RenderTargetPool pool(GetContext());
+
+  auto target0 = pool.Acquire(ISize(100, 100), false);
+  ASSERT_TRUE(target0.IsValid());
+  auto target1 = pool.Acquire(ISize(100, 100), false);
+  ASSERT_TRUE(target1.IsValid());
+  ASSERT_NE(target0.GetRenderTargetTexture(), target1.GetRenderTargetTexture());
+  ASSERT_EQ(pool.GetAllocatedTargetCount(), 2u);
+
+  pool.Release(target0);
+  auto target2 = pool.Acquire(ISize(100, 100), false);
+  ASSERT_EQ(target0.GetRenderTargetTexture(), target2.GetRenderTargetTexture());
+  ASSERT_EQ(pool.GetAllocatedTargetCount(), 2u);
+
+  // Targets that go unused for a whole frame are dropped.
+  pool.Release(target1);
+  pool.Release(target2);
+  pool.EndFrame();
+  ASSERT_EQ(pool.GetAllocatedTargetCount(), 2u);
+  pool.EndFrame();
+  ASSERT_EQ(pool.GetAllocatedTargetCount(), 0u);
+}
+
 TEST_P(EntityTest, FilterCoverageRespectsCropRect) {
   auto image = CreateTextureForFixture("boston.jpg");
   auto filter = ColorFilterContents::MakeBlend(BlendMode::kSoftLight,
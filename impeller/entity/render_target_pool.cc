@@ -0,0 +1,121 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/entity/render_target_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "flutter/fml/trace_event.h"
+
+namespace impeller {
+
+RenderTargetPool::RenderTargetPool(std::shared_ptr<Context> context)
+    : context_(std::move(context)) {}
+
+RenderTargetPool::~RenderTargetPool() = default;
+
+RenderTarget RenderTargetPool::Acquire(ISize size, bool readable) {
+  {
+    Lock lock(mutex_);
+    for (auto& entry : entries_) {
+      if (!entry.in_use && entry.size == size && entry.readable == readable) {
+        entry.in_use = true;
+        entry.used_this_frame = true;
+        return entry.target;
+      }
+    }
+  }
+
+  auto target = CreateRenderTarget(size, readable);
+  if (!target.IsValid()) {
+    return target;
+  }
+
+  Lock lock(mutex_);
+  entries_.push_back(Entry{.size = size,
+                           .readable = readable,
+                           .in_use = true,
+                           .used_this_frame = true,
+                           .target = target});
+  return target;
+}
+
+void RenderTargetPool::Release(const RenderTarget& target) {
+  auto texture = target.GetRenderTargetTexture();
+  if (!texture) {
+    return;
+  }
+  Lock lock(mutex_);
+  for (auto& entry : entries_) {
+    if (entry.target.GetRenderTargetTexture() == texture) {
+      entry.in_use = false;
+      return;
+    }
+  }
+}
+
+void RenderTargetPool::EndFrame() {
+  TRACE_EVENT0("impeller", "RenderTargetPool::EndFrame");
+  Lock lock(mutex_);
+  entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+                                [](const Entry& entry) {
+                                  return !entry.in_use &&
+                                         !entry.used_this_frame;
+                                }),
+                 entries_.end());
+  for (auto& entry : entries_) {
+    entry.used_this_frame = false;
+  }
+}
+
+size_t RenderTargetPool::GetAllocatedTargetCount() const {
+  Lock lock(mutex_);
+  return entries_.size();
+}
+
+size_t RenderTargetPool::GetFreeTargetCount() const {
+  Lock lock(mutex_);
+  return std::count_if(entries_.begin(), entries_.end(),
+                       [](const Entry& entry) { return !entry.in_use; });
+}
+
+RenderTarget RenderTargetPool::CreateRenderTarget(ISize size,
+                                                  bool readable) const {
+  /// All of the load/store actions are managed by `InlinePassContext` when
+  /// `RenderPasses` are created, so we just set them to `kDontCare` here.
+  /// What's important is the `StorageMode` of the textures, which cannot be
+  /// changed for the lifetime of the textures.
+
+  if (context_->SupportsOffscreenMSAA()) {
+    return RenderTarget::CreateOffscreenMSAA(
+        *context_,                         // context
+        size,                              // size
+        "EntityPass",                      // label
+        StorageMode::kDeviceTransient,     // color_storage_mode
+        StorageMode::kDevicePrivate,       // color_resolve_storage_mode
+        LoadAction::kDontCare,             // color_load_action
+        StoreAction::kMultisampleResolve,  // color_store_action
+        readable ? StorageMode::kDevicePrivate
+                 : StorageMode::kDeviceTransient,  // stencil_storage_mode
+        LoadAction::kDontCare,                     // stencil_load_action
+        StoreAction::kDontCare                     // stencil_store_action
+    );
+  }
+
+  return RenderTarget::CreateOffscreen(
+      *context_,                    // context
+      size,                         // size
+      "EntityPass",                 // label
+      StorageMode::kDevicePrivate,  // color_storage_mode
+      LoadAction::kDontCare,        // color_load_action
+      StoreAction::kDontCare,       // color_store_action
+      readable ? StorageMode::kDevicePrivate
+               : StorageMode::kDeviceTransient,  // stencil_storage_mode
+      LoadAction::kDontCare,                     // stencil_load_action
+      StoreAction::kDontCare                     // stencil_store_action
+  );
+}
+
+}  // namespace impeller
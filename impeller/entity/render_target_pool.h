@@ -0,0 +1,84 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "impeller/base/thread.h"
+#include "impeller/geometry/size.h"
+#include "impeller/renderer/context.h"
+#include "impeller/renderer/render_target.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      A pool of offscreen render targets used by `EntityPass`
+///             subpasses.
+///
+///             Render targets are handed out by `Acquire` and returned to the
+///             pool by `Release` once all work that reads from them has been
+///             submitted. Released targets with a matching size and stencil
+///             configuration are reused by later subpasses in the same frame
+///             and by subpasses in subsequent frames. Targets that go unused
+///             for an entire frame are dropped in `EndFrame`.
+///
+class RenderTargetPool {
+ public:
+  explicit RenderTargetPool(std::shared_ptr<Context> context);
+
+  ~RenderTargetPool();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Get a render target suitable for an `EntityPass`. All
+  ///             load/store actions are left as `kDontCare` since they are
+  ///             managed by `InlinePassContext`.
+  ///
+  /// @param[in]  size      The size of the render target.
+  /// @param[in]  readable  Whether the stencil attachment needs to survive
+  ///                       across render passes (i.e. the pass reads from its
+  ///                       own texture).
+  ///
+  /// @return     The render target. Invalid if allocation failed.
+  ///
+  RenderTarget Acquire(ISize size, bool readable);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Return a render target obtained from `Acquire` to the pool.
+  ///             The caller must guarantee that all commands referencing the
+  ///             target have already been submitted.
+  ///
+  void Release(const RenderTarget& target);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Mark the end of a frame. Free targets that were not used
+  ///             since the previous call are deallocated.
+  ///
+  void EndFrame();
+
+  size_t GetAllocatedTargetCount() const;
+
+  size_t GetFreeTargetCount() const;
+
+ private:
+  struct Entry {
+    ISize size;
+    bool readable = false;
+    bool in_use = false;
+    bool used_this_frame = false;
+    RenderTarget target;
+  };
+
+  std::shared_ptr<Context> context_;
+  mutable Mutex mutex_;
+  std::vector<Entry> entries_ IPLR_GUARDED_BY(mutex_);
+
+  RenderTarget CreateRenderTarget(ISize size, bool readable) const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(RenderTargetPool);
+};
+
+}  // namespace impeller
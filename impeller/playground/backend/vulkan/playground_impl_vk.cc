@@ -75,6 +75,7 @@ PlaygroundImplVK::PlaygroundImplVK()
                                        &::glfwGetInstanceProcAddress),    //
                                    ShaderLibraryMappingsForPlayground(),  //
                                    nullptr,                               //
+                                   fml::UniqueFD{},                       //
                                    concurrent_loop_->GetTaskRunner(),     //
                                    "Playground Library"                   //
   );
@@ -58,6 +58,10 @@ std::shared_ptr<Texture> Allocator::CreateTexture(
   return OnCreateTexture(desc);
 }
 
+AllocatorStatistics Allocator::GetStatistics() const {
+  return {};
+}
+
 uint16_t Allocator::MinimumBytesPerRow(PixelFormat format) const {
   return BytesPerPixelForPixelFormat(format);
 }
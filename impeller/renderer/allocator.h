@@ -17,6 +17,27 @@ class Context;
 class DeviceBuffer;
 class Texture;
 
+//------------------------------------------------------------------------------
+/// @brief      A snapshot of the device memory owned by an allocator.
+///
+struct AllocatorStatistics {
+  /// The number of live buffer and texture allocations.
+  size_t allocation_count = 0u;
+  /// The number of bytes used by live allocations.
+  size_t live_bytes = 0u;
+  /// The number of bytes of device memory reserved by the allocator. This
+  /// includes the unused space in blocks that allocations are carved from.
+  size_t reserved_bytes = 0u;
+
+  /// The fraction of reserved memory not used by any allocation.
+  double GetFragmentation() const {
+    if (reserved_bytes == 0u || live_bytes >= reserved_bytes) {
+      return 0.0;
+    }
+    return 1.0 - static_cast<double>(live_bytes) / reserved_bytes;
+  }
+};
+
 //------------------------------------------------------------------------------
 /// @brief      An object that allocates device memory.
 ///
@@ -45,6 +66,13 @@ class Allocator {
 
   virtual ISize GetMaxTextureSizeSupported() const = 0;
 
+  //------------------------------------------------------------------------------
+  /// @brief      Get statistics about the memory owned by this allocator.
+  ///             Backends that don't track their allocations return empty
+  ///             statistics.
+  ///
+  virtual AllocatorStatistics GetStatistics() const;
+
  protected:
   Allocator();
 
@@ -146,26 +146,26 @@ bool BufferBindingsGLES::BindVertexAttributes(const ProcTableGLES& gl,
 }
 
 bool BufferBindingsGLES::BindUniformData(
-    const ProcTableGLES& gl,
+    StateTrackerGLES& state,
     Allocator& transients_allocator,
     const Bindings& vertex_bindings,
     const Bindings& fragment_bindings) const {
   for (const auto& buffer : vertex_bindings.buffers) {
-    if (!BindUniformBuffer(gl, transients_allocator, buffer.second)) {
+    if (!BindUniformBuffer(state, transients_allocator, buffer.second)) {
       return false;
     }
   }
   for (const auto& buffer : fragment_bindings.buffers) {
-    if (!BindUniformBuffer(gl, transients_allocator, buffer.second)) {
+    if (!BindUniformBuffer(state, transients_allocator, buffer.second)) {
       return false;
     }
   }
 
-  if (!BindTextures(gl, vertex_bindings, ShaderStage::kVertex)) {
+  if (!BindTextures(state, vertex_bindings, ShaderStage::kVertex)) {
     return false;
   }
 
-  if (!BindTextures(gl, fragment_bindings, ShaderStage::kFragment)) {
+  if (!BindTextures(state, fragment_bindings, ShaderStage::kFragment)) {
     return false;
   }
 
@@ -179,9 +179,10 @@ bool BufferBindingsGLES::UnbindVertexAttributes(const ProcTableGLES& gl) const {
   return true;
 }
 
-bool BufferBindingsGLES::BindUniformBuffer(const ProcTableGLES& gl,
+bool BufferBindingsGLES::BindUniformBuffer(StateTrackerGLES& state,
                                            Allocator& transients_allocator,
                                            const BufferResource& buffer) const {
+  const auto& gl = state.GetProcTable();
   const auto* metadata = buffer.isa;
   if (metadata == nullptr) {
     // Vertex buffer bindings don't have metadata as those definitions are
@@ -199,6 +200,12 @@ bool BufferBindingsGLES::BindUniformBuffer(const ProcTableGLES& gl,
   const uint8_t* buffer_ptr =
       device_buffer_gles.GetBufferData() + buffer.resource.range.offset;
 
+  // Host buffers deduplicate identical uniforms, so consecutive draws with the
+  // same uniforms usually reference the same data.
+  if (!state.ShouldSetUniforms(metadata, buffer_ptr)) {
+    return true;
+  }
+
   if (metadata->members.empty()) {
     VALIDATION_LOG << "Uniform buffer had no members. This is currently "
                       "unsupported in the OpenGL ES backend. Use a uniform "
@@ -307,9 +314,10 @@ bool BufferBindingsGLES::BindUniformBuffer(const ProcTableGLES& gl,
   return true;
 }
 
-bool BufferBindingsGLES::BindTextures(const ProcTableGLES& gl,
+bool BufferBindingsGLES::BindTextures(StateTrackerGLES& state,
                                       const Bindings& bindings,
                                       ShaderStage stage) const {
+  const auto& gl = state.GetProcTable();
   size_t active_index = 0;
   for (const auto& texture : bindings.textures) {
     const auto& texture_gles = TextureGLES::Cast(*texture.second.resource);
@@ -333,12 +341,12 @@ bool BufferBindingsGLES::BindTextures(const ProcTableGLES& gl,
                         "this shader stage.";
       return false;
     }
-    gl.ActiveTexture(GL_TEXTURE0 + active_index);
+    state.ActiveTexture(GL_TEXTURE0 + active_index);
 
     //--------------------------------------------------------------------------
     /// Bind the texture.
     ///
-    if (!texture_gles.Bind()) {
+    if (!texture_gles.Bind(&state)) {
       return false;
     }
 
@@ -10,6 +10,7 @@
 #include "flutter/fml/macros.h"
 #include "impeller/renderer/backend/gles/gles.h"
 #include "impeller/renderer/backend/gles/proc_table_gles.h"
+#include "impeller/renderer/backend/gles/state_tracker_gles.h"
 #include "impeller/renderer/command.h"
 #include "impeller/renderer/vertex_descriptor.h"
 
@@ -33,7 +34,7 @@ class BufferBindingsGLES {
   bool BindVertexAttributes(const ProcTableGLES& gl,
                             size_t vertex_offset) const;
 
-  bool BindUniformData(const ProcTableGLES& gl,
+  bool BindUniformData(StateTrackerGLES& state,
                        Allocator& transients_allocator,
                        const Bindings& vertex_bindings,
                        const Bindings& fragment_bindings) const;
@@ -55,11 +56,11 @@ class BufferBindingsGLES {
   std::vector<VertexAttribPointer> vertex_attrib_arrays_;
   std::map<std::string, GLint> uniform_locations_;
 
-  bool BindUniformBuffer(const ProcTableGLES& gl,
+  bool BindUniformBuffer(StateTrackerGLES& state,
                          Allocator& transients_allocator,
                          const BufferResource& buffer) const;
 
-  bool BindTextures(const ProcTableGLES& gl,
+  bool BindTextures(StateTrackerGLES& state,
                     const Bindings& bindings,
                     ShaderStage stage) const;
 
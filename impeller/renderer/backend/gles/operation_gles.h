@@ -0,0 +1,137 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/macros.h"
+
+namespace impeller {
+
+class ReactorGLES;
+
+//------------------------------------------------------------------------------
+/// @brief      A move-only callable that performs work on a reactor.
+///
+///             Unlike |std::function|, callables of up to
+///             |kInlineStorageSize| bytes are stored in place. Enqueuing the
+///             operations of render and blit passes, which capture a few
+///             shared pointers and vectors, does not allocate a closure on the
+///             heap. Larger callables are moved to the heap.
+///
+class OperationGLES {
+ public:
+  static constexpr size_t kInlineStorageSize = 64u;
+
+  OperationGLES() = default;
+
+  OperationGLES(std::nullptr_t) {}
+
+  template <class Callable,
+            class = std::enable_if_t<
+                !std::is_same_v<std::decay_t<Callable>, OperationGLES> &&
+                std::is_invocable_v<std::decay_t<Callable>&,
+                                    const ReactorGLES&>>>
+  OperationGLES(Callable&& callable) {
+    using Stored = std::decay_t<Callable>;
+    if constexpr (CanStoreInline<Stored>()) {
+      new (storage_) Stored(std::forward<Callable>(callable));
+      vtable_ = &kInlineVTable<Stored>;
+    } else {
+      new (storage_) Stored*(new Stored(std::forward<Callable>(callable)));
+      vtable_ = &kHeapVTable<Stored>;
+    }
+  }
+
+  OperationGLES(OperationGLES&& other) { MoveFrom(other); }
+
+  OperationGLES& operator=(OperationGLES&& other) {
+    if (this != &other) {
+      Reset();
+      MoveFrom(other);
+    }
+    return *this;
+  }
+
+  ~OperationGLES() { Reset(); }
+
+  explicit operator bool() const { return vtable_ != nullptr; }
+
+  //----------------------------------------------------------------------------
+  /// @return     If the callable is stored in place instead of on the heap.
+  ///
+  bool IsStoredInline() const { return vtable_ && vtable_->is_inline; }
+
+  void operator()(const ReactorGLES& reactor) {
+    FML_DCHECK(vtable_ != nullptr);
+    vtable_->invoke(storage_, reactor);
+  }
+
+ private:
+  struct VTable {
+    void (*invoke)(void* storage, const ReactorGLES& reactor);
+    // Move constructs the callable into |dst| and destroys the one in |src|.
+    void (*relocate)(void* dst, void* src);
+    void (*destroy)(void* storage);
+    bool is_inline;
+  };
+
+  template <class T>
+  static constexpr bool CanStoreInline() {
+    return sizeof(T) <= kInlineStorageSize &&
+           alignof(T) <= alignof(std::max_align_t) &&
+           std::is_nothrow_move_constructible_v<T>;
+  }
+
+  template <class T>
+  static constexpr VTable kInlineVTable = {
+      [](void* storage, const ReactorGLES& reactor) {
+        (*static_cast<T*>(storage))(reactor);
+      },
+      [](void* dst, void* src) {
+        new (dst) T(std::move(*static_cast<T*>(src)));
+        static_cast<T*>(src)->~T();
+      },
+      [](void* storage) { static_cast<T*>(storage)->~T(); },
+      true,
+  };
+
+  template <class T>
+  static constexpr VTable kHeapVTable = {
+      [](void* storage, const ReactorGLES& reactor) {
+        (**static_cast<T**>(storage))(reactor);
+      },
+      [](void* dst, void* src) { new (dst) T*(*static_cast<T**>(src)); },
+      [](void* storage) { delete *static_cast<T**>(storage); },
+      false,
+  };
+
+  alignas(std::max_align_t) unsigned char storage_[kInlineStorageSize];
+  const VTable* vtable_ = nullptr;
+
+  void MoveFrom(OperationGLES& other) {
+    if (other.vtable_ == nullptr) {
+      return;
+    }
+    other.vtable_->relocate(storage_, other.storage_);
+    vtable_ = other.vtable_;
+    other.vtable_ = nullptr;
+  }
+
+  void Reset() {
+    if (vtable_ != nullptr) {
+      vtable_->destroy(storage_);
+      vtable_ = nullptr;
+    }
+  }
+
+  FML_DISALLOW_COPY_AND_ASSIGN(OperationGLES);
+};
+
+}  // namespace impeller
@@ -24,9 +24,15 @@ class PipelineGLES final
 
   const HandleGLES& GetProgramHandle() const;
 
-  [[nodiscard]] bool BindProgram() const;
-
-  [[nodiscard]] bool UnbindProgram() const;
+  //----------------------------------------------------------------------------
+  /// @brief      Makes the program of the pipeline current. The program is left
+  ///             bound so that consecutive commands using the same pipeline do
+  ///             not switch programs. Callers unbind it with |UnbindProgram|
+  ///             when they are done drawing.
+  ///
+  [[nodiscard]] bool BindProgram(StateTrackerGLES& state) const;
+
+  [[nodiscard]] static bool UnbindProgram(StateTrackerGLES& state);
 
   const BufferBindingsGLES* GetBufferBindings() const;
 
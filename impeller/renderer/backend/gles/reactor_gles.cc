@@ -5,6 +5,7 @@
 #include "impeller/renderer/backend/gles/reactor_gles.h"
 
 #include <algorithm>
+#include <utility>
 
 #include "flutter/fml/trace_event.h"
 #include "impeller/base/validation.h"
@@ -239,14 +240,32 @@ bool ReactorGLES::FlushOps() {
   {
     Lock ops_lock(ops_mutex_);
     std::swap(ops_, ops);
+    std::swap(ops_, spare_ops_);
   }
-  for (const auto& op : ops) {
+  for (auto& op : ops) {
     TRACE_EVENT0("impeller", "ReactorGLES::Operation");
     op(*this);
   }
+  ops.clear();
+  {
+    Lock ops_lock(ops_mutex_);
+    if (ops.capacity() > spare_ops_.capacity()) {
+      std::swap(ops, spare_ops_);
+    }
+  }
   return true;
 }
 
+void ReactorGLES::RecordGLCallCounts(const GLCallCounts& counts) const {
+  Lock lock(call_counts_mutex_);
+  call_counts_ += counts;
+}
+
+GLCallCounts ReactorGLES::TakeGLCallCounts() {
+  Lock lock(call_counts_mutex_);
+  return std::exchange(call_counts_, {});
+}
+
 void ReactorGLES::SetDebugLabel(const HandleGLES& handle, std::string label) {
   if (!can_set_debug_labels_) {
     return;
@@ -4,7 +4,6 @@
 
 #pragma once
 
-#include <functional>
 #include <memory>
 #include <vector>
 
@@ -12,7 +11,9 @@
 #include "flutter/fml/macros.h"
 #include "impeller/base/thread.h"
 #include "impeller/renderer/backend/gles/handle_gles.h"
+#include "impeller/renderer/backend/gles/operation_gles.h"
 #include "impeller/renderer/backend/gles/proc_table_gles.h"
+#include "impeller/renderer/backend/gles/state_tracker_gles.h"
 
 namespace impeller {
 
@@ -50,11 +51,23 @@ class ReactorGLES {
 
   void SetDebugLabel(const HandleGLES& handle, std::string label);
 
-  using Operation = std::function<void(const ReactorGLES& reactor)>;
+  using Operation = OperationGLES;
   [[nodiscard]] bool AddOperation(Operation operation);
 
   [[nodiscard]] bool React();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Adds the GL calls made by an operation to the counts of the
+  ///             current frame.
+  ///
+  void RecordGLCallCounts(const GLCallCounts& counts) const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the GL calls recorded since the last call and resets
+  ///             the counts. This is called once per presented frame.
+  ///
+  GLCallCounts TakeGLCallCounts();
+
  private:
   struct LiveHandle {
     std::optional<GLuint> name;
@@ -73,6 +86,12 @@ class ReactorGLES {
 
   mutable Mutex ops_mutex_;
   std::vector<Operation> ops_ IPLR_GUARDED_BY(ops_mutex_);
+  // The storage of previously flushed operations. It is reused so that
+  // enqueuing operations does not grow a new vector every frame.
+  std::vector<Operation> spare_ops_ IPLR_GUARDED_BY(ops_mutex_);
+
+  mutable Mutex call_counts_mutex_;
+  mutable GLCallCounts call_counts_ IPLR_GUARDED_BY(call_counts_mutex_);
 
   // Make sure the container is one where erasing items during iteration doesn't
   // invalidate other iterators.
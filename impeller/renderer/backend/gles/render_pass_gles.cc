@@ -12,6 +12,7 @@
 #include "impeller/renderer/backend/gles/device_buffer_gles.h"
 #include "impeller/renderer/backend/gles/formats_gles.h"
 #include "impeller/renderer/backend/gles/pipeline_gles.h"
+#include "impeller/renderer/backend/gles/state_tracker_gles.h"
 #include "impeller/renderer/backend/gles/texture_gles.h"
 
 namespace impeller {
@@ -36,21 +37,21 @@ void RenderPassGLES::OnSetLabel(std::string label) {
   label_ = std::move(label);
 }
 
-void ConfigureBlending(const ProcTableGLES& gl,
+void ConfigureBlending(StateTrackerGLES& state,
                        const ColorAttachmentDescriptor* color) {
   if (!color->blending_enabled) {
-    gl.Disable(GL_BLEND);
+    state.Disable(GL_BLEND);
     return;
   }
 
-  gl.Enable(GL_BLEND);
-  gl.BlendFuncSeparate(
+  state.Enable(GL_BLEND);
+  state.BlendFuncSeparate(
       ToBlendFactor(color->src_color_blend_factor),  // src color
       ToBlendFactor(color->dst_color_blend_factor),  // dst color
       ToBlendFactor(color->src_alpha_blend_factor),  // src alpha
       ToBlendFactor(color->dst_alpha_blend_factor)   // dst alpha
   );
-  gl.BlendEquationSeparate(
+  state.BlendEquationSeparate(
       ToBlendOperation(color->color_blend_op),  // mode color
       ToBlendOperation(color->alpha_blend_op)   // mode alpha
   );
@@ -63,49 +64,51 @@ void ConfigureBlending(const ProcTableGLES& gl,
                  : GL_FALSE;
     };
 
-    gl.ColorMask(is_set(color->write_mask, ColorWriteMask::kRed),    // red
-                 is_set(color->write_mask, ColorWriteMask::kGreen),  // green
-                 is_set(color->write_mask, ColorWriteMask::kBlue),   // blue
-                 is_set(color->write_mask, ColorWriteMask::kAlpha)   // alpha
+    state.ColorMask(
+        is_set(color->write_mask, ColorWriteMask::kRed),    // red
+        is_set(color->write_mask, ColorWriteMask::kGreen),  // green
+        is_set(color->write_mask, ColorWriteMask::kBlue),   // blue
+        is_set(color->write_mask, ColorWriteMask::kAlpha)   // alpha
     );
   }
 }
 
 void ConfigureStencil(GLenum face,
-                      const ProcTableGLES& gl,
+                      StateTrackerGLES& state,
                       const StencilAttachmentDescriptor& stencil,
                       uint32_t stencil_reference) {
-  gl.StencilOpSeparate(
+  state.StencilOpSeparate(
       face,                                    // face
       ToStencilOp(stencil.stencil_failure),    // stencil fail
       ToStencilOp(stencil.depth_failure),      // depth fail
       ToStencilOp(stencil.depth_stencil_pass)  // depth stencil pass
   );
-  gl.StencilFuncSeparate(face,                                        // face
-                         ToCompareFunction(stencil.stencil_compare),  // func
-                         stencil_reference,                           // ref
-                         stencil.read_mask                            // mask
+  state.StencilFuncSeparate(
+      face,                                        // face
+      ToCompareFunction(stencil.stencil_compare),  // func
+      stencil_reference,                           // ref
+      stencil.read_mask                            // mask
   );
-  gl.StencilMaskSeparate(face, stencil.write_mask);
+  state.StencilMaskSeparate(face, stencil.write_mask);
 }
 
-void ConfigureStencil(const ProcTableGLES& gl,
+void ConfigureStencil(StateTrackerGLES& state,
                       const PipelineDescriptor& pipeline,
                       uint32_t stencil_reference) {
   if (!pipeline.HasStencilAttachmentDescriptors()) {
-    gl.Disable(GL_STENCIL_TEST);
+    state.Disable(GL_STENCIL_TEST);
     return;
   }
 
-  gl.Enable(GL_STENCIL_TEST);
+  state.Enable(GL_STENCIL_TEST);
   const auto& front = pipeline.GetFrontStencilAttachmentDescriptor();
   const auto& back = pipeline.GetBackStencilAttachmentDescriptor();
   if (front == back) {
-    ConfigureStencil(GL_FRONT_AND_BACK, gl, *front, stencil_reference);
+    ConfigureStencil(GL_FRONT_AND_BACK, state, *front, stencil_reference);
   } else if (front.has_value()) {
-    ConfigureStencil(GL_FRONT, gl, *front, stencil_reference);
+    ConfigureStencil(GL_FRONT, state, *front, stencil_reference);
   } else if (back.has_value()) {
-    ConfigureStencil(GL_BACK, gl, *back, stencil_reference);
+    ConfigureStencil(GL_BACK, state, *back, stencil_reference);
   } else {
     FML_UNREACHABLE();
   }
@@ -150,6 +153,13 @@ struct RenderPassData {
 
   const auto& gl = reactor.GetProcTable();
 
+  // All GL state changes of the pass go through the tracker so that state
+  // shared by consecutive commands is only set once.
+  StateTrackerGLES state(gl);
+  fml::ScopedCleanupClosure record_call_counts([&reactor, &state]() {
+    reactor.RecordGLCallCounts(state.GetCallCounts());
+  });
+
   fml::ScopedCleanupClosure pop_pass_debug_marker(
       [&gl]() { gl.PopDebugGroup(); });
   if (!pass_data.label.empty()) {
@@ -222,12 +232,12 @@ struct RenderPassData {
     clear_bits |= GL_STENCIL_BUFFER_BIT;
   }
 
-  gl.Disable(GL_SCISSOR_TEST);
-  gl.Disable(GL_DEPTH_TEST);
-  gl.Disable(GL_STENCIL_TEST);
-  gl.Disable(GL_CULL_FACE);
-  gl.Disable(GL_BLEND);
-  gl.ColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+  state.Disable(GL_SCISSOR_TEST);
+  state.Disable(GL_DEPTH_TEST);
+  state.Disable(GL_STENCIL_TEST);
+  state.Disable(GL_CULL_FACE);
+  state.Disable(GL_BLEND);
+  state.ColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
 
   gl.Clear(clear_bits);
 
@@ -263,12 +273,13 @@ struct RenderPassData {
     //--------------------------------------------------------------------------
     /// Configure blending.
     ///
-    ConfigureBlending(gl, color_attachment);
+    ConfigureBlending(state, color_attachment);
 
     //--------------------------------------------------------------------------
     /// Setup stencil.
     ///
-    ConfigureStencil(gl, pipeline.GetDescriptor(), command.stencil_reference);
+    ConfigureStencil(state, pipeline.GetDescriptor(),
+                     command.stencil_reference);
 
     //--------------------------------------------------------------------------
     /// Configure depth.
@@ -276,11 +287,11 @@ struct RenderPassData {
     if (auto depth =
             pipeline.GetDescriptor().GetDepthStencilAttachmentDescriptor();
         depth.has_value()) {
-      gl.Enable(GL_DEPTH_TEST);
-      gl.DepthFunc(ToCompareFunction(depth->depth_compare));
-      gl.DepthMask(depth->depth_write_enabled ? GL_TRUE : GL_FALSE);
+      state.Enable(GL_DEPTH_TEST);
+      state.DepthFunc(ToCompareFunction(depth->depth_compare));
+      state.DepthMask(depth->depth_write_enabled ? GL_TRUE : GL_FALSE);
     } else {
-      gl.Disable(GL_DEPTH_TEST);
+      state.Disable(GL_DEPTH_TEST);
     }
 
     // Both the viewport and scissor are specified in framebuffer coordinates.
@@ -292,14 +303,15 @@ struct RenderPassData {
     /// Setup the viewport.
     ///
     const auto& viewport = command.viewport.value_or(pass_data.viewport);
-    gl.Viewport(viewport.rect.origin.x,  // x
-                target_size.height - viewport.rect.origin.y -
-                    viewport.rect.size.height,  // y
-                viewport.rect.size.width,       // width
-                viewport.rect.size.height       // height
+    state.Viewport(viewport.rect.origin.x,  // x
+                   target_size.height - viewport.rect.origin.y -
+                       viewport.rect.size.height,  // y
+                   viewport.rect.size.width,       // width
+                   viewport.rect.size.height       // height
     );
     if (pass_data.depth_attachment) {
-      gl.DepthRangef(viewport.depth_range.z_near, viewport.depth_range.z_far);
+      state.DepthRangef(viewport.depth_range.z_near,
+                        viewport.depth_range.z_far);
     }
 
     //--------------------------------------------------------------------------
@@ -307,15 +319,15 @@ struct RenderPassData {
     ///
     if (command.scissor.has_value()) {
       const auto& scissor = command.scissor.value();
-      gl.Enable(GL_SCISSOR_TEST);
-      gl.Scissor(
+      state.Enable(GL_SCISSOR_TEST);
+      state.Scissor(
           scissor.origin.x,                                             // x
           target_size.height - scissor.origin.y - scissor.size.height,  // y
           scissor.size.width,                                           // width
           scissor.size.height  // height
       );
     } else {
-      gl.Disable(GL_SCISSOR_TEST);
+      state.Disable(GL_SCISSOR_TEST);
     }
 
     //--------------------------------------------------------------------------
@@ -323,15 +335,15 @@ struct RenderPassData {
     ///
     switch (pipeline.GetDescriptor().GetCullMode()) {
       case CullMode::kNone:
-        gl.Disable(GL_CULL_FACE);
+        state.Disable(GL_CULL_FACE);
         break;
       case CullMode::kFrontFace:
-        gl.Enable(GL_CULL_FACE);
-        gl.CullFace(GL_FRONT);
+        state.Enable(GL_CULL_FACE);
+        state.CullFace(GL_FRONT);
         break;
       case CullMode::kBackFace:
-        gl.Enable(GL_CULL_FACE);
-        gl.CullFace(GL_BACK);
+        state.Enable(GL_CULL_FACE);
+        state.CullFace(GL_BACK);
         break;
     }
     //--------------------------------------------------------------------------
@@ -339,10 +351,10 @@ struct RenderPassData {
     ///
     switch (pipeline.GetDescriptor().GetWindingOrder()) {
       case WindingOrder::kClockwise:
-        gl.FrontFace(GL_CW);
+        state.FrontFace(GL_CW);
         break;
       case WindingOrder::kCounterClockwise:
-        gl.FrontFace(GL_CCW);
+        state.FrontFace(GL_CCW);
         break;
     }
 
@@ -385,7 +397,7 @@ struct RenderPassData {
     //--------------------------------------------------------------------------
     /// Bind the pipeline program.
     ///
-    if (!pipeline.BindProgram()) {
+    if (!pipeline.BindProgram(state)) {
       return false;
     }
 
@@ -400,7 +412,7 @@ struct RenderPassData {
     //--------------------------------------------------------------------------
     /// Bind uniform data.
     ///
-    if (!vertex_desc_gles->BindUniformData(gl,                        //
+    if (!vertex_desc_gles->BindUniformData(state,                     //
                                            *transients_allocator,     //
                                            command.vertex_bindings,   //
                                            command.fragment_bindings  //
@@ -412,11 +424,11 @@ struct RenderPassData {
     /// Finally! Invoke the draw call.
     ///
     PrimitiveType primitive_type = pipeline.GetDescriptor().GetPrimitiveType();
-    gl.DrawElements(ToMode(primitive_type),           // mode
-                    command.index_count,              // count
-                    ToIndexType(command.index_type),  // type
-                    reinterpret_cast<const GLvoid*>(static_cast<GLsizei>(
-                        index_buffer_view.range.offset))  // indices
+    state.DrawElements(ToMode(primitive_type),           // mode
+                       command.index_count,              // count
+                       ToIndexType(command.index_type),  // type
+                       reinterpret_cast<const GLvoid*>(static_cast<GLsizei>(
+                           index_buffer_view.range.offset))  // indices
     );
 
     //--------------------------------------------------------------------------
@@ -425,13 +437,13 @@ struct RenderPassData {
     if (!vertex_desc_gles->UnbindVertexAttributes(gl)) {
       return false;
     }
+  }
 
-    //--------------------------------------------------------------------------
-    /// Unbind the program pipeline.
-    ///
-    if (!pipeline.UnbindProgram()) {
-      return false;
-    }
+  //----------------------------------------------------------------------------
+  /// Unbind the program of the last command.
+  ///
+  if (!PipelineGLES::UnbindProgram(state)) {
+    return false;
   }
 
   if (gl.DiscardFramebufferEXT.IsAvailable()) {
@@ -0,0 +1,246 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/renderer/backend/gles/state_tracker_gles.h"
+
+namespace impeller {
+
+GLCallCounts& GLCallCounts::operator+=(const GLCallCounts& other) {
+  issued_calls += other.issued_calls;
+  elided_calls += other.elided_calls;
+  draw_calls += other.draw_calls;
+  return *this;
+}
+
+StateTrackerGLES::StateTrackerGLES(const ProcTableGLES& gl) : gl_(gl) {}
+
+StateTrackerGLES::~StateTrackerGLES() = default;
+
+template <class T>
+bool StateTrackerGLES::Update(std::optional<T>& current, const T& value) {
+  if (current == value) {
+    counts_.elided_calls++;
+    return false;
+  }
+  current = value;
+  counts_.issued_calls++;
+  return true;
+}
+
+template <class T>
+bool StateTrackerGLES::Update(GLenum face,
+                              PerFace<T>& current,
+                              const T& value) {
+  const bool front = face == GL_FRONT || face == GL_FRONT_AND_BACK;
+  const bool back = face == GL_BACK || face == GL_FRONT_AND_BACK;
+  if (!front && !back) {
+    counts_.issued_calls++;
+    return true;
+  }
+  if ((!front || current[0] == value) && (!back || current[1] == value)) {
+    counts_.elided_calls++;
+    return false;
+  }
+  if (front) {
+    current[0] = value;
+  }
+  if (back) {
+    current[1] = value;
+  }
+  counts_.issued_calls++;
+  return true;
+}
+
+void StateTrackerGLES::SetCapability(GLenum capability, bool enabled) {
+  std::optional<Capability> tracked;
+  switch (capability) {
+    case GL_BLEND:
+      tracked = kBlend;
+      break;
+    case GL_CULL_FACE:
+      tracked = kCullFace;
+      break;
+    case GL_DEPTH_TEST:
+      tracked = kDepthTest;
+      break;
+    case GL_SCISSOR_TEST:
+      tracked = kScissorTest;
+      break;
+    case GL_STENCIL_TEST:
+      tracked = kStencilTest;
+      break;
+  }
+  if (tracked.has_value()) {
+    if (!Update(capabilities_[tracked.value()], enabled)) {
+      return;
+    }
+  } else {
+    counts_.issued_calls++;
+  }
+  if (enabled) {
+    gl_.Enable(capability);
+  } else {
+    gl_.Disable(capability);
+  }
+}
+
+void StateTrackerGLES::Enable(GLenum capability) {
+  SetCapability(capability, true);
+}
+
+void StateTrackerGLES::Disable(GLenum capability) {
+  SetCapability(capability, false);
+}
+
+void StateTrackerGLES::BlendFuncSeparate(GLenum src_color,
+                                         GLenum dst_color,
+                                         GLenum src_alpha,
+                                         GLenum dst_alpha) {
+  if (Update(blend_func_,
+             std::make_tuple(src_color, dst_color, src_alpha, dst_alpha))) {
+    gl_.BlendFuncSeparate(src_color, dst_color, src_alpha, dst_alpha);
+  }
+}
+
+void StateTrackerGLES::BlendEquationSeparate(GLenum mode_color,
+                                             GLenum mode_alpha) {
+  if (Update(blend_equation_, std::make_tuple(mode_color, mode_alpha))) {
+    gl_.BlendEquationSeparate(mode_color, mode_alpha);
+  }
+}
+
+void StateTrackerGLES::ColorMask(GLboolean red,
+                                 GLboolean green,
+                                 GLboolean blue,
+                                 GLboolean alpha) {
+  if (Update(color_mask_, std::make_tuple(red, green, blue, alpha))) {
+    gl_.ColorMask(red, green, blue, alpha);
+  }
+}
+
+void StateTrackerGLES::StencilOpSeparate(GLenum face,
+                                         GLenum stencil_fail,
+                                         GLenum depth_fail,
+                                         GLenum depth_stencil_pass) {
+  if (Update(face, stencil_op_,
+             std::make_tuple(stencil_fail, depth_fail, depth_stencil_pass))) {
+    gl_.StencilOpSeparate(face, stencil_fail, depth_fail, depth_stencil_pass);
+  }
+}
+
+void StateTrackerGLES::StencilFuncSeparate(GLenum face,
+                                           GLenum func,
+                                           GLint ref,
+                                           GLuint mask) {
+  if (Update(face, stencil_func_, std::make_tuple(func, ref, mask))) {
+    gl_.StencilFuncSeparate(face, func, ref, mask);
+  }
+}
+
+void StateTrackerGLES::StencilMaskSeparate(GLenum face, GLuint mask) {
+  if (Update(face, stencil_mask_, mask)) {
+    gl_.StencilMaskSeparate(face, mask);
+  }
+}
+
+void StateTrackerGLES::DepthFunc(GLenum func) {
+  if (Update(depth_func_, func)) {
+    gl_.DepthFunc(func);
+  }
+}
+
+void StateTrackerGLES::DepthMask(GLboolean flag) {
+  if (Update(depth_mask_, flag)) {
+    gl_.DepthMask(flag);
+  }
+}
+
+void StateTrackerGLES::DepthRangef(GLfloat z_near, GLfloat z_far) {
+  if (Update(depth_range_, std::make_tuple(z_near, z_far))) {
+    gl_.DepthRangef(z_near, z_far);
+  }
+}
+
+void StateTrackerGLES::Viewport(GLint x,
+                                GLint y,
+                                GLsizei width,
+                                GLsizei height) {
+  if (Update(viewport_, std::make_tuple(x, y, width, height))) {
+    gl_.Viewport(x, y, width, height);
+  }
+}
+
+void StateTrackerGLES::Scissor(GLint x,
+                               GLint y,
+                               GLsizei width,
+                               GLsizei height) {
+  if (Update(scissor_, std::make_tuple(x, y, width, height))) {
+    gl_.Scissor(x, y, width, height);
+  }
+}
+
+void StateTrackerGLES::CullFace(GLenum mode) {
+  if (Update(cull_face_, mode)) {
+    gl_.CullFace(mode);
+  }
+}
+
+void StateTrackerGLES::FrontFace(GLenum mode) {
+  if (Update(front_face_, mode)) {
+    gl_.FrontFace(mode);
+  }
+}
+
+void StateTrackerGLES::UseProgram(GLuint program) {
+  if (Update(program_, program)) {
+    gl_.UseProgram(program);
+  }
+}
+
+void StateTrackerGLES::ActiveTexture(GLenum texture) {
+  if (Update(active_texture_, texture)) {
+    gl_.ActiveTexture(texture);
+  }
+}
+
+void StateTrackerGLES::BindTexture(GLenum target, GLuint texture) {
+  // Bindings are per texture unit, so they can only be tracked once the active
+  // unit is known.
+  const size_t unit = active_texture_.has_value()
+                          ? active_texture_.value() - GL_TEXTURE0
+                          : kMaxTrackedTextureUnits;
+  if (unit < kMaxTrackedTextureUnits) {
+    if (!Update(texture_bindings_[unit], std::make_tuple(target, texture))) {
+      return;
+    }
+  } else {
+    counts_.issued_calls++;
+  }
+  gl_.BindTexture(target, texture);
+}
+
+void StateTrackerGLES::DrawElements(GLenum mode,
+                                    GLsizei count,
+                                    GLenum type,
+                                    const GLvoid* indices) {
+  counts_.draw_calls++;
+  gl_.DrawElements(mode, count, type, indices);
+}
+
+bool StateTrackerGLES::ShouldSetUniforms(const void* block, const void* data) {
+  // Uniforms are program state, so they can only be tracked once the current
+  // program is known.
+  if (!program_.has_value()) {
+    return true;
+  }
+  auto& current = uniform_blocks_[std::make_pair(program_.value(), block)];
+  if (current == data) {
+    counts_.elided_calls++;
+    return false;
+  }
+  current = data;
+  return true;
+}
+
+}  // namespace impeller
@@ -0,0 +1,180 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <array>
+#include <map>
+#include <optional>
+#include <tuple>
+#include <utility>
+
+#include "flutter/fml/macros.h"
+#include "impeller/renderer/backend/gles/proc_table_gles.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      Counts of the GL calls made through a |StateTrackerGLES|.
+///
+struct GLCallCounts {
+  /// The number of state changing calls that were made.
+  size_t issued_calls = 0u;
+  /// The number of state changing calls that were skipped because they would
+  /// not have changed the state.
+  size_t elided_calls = 0u;
+  /// The number of draw calls.
+  size_t draw_calls = 0u;
+
+  GLCallCounts& operator+=(const GLCallCounts& other);
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Shadows the GL state set through it and skips calls that would
+///             set state to the value it already has.
+///
+///             GL state may also be changed by code that does not use the
+///             tracker, such as texture uploads, blits or an embedder sharing
+///             the context. All state starts out unknown and a tracker must
+///             only be used for a span of calls that is not interleaved with
+///             such changes, like the encoding of a single render pass.
+///
+class StateTrackerGLES {
+ public:
+  /// The number of texture units whose bindings are tracked. Bindings to
+  /// units past this are always issued.
+  static constexpr size_t kMaxTrackedTextureUnits = 16u;
+
+  explicit StateTrackerGLES(const ProcTableGLES& gl);
+
+  ~StateTrackerGLES();
+
+  const ProcTableGLES& GetProcTable() const { return gl_; }
+
+  const GLCallCounts& GetCallCounts() const { return counts_; }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Enables a capability. |GL_BLEND|, |GL_CULL_FACE|,
+  ///             |GL_DEPTH_TEST|, |GL_SCISSOR_TEST| and |GL_STENCIL_TEST| are
+  ///             tracked. Other capabilities are always set.
+  ///
+  void Enable(GLenum capability);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Disables a capability. See |Enable|.
+  ///
+  void Disable(GLenum capability);
+
+  void BlendFuncSeparate(GLenum src_color,
+                         GLenum dst_color,
+                         GLenum src_alpha,
+                         GLenum dst_alpha);
+
+  void BlendEquationSeparate(GLenum mode_color, GLenum mode_alpha);
+
+  void ColorMask(GLboolean red,
+                 GLboolean green,
+                 GLboolean blue,
+                 GLboolean alpha);
+
+  void StencilOpSeparate(GLenum face,
+                         GLenum stencil_fail,
+                         GLenum depth_fail,
+                         GLenum depth_stencil_pass);
+
+  void StencilFuncSeparate(GLenum face, GLenum func, GLint ref, GLuint mask);
+
+  void StencilMaskSeparate(GLenum face, GLuint mask);
+
+  void DepthFunc(GLenum func);
+
+  void DepthMask(GLboolean flag);
+
+  void DepthRangef(GLfloat z_near, GLfloat z_far);
+
+  void Viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+  void Scissor(GLint x, GLint y, GLsizei width, GLsizei height);
+
+  void CullFace(GLenum mode);
+
+  void FrontFace(GLenum mode);
+
+  void UseProgram(GLuint program);
+
+  void ActiveTexture(GLenum texture);
+
+  void BindTexture(GLenum target, GLuint texture);
+
+  void DrawElements(GLenum mode,
+                    GLsizei count,
+                    GLenum type,
+                    const GLvoid* indices);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Records that the uniforms of a block of the current program
+  ///             are about to be set from the given data.
+  ///
+  /// @param[in]  block  Identifies the uniform block, such as its metadata.
+  /// @param[in]  data   The data the uniforms are set from. The data must not
+  ///                    change while the tracker is in use.
+  ///
+  /// @return     If the uniforms need to be set. They don't if the current
+  ///             program was last given the uniforms of this block from the
+  ///             same data through this tracker.
+  ///
+  [[nodiscard]] bool ShouldSetUniforms(const void* block, const void* data);
+
+ private:
+  enum Capability {
+    kBlend,
+    kCullFace,
+    kDepthTest,
+    kScissorTest,
+    kStencilTest,
+    kCapabilityCount,
+  };
+
+  template <class T>
+  using PerFace = std::array<std::optional<T>, 2>;
+
+  using Region = std::tuple<GLint, GLint, GLsizei, GLsizei>;
+
+  const ProcTableGLES& gl_;
+  GLCallCounts counts_;
+
+  std::array<std::optional<bool>, kCapabilityCount> capabilities_;
+  std::optional<std::tuple<GLenum, GLenum, GLenum, GLenum>> blend_func_;
+  std::optional<std::tuple<GLenum, GLenum>> blend_equation_;
+  std::optional<std::tuple<GLboolean, GLboolean, GLboolean, GLboolean>>
+      color_mask_;
+  PerFace<std::tuple<GLenum, GLenum, GLenum>> stencil_op_;
+  PerFace<std::tuple<GLenum, GLint, GLuint>> stencil_func_;
+  PerFace<GLuint> stencil_mask_;
+  std::optional<GLenum> depth_func_;
+  std::optional<GLboolean> depth_mask_;
+  std::optional<std::tuple<GLfloat, GLfloat>> depth_range_;
+  std::optional<Region> viewport_;
+  std::optional<Region> scissor_;
+  std::optional<GLenum> cull_face_;
+  std::optional<GLenum> front_face_;
+  std::optional<GLuint> program_;
+  std::optional<GLenum> active_texture_;
+  std::array<std::optional<std::tuple<GLenum, GLuint>>,
+             kMaxTrackedTextureUnits>
+      texture_bindings_;
+  std::map<std::pair<GLuint, const void*>, const void*> uniform_blocks_;
+
+  void SetCapability(GLenum capability, bool enabled);
+
+  template <class T>
+  bool Update(std::optional<T>& current, const T& value);
+
+  template <class T>
+  bool Update(GLenum face, PerFace<T>& current, const T& value);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(StateTrackerGLES);
+};
+
+}  // namespace impeller
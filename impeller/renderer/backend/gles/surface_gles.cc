@@ -61,18 +61,30 @@ std::unique_ptr<Surface> SurfaceGLES::WrapFBO(
   render_target_desc.SetStencilAttachment(stencil0);
 
   return std::unique_ptr<SurfaceGLES>(
-      new SurfaceGLES(std::move(swap_callback), render_target_desc));
+      new SurfaceGLES(gl_context.GetReactor(), std::move(swap_callback),
+                      render_target_desc));
 }
 
-SurfaceGLES::SurfaceGLES(SwapCallback swap_callback,
+SurfaceGLES::SurfaceGLES(ReactorGLES::Ref reactor,
+                         SwapCallback swap_callback,
                          const RenderTarget& target_desc)
-    : Surface(target_desc), swap_callback_(std::move(swap_callback)) {}
+    : Surface(target_desc),
+      reactor_(std::move(reactor)),
+      swap_callback_(std::move(swap_callback)) {}
 
 // |Surface|
 SurfaceGLES::~SurfaceGLES() = default;
 
 // |Surface|
 bool SurfaceGLES::Present() const {
+  if (reactor_) {
+    const auto counts = reactor_->TakeGLCallCounts();
+    FML_TRACE_COUNTER("impeller", "ReactorGLES",
+                      reinterpret_cast<int64_t>(reactor_.get()),  //
+                      "GLCalls", counts.issued_calls,             //
+                      "ElidedGLCalls", counts.elided_calls,       //
+                      "DrawCalls", counts.draw_calls);
+  }
   return swap_callback_ ? swap_callback_() : false;
 }
 
@@ -9,6 +9,7 @@
 
 #include "flutter/fml/macros.h"
 #include "impeller/renderer/backend/gles/gles.h"
+#include "impeller/renderer/backend/gles/reactor_gles.h"
 #include "impeller/renderer/context.h"
 #include "impeller/renderer/surface.h"
 
@@ -29,9 +30,12 @@ class SurfaceGLES final : public Surface {
   ~SurfaceGLES() override;
 
  private:
+  ReactorGLES::Ref reactor_;
   SwapCallback swap_callback_;
 
-  SurfaceGLES(SwapCallback swap_callback, const RenderTarget& target_desc);
+  SurfaceGLES(ReactorGLES::Ref reactor,
+              SwapCallback swap_callback,
+              const RenderTarget& target_desc);
 
   // |Surface|
   bool Present() const override;
@@ -0,0 +1,120 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/renderer/backend/gles/test/mock_gles.h"
+
+#include <cstring>
+#include <utility>
+
+#include "flutter/fml/logging.h"
+
+namespace impeller {
+namespace testing {
+
+static MockGLES* g_mock_gles = nullptr;
+
+static void RecordGLCall(const char* name) {
+  if (g_mock_gles) {
+    g_mock_gles->RecordCall(name);
+  }
+}
+
+// Every proc that is not mocked below resolves to this. It is never called
+// with arguments that it needs to read.
+static void doNothing() {}
+
+static const GLubyte* mockGetString(GLenum name) {
+  switch (name) {
+    case GL_VENDOR:
+    case GL_RENDERER:
+      return reinterpret_cast<const GLubyte*>("MockGLES");
+    case GL_VERSION:
+      return reinterpret_cast<const GLubyte*>("OpenGL ES 3.0");
+    case GL_SHADING_LANGUAGE_VERSION:
+      return reinterpret_cast<const GLubyte*>("OpenGL ES GLSL ES 1.0");
+    default:
+      return reinterpret_cast<const GLubyte*>("");
+  }
+}
+
+static void mockGetIntegerv(GLenum name, GLint* value) {
+  *value = 32;
+}
+
+static GLenum mockGetError() {
+  return GL_NO_ERROR;
+}
+
+#define FOR_EACH_RECORDED_PROC(PROC)                            \
+  PROC(ActiveTexture, (GLenum))                                 \
+  PROC(BindTexture, (GLenum, GLuint))                           \
+  PROC(BlendEquationSeparate, (GLenum, GLenum))                 \
+  PROC(BlendFuncSeparate, (GLenum, GLenum, GLenum, GLenum))     \
+  PROC(ColorMask, (GLboolean, GLboolean, GLboolean, GLboolean)) \
+  PROC(CullFace, (GLenum))                                      \
+  PROC(DepthFunc, (GLenum))                                     \
+  PROC(DepthMask, (GLboolean))                                  \
+  PROC(DepthRangef, (GLfloat, GLfloat))                         \
+  PROC(Disable, (GLenum))                                       \
+  PROC(DrawElements, (GLenum, GLsizei, GLenum, const void*))    \
+  PROC(Enable, (GLenum))                                        \
+  PROC(FrontFace, (GLenum))                                     \
+  PROC(Scissor, (GLint, GLint, GLsizei, GLsizei))               \
+  PROC(StencilFuncSeparate, (GLenum, GLenum, GLint, GLuint))    \
+  PROC(StencilMaskSeparate, (GLenum, GLuint))                   \
+  PROC(StencilOpSeparate, (GLenum, GLenum, GLenum, GLenum))     \
+  PROC(UseProgram, (GLuint))                                    \
+  PROC(Viewport, (GLint, GLint, GLsizei, GLsizei))
+
+#define IMPELLER_RECORDED_PROC(name, params) \
+  static void mock##name params { RecordGLCall("gl" #name); }
+FOR_EACH_RECORDED_PROC(IMPELLER_RECORDED_PROC)
+#undef IMPELLER_RECORDED_PROC
+
+static void* ResolveMockProc(const char* name) {
+  if (std::strcmp(name, "glGetString") == 0) {
+    return reinterpret_cast<void*>(&mockGetString);
+  }
+  if (std::strcmp(name, "glGetIntegerv") == 0) {
+    return reinterpret_cast<void*>(&mockGetIntegerv);
+  }
+  if (std::strcmp(name, "glGetError") == 0) {
+    return reinterpret_cast<void*>(&mockGetError);
+  }
+#define IMPELLER_RECORDED_PROC(proc_name, params)     \
+  if (std::strcmp(name, "gl" #proc_name) == 0) {      \
+    return reinterpret_cast<void*>(&mock##proc_name); \
+  }
+  FOR_EACH_RECORDED_PROC(IMPELLER_RECORDED_PROC)
+#undef IMPELLER_RECORDED_PROC
+  return reinterpret_cast<void*>(&doNothing);
+}
+
+std::shared_ptr<MockGLES> MockGLES::Init() {
+  FML_CHECK(g_mock_gles == nullptr) << "Only one MockGLES may exist at a time.";
+  auto mock_gles = std::shared_ptr<MockGLES>(new MockGLES());
+  g_mock_gles = mock_gles.get();
+  return mock_gles;
+}
+
+MockGLES::MockGLES() = default;
+
+MockGLES::~MockGLES() {
+  g_mock_gles = nullptr;
+}
+
+std::unique_ptr<ProcTableGLES> MockGLES::CreateProcTable() const {
+  return std::make_unique<ProcTableGLES>(ResolveMockProc);
+}
+
+std::vector<std::string> MockGLES::TakeCapturedCalls() {
+  return std::exchange(captured_calls_, {});
+}
+
+void MockGLES::RecordCall(const char* name) {
+  captured_calls_.emplace_back(name);
+}
+
+}  // namespace testing
+}  // namespace impeller
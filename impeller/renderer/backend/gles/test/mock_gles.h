@@ -0,0 +1,52 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "impeller/renderer/backend/gles/proc_table_gles.h"
+
+namespace impeller {
+namespace testing {
+
+//------------------------------------------------------------------------------
+/// @brief      Provides proc tables for tests that do not need a GL context.
+///
+///             The procs resolve to stubs. The stubs of the procs that change
+///             pipeline state, bind textures or draw record their names, in
+///             call order, into the mock. Only one mock may exist at a time.
+///
+class MockGLES {
+ public:
+  static std::shared_ptr<MockGLES> Init();
+
+  ~MockGLES();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Creates a valid proc table that records calls into this mock.
+  ///
+  std::unique_ptr<ProcTableGLES> CreateProcTable() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the names of the calls recorded since the last call
+  ///             and clears them.
+  ///
+  std::vector<std::string> TakeCapturedCalls();
+
+  void RecordCall(const char* name);
+
+ private:
+  std::vector<std::string> captured_calls_;
+
+  MockGLES();
+
+  FML_DISALLOW_COPY_AND_ASSIGN(MockGLES);
+};
+
+}  // namespace testing
+}  // namespace impeller
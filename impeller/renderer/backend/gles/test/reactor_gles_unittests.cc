@@ -0,0 +1,90 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <array>
+
+#include "flutter/testing/testing.h"
+#include "impeller/renderer/backend/gles/reactor_gles.h"
+#include "impeller/renderer/backend/gles/test/mock_gles.h"
+
+namespace impeller {
+namespace testing {
+
+class TestWorker : public ReactorGLES::Worker {
+ public:
+  // |ReactorGLES::Worker|
+  bool CanReactorReactOnCurrentThreadNow(
+      const ReactorGLES& reactor) const override {
+    return true;
+  }
+};
+
+TEST(ReactorGLESTest, StoresSmallOperationsInline) {
+  size_t calls = 0;
+  ReactorGLES::Operation small = [&calls](const ReactorGLES&) { calls++; };
+  EXPECT_TRUE(small.IsStoredInline());
+
+  std::array<uint8_t, ReactorGLES::Operation::kInlineStorageSize> payload = {};
+  ReactorGLES::Operation large = [&calls, payload](const ReactorGLES&) {
+    calls += payload.size();
+  };
+  EXPECT_FALSE(large.IsStoredInline());
+
+  auto moved = std::move(large);
+  EXPECT_FALSE(large);
+  EXPECT_TRUE(moved);
+  EXPECT_FALSE(moved.IsStoredInline());
+}
+
+TEST(ReactorGLESTest, PerformsQueuedOperationsInOrder) {
+  auto mock_gles = MockGLES::Init();
+  auto reactor = std::make_shared<ReactorGLES>(mock_gles->CreateProcTable());
+  ASSERT_TRUE(reactor->IsValid());
+
+  std::vector<int> performed;
+  auto value = std::make_unique<int>(2);
+  std::array<uint8_t, ReactorGLES::Operation::kInlineStorageSize> payload = {};
+  payload[0] = 3;
+  ASSERT_TRUE(reactor->AddOperation(
+      [&performed](const ReactorGLES&) { performed.push_back(1); }));
+  ASSERT_TRUE(reactor->AddOperation(
+      [&performed, value = std::move(value)](const ReactorGLES&) {
+        performed.push_back(*value);
+      }));
+  ASSERT_TRUE(reactor->AddOperation(
+      [&performed, payload](const ReactorGLES&) {
+        performed.push_back(payload[0]);
+      }));
+  // Nothing is performed until there is a worker to react on.
+  EXPECT_TRUE(performed.empty());
+
+  auto worker = std::make_shared<TestWorker>();
+  reactor->AddWorker(worker);
+  ASSERT_TRUE(reactor->React());
+  EXPECT_EQ(performed, (std::vector<int>{1, 2, 3}));
+
+  ASSERT_TRUE(reactor->AddOperation(
+      [&performed](const ReactorGLES&) { performed.push_back(4); }));
+  EXPECT_EQ(performed, (std::vector<int>{1, 2, 3, 4}));
+}
+
+TEST(ReactorGLESTest, AccumulatesGLCallCountsUntilTaken) {
+  auto mock_gles = MockGLES::Init();
+  auto reactor = std::make_shared<ReactorGLES>(mock_gles->CreateProcTable());
+  ASSERT_TRUE(reactor->IsValid());
+
+  reactor->RecordGLCallCounts(
+      {.issued_calls = 4u, .elided_calls = 6u, .draw_calls = 1u});
+  reactor->RecordGLCallCounts(
+      {.issued_calls = 1u, .elided_calls = 2u, .draw_calls = 1u});
+
+  auto counts = reactor->TakeGLCallCounts();
+  EXPECT_EQ(counts.issued_calls, 5u);
+  EXPECT_EQ(counts.elided_calls, 8u);
+  EXPECT_EQ(counts.draw_calls, 2u);
+  EXPECT_EQ(reactor->TakeGLCallCounts().issued_calls, 0u);
+}
+
+}  // namespace testing
+}  // namespace impeller
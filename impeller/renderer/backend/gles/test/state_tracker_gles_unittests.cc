@@ -0,0 +1,120 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/testing/testing.h"
+#include "impeller/renderer/backend/gles/state_tracker_gles.h"
+#include "impeller/renderer/backend/gles/test/mock_gles.h"
+
+namespace impeller {
+namespace testing {
+
+using Calls = std::vector<std::string>;
+
+TEST(StateTrackerGLESTest, ElidesRedundantStateChanges) {
+  auto mock_gles = MockGLES::Init();
+  auto gl = mock_gles->CreateProcTable();
+  ASSERT_TRUE(gl->IsValid());
+  mock_gles->TakeCapturedCalls();
+
+  StateTrackerGLES state(*gl);
+  state.Enable(GL_BLEND);
+  state.Enable(GL_BLEND);
+  state.Disable(GL_BLEND);
+  state.UseProgram(1u);
+  state.UseProgram(1u);
+  state.UseProgram(2u);
+  state.Viewport(0, 0, 100, 100);
+  state.Viewport(0, 0, 100, 100);
+
+  EXPECT_EQ(mock_gles->TakeCapturedCalls(),
+            (Calls{"glEnable", "glDisable", "glUseProgram", "glUseProgram",
+                   "glViewport"}));
+  EXPECT_EQ(state.GetCallCounts().issued_calls, 5u);
+  EXPECT_EQ(state.GetCallCounts().elided_calls, 3u);
+}
+
+TEST(StateTrackerGLESTest, AlwaysSetsUntrackedCapabilities) {
+  auto mock_gles = MockGLES::Init();
+  auto gl = mock_gles->CreateProcTable();
+  mock_gles->TakeCapturedCalls();
+
+  StateTrackerGLES state(*gl);
+  state.Enable(GL_DITHER);
+  state.Enable(GL_DITHER);
+
+  EXPECT_EQ(mock_gles->TakeCapturedCalls(), (Calls{"glEnable", "glEnable"}));
+  EXPECT_EQ(state.GetCallCounts().elided_calls, 0u);
+}
+
+TEST(StateTrackerGLESTest, TracksStencilStatePerFace) {
+  auto mock_gles = MockGLES::Init();
+  auto gl = mock_gles->CreateProcTable();
+  mock_gles->TakeCapturedCalls();
+
+  StateTrackerGLES state(*gl);
+  state.StencilMaskSeparate(GL_FRONT_AND_BACK, 0xFF);
+  // Both faces are known after setting them together.
+  state.StencilMaskSeparate(GL_FRONT, 0xFF);
+  state.StencilMaskSeparate(GL_BACK, 0x0F);
+  // The front face differs.
+  state.StencilMaskSeparate(GL_FRONT_AND_BACK, 0x0F);
+  state.StencilMaskSeparate(GL_FRONT_AND_BACK, 0x0F);
+
+  EXPECT_EQ(mock_gles->TakeCapturedCalls().size(), 3u);
+  EXPECT_EQ(state.GetCallCounts().issued_calls, 3u);
+  EXPECT_EQ(state.GetCallCounts().elided_calls, 2u);
+}
+
+TEST(StateTrackerGLESTest, TracksTextureBindingsPerUnit) {
+  auto mock_gles = MockGLES::Init();
+  auto gl = mock_gles->CreateProcTable();
+  mock_gles->TakeCapturedCalls();
+
+  StateTrackerGLES state(*gl);
+  // The active unit is unknown, so bindings can't be tracked yet.
+  state.BindTexture(GL_TEXTURE_2D, 1u);
+  state.BindTexture(GL_TEXTURE_2D, 1u);
+  EXPECT_EQ(mock_gles->TakeCapturedCalls(),
+            (Calls{"glBindTexture", "glBindTexture"}));
+
+  state.ActiveTexture(GL_TEXTURE0);
+  state.BindTexture(GL_TEXTURE_2D, 1u);
+  state.BindTexture(GL_TEXTURE_2D, 1u);
+  state.ActiveTexture(GL_TEXTURE1);
+  state.BindTexture(GL_TEXTURE_2D, 1u);
+  state.ActiveTexture(GL_TEXTURE0);
+  state.BindTexture(GL_TEXTURE_2D, 1u);
+  state.DrawElements(GL_TRIANGLES, 3, GL_UNSIGNED_SHORT, nullptr);
+
+  EXPECT_EQ(mock_gles->TakeCapturedCalls(),
+            (Calls{"glActiveTexture", "glBindTexture", "glActiveTexture",
+                   "glBindTexture", "glActiveTexture", "glDrawElements"}));
+  EXPECT_EQ(state.GetCallCounts().draw_calls, 1u);
+}
+
+TEST(StateTrackerGLESTest, TracksUniformDataPerProgram) {
+  auto mock_gles = MockGLES::Init();
+  auto gl = mock_gles->CreateProcTable();
+
+  StateTrackerGLES state(*gl);
+  int block = 0;
+  uint8_t data[2] = {};
+  // The current program is not known yet.
+  EXPECT_TRUE(state.ShouldSetUniforms(&block, &data[0]));
+  EXPECT_TRUE(state.ShouldSetUniforms(&block, &data[0]));
+
+  state.UseProgram(1u);
+  EXPECT_TRUE(state.ShouldSetUniforms(&block, &data[0]));
+  EXPECT_FALSE(state.ShouldSetUniforms(&block, &data[0]));
+  EXPECT_TRUE(state.ShouldSetUniforms(&block, &data[1]));
+
+  // Uniforms are per program.
+  state.UseProgram(2u);
+  EXPECT_TRUE(state.ShouldSetUniforms(&block, &data[1]));
+  state.UseProgram(1u);
+  EXPECT_FALSE(state.ShouldSetUniforms(&block, &data[1]));
+}
+
+}  // namespace testing
+}  // namespace impeller
@@ -263,7 +263,7 @@ bool TextureGLES::OnSetContents(std::shared_ptr<const fml::Mapping> mapping,
     }
   };
 
-  contents_initialized_ = reactor_->AddOperation(texture_upload);
+  contents_initialized_ = reactor_->AddOperation(std::move(texture_upload));
   return contents_initialized_;
 }
 
@@ -366,7 +366,7 @@ std::optional<GLuint> TextureGLES::GetGLHandle() const {
   return reactor_->GetGLHandle(handle_);
 }
 
-bool TextureGLES::Bind() const {
+bool TextureGLES::Bind(StateTrackerGLES* state) const {
   auto handle = GetGLHandle();
   if (!handle.has_value()) {
     return false;
@@ -379,7 +379,11 @@ bool TextureGLES::Bind() const {
         VALIDATION_LOG << "Could not bind texture of this type.";
         return false;
       }
-      gl.BindTexture(target.value(), handle.value());
+      if (state) {
+        state->BindTexture(target.value(), handle.value());
+      } else {
+        gl.BindTexture(target.value(), handle.value());
+      }
     } break;
     case Type::kRenderBuffer:
       gl.BindRenderbuffer(GL_RENDERBUFFER, handle.value());
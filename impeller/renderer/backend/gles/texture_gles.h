@@ -8,6 +8,7 @@
 #include "impeller/base/backend_cast.h"
 #include "impeller/renderer/backend/gles/handle_gles.h"
 #include "impeller/renderer/backend/gles/reactor_gles.h"
+#include "impeller/renderer/backend/gles/state_tracker_gles.h"
 #include "impeller/renderer/texture.h"
 
 namespace impeller {
@@ -35,7 +36,13 @@ class TextureGLES final : public Texture,
 
   std::optional<GLuint> GetGLHandle() const;
 
-  [[nodiscard]] bool Bind() const;
+  //----------------------------------------------------------------------------
+  /// @brief      Binds the texture to the active texture unit.
+  ///
+  /// @param      state  If not null, the texture is bound through the tracker
+  ///                    so that redundant bindings are skipped.
+  ///
+  [[nodiscard]] bool Bind(StateTrackerGLES* state = nullptr) const;
 
   [[nodiscard]] bool GenerateMipmaps() const;
 
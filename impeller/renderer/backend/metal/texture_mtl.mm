@@ -79,6 +79,26 @@ bool TextureMTL::OnSetContents(const uint8_t* contents,
   return true;
 }
 
+// |Texture|
+bool TextureMTL::OnSetRegionContents(const uint8_t* contents,
+                                     size_t bytes_per_row,
+                                     IRect region) {
+  if (!IsValid() || is_wrapped_) {
+    return false;
+  }
+
+  const auto mtl_region =
+      MTLRegionMake2D(region.origin.x, region.origin.y,  //
+                      region.size.width, region.size.height);
+  [texture_ replaceRegion:mtl_region         //
+              mipmapLevel:0u                 //
+                withBytes:contents           //
+              bytesPerRow:bytes_per_row      //
+  ];
+
+  return true;
+}
+
 ISize TextureMTL::GetSize() const {
   return {static_cast<ISize::Type>(texture_.width),
           static_cast<ISize::Type>(texture_.height)};
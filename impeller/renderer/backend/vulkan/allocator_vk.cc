@@ -4,9 +4,11 @@
 
 #include "impeller/renderer/backend/vulkan/allocator_vk.h"
 
+#include <array>
 #include <memory>
 
 #include "flutter/fml/memory/ref_ptr.h"
+#include "flutter/fml/trace_event.h"
 #include "flutter/vulkan/procs/vulkan_handle.h"
 #include "flutter/vulkan/procs/vulkan_proc_table.h"
 #include "impeller/renderer/backend/vulkan/device_buffer_vk.h"
@@ -16,6 +18,37 @@
 
 namespace impeller {
 
+// Frame scoped buffers up to this size are placed in the ring buffer.
+static constexpr size_t kMaxFrameBufferSize = 1u << 20;
+static constexpr size_t kFrameBufferPoolBlockSize = 16u << 20;
+
+// Other buffers up to this size are sub-allocated from the small buffer pool.
+static constexpr size_t kMaxSmallBufferSize = 256u << 10;
+static constexpr size_t kSmallBufferPoolBlockSize = 4u << 20;
+
+// Textures at least this large get their own device memory allocation.
+static constexpr size_t kDedicatedTextureSizeThreshold = 4u << 20;
+
+static vk::BufferCreateInfo::NativeType MakeBufferCreateInfo(size_t size) {
+  return static_cast<vk::BufferCreateInfo::NativeType>(
+      vk::BufferCreateInfo()
+          .setUsage(vk::BufferUsageFlagBits::eVertexBuffer |
+                    vk::BufferUsageFlagBits::eIndexBuffer |
+                    vk::BufferUsageFlagBits::eUniformBuffer |
+                    vk::BufferUsageFlagBits::eTransferSrc |
+                    vk::BufferUsageFlagBits::eTransferDst)
+          .setSize(size)
+          .setSharingMode(vk::SharingMode::eExclusive));
+}
+
+static VmaAllocationCreateInfo MakeHostVisibleAllocationCreateInfo() {
+  VmaAllocationCreateInfo alloc_create_info = {};
+  alloc_create_info.usage = VMA_MEMORY_USAGE_AUTO;
+  alloc_create_info.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT |
+                            VMA_ALLOCATION_CREATE_MAPPED_BIT;
+  return alloc_create_info;
+}
+
 AllocatorVK::AllocatorVK(ContextVK& context,
                          uint32_t vulkan_api_version,
                          const vk::PhysicalDevice& physical_device,
@@ -83,15 +116,105 @@ AllocatorVK::AllocatorVK(ContextVK& context,
     return;
   }
   allocator_ = allocator;
+
+  // The custom pools are optional. Buffers fall back to the default pools if
+  // they could not be created.
+  frame_buffer_pool_ =
+      CreateBufferPool(VMA_POOL_CREATE_LINEAR_ALGORITHM_BIT,  // flags
+                       kFrameBufferPoolBlockSize,             // block size
+                       1u  // max block count, required for ring buffer use
+      );
+  small_buffer_pool_ = CreateBufferPool(0u,                         // flags
+                                        kSmallBufferPoolBlockSize,  // block size
+                                        0u  // max block count, unlimited
+  );
+
   is_valid_ = true;
 }
 
 AllocatorVK::~AllocatorVK() {
+  if (frame_buffer_pool_) {
+    ::vmaDestroyPool(allocator_, frame_buffer_pool_);
+  }
+  if (small_buffer_pool_) {
+    ::vmaDestroyPool(allocator_, small_buffer_pool_);
+  }
   if (allocator_) {
     ::vmaDestroyAllocator(allocator_);
   }
 }
 
+VmaPool AllocatorVK::CreateBufferPool(VmaPoolCreateFlags flags,
+                                      size_t block_size,
+                                      size_t max_block_count) const {
+  // The memory type only depends on the usage, not the size of the buffer.
+  auto buffer_create_info = MakeBufferCreateInfo(1024u);
+  auto alloc_create_info = MakeHostVisibleAllocationCreateInfo();
+
+  uint32_t memory_type_index = 0u;
+  auto result = vk::Result{::vmaFindMemoryTypeIndexForBufferInfo(
+      allocator_, &buffer_create_info, &alloc_create_info,
+      &memory_type_index)};
+  if (result != vk::Result::eSuccess) {
+    VALIDATION_LOG << "Could not find memory type for buffer pool: "
+                   << vk::to_string(result);
+    return {};
+  }
+
+  VmaPoolCreateInfo pool_create_info = {};
+  pool_create_info.memoryTypeIndex = memory_type_index;
+  pool_create_info.flags = flags;
+  pool_create_info.blockSize = block_size;
+  pool_create_info.maxBlockCount = max_block_count;
+
+  VmaPool pool = {};
+  result = vk::Result{::vmaCreatePool(allocator_, &pool_create_info, &pool)};
+  if (result != vk::Result::eSuccess) {
+    VALIDATION_LOG << "Could not create buffer pool: " << vk::to_string(result);
+    return {};
+  }
+  return pool;
+}
+
+// |Allocator|
+AllocatorStatistics AllocatorVK::GetStatistics() const {
+  AllocatorStatistics statistics;
+  if (!allocator_) {
+    return statistics;
+  }
+
+  const VkPhysicalDeviceMemoryProperties* memory_properties = nullptr;
+  ::vmaGetMemoryProperties(allocator_, &memory_properties);
+
+  // Unlike |vmaCalculateStatistics|, this doesn't walk every allocation and is
+  // cheap enough to call every frame.
+  std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets = {};
+  ::vmaGetHeapBudgets(allocator_, budgets.data());
+  for (uint32_t i = 0; i < memory_properties->memoryHeapCount; i++) {
+    const auto& heap_statistics = budgets[i].statistics;
+    statistics.allocation_count += heap_statistics.allocationCount;
+    statistics.live_bytes += heap_statistics.allocationBytes;
+    statistics.reserved_bytes += heap_statistics.blockBytes;
+  }
+  return statistics;
+}
+
+void AllocatorVK::DidAcquireSurfaceFrame(size_t frame_index) {
+  if (!allocator_) {
+    return;
+  }
+  ::vmaSetCurrentFrameIndex(allocator_, static_cast<uint32_t>(frame_index));
+
+  const auto statistics = GetStatistics();
+  FML_TRACE_COUNTER("impeller", "AllocatorVK",
+                    reinterpret_cast<int64_t>(this),                      //
+                    "AllocationCount", statistics.allocation_count,       //
+                    "LiveKBytes", statistics.live_bytes / 1024u,          //
+                    "ReservedKBytes", statistics.reserved_bytes / 1024u,  //
+                    "FragmentationPercent",
+                    static_cast<int64_t>(statistics.GetFragmentation() * 100));
+}
+
 // |Allocator|
 bool AllocatorVK::IsValid() const {
   return is_valid_;
@@ -120,10 +243,15 @@ std::shared_ptr<Texture> AllocatorVK::OnCreateTexture(
 
   VmaAllocationCreateInfo alloc_create_info = {};
   alloc_create_info.usage = VMA_MEMORY_USAGE_AUTO;
-  // docs recommend using `VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT` for image
-  // allocations, but setting them to be host visible for now.
+  // Images are host visible for now as their contents are not uploaded via
+  // the transfer queue yet.
   alloc_create_info.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT |
                             VMA_ALLOCATION_CREATE_MAPPED_BIT;
+  // Small textures like glyph atlases are sub-allocated from shared blocks.
+  // Large ones get their own memory so they don't fragment those blocks.
+  if (desc.GetByteSizeOfBaseMipLevel() >= kDedicatedTextureSizeThreshold) {
+    alloc_create_info.flags |= VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+  }
 
   auto create_info_native =
       static_cast<vk::ImageCreateInfo::NativeType>(image_create_info);
@@ -191,28 +319,29 @@ std::shared_ptr<DeviceBuffer> AllocatorVK::OnCreateBuffer(
     const DeviceBufferDescriptor& desc) {
   // TODO (kaushikiska): consider optimizing  the usage flags based on
   // StorageMode.
+  VmaPool pool = {};
+  if (desc.frame_scoped && desc.size <= kMaxFrameBufferSize) {
+    pool = frame_buffer_pool_;
+  } else if (desc.size <= kMaxSmallBufferSize) {
+    pool = small_buffer_pool_;
+  }
   auto device_allocation = std::make_unique<DeviceBufferAllocationVK>(
-      CreateHostVisibleDeviceAllocation(desc.size));
+      CreateHostVisibleDeviceAllocation(desc.size, pool));
+  if (!device_allocation->buffer) {
+    return nullptr;
+  }
   return std::make_shared<DeviceBufferVK>(desc, context_,
                                           std::move(device_allocation));
 }
 
 DeviceBufferAllocationVK AllocatorVK::CreateHostVisibleDeviceAllocation(
-    size_t size) {
-  auto buffer_create_info = static_cast<vk::BufferCreateInfo::NativeType>(
-      vk::BufferCreateInfo()
-          .setUsage(vk::BufferUsageFlagBits::eVertexBuffer |
-                    vk::BufferUsageFlagBits::eIndexBuffer |
-                    vk::BufferUsageFlagBits::eUniformBuffer |
-                    vk::BufferUsageFlagBits::eTransferSrc |
-                    vk::BufferUsageFlagBits::eTransferDst)
-          .setSize(size)
-          .setSharingMode(vk::SharingMode::eExclusive));
+    size_t size,
+    VmaPool pool) {
+  auto buffer_create_info = MakeBufferCreateInfo(size);
 
-  VmaAllocationCreateInfo allocCreateInfo = {};
-  allocCreateInfo.usage = VMA_MEMORY_USAGE_AUTO;
-  allocCreateInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT |
-                          VMA_ALLOCATION_CREATE_MAPPED_BIT;
+  VmaAllocationCreateInfo allocCreateInfo =
+      MakeHostVisibleAllocationCreateInfo();
+  allocCreateInfo.pool = pool;
 
   VkBuffer buffer;
   VmaAllocation buffer_allocation;
@@ -221,6 +350,12 @@ DeviceBufferAllocationVK AllocatorVK::CreateHostVisibleDeviceAllocation(
       vmaCreateBuffer(allocator_, &buffer_create_info, &allocCreateInfo,
                       &buffer, &buffer_allocation, &buffer_allocation_info)};
 
+  if (result != vk::Result::eSuccess && pool) {
+    // The pool is full. This is expected for the ring buffer if a frame scoped
+    // buffer outlives its frame, so try the default pools instead.
+    return CreateHostVisibleDeviceAllocation(size, {});
+  }
+
   if (result != vk::Result::eSuccess) {
     VALIDATION_LOG << "Unable to allocate a device buffer: "
                    << vk::to_string(result);
@@ -16,16 +16,43 @@
 
 namespace impeller {
 
+//------------------------------------------------------------------------------
+/// @brief      Allocates device memory using VMA.
+///
+///             Besides the default VMA pools, two custom pools are used for
+///             buffers:
+///
+///             * A linear pool used as a ring buffer for frame scoped buffers
+///               such as the device copies of host buffers. These are released
+///               in roughly the order they were allocated, so the ring can
+///               reuse the same block frame after frame.
+///             * A pool for other small buffers. VMA's default TLSF algorithm
+///               buckets free ranges by size class, so small buffers share a
+///               few blocks instead of each getting its own allocation.
+///
+///             Large textures get dedicated allocations.
+///
 class AllocatorVK final : public Allocator {
  public:
   // |Allocator|
   ~AllocatorVK() override;
 
+  // |Allocator|
+  AllocatorStatistics GetStatistics() const override;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Called when a new frame is started. Reports memory statistics
+  ///             to the timeline.
+  ///
+  void DidAcquireSurfaceFrame(size_t frame_index);
+
  private:
   friend class ContextVK;
 
   fml::RefPtr<vulkan::VulkanProcTable> vk_;
   VmaAllocator allocator_ = {};
+  VmaPool frame_buffer_pool_ = {};
+  VmaPool small_buffer_pool_ = {};
   ContextVK& context_;
   vk::Device device_;
   bool is_valid_ = false;
@@ -52,7 +79,13 @@ class AllocatorVK final : public Allocator {
   // |Allocator|
   ISize GetMaxTextureSizeSupported() const override;
 
-  DeviceBufferAllocationVK CreateHostVisibleDeviceAllocation(size_t size);
+  DeviceBufferAllocationVK CreateHostVisibleDeviceAllocation(
+      size_t size,
+      VmaPool pool = {});
+
+  VmaPool CreateBufferPool(VmaPoolCreateFlags flags,
+                           size_t block_size,
+                           size_t max_block_count) const;
 
   FML_DISALLOW_COPY_AND_ASSIGN(AllocatorVK);
 };
@@ -24,11 +24,19 @@ std::shared_ptr<CommandBufferVK> CommandBufferVK::Create(
   if (auto context = context_arg.lock()) {
     auto context_vk = reinterpret_cast<const ContextVK*>(context.get());
     auto queue = context_vk->GetGraphicsQueue();
-    auto command_pool = context_vk->CreateGraphicsCommandPool();
+    auto command_pool = context_vk->GetGraphicsCommandPool();
+    if (!command_pool) {
+      return nullptr;
+    }
     auto fenced_command_buffer = std::make_shared<FencedCommandBufferVK>(
-        device, queue, command_pool->Get());
-    return std::make_shared<CommandBufferVK>(
-        context, device, std::move(command_pool), fenced_command_buffer);
+        device, queue, std::move(command_pool),
+        context_vk->GetDescriptorPoolRecycler());
+    if (!fenced_command_buffer->Get() ||
+        !fenced_command_buffer->GetDescriptorPool()) {
+      return nullptr;
+    }
+    return std::make_shared<CommandBufferVK>(context, device,
+                                             fenced_command_buffer);
   } else {
     return nullptr;
   }
@@ -37,11 +45,9 @@ std::shared_ptr<CommandBufferVK> CommandBufferVK::Create(
 CommandBufferVK::CommandBufferVK(
     std::weak_ptr<const Context> context,
     vk::Device device,
-    std::unique_ptr<CommandPoolVK> command_pool,
     std::shared_ptr<FencedCommandBufferVK> command_buffer)
     : CommandBuffer(std::move(context)),
       device_(device),
-      command_pool_(std::move(command_pool)),
       fenced_command_buffer_(std::move(command_buffer)) {
   is_valid_ = true;
 }
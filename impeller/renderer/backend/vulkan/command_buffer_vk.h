@@ -21,7 +21,6 @@ class CommandBufferVK final : public CommandBuffer {
 
   CommandBufferVK(std::weak_ptr<const Context> context,
                   vk::Device device,
-                  std::unique_ptr<CommandPoolVK> command_pool,
                   std::shared_ptr<FencedCommandBufferVK> command_buffer);
 
   // |CommandBuffer|
@@ -31,7 +30,6 @@ class CommandBufferVK final : public CommandBuffer {
   friend class ContextVK;
 
   vk::Device device_;
-  std::unique_ptr<CommandPoolVK> command_pool_;
   vk::UniqueRenderPass render_pass_;
   std::shared_ptr<FencedCommandBufferVK> fenced_command_buffer_;
   bool is_valid_ = false;
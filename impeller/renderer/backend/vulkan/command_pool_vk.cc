@@ -4,30 +4,146 @@
 
 #include "impeller/renderer/backend/vulkan/command_pool_vk.h"
 
+#include <unordered_map>
+
+#include "flutter/fml/trace_event.h"
+#include "impeller/base/validation.h"
+
 namespace impeller {
 
-std::unique_ptr<CommandPoolVK> CommandPoolVK::Create(vk::Device device,
-                                                     uint32_t queue_index) {
+// Recycled command buffers beyond this count are freed back to the driver.
+static constexpr size_t kMaxRecycledCommandBuffers = 64u;
+
+using CommandPoolMap =
+    std::unordered_map<const ContextVK*, std::shared_ptr<CommandPoolVK>>;
+
+static thread_local CommandPoolMap tls_command_pools;
+
+// All pools for a context across all threads. Used to tear the pools down
+// before the device is collected even if the threads that own them are still
+// alive.
+static Mutex g_all_pools_mutex;
+static std::unordered_map<const ContextVK*,
+                          std::vector<std::weak_ptr<CommandPoolVK>>>
+    g_all_pools IPLR_GUARDED_BY(g_all_pools_mutex);
+
+std::shared_ptr<CommandPoolVK> CommandPoolVK::GetThreadLocal(
+    const ContextVK* context,
+    vk::Device device,
+    uint32_t queue_index) {
+  auto found = tls_command_pools.find(context);
+  // A pool that is no longer valid was cleared along with a previous context
+  // that lived at the same address.
+  if (found != tls_command_pools.end() && found->second->IsValid()) {
+    return found->second;
+  }
+
+  TRACE_EVENT0("impeller", "CreateCommandPool");
   vk::CommandPoolCreateInfo create_info;
   create_info.setQueueFamilyIndex(queue_index);
+  create_info.setFlags(vk::CommandPoolCreateFlagBits::eResetCommandBuffer);
 
   auto res = device.createCommandPoolUnique(create_info);
   if (res.result != vk::Result::eSuccess) {
-    FML_CHECK(false) << "Failed to create command pool: "
-                     << vk::to_string(res.result);
+    VALIDATION_LOG << "Failed to create command pool: "
+                   << vk::to_string(res.result);
     return nullptr;
   }
 
-  return std::make_unique<CommandPoolVK>(std::move(res.value));
+  auto pool = std::shared_ptr<CommandPoolVK>(
+      new CommandPoolVK(device, std::move(res.value)));
+  tls_command_pools[context] = pool;
+  {
+    Lock lock(g_all_pools_mutex);
+    g_all_pools[context].push_back(pool);
+  }
+  return pool;
+}
+
+void CommandPoolVK::ClearAllPools(const ContextVK* context) {
+  std::vector<std::weak_ptr<CommandPoolVK>> pools;
+  {
+    Lock lock(g_all_pools_mutex);
+    auto found = g_all_pools.find(context);
+    if (found == g_all_pools.end()) {
+      return;
+    }
+    pools = std::move(found->second);
+    g_all_pools.erase(found);
+  }
+  for (const auto& weak_pool : pools) {
+    if (auto pool = weak_pool.lock()) {
+      pool->Destroy();
+    }
+  }
+  tls_command_pools.erase(context);
+}
+
+CommandPoolVK::CommandPoolVK(vk::Device device, vk::UniqueCommandPool pool)
+    : device_(device), pool_(std::move(pool)) {}
+
+CommandPoolVK::~CommandPoolVK() {
+  Destroy();
+}
+
+bool CommandPoolVK::IsValid() const {
+  Lock lock(mutex_);
+  return !!pool_;
 }
 
-vk::CommandPool CommandPoolVK::Get() const {
-  return *command_pool_;
+void CommandPoolVK::Destroy() {
+  Lock lock(mutex_);
+  // Destroying the pool implicitly frees all buffers allocated from it.
+  recycled_buffers_.clear();
+  pool_.reset();
 }
 
-CommandPoolVK::CommandPoolVK(vk::UniqueCommandPool command_pool)
-    : command_pool_(std::move(command_pool)) {}
+vk::CommandBuffer CommandPoolVK::AllocateCommandBuffer() {
+  Lock lock(mutex_);
+  if (!pool_) {
+    return {};
+  }
+
+  if (recycled_buffers_.size() > kMaxRecycledCommandBuffers) {
+    std::vector<vk::CommandBuffer> excess(
+        recycled_buffers_.begin() + kMaxRecycledCommandBuffers,
+        recycled_buffers_.end());
+    recycled_buffers_.resize(kMaxRecycledCommandBuffers);
+    device_.freeCommandBuffers(pool_.get(), excess);
+  }
+
+  if (!recycled_buffers_.empty()) {
+    // The pool is created with |eResetCommandBuffer|, so beginning the buffer
+    // implicitly resets it.
+    auto buffer = recycled_buffers_.back();
+    recycled_buffers_.pop_back();
+    return buffer;
+  }
 
-CommandPoolVK::~CommandPoolVK() = default;
+  vk::CommandBufferAllocateInfo allocate_info;
+  allocate_info.setLevel(vk::CommandBufferLevel::ePrimary);
+  allocate_info.setCommandBufferCount(1);
+  allocate_info.setCommandPool(pool_.get());
+
+  auto res = device_.allocateCommandBuffers(allocate_info);
+  if (res.result != vk::Result::eSuccess) {
+    VALIDATION_LOG << "Failed to allocate command buffer: "
+                   << vk::to_string(res.result);
+    return {};
+  }
+  return res.value[0];
+}
+
+void CommandPoolVK::RecycleCommandBuffers(
+    std::vector<vk::CommandBuffer>& buffers) {
+  Lock lock(mutex_);
+  if (pool_) {
+    // Freeing happens on the owning thread in |AllocateCommandBuffer| as host
+    // access to the pool may only be synchronized there.
+    recycled_buffers_.insert(recycled_buffers_.end(), buffers.begin(),
+                             buffers.end());
+  }
+  buffers.clear();
+}
 
 }  // namespace impeller
@@ -4,24 +4,73 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "flutter/fml/macros.h"
+#include "impeller/base/thread.h"
 #include "impeller/renderer/backend/vulkan/vk.h"
 
 namespace impeller {
 
+class ContextVK;
+
+//------------------------------------------------------------------------------
+/// @brief      A command pool owned by a single thread that hands out recycled
+///             command buffers.
+///
+///             Vulkan requires host access to a command pool, including
+///             recording into any of its command buffers, to be externally
+///             synchronized. Giving each thread its own pool avoids both that
+///             synchronization and the cost of creating a pool per command
+///             buffer.
+///
+///             Command buffers may be recycled from any thread. Recycling
+///             only records the handle; the buffers are reset lazily when they
+///             are begun again on the owning thread.
+///
 class CommandPoolVK {
  public:
-  static std::unique_ptr<CommandPoolVK> Create(vk::Device device,
-                                               uint32_t queue_index);
+  //----------------------------------------------------------------------------
+  /// @brief      Get the command pool for the calling thread, creating it on
+  ///             first use.
+  ///
+  static std::shared_ptr<CommandPoolVK> GetThreadLocal(
+      const ContextVK* context,
+      vk::Device device,
+      uint32_t queue_index);
 
-  explicit CommandPoolVK(vk::UniqueCommandPool command_pool);
+  //----------------------------------------------------------------------------
+  /// @brief      Destroy the pools created for the context on all threads.
+  ///             This must be called before the device is destroyed.
+  ///
+  static void ClearAllPools(const ContextVK* context);
 
   ~CommandPoolVK();
 
-  vk::CommandPool Get() const;
+  bool IsValid() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Allocate a primary command buffer, reusing a recycled one if
+  ///             available. Must be called on the owning thread.
+  ///
+  vk::CommandBuffer AllocateCommandBuffer();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Return command buffers that the GPU no longer references to
+  ///             the pool. The vector is drained.
+  ///
+  void RecycleCommandBuffers(std::vector<vk::CommandBuffer>& buffers);
 
  private:
-  vk::UniqueCommandPool command_pool_;
+  const vk::Device device_;
+  mutable Mutex mutex_;
+  vk::UniqueCommandPool pool_ IPLR_GUARDED_BY(mutex_);
+  std::vector<vk::CommandBuffer> recycled_buffers_ IPLR_GUARDED_BY(mutex_);
+
+  CommandPoolVK(vk::Device device, vk::UniqueCommandPool pool);
+
+  void Destroy();
 
   FML_DISALLOW_COPY_AND_ASSIGN(CommandPoolVK);
 };
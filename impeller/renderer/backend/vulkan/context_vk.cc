@@ -218,12 +218,14 @@ std::shared_ptr<ContextVK> ContextVK::Create(
     PFN_vkGetInstanceProcAddr proc_address_callback,
     const std::vector<std::shared_ptr<fml::Mapping>>& shader_libraries_data,
     const std::shared_ptr<const fml::Mapping>& pipeline_cache_data,
+    fml::UniqueFD cache_directory,
     std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner,
     const std::string& label) {
   auto context = std::shared_ptr<ContextVK>(new ContextVK(
       proc_address_callback,          //
       shader_libraries_data,          //
       pipeline_cache_data,            //
+      std::move(cache_directory),     //
       std::move(worker_task_runner),  //
       label                           //
       ));
@@ -237,6 +239,7 @@ ContextVK::ContextVK(
     PFN_vkGetInstanceProcAddr proc_address_callback,
     const std::vector<std::shared_ptr<fml::Mapping>>& shader_libraries_data,
     const std::shared_ptr<const fml::Mapping>& pipeline_cache_data,
+    fml::UniqueFD cache_directory,
     std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner,
     const std::string& label)
     : worker_task_runner_(std::move(worker_task_runner)) {
@@ -450,9 +453,11 @@ ContextVK::ContextVK(
   }
 
   auto pipeline_library = std::shared_ptr<PipelineLibraryVK>(
-      new PipelineLibraryVK(device.value.get(),   //
-                            pipeline_cache_data,  //
-                            worker_task_runner_   //
+      new PipelineLibraryVK(device.value.get(),                //
+                            physical_device->getProperties(),  //
+                            pipeline_cache_data,               //
+                            std::move(cache_directory),        //
+                            worker_task_runner_                //
                             ));
 
   if (!pipeline_library->IsValid()) {
@@ -471,6 +476,9 @@ ContextVK::ContextVK(
     return;
   }
 
+  auto descriptor_pool_recycler =
+      std::make_shared<DescriptorPoolRecyclerVK>(device.value.get());
+
   auto work_queue = WorkQueueCommon::Create();
 
   if (!work_queue) {
@@ -485,6 +493,7 @@ ContextVK::ContextVK(
   shader_library_ = std::move(shader_library);
   sampler_library_ = std::move(sampler_library);
   pipeline_library_ = std::move(pipeline_library);
+  descriptor_pool_recycler_ = std::move(descriptor_pool_recycler);
   work_queue_ = std::move(work_queue);
   graphics_queue_ =
       device_->getQueue(graphics_queue->family, graphics_queue->index);
@@ -496,7 +505,9 @@ ContextVK::ContextVK(
   is_valid_ = true;
 }
 
-ContextVK::~ContextVK() = default;
+ContextVK::~ContextVK() {
+  CommandPoolVK::ClearAllPools(this);
+}
 
 bool ContextVK::IsValid() const {
   return is_valid_;
@@ -532,6 +543,8 @@ vk::Instance ContextVK::GetInstance() const {
 }
 
 std::unique_ptr<Surface> ContextVK::AcquireSurface(size_t current_frame) {
+  pipeline_library_->DidAcquireSurfaceFrame();
+  allocator_->DidAcquireSurfaceFrame(current_frame);
   return surface_producer_->AcquireSurface(current_frame);
 }
 
@@ -587,8 +600,16 @@ bool ContextVK::SupportsOffscreenMSAA() const {
   return true;
 }
 
-std::unique_ptr<DescriptorPoolVK> ContextVK::CreateDescriptorPool() const {
-  return std::make_unique<DescriptorPoolVK>(*device_);
+bool ContextVK::ShouldPrewarmPipelines() const {
+  // Pipelines are compiled on the worker task runner. Requesting the common
+  // variants upfront keeps pipeline compilation off the raster thread during
+  // the first frames.
+  return true;
+}
+
+const std::shared_ptr<DescriptorPoolRecyclerVK>&
+ContextVK::GetDescriptorPoolRecycler() const {
+  return descriptor_pool_recycler_;
 }
 
 PixelFormat ContextVK::GetColorAttachmentPixelFormat() const {
@@ -603,8 +624,8 @@ vk::Queue ContextVK::GetGraphicsQueue() const {
   return graphics_queue_;
 }
 
-std::unique_ptr<CommandPoolVK> ContextVK::CreateGraphicsCommandPool() const {
-  return CommandPoolVK::Create(*device_, graphics_queue_idx_);
+std::shared_ptr<CommandPoolVK> ContextVK::GetGraphicsCommandPool() const {
+  return CommandPoolVK::GetThreadLocal(this, *device_, graphics_queue_idx_);
 }
 
 }  // namespace impeller
@@ -9,6 +9,7 @@
 #include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/mapping.h"
+#include "flutter/fml/unique_fd.h"
 #include "impeller/base/backend_cast.h"
 #include "impeller/renderer/backend/vulkan/command_pool_vk.h"
 #include "impeller/renderer/backend/vulkan/deletion_queue_vk.h"
@@ -33,12 +34,15 @@ bool HasValidationLayers();
 
 }  // namespace vk
 
+class AllocatorVK;
+
 class ContextVK final : public Context, public BackendCast<ContextVK, Context> {
  public:
   static std::shared_ptr<ContextVK> Create(
       PFN_vkGetInstanceProcAddr proc_address_callback,
       const std::vector<std::shared_ptr<fml::Mapping>>& shader_libraries_data,
       const std::shared_ptr<const fml::Mapping>& pipeline_cache_data,
+      fml::UniqueFD cache_directory,
       std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner,
       const std::string& label);
 
@@ -86,7 +90,8 @@ class ContextVK final : public Context, public BackendCast<ContextVK, Context> {
 
   std::unique_ptr<Surface> AcquireSurface(size_t current_frame);
 
-  std::unique_ptr<DescriptorPoolVK> CreateDescriptorPool() const;
+  const std::shared_ptr<DescriptorPoolRecyclerVK>& GetDescriptorPoolRecycler()
+      const;
 
 #ifdef FML_OS_ANDROID
   vk::UniqueSurfaceKHR CreateAndroidSurface(ANativeWindow* window) const;
@@ -94,7 +99,10 @@ class ContextVK final : public Context, public BackendCast<ContextVK, Context> {
 
   vk::Queue GetGraphicsQueue() const;
 
-  std::unique_ptr<CommandPoolVK> CreateGraphicsCommandPool() const;
+  //----------------------------------------------------------------------------
+  /// @brief      The graphics command pool owned by the calling thread.
+  ///
+  std::shared_ptr<CommandPoolVK> GetGraphicsCommandPool() const;
 
  private:
   std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner_;
@@ -102,10 +110,11 @@ class ContextVK final : public Context, public BackendCast<ContextVK, Context> {
   vk::UniqueDebugUtilsMessengerEXT debug_messenger_;
   vk::PhysicalDevice physical_device_;
   vk::UniqueDevice device_;
-  std::shared_ptr<Allocator> allocator_;
+  std::shared_ptr<AllocatorVK> allocator_;
   std::shared_ptr<ShaderLibraryVK> shader_library_;
   std::shared_ptr<SamplerLibraryVK> sampler_library_;
   std::shared_ptr<PipelineLibraryVK> pipeline_library_;
+  std::shared_ptr<DescriptorPoolRecyclerVK> descriptor_pool_recycler_;
   uint32_t graphics_queue_idx_;
   vk::Queue graphics_queue_;
   vk::Queue compute_queue_;
@@ -122,6 +131,7 @@ class ContextVK final : public Context, public BackendCast<ContextVK, Context> {
       PFN_vkGetInstanceProcAddr proc_address_callback,
       const std::vector<std::shared_ptr<fml::Mapping>>& shader_libraries_data,
       const std::shared_ptr<const fml::Mapping>& pipeline_cache_data,
+      fml::UniqueFD cache_directory,
       std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner,
       const std::string& label);
 
@@ -149,6 +159,9 @@ class ContextVK final : public Context, public BackendCast<ContextVK, Context> {
   // |Context|
   bool SupportsOffscreenMSAA() const override;
 
+  // |Context|
+  bool ShouldPrewarmPipelines() const override;
+
   // |Context|
   const BackendFeatures& GetBackendFeatures() const override;
 
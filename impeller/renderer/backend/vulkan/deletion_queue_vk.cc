@@ -6,22 +6,32 @@
 
 namespace impeller {
 
-DeletionQueueVK::DeletionQueueVK() = default;
+DeletionQueueVK::DeletionQueueVK(vk::Device device) : device_(device) {}
 
 DeletionQueueVK::~DeletionQueueVK() {
   Flush();
 }
 
 void DeletionQueueVK::Flush() {
-  for (auto it = deletors_.rbegin(); it != deletors_.rend(); ++it) {
-    (*it)();
+  // Framebuffers reference their render passes, so they go first.
+  for (auto it = framebuffers_.rbegin(); it != framebuffers_.rend(); ++it) {
+    device_.destroyFramebuffer(*it);
   }
+  for (auto it = render_passes_.rbegin(); it != render_passes_.rend(); ++it) {
+    device_.destroyRenderPass(*it);
+  }
+
+  // |clear| keeps the capacity around for the next submission.
+  framebuffers_.clear();
+  render_passes_.clear();
+}
 
-  deletors_.clear();
+void DeletionQueueVK::Push(vk::Framebuffer framebuffer) {
+  framebuffers_.push_back(framebuffer);
 }
 
-void DeletionQueueVK::Push(Deletor&& deletor) {
-  deletors_.push_back(std::move(deletor));
+void DeletionQueueVK::Push(vk::RenderPass render_pass) {
+  render_passes_.push_back(render_pass);
 }
 
 }  // namespace impeller
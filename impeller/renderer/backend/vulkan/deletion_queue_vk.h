@@ -4,27 +4,37 @@
 
 #pragma once
 
-#include <deque>
-#include <functional>
+#include <vector>
 
 #include "flutter/fml/macros.h"
+#include "impeller/renderer/backend/vulkan/vk.h"
 
 namespace impeller {
 
+//------------------------------------------------------------------------------
+/// @brief      Collects Vulkan handles whose destruction must be deferred until
+///             the GPU is done with the command buffer that references them.
+///
+///             Handles are stored by type in flat vectors rather than as
+///             individually heap allocated closures, so deferring the
+///             deletion of a handle costs at most an amortized vector growth.
+///
 class DeletionQueueVK {
  public:
-  using Deletor = std::function<void()>;
-
-  explicit DeletionQueueVK();
+  explicit DeletionQueueVK(vk::Device device);
 
   ~DeletionQueueVK();
 
   void Flush();
 
-  void Push(Deletor&& deletor);
+  void Push(vk::Framebuffer framebuffer);
+
+  void Push(vk::RenderPass render_pass);
 
  private:
-  std::deque<Deletor> deletors_;
+  vk::Device device_;
+  std::vector<vk::Framebuffer> framebuffers_;
+  std::vector<vk::RenderPass> render_passes_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(DeletionQueueVK);
 };
@@ -4,50 +4,130 @@
 
 #include "impeller/renderer/backend/vulkan/descriptor_pool_vk.h"
 
+#include "flutter/fml/trace_event.h"
 #include "fml/logging.h"
 #include "impeller/base/validation.h"
 #include "vulkan/vulkan_enums.hpp"
 
 namespace impeller {
 
-DescriptorPoolVK::DescriptorPoolVK(vk::Device device) {
-  constexpr size_t kPoolSize = 1024;
+// The number of sets each pool in the chain can hold. The descriptor counts
+// assume a handful of uniform buffers and samplers per draw.
+static constexpr uint32_t kSetsPerPool = 256u;
+static constexpr uint32_t kDescriptorsPerSet = 4u;
 
+// The number of reset pools kept around for reuse.
+static constexpr size_t kMaxRecycledPools = 8u;
+
+DescriptorPoolVK::DescriptorPoolVK(vk::Device device) : device_(device) {
+  is_valid_ = AppendPool();
+}
+
+DescriptorPoolVK::~DescriptorPoolVK() = default;
+
+bool DescriptorPoolVK::IsValid() const {
+  return is_valid_;
+}
+
+bool DescriptorPoolVK::AppendPool() {
+  TRACE_EVENT0("impeller", "CreateDescriptorPool");
+  // Only the descriptor types produced by |ToVKDescriptorSetLayoutBinding|.
   std::vector<vk::DescriptorPoolSize> pool_sizes = {
-      {vk::DescriptorType::eSampler, kPoolSize},
-      {vk::DescriptorType::eCombinedImageSampler, kPoolSize},
-      {vk::DescriptorType::eSampledImage, kPoolSize},
-      {vk::DescriptorType::eStorageImage, kPoolSize},
-      {vk::DescriptorType::eUniformTexelBuffer, kPoolSize},
-      {vk::DescriptorType::eStorageTexelBuffer, kPoolSize},
-      {vk::DescriptorType::eUniformBuffer, kPoolSize},
-      {vk::DescriptorType::eStorageBuffer, kPoolSize},
-      {vk::DescriptorType::eUniformBufferDynamic, kPoolSize},
-      {vk::DescriptorType::eStorageBufferDynamic, kPoolSize},
-      {vk::DescriptorType::eInputAttachment, kPoolSize},
+      {vk::DescriptorType::eCombinedImageSampler,
+       kSetsPerPool * kDescriptorsPerSet},
+      {vk::DescriptorType::eUniformBuffer, kSetsPerPool * kDescriptorsPerSet},
   };
 
-  vk::DescriptorPoolCreateInfo pool_info = {
-      vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet,  // flags
-      static_cast<uint32_t>(pool_sizes.size() * kPoolSize),  // max sets
-      static_cast<uint32_t>(pool_sizes.size()),              // pool sizes count
-      pool_sizes.data()                                      // pool sizes
-  };
+  vk::DescriptorPoolCreateInfo pool_info;
+  pool_info.setMaxSets(kSetsPerPool);
+  pool_info.setPoolSizes(pool_sizes);
 
-  auto res = device.createDescriptorPool(pool_info);
+  auto res = device_.createDescriptorPoolUnique(pool_info);
   if (res.result != vk::Result::eSuccess) {
-    VALIDATION_LOG << "Unable to create a descriptor pool";
-    return;
+    VALIDATION_LOG << "Unable to create a descriptor pool: "
+                   << vk::to_string(res.result);
+    return false;
   }
 
-  pool_ = res.value;
-  is_valid_ = true;
+  pools_.emplace_back(std::move(res.value));
+  return true;
 }
 
-vk::DescriptorPool DescriptorPoolVK::GetPool() {
-  return pool_;
+std::optional<vk::DescriptorSet> DescriptorPoolVK::AllocateDescriptorSet(
+    vk::DescriptorSetLayout layout) {
+  if (!is_valid_) {
+    return std::nullopt;
+  }
+
+  vk::DescriptorSetAllocateInfo alloc_info;
+  alloc_info.setDescriptorSetCount(1);
+  alloc_info.setPSetLayouts(&layout);
+
+  // Pools past |current_pool_| have never been allocated from since the last
+  // reset, so if a set does not fit in the next pool it will not fit in any
+  // other. Only move on once rather than growing the chain without bound.
+  for (size_t attempt = 0u; attempt < 2u; attempt++) {
+    alloc_info.setDescriptorPool(pools_[current_pool_].get());
+    vk::DescriptorSet set;
+    auto res = device_.allocateDescriptorSets(&alloc_info, &set);
+    if (res == vk::Result::eSuccess) {
+      return set;
+    }
+    if ((res != vk::Result::eErrorOutOfPoolMemory &&
+         res != vk::Result::eErrorFragmentedPool) ||
+        attempt > 0u) {
+      VALIDATION_LOG << "Failed to allocate descriptor sets: "
+                     << vk::to_string(res);
+      return std::nullopt;
+    }
+    // The current pool is exhausted. Move on to the next one in the chain,
+    // growing it if necessary.
+    current_pool_++;
+    if (current_pool_ == pools_.size() && !AppendPool()) {
+      current_pool_--;
+      return std::nullopt;
+    }
+  }
+  return std::nullopt;
 }
 
-DescriptorPoolVK::~DescriptorPoolVK() = default;
+void DescriptorPoolVK::Reset() {
+  for (size_t i = 0; i <= current_pool_ && i < pools_.size(); i++) {
+    device_.resetDescriptorPool(pools_[i].get());
+  }
+  current_pool_ = 0u;
+}
+
+DescriptorPoolRecyclerVK::DescriptorPoolRecyclerVK(vk::Device device)
+    : device_(device) {}
+
+DescriptorPoolRecyclerVK::~DescriptorPoolRecyclerVK() = default;
+
+std::unique_ptr<DescriptorPoolVK> DescriptorPoolRecyclerVK::Get() {
+  {
+    Lock lock(mutex_);
+    if (!recycled_.empty()) {
+      auto pool = std::move(recycled_.back());
+      recycled_.pop_back();
+      return pool;
+    }
+  }
+  auto pool = std::make_unique<DescriptorPoolVK>(device_);
+  if (!pool->IsValid()) {
+    return nullptr;
+  }
+  return pool;
+}
+
+void DescriptorPoolRecyclerVK::Reclaim(std::unique_ptr<DescriptorPoolVK> pool) {
+  if (!pool) {
+    return;
+  }
+  pool->Reset();
+  Lock lock(mutex_);
+  if (recycled_.size() < kMaxRecycledPools) {
+    recycled_.push_back(std::move(pool));
+  }
+}
 
 }  // namespace impeller
@@ -5,27 +5,74 @@
 #pragma once
 
 #include <memory>
+#include <optional>
+#include <vector>
 
 #include "flutter/fml/macros.h"
+#include "impeller/base/thread.h"
 #include "impeller/renderer/backend/vulkan/vk.h"
 #include "vulkan/vulkan_enums.hpp"
 #include "vulkan/vulkan_handles.hpp"
 
 namespace impeller {
 
+//------------------------------------------------------------------------------
+/// @brief      A growable set of descriptor pools that all the descriptor sets
+///             of a single command buffer are allocated from.
+///
+///             Individual sets are never freed. Instead, the whole pool is
+///             reset at once after the fence of the command buffer that uses
+///             it has been signaled.
+///
 class DescriptorPoolVK {
  public:
   explicit DescriptorPoolVK(vk::Device device);
 
   ~DescriptorPoolVK();
 
-  vk::DescriptorPool GetPool();
+  bool IsValid() const;
+
+  std::optional<vk::DescriptorSet> AllocateDescriptorSet(
+      vk::DescriptorSetLayout layout);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Return all allocated sets to the pool. The GPU must no longer
+  ///             reference any of them.
+  ///
+  void Reset();
 
  private:
-  vk::DescriptorPool pool_;
+  const vk::Device device_;
+  std::vector<vk::UniqueDescriptorPool> pools_;
+  size_t current_pool_ = 0u;
   bool is_valid_ = false;
 
+  bool AppendPool();
+
   FML_DISALLOW_COPY_AND_ASSIGN(DescriptorPoolVK);
 };
 
+//------------------------------------------------------------------------------
+/// @brief      A ring of descriptor pools that are reset and handed out again
+///             once the command buffers using them have retired.
+///
+class DescriptorPoolRecyclerVK {
+ public:
+  explicit DescriptorPoolRecyclerVK(vk::Device device);
+
+  ~DescriptorPoolRecyclerVK();
+
+  std::unique_ptr<DescriptorPoolVK> Get();
+
+  void Reclaim(std::unique_ptr<DescriptorPoolVK> pool);
+
+ private:
+  const vk::Device device_;
+  Mutex mutex_;
+  std::vector<std::unique_ptr<DescriptorPoolVK>> recycled_
+      IPLR_GUARDED_BY(mutex_);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(DescriptorPoolRecyclerVK);
+};
+
 }  // namespace impeller
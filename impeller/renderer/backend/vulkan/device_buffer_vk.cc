@@ -25,7 +25,16 @@ DeviceBufferVK::DeviceBufferVK(
       context_(context),
       device_allocation_(std::move(device_allocation)) {}
 
-DeviceBufferVK::~DeviceBufferVK() = default;
+DeviceBufferVK::~DeviceBufferVK() {
+  // Command buffer submission waits for the GPU, so the buffer is no longer in
+  // use by the time the last reference to it is dropped.
+  const auto& backing = device_allocation_->backing_allocation;
+  if (device_allocation_->buffer && backing.allocator) {
+    ::vmaDestroyBuffer(*backing.allocator,
+                       static_cast<VkBuffer>(device_allocation_->buffer),
+                       backing.allocation);
+  }
+}
 
 uint8_t* DeviceBufferVK::OnGetContents() const {
   return reinterpret_cast<uint8_t*>(device_allocation_->GetMapping());
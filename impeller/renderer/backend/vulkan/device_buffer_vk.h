@@ -13,9 +13,6 @@
 
 namespace impeller {
 
-// https://github.com/flutter/flutter/issues/112387
-// This buffer can be freed once the command buffer is disposed.
-// vmaDestroyBuffer(allocator_, buffer_, allocation_);
 struct BackingAllocationVK {
   VmaAllocator* allocator = nullptr;
   VmaAllocation allocation = nullptr;
@@ -11,31 +11,20 @@
 
 namespace impeller {
 
-static vk::CommandBuffer CreateCommandBuffer(vk::Device device,
-                                             vk::CommandPool pool) {
-  vk::CommandBufferAllocateInfo allocate_info;
-  allocate_info.setLevel(vk::CommandBufferLevel::ePrimary);
-  allocate_info.setCommandBufferCount(1);
-  allocate_info.setCommandPool(pool);
-
-  auto res = device.allocateCommandBuffers(allocate_info);
-  if (res.result != vk::Result::eSuccess) {
-    VALIDATION_LOG << "Failed to allocate command buffer: "
-                   << vk::to_string(res.result);
-    return nullptr;
-  }
-
-  return res.value[0];
-}
-
-FencedCommandBufferVK::FencedCommandBufferVK(vk::Device device,
-                                             vk::Queue queue,
-                                             vk::CommandPool command_pool)
+FencedCommandBufferVK::FencedCommandBufferVK(
+    vk::Device device,
+    vk::Queue queue,
+    std::shared_ptr<CommandPoolVK> command_pool,
+    std::weak_ptr<DescriptorPoolRecyclerVK> descriptor_pool_recycler)
     : device_(device),
       queue_(queue),
-      command_pool_(command_pool),
-      deletion_queue_(std::make_unique<DeletionQueueVK>()) {
-  command_buffer_ = CreateCommandBuffer(device_, command_pool_);
+      command_pool_(std::move(command_pool)),
+      descriptor_pool_recycler_(std::move(descriptor_pool_recycler)),
+      deletion_queue_(std::make_unique<DeletionQueueVK>(device)) {
+  command_buffer_ = command_pool_->AllocateCommandBuffer();
+  if (auto recycler = descriptor_pool_recycler_.lock()) {
+    descriptor_pool_ = recycler->Get();
+  }
 }
 
 vk::CommandBuffer FencedCommandBufferVK::Get() const {
@@ -43,7 +32,7 @@ vk::CommandBuffer FencedCommandBufferVK::Get() const {
 }
 
 vk::CommandBuffer FencedCommandBufferVK::GetSingleUseChild() {
-  auto child = CreateCommandBuffer(device_, command_pool_);
+  auto child = command_pool_->AllocateCommandBuffer();
   children_.push_back(child);
   return child;
 }
@@ -52,9 +41,18 @@ FencedCommandBufferVK::~FencedCommandBufferVK() {
   if (!submitted_) {
     FML_LOG(WARNING)
         << "FencedCommandBufferVK is being destroyed without being submitted.";
-    children_.push_back(command_buffer_);
   }
-  device_.freeCommandBuffers(command_pool_, children_);
+  children_.push_back(command_buffer_);
+  // Either the fence was waited on in |Submit| or the buffers never made it to
+  // the GPU. In both cases, they may be reused right away.
+  Recycle();
+}
+
+void FencedCommandBufferVK::Recycle() {
+  command_pool_->RecycleCommandBuffers(children_);
+  if (auto recycler = descriptor_pool_recycler_.lock()) {
+    recycler->Reclaim(std::move(descriptor_pool_));
+  }
 }
 
 bool FencedCommandBufferVK::Submit() {
@@ -63,8 +61,6 @@ bool FencedCommandBufferVK::Submit() {
     return false;
   }
 
-  children_.push_back(command_buffer_);
-
   auto fence_res = device_.createFenceUnique(vk::FenceCreateInfo());
   if (fence_res.result != vk::Result::eSuccess) {
     VALIDATION_LOG << "Failed to create fence: "
@@ -73,9 +69,11 @@ bool FencedCommandBufferVK::Submit() {
   }
   vk::UniqueFence fence = std::move(fence_res.value);
 
+  children_.push_back(command_buffer_);
   vk::SubmitInfo submit_info;
   submit_info.setCommandBuffers(children_);
   auto res = queue_.submit(submit_info, *fence);
+  children_.pop_back();
   if (res != vk::Result::eSuccess) {
     VALIDATION_LOG << "Failed to submit command buffer: " << vk::to_string(res);
     return false;
@@ -98,4 +96,8 @@ DeletionQueueVK* FencedCommandBufferVK::GetDeletionQueue() const {
   return deletion_queue_.get();
 }
 
+DescriptorPoolVK* FencedCommandBufferVK::GetDescriptorPool() const {
+  return descriptor_pool_.get();
+}
+
 }  // namespace impeller
@@ -7,16 +7,20 @@
 #include <memory>
 
 #include "flutter/fml/macros.h"
+#include "impeller/renderer/backend/vulkan/command_pool_vk.h"
 #include "impeller/renderer/backend/vulkan/deletion_queue_vk.h"
+#include "impeller/renderer/backend/vulkan/descriptor_pool_vk.h"
 #include "impeller/renderer/backend/vulkan/vk.h"
 
 namespace impeller {
 
 class FencedCommandBufferVK {
  public:
-  FencedCommandBufferVK(vk::Device device,
-                        vk::Queue queue,
-                        vk::CommandPool command_pool);
+  FencedCommandBufferVK(
+      vk::Device device,
+      vk::Queue queue,
+      std::shared_ptr<CommandPoolVK> command_pool,
+      std::weak_ptr<DescriptorPoolRecyclerVK> descriptor_pool_recycler);
 
   ~FencedCommandBufferVK();
 
@@ -29,15 +33,26 @@ class FencedCommandBufferVK {
 
   DeletionQueueVK* GetDeletionQueue() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      The pool to allocate the descriptor sets used by this command
+  ///             buffer from. It is reset and recycled once the command buffer
+  ///             has retired.
+  ///
+  DescriptorPoolVK* GetDescriptorPool() const;
+
  private:
   vk::Device device_;
   vk::Queue queue_;
-  vk::CommandPool command_pool_;
+  std::shared_ptr<CommandPoolVK> command_pool_;
+  std::weak_ptr<DescriptorPoolRecyclerVK> descriptor_pool_recycler_;
+  std::unique_ptr<DescriptorPoolVK> descriptor_pool_;
   std::unique_ptr<DeletionQueueVK> deletion_queue_;
   vk::CommandBuffer command_buffer_;
   std::vector<vk::CommandBuffer> children_;
   bool submitted_ = false;
 
+  void Recycle();
+
   FML_DISALLOW_COPY_AND_ASSIGN(FencedCommandBufferVK);
 };
 
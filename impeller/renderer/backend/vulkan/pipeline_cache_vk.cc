@@ -0,0 +1,199 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/renderer/backend/vulkan/pipeline_cache_vk.h"
+
+#include <cstring>
+
+#include "flutter/fml/file.h"
+#include "flutter/fml/trace_event.h"
+#include "impeller/base/validation.h"
+
+namespace impeller {
+
+PipelineCacheHeaderVK::PipelineCacheHeaderVK() = default;
+
+PipelineCacheHeaderVK::PipelineCacheHeaderVK(
+    const vk::PhysicalDeviceProperties& props,
+    uint64_t p_data_size)
+    : vendor_id(props.vendorID),
+      device_id(props.deviceID),
+      driver_version(props.driverVersion),
+      api_version(props.apiVersion),
+      data_size(p_data_size) {
+  static_assert(sizeof(uuid) == sizeof(props.pipelineCacheUUID));
+  std::memcpy(uuid, props.pipelineCacheUUID, sizeof(uuid));
+}
+
+bool PipelineCacheHeaderVK::IsCompatibleWith(
+    const PipelineCacheHeaderVK& current) const {
+  return magic == current.magic &&                    //
+         version == current.version &&                //
+         vendor_id == current.vendor_id &&            //
+         device_id == current.device_id &&            //
+         driver_version == current.driver_version &&  //
+         api_version == current.api_version &&        //
+         std::memcmp(uuid, current.uuid, sizeof(uuid)) == 0;
+}
+
+/// Returns the pipeline cache data following the header in `mapping` if the
+/// header is compatible with `current`.
+static std::unique_ptr<fml::Mapping> ValidateCacheData(
+    std::unique_ptr<fml::Mapping> mapping,
+    const PipelineCacheHeaderVK& current) {
+  if (!mapping || mapping->GetSize() < sizeof(PipelineCacheHeaderVK)) {
+    return nullptr;
+  }
+  PipelineCacheHeaderVK header;
+  std::memcpy(&header, mapping->GetMapping(), sizeof(header));
+  if (!header.IsCompatibleWith(current)) {
+    FML_LOG(INFO) << "Discarding Vulkan pipeline cache generated by a "
+                     "different device or driver.";
+    return nullptr;
+  }
+  if (header.data_size != mapping->GetSize() - sizeof(header)) {
+    VALIDATION_LOG << "Vulkan pipeline cache on disk was truncated.";
+    return nullptr;
+  }
+  auto data = mapping->GetMapping() + sizeof(header);
+  // Keep the file mapping alive for as long as the returned data.
+  auto raw = mapping.release();
+  return std::make_unique<fml::NonOwnedMapping>(
+      data, header.data_size,
+      [raw](const uint8_t* data, size_t size) { delete raw; });
+}
+
+PipelineCacheVK::PipelineCacheVK(
+    vk::Device device,
+    const vk::PhysicalDeviceProperties& properties,
+    fml::UniqueFD cache_directory,
+    const std::shared_ptr<const fml::Mapping>& fallback_data)
+    : device_(device),
+      header_(properties, 0u),
+      cache_directory_(std::move(cache_directory)) {
+  TRACE_EVENT0("impeller", "PipelineCacheVK::Create");
+
+  // Prefer the cache persisted by previous runs. Data provided by the embedder
+  // may be used if the on-disk cache is absent or stale. The embedder data is
+  // passed to the driver verbatim since it may not carry our header.
+  std::shared_ptr<const fml::Mapping> initial_data =
+      ValidateCacheData(OpenCacheFile(), header_);
+  if (!initial_data) {
+    initial_data = fallback_data;
+  }
+
+  vk::PipelineCacheCreateInfo cache_info;
+  if (initial_data) {
+    cache_info.initialDataSize = initial_data->GetSize();
+    cache_info.pInitialData = initial_data->GetMapping();
+  }
+
+  auto cache = device_.createPipelineCacheUnique(cache_info);
+  if (cache.result != vk::Result::eSuccess && initial_data) {
+    // Drivers may reject data they can't use with an error. Retry without the
+    // initial data instead of failing context creation.
+    FML_LOG(ERROR) << "Could not create pipeline cache with initial data: "
+                   << vk::to_string(cache.result);
+    cache = device_.createPipelineCacheUnique({});
+  }
+  if (cache.result != vk::Result::eSuccess) {
+    VALIDATION_LOG << "Could not create pipeline cache: "
+                   << vk::to_string(cache.result);
+    return;
+  }
+
+  cache_ = std::move(cache.value);
+  is_valid_ = true;
+}
+
+PipelineCacheVK::~PipelineCacheVK() = default;
+
+bool PipelineCacheVK::IsValid() const {
+  return is_valid_;
+}
+
+bool PipelineCacheVK::IsDirty() const {
+  return dirty_;
+}
+
+vk::UniquePipeline PipelineCacheVK::CreatePipeline(
+    const vk::GraphicsPipelineCreateInfo& info) {
+  // See the note in the header about why this is a reader lock.
+  ReaderLock lock(cache_mutex_);
+  auto pipeline = device_.createGraphicsPipelineUnique(cache_.get(), info);
+  if (pipeline.result != vk::Result::eSuccess) {
+    VALIDATION_LOG << "Could not create graphics pipeline: "
+                   << vk::to_string(pipeline.result);
+    return {};
+  }
+  dirty_ = true;
+  return std::move(pipeline.value);
+}
+
+std::unique_ptr<fml::Mapping> PipelineCacheVK::CopyCacheData() const {
+  std::vector<uint8_t> data;
+  {
+    WriterLock lock(cache_mutex_);
+    if (!cache_) {
+      return nullptr;
+    }
+    auto result = device_.getPipelineCacheData(*cache_);
+    if (result.result != vk::Result::eSuccess) {
+      VALIDATION_LOG << "Could not get pipeline cache data: "
+                     << vk::to_string(result.result);
+      return nullptr;
+    }
+    data = std::move(result.value);
+  }
+
+  auto header = header_;
+  header.data_size = data.size();
+
+  const auto total_size = sizeof(header) + data.size();
+  auto buffer = static_cast<uint8_t*>(std::malloc(total_size));
+  if (!buffer) {
+    return nullptr;
+  }
+  std::memcpy(buffer, &header, sizeof(header));
+  std::memcpy(buffer + sizeof(header), data.data(), data.size());
+  return std::make_unique<fml::MallocMapping>(buffer, total_size);
+}
+
+bool PipelineCacheVK::PersistCacheToDisk() {
+  if (!is_valid_ || !cache_directory_.is_valid()) {
+    return false;
+  }
+  // Claim the dirty bit before reading the data so that pipelines created
+  // concurrently mark the cache dirty again.
+  if (!dirty_.exchange(false)) {
+    return true;
+  }
+  TRACE_EVENT0("impeller", "PipelineCacheVK::PersistCacheToDisk");
+  auto data = CopyCacheData();
+  if (!data) {
+    dirty_ = true;
+    return false;
+  }
+  if (!fml::WriteAtomically(cache_directory_, kCacheFileName, *data)) {
+    VALIDATION_LOG << "Could not write Vulkan pipeline cache to disk.";
+    dirty_ = true;
+    return false;
+  }
+  return true;
+}
+
+std::unique_ptr<fml::Mapping> PipelineCacheVK::OpenCacheFile() const {
+  if (!cache_directory_.is_valid() ||
+      !fml::FileExists(cache_directory_, kCacheFileName)) {
+    return nullptr;
+  }
+  auto mapping = fml::FileMapping::CreateReadOnly(cache_directory_,
+                                                  kCacheFileName);
+  if (!mapping || !mapping->IsValid()) {
+    return nullptr;
+  }
+  return mapping;
+}
+
+}  // namespace impeller
@@ -0,0 +1,107 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "flutter/fml/unique_fd.h"
+#include "impeller/base/thread.h"
+#include "impeller/renderer/backend/vulkan/vk.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      The header written in front of the serialized Vulkan pipeline
+///             cache data. The cache data is only ever handed back to the
+///             driver if every field matches the current device and driver.
+///             Driver updates routinely invalidate pipeline caches and some
+///             drivers crash on foreign data instead of rejecting it.
+///
+struct PipelineCacheHeaderVK {
+  static constexpr uint32_t kMagic = 0x4B564C50;  // "PLVK"
+  static constexpr uint32_t kVersion = 1u;
+
+  uint32_t magic = kMagic;
+  uint32_t version = kVersion;
+  uint32_t vendor_id = 0u;
+  uint32_t device_id = 0u;
+  uint32_t driver_version = 0u;
+  uint32_t api_version = 0u;
+  uint8_t uuid[VK_UUID_SIZE] = {};
+  uint64_t data_size = 0u;
+
+  PipelineCacheHeaderVK();
+
+  explicit PipelineCacheHeaderVK(const vk::PhysicalDeviceProperties& props,
+                                 uint64_t data_size);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether the cache data following this header was generated
+  ///             by the same device and driver as `current`.
+  ///
+  bool IsCompatibleWith(const PipelineCacheHeaderVK& current) const;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      Owns the `VkPipelineCache` used by `PipelineLibraryVK` and
+///             handles loading it from and persisting it to the cache
+///             directory.
+///
+class PipelineCacheVK {
+ public:
+  static constexpr const char* kCacheFileName = "flutter.impeller.vkcache";
+
+  PipelineCacheVK(vk::Device device,
+                  const vk::PhysicalDeviceProperties& properties,
+                  fml::UniqueFD cache_directory,
+                  const std::shared_ptr<const fml::Mapping>& fallback_data);
+
+  ~PipelineCacheVK();
+
+  bool IsValid() const;
+
+  vk::UniquePipeline CreatePipeline(const vk::GraphicsPipelineCreateInfo& info);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Whether pipelines have been added to the cache since it was
+  ///             last loaded or persisted.
+  ///
+  bool IsDirty() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Write the cache contents to the cache directory if any
+  ///             pipelines were created since the last time it was written.
+  ///             This is safe to call from any thread.
+  ///
+  /// @return     If the cache is now up to date on disk.
+  ///
+  bool PersistCacheToDisk();
+
+  std::unique_ptr<fml::Mapping> CopyCacheData() const;
+
+ private:
+  const vk::Device device_;
+  const PipelineCacheHeaderVK header_;
+  const fml::UniqueFD cache_directory_;
+  // On locking around the pipeline cache: The cache is internally
+  // synchronized. So there is no need to hold a writer lock around its use
+  // when pipelines are being created. The time it takes for implementations to
+  // spend within the critical section of the cache is limited compared to the
+  // time it takes for the "create pipeline" call itself. The writer lock is
+  // only necessary when fetching pipeline cache data for persisting to disk.
+  mutable RWMutex cache_mutex_;
+  vk::UniquePipelineCache cache_ IPLR_GUARDED_BY(cache_mutex_);
+  std::atomic_bool dirty_ = false;
+  bool is_valid_ = false;
+
+  std::unique_ptr<fml::Mapping> OpenCacheFile() const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(PipelineCacheVK);
+};
+
+}  // namespace impeller
@@ -20,33 +20,61 @@ namespace impeller {
 
 PipelineLibraryVK::PipelineLibraryVK(
     const vk::Device& device,
+    const vk::PhysicalDeviceProperties& physical_device_properties,
     const std::shared_ptr<const fml::Mapping>& pipeline_cache_data,
+    fml::UniqueFD cache_directory,
     std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner)
     : worker_task_runner_(std::move(worker_task_runner)) {
   if (!worker_task_runner_) {
     return;
   }
 
-  vk::PipelineCacheCreateInfo cache_info;
+  auto pso_cache = std::make_unique<PipelineCacheVK>(
+      device, physical_device_properties, std::move(cache_directory),
+      pipeline_cache_data);
 
-  if (pipeline_cache_data) {
-    cache_info.pInitialData = pipeline_cache_data->GetMapping();
-    cache_info.initialDataSize = pipeline_cache_data->GetSize();
-  }
-
-  auto cache = device.createPipelineCacheUnique(cache_info);
-
-  if (cache.result != vk::Result::eSuccess) {
+  if (!pso_cache->IsValid()) {
     VALIDATION_LOG << "Could not create pipeline cache.";
     return;
   }
 
   device_ = device;
-  cache_ = std::move(cache.value);
+  pso_cache_ = std::move(pso_cache);
   is_valid_ = true;
 }
 
-PipelineLibraryVK::~PipelineLibraryVK() = default;
+PipelineLibraryVK::~PipelineLibraryVK() {
+  // Make sure pipelines compiled during this run are available to the next
+  // one even if no periodic persist happened since they were created.
+  PersistPipelineCacheToDisk();
+}
+
+void PipelineLibraryVK::DidAcquireSurfaceFrame() {
+  if (!IsValid()) {
+    return;
+  }
+  if (++frames_acquired_ % kPersistCacheFrameInterval != 0u) {
+    return;
+  }
+  if (!pso_cache_->IsDirty()) {
+    return;
+  }
+  auto weak_this = weak_from_this();
+  worker_task_runner_->PostTask([weak_this]() {
+    auto thiz = weak_this.lock();
+    if (!thiz) {
+      // The library persists the cache itself when it is collected.
+      return;
+    }
+    PipelineLibraryVK::Cast(thiz.get())->PersistPipelineCacheToDisk();
+  });
+}
+
+void PipelineLibraryVK::PersistPipelineCacheToDisk() {
+  if (pso_cache_) {
+    pso_cache_->PersistCacheToDisk();
+  }
+}
 
 // |PipelineLibrary|
 bool PipelineLibraryVK::IsValid() const {
@@ -396,23 +424,19 @@ std::unique_ptr<PipelineCreateInfoVK> PipelineLibraryVK::CreatePipeline(
   depth_stencil_state.setStencilTestEnable(false);
   pipeline_info.setPDepthStencilState(&depth_stencil_state);
 
-  // See the note in the header about why this is a reader lock.
-  ReaderLock lock(cache_mutex_);
-  auto pipeline =
-      device_.createGraphicsPipelineUnique(cache_.get(), pipeline_info);
-  if (pipeline.result != vk::Result::eSuccess) {
-    VALIDATION_LOG << "Could not create graphics pipeline - " << desc.GetLabel()
-                   << ": " << vk::to_string(pipeline.result);
+  auto pipeline = pso_cache_->CreatePipeline(pipeline_info);
+  if (!pipeline) {
+    VALIDATION_LOG << "Could not create graphics pipeline - "
+                   << desc.GetLabel();
     return nullptr;
   }
 
   ContextVK::SetDebugName(device_, *pipeline_layout.value,
                           "pipeline_layout_" + desc.GetLabel());
-  ContextVK::SetDebugName(device_, *pipeline.value,
-                          "pipeline_" + desc.GetLabel());
+  ContextVK::SetDebugName(device_, *pipeline, "pipeline_" + desc.GetLabel());
 
   return std::make_unique<PipelineCreateInfoVK>(
-      std::move(pipeline.value), std::move(render_pass.value()),
+      std::move(pipeline), std::move(render_pass.value()),
       std::move(pipeline_layout.value), std::move(descriptor_set_layout));
 }
 
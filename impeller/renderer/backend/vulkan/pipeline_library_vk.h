@@ -4,11 +4,14 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/mapping.h"
 #include "impeller/base/backend_cast.h"
 #include "impeller/base/thread.h"
+#include "impeller/renderer/backend/vulkan/pipeline_cache_vk.h"
 #include "impeller/renderer/backend/vulkan/pipeline_vk.h"
 #include "impeller/renderer/backend/vulkan/vk.h"
 #include "impeller/renderer/pipeline_library.h"
@@ -25,28 +28,36 @@ class PipelineLibraryVK final
   // |PipelineLibrary|
   ~PipelineLibraryVK() override;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Called once per frame. Periodically persists the pipeline
+  ///             cache to disk on a worker thread if new pipelines were
+  ///             created since it was last written.
+  ///
+  void DidAcquireSurfaceFrame();
+
  private:
   friend ContextVK;
 
+  /// The number of frames between attempts to persist the pipeline cache.
+  static constexpr size_t kPersistCacheFrameInterval = 120u;
+
   vk::Device device_;
-  // On locking around the pipeline cache: The cache is internally synchronized.
-  // So there is no need to hold a writer lock around its use when pipelines are
-  // being created. The time it takes for implementations to spend within the
-  // critical section of the cache is limited compared to the time it
-  // takes for the "create pipeline" call itself. The writer lock is only
-  // necessary when fetching pipeline cache data for persisting to disk.
-  mutable RWMutex cache_mutex_;
-  vk::UniquePipelineCache cache_ IPLR_GUARDED_BY(cache_mutex_);
+  std::unique_ptr<PipelineCacheVK> pso_cache_;
   std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner_;
   Mutex pipelines_mutex_;
   PipelineMap pipelines_ IPLR_GUARDED_BY(pipelines_mutex_);
+  std::atomic_size_t frames_acquired_ = 0u;
   bool is_valid_ = false;
 
   PipelineLibraryVK(
       const vk::Device& device,
+      const vk::PhysicalDeviceProperties& physical_device_properties,
       const std::shared_ptr<const fml::Mapping>& pipeline_cache_data,
+      fml::UniqueFD cache_directory,
       std::shared_ptr<fml::ConcurrentTaskRunner> worker_task_runner);
 
+  void PersistPipelineCacheToDisk();
+
   // |PipelineLibrary|
   bool IsValid() const override;
 
@@ -73,10 +73,7 @@ bool RenderPassVK::OnEncodeCommands(const Context& context) const {
   auto& texture = TextureVK::Cast(*color0.texture);
   vk::Framebuffer framebuffer = CreateFrameBuffer(texture);
 
-  command_buffer_->GetDeletionQueue()->Push(
-      [device = device_, fbo = framebuffer]() {
-        device.destroyFramebuffer(fbo);
-      });
+  command_buffer_->GetDeletionQueue()->Push(framebuffer);
 
   // layout transition.
   if (!TransitionImageLayout(texture.GetImage(), vk::ImageLayout::eUndefined,
@@ -141,11 +138,7 @@ bool RenderPassVK::EndCommandBuffer() {
       return false;
     }
 
-    const auto& context_vk = GetContextVK();
-    command_buffer_->GetDeletionQueue()->Push(
-        [device = device_, render_pass = render_pass_]() {
-          device.destroyRenderPass(render_pass);
-        });
+    command_buffer_->GetDeletionQueue()->Push(render_pass_);
 
     return true;
   }
@@ -215,43 +208,27 @@ bool RenderPassVK::AllocateAndBindDescriptorSets(
   vk::PipelineLayout pipeline_layout =
       pipeline_create_info->GetPipelineLayout();
 
-  const auto& context_vk = GetContextVK();
-  const auto& pool = context_vk.CreateDescriptorPool();
-
-  command_buffer_->GetDeletionQueue()->Push(
-      [pool = pool->GetPool(), device = device_]() {
-        device.destroyDescriptorPool(pool);
-      });
-
-  vk::DescriptorSetAllocateInfo alloc_info;
-  std::array<vk::DescriptorSetLayout, 1> dsls = {
-      pipeline_create_info->GetDescriptorSetLayout(),
-  };
-
-  alloc_info.setDescriptorPool(pool->GetPool());
-  alloc_info.setSetLayouts(dsls);
-
-  auto desc_sets_res = device_.allocateDescriptorSets(alloc_info);
-  if (desc_sets_res.result != vk::Result::eSuccess) {
-    VALIDATION_LOG << "Failed to allocate descriptor sets: "
-                   << vk::to_string(desc_sets_res.result);
+  auto desc_set = command_buffer_->GetDescriptorPool()->AllocateDescriptorSet(
+      pipeline_create_info->GetDescriptorSetLayout());
+  if (!desc_set.has_value()) {
     return false;
   }
 
-  auto desc_sets = desc_sets_res.value;
   bool update_vertex_descriptors = UpdateDescriptorSets(
-      "vertex_bindings", command.vertex_bindings, allocator, desc_sets[0]);
+      "vertex_bindings", command.vertex_bindings, allocator, desc_set.value());
   if (!update_vertex_descriptors) {
     return false;
   }
-  bool update_frag_descriptors = UpdateDescriptorSets(
-      "fragment_bindings", command.fragment_bindings, allocator, desc_sets[0]);
+  bool update_frag_descriptors =
+      UpdateDescriptorSets("fragment_bindings", command.fragment_bindings,
+                           allocator, desc_set.value());
   if (!update_frag_descriptors) {
     return false;
   }
 
-  command_buffer_->Get().bindDescriptorSets(
-      vk::PipelineBindPoint::eGraphics, pipeline_layout, 0, desc_sets, nullptr);
+  command_buffer_->Get().bindDescriptorSets(vk::PipelineBindPoint::eGraphics,
+                                            pipeline_layout, 0,
+                                            desc_set.value(), nullptr);
   return true;
 }
 
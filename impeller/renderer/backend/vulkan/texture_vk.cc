@@ -18,6 +18,12 @@ TextureVK::~TextureVK() {
     const auto& texture = texture_info_->allocated_texture;
     vmaDestroyImage(*texture.backing_allocation.allocator, texture.image,
                     texture.backing_allocation.allocation);
+    const auto& staging = texture.staging_buffer;
+    if (staging.buffer && staging.backing_allocation.allocator) {
+      vmaDestroyBuffer(*staging.backing_allocation.allocator,
+                       static_cast<VkBuffer>(staging.buffer),
+                       staging.backing_allocation.allocation);
+    }
   }
 }
 
@@ -63,6 +69,33 @@ bool TextureVK::OnSetContents(std::shared_ptr<const fml::Mapping> mapping,
   return OnSetContents(mapping->GetMapping(), mapping->GetSize(), slice);
 }
 
+bool TextureVK::OnSetRegionContents(const uint8_t* contents,
+                                    size_t bytes_per_row,
+                                    IRect region) {
+  if (IsWrapped() || !IsValid()) {
+    return false;
+  }
+
+  auto mapping = static_cast<uint8_t*>(
+      texture_info_->allocated_texture.staging_buffer.GetMapping());
+  if (!mapping) {
+    return false;
+  }
+
+  // The staging buffer is copied to the image in its entirety when the
+  // texture is used, so only the rows of the region need to be updated here.
+  const auto& desc = GetTextureDescriptor();
+  const size_t bytes_per_pixel = BytesPerPixelForPixelFormat(desc.format);
+  const size_t dst_bytes_per_row = desc.GetBytesPerRow();
+  const size_t region_row_bytes = region.size.width * bytes_per_pixel;
+  for (int64_t row = 0; row < region.size.height; row++) {
+    ::memcpy(mapping + (region.origin.y + row) * dst_bytes_per_row +
+                 region.origin.x * bytes_per_pixel,
+             contents + row * bytes_per_row, region_row_bytes);
+  }
+  return true;
+}
+
 bool TextureVK::IsValid() const {
   switch (texture_info_->backing_type) {
     case TextureBackingTypeVK::kUnknownType:
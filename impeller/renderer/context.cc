@@ -14,6 +14,10 @@ bool Context::HasThreadingRestrictions() const {
   return false;
 }
 
+bool Context::ShouldPrewarmPipelines() const {
+  return false;
+}
+
 std::shared_ptr<GPUTracer> Context::GetGPUTracer() const {
   return nullptr;
 }
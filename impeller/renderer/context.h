@@ -51,6 +51,14 @@ class Context : public std::enable_shared_from_this<Context> {
 
   virtual bool HasThreadingRestrictions() const;
 
+  //----------------------------------------------------------------------------
+  /// @return     Whether pipeline variants for common rendering options should
+  ///             be requested eagerly when a content context is set up so
+  ///             that they can be compiled in the background instead of
+  ///             stalling the first frames that use them.
+  ///
+  virtual bool ShouldPrewarmPipelines() const;
+
   virtual bool SupportsOffscreenMSAA() const = 0;
 
   virtual const BackendFeatures& GetBackendFeatures() const = 0;
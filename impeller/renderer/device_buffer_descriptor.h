@@ -13,6 +13,9 @@ namespace impeller {
 struct DeviceBufferDescriptor {
   StorageMode storage_mode = StorageMode::kDeviceTransient;
   size_t size = 0u;
+  /// Whether the buffer is released as soon as the frame that uses it has
+  /// been rendered. Backends may place such buffers in a linear arena.
+  bool frame_scoped = false;
 };
 
 }  // namespace impeller
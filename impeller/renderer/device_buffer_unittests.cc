@@ -4,6 +4,7 @@
 
 #include "flutter/testing/testing.h"
 #include "impeller/playground/playground.h"
+#include "impeller/renderer/allocator.h"
 #include "impeller/renderer/device_buffer.h"
 
 namespace impeller {
@@ -11,5 +12,17 @@ namespace testing {
 
 using DeviceBufferTest = Playground;
 
+TEST(AllocatorStatisticsTest, ComputesFragmentation) {
+  AllocatorStatistics statistics;
+  ASSERT_EQ(statistics.GetFragmentation(), 0.0);
+
+  statistics.live_bytes = 256u;
+  statistics.reserved_bytes = 1024u;
+  ASSERT_DOUBLE_EQ(statistics.GetFragmentation(), 0.75);
+
+  statistics.live_bytes = 1024u;
+  ASSERT_EQ(statistics.GetFragmentation(), 0.0);
+}
+
 }  // namespace testing
 }  // namespace impeller
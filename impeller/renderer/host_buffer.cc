@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <cstring>
+#include <string_view>
 
 #include "flutter/fml/logging.h"
 
@@ -56,13 +57,43 @@ BufferView HostBuffer::Emplace(const void* buffer, size_t length) {
   return BufferView{shared_from_this(), GetBuffer(), Range{old_length, length}};
 }
 
+BufferView HostBuffer::EmplaceUnique(const void* buffer,
+                                     size_t length,
+                                     size_t align) {
+  statistics_.uniform_count++;
+  const auto hash = std::hash<std::string_view>{}(
+      std::string_view(reinterpret_cast<const char*>(buffer), length));
+  auto [begin, end] = uniform_ranges_.equal_range(hash);
+  for (auto it = begin; it != end; ++it) {
+    const auto& range = it->second;
+    if (range.length == length && (align == 0 || range.offset % align == 0) &&
+        ::memcmp(GetBuffer() + range.offset, buffer, length) == 0) {
+      statistics_.deduplicated_uniform_count++;
+      statistics_.deduplicated_bytes += length;
+      return BufferView{shared_from_this(), GetBuffer(), range};
+    }
+  }
+
+  auto view = Emplace(buffer, length, align);
+  if (view) {
+    uniform_ranges_.emplace(hash, view.range);
+  }
+  return view;
+}
+
 std::shared_ptr<const DeviceBuffer> HostBuffer::GetDeviceBuffer(
     Allocator& allocator) const {
   if (generation_ == device_buffer_generation_) {
     return device_buffer_;
   }
-  auto new_buffer = allocator.CreateBufferWithCopy(GetBuffer(), GetLength());
-  if (!new_buffer) {
+  // The device copy only lives as long as the pass that owns this buffer.
+  DeviceBufferDescriptor desc;
+  desc.storage_mode = StorageMode::kHostVisible;
+  desc.size = GetLength();
+  desc.frame_scoped = true;
+  auto new_buffer = allocator.CreateBuffer(desc);
+  if (!new_buffer ||
+      !new_buffer->CopyHostBuffer(GetBuffer(), Range{0, GetLength()})) {
     return nullptr;
   }
   new_buffer->SetLabel(label_);
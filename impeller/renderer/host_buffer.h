@@ -8,6 +8,7 @@
 #include <memory>
 #include <string>
 #include <type_traits>
+#include <unordered_map>
 
 #include "flutter/fml/macros.h"
 #include "impeller/base/allocation.h"
@@ -28,10 +29,28 @@ class HostBuffer final : public std::enable_shared_from_this<HostBuffer>,
 
   void SetLabel(std::string label);
 
+  struct Statistics {
+    /// The number of uniforms emplaced with |EmplaceUniform|.
+    size_t uniform_count = 0u;
+    /// The number of those uniforms that were identical to a previously
+    /// emplaced uniform and reused its data.
+    size_t deduplicated_uniform_count = 0u;
+    /// The number of bytes that were not added to the buffer because uniforms
+    /// were deduplicated.
+    size_t deduplicated_bytes = 0u;
+  };
+
+  const Statistics& GetStatistics() const { return statistics_; }
+
   //----------------------------------------------------------------------------
   /// @brief      Emplace uniform data onto the host buffer. Ensure that backend
   ///             specific uniform alignment requirements are respected.
   ///
+  ///             Uniforms with the same contents as a uniform previously
+  ///             emplaced onto this buffer return a view of the same range.
+  ///             Draws that share transforms or colors then reference the same
+  ///             data, which backends do not need to bind again.
+  ///
   /// @param[in]  uniform     The uniform struct to emplace onto the buffer.
   ///
   /// @tparam     UniformType The type of the uniform struct.
@@ -43,9 +62,9 @@ class HostBuffer final : public std::enable_shared_from_this<HostBuffer>,
   [[nodiscard]] BufferView EmplaceUniform(const UniformType& uniform) {
     const auto alignment =
         std::max(alignof(UniformType), DefaultUniformAlignment());
-    return Emplace(reinterpret_cast<const void*>(&uniform),  // buffer
-                   sizeof(UniformType),                      // size
-                   alignment                                 // alignment
+    return EmplaceUnique(reinterpret_cast<const void*>(&uniform),  // buffer
+                         sizeof(UniformType),                      // size
+                         alignment                                 // alignment
     );
   }
 
@@ -100,6 +119,10 @@ class HostBuffer final : public std::enable_shared_from_this<HostBuffer>,
   mutable size_t device_buffer_generation_ = 0u;
   size_t generation_ = 1u;
   std::string label_;
+  // The ranges of the uniforms in the buffer, keyed by the hash of their
+  // contents.
+  std::unordered_multimap<size_t, Range> uniform_ranges_;
+  Statistics statistics_;
 
   // |Buffer|
   std::shared_ptr<const DeviceBuffer> GetDeviceBuffer(
@@ -107,6 +130,10 @@ class HostBuffer final : public std::enable_shared_from_this<HostBuffer>,
 
   [[nodiscard]] BufferView Emplace(const void* buffer, size_t length);
 
+  [[nodiscard]] BufferView EmplaceUnique(const void* buffer,
+                                         size_t length,
+                                         size_t align);
+
   HostBuffer();
 
   FML_DISALLOW_COPY_AND_ASSIGN(HostBuffer);
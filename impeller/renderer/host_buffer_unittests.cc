@@ -75,5 +75,41 @@ TEST(HostBufferTest, CanEmplaceWithAlignment) {
   }
 }
 
+TEST(HostBufferTest, EmplaceUniformDeduplicatesIdenticalUniforms) {
+  struct Uniform {
+    float values[4];
+  };
+  auto buffer = HostBuffer::Create();
+
+  auto first = buffer->EmplaceUniform(Uniform{{1, 2, 3, 4}});
+  auto other = buffer->EmplaceUniform(Uniform{{4, 3, 2, 1}});
+  auto repeated = buffer->EmplaceUniform(Uniform{{1, 2, 3, 4}});
+  ASSERT_TRUE(first);
+  ASSERT_TRUE(other);
+  ASSERT_TRUE(repeated);
+  ASSERT_EQ(repeated.range, first.range);
+  ASSERT_FALSE(other.range == first.range);
+
+  const auto& statistics = buffer->GetStatistics();
+  ASSERT_EQ(statistics.uniform_count, 3u);
+  ASSERT_EQ(statistics.deduplicated_uniform_count, 1u);
+  ASSERT_EQ(statistics.deduplicated_bytes, sizeof(Uniform));
+  ASSERT_EQ(buffer->GetLength(),
+            DefaultUniformAlignment() + sizeof(Uniform));
+}
+
+TEST(HostBufferTest, EmplaceDoesNotDeduplicate) {
+  struct Length4 {
+    uint8_t pad[4];
+  };
+  auto buffer = HostBuffer::Create();
+
+  auto first = buffer->Emplace(Length4{});
+  auto second = buffer->Emplace(Length4{});
+  ASSERT_EQ(first.range, Range(0u, 4u));
+  ASSERT_EQ(second.range, Range(4u, 4u));
+  ASSERT_EQ(buffer->GetStatistics().uniform_count, 0u);
+}
+
 }  // namespace  testing
 }  // namespace impeller
@@ -4,6 +4,8 @@
 
 #include "impeller/renderer/render_pass.h"
 
+#include "flutter/fml/trace_event.h"
+
 namespace impeller {
 
 RenderPass::RenderPass(std::weak_ptr<const Context> context,
@@ -71,6 +73,12 @@ bool RenderPass::EncodeCommands() const {
   if (!context) {
     return false;
   }
+  const auto& statistics = transients_buffer_->GetStatistics();
+  FML_TRACE_COUNTER("impeller", "RenderPassTransients",
+                    reinterpret_cast<int64_t>(context.get()),           //
+                    "Bytes", transients_buffer_->GetLength(),           //
+                    "DeduplicatedBytes", statistics.deduplicated_bytes  //
+  );
   return OnEncodeCommands(*context);
 }
 
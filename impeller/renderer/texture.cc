@@ -42,6 +42,32 @@ bool Texture::SetContents(std::shared_ptr<const fml::Mapping> mapping,
   return true;
 }
 
+bool Texture::SetRegionContents(const uint8_t* contents,
+                                size_t bytes_per_row,
+                                IRect region) {
+  if (!contents || desc_.type != TextureType::kTexture2D) {
+    return false;
+  }
+  if (region.size.IsEmpty()) {
+    return true;
+  }
+  if (!IRect::MakeSize(desc_.size).Contains(region)) {
+    VALIDATION_LOG << "Region is out of bounds of the texture.";
+    return false;
+  }
+  if (!OnSetRegionContents(contents, bytes_per_row, region)) {
+    return false;
+  }
+  intent_ = TextureIntent::kUploadFromHost;
+  return true;
+}
+
+bool Texture::OnSetRegionContents(const uint8_t* contents,
+                                  size_t bytes_per_row,
+                                  IRect region) {
+  return false;
+}
+
 size_t Texture::GetMipCount() const {
   return GetTextureDescriptor().mip_count;
 }
@@ -8,6 +8,7 @@
 
 #include "flutter/fml/macros.h"
 #include "flutter/fml/mapping.h"
+#include "impeller/geometry/rect.h"
 #include "impeller/geometry/size.h"
 #include "impeller/renderer/formats.h"
 #include "impeller/renderer/texture_descriptor.h"
@@ -27,6 +28,23 @@ class Texture {
   [[nodiscard]] bool SetContents(std::shared_ptr<const fml::Mapping> mapping,
                                  size_t slice = 0);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Replace the contents of a region of the base mip level of a
+  ///             2D texture, leaving the rest of the texture untouched.
+  ///
+  /// @param[in]  contents       The first pixel of the region.
+  /// @param[in]  bytes_per_row  The stride between the rows of the region in
+  ///                            `contents`.
+  /// @param[in]  region         The region of the texture to replace.
+  ///
+  /// @return     If the region was replaced. Backends that cannot update a
+  ///             region in place return false, in which case the caller must
+  ///             set the full contents instead.
+  ///
+  [[nodiscard]] bool SetRegionContents(const uint8_t* contents,
+                                       size_t bytes_per_row,
+                                       IRect region);
+
   virtual bool IsValid() const = 0;
 
   virtual ISize GetSize() const = 0;
@@ -52,6 +70,10 @@ class Texture {
       std::shared_ptr<const fml::Mapping> mapping,
       size_t slice) = 0;
 
+  [[nodiscard]] virtual bool OnSetRegionContents(const uint8_t* contents,
+                                                 size_t bytes_per_row,
+                                                 IRect region);
+
  private:
   TextureIntent intent_ = TextureIntent::kRenderToTexture;
   const TextureDescriptor desc_;
@@ -4,6 +4,9 @@
 
 #include "impeller/typographer/backends/skia/text_render_context_skia.h"
 
+#include <algorithm>
+#include <cmath>
+#include <optional>
 #include <utility>
 
 #include "flutter/fml/logging.h"
@@ -11,14 +14,13 @@
 #include "impeller/base/allocation.h"
 #include "impeller/renderer/allocator.h"
 #include "impeller/typographer/backends/skia/typeface_skia.h"
+#include "impeller/typographer/rectangle_packer.h"
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkFont.h"
 #include "third_party/skia/include/core/SkFontMetrics.h"
 #include "third_party/skia/include/core/SkRSXform.h"
 #include "third_party/skia/include/core/SkSurface.h"
-#include "third_party/skia/src/core/SkIPoint16.h"   // nogncheck
-#include "third_party/skia/src/gpu/GrRectanizer.h"  // nogncheck
 
 namespace impeller {
 
@@ -58,40 +60,36 @@ static FontGlyphPair::Vector CollectUniqueFontGlyphPairs(
   return vector;
 }
 
-static size_t PairsFitInAtlasOfSize(const FontGlyphPair::Vector& pairs,
-                                    const ISize& atlas_size,
-                                    std::vector<Rect>& glyph_positions) {
-  if (atlas_size.IsEmpty()) {
-    return false;
-  }
+// TODO(bdero): We might be able to remove this per-glyph padding if we fix
+//              the underlying causes of the overlap.
+//              https://github.com/flutter/flutter/issues/114563
+static constexpr auto kPadding = 2;
 
-  auto rect_packer = std::unique_ptr<GrRectanizer>(
-      GrRectanizer::Factory(atlas_size.width, atlas_size.height));
+static ISize GetGlyphSize(const FontGlyphPair& pair) {
+  return ISize::Ceil((pair.glyph.bounds * pair.font.GetMetrics().scale).size);
+}
 
+/// Appends the pairs to the packer and records their locations. Returns the
+/// number of pairs that did not fit.
+static size_t AppendToRectPacker(const FontGlyphPair::Vector& pairs,
+                                 RectanglePacker& rect_packer,
+                                 std::vector<Rect>& glyph_positions) {
   glyph_positions.clear();
   glyph_positions.reserve(pairs.size());
 
-  // TODO(bdero): We might be able to remove this per-glyph padding if we fix
-  //              the underlying causes of the overlap.
-  //              https://github.com/flutter/flutter/issues/114563
-  constexpr auto padding = 2;
-
   for (size_t i = 0; i < pairs.size(); i++) {
-    const auto& pair = pairs[i];
-
-    const auto glyph_size =
-        ISize::Ceil((pair.glyph.bounds * pair.font.GetMetrics().scale).size);
-    SkIPoint16 location_in_atlas;
-    if (!rect_packer->addRect(glyph_size.width + padding,   //
-                              glyph_size.height + padding,  //
-                              &location_in_atlas            //
-                              )) {
+    const auto glyph_size = GetGlyphSize(pairs[i]);
+    IPoint location_in_atlas;
+    if (!rect_packer.AddRect(ISize(glyph_size.width + kPadding,   //
+                                   glyph_size.height + kPadding   //
+                                   ),
+                             &location_in_atlas)) {
       return pairs.size() - i;
     }
-    glyph_positions.emplace_back(Rect::MakeXYWH(location_in_atlas.x(),  //
-                                                location_in_atlas.y(),  //
-                                                glyph_size.width,       //
-                                                glyph_size.height       //
+    glyph_positions.emplace_back(Rect::MakeXYWH(location_in_atlas.x,  //
+                                                location_in_atlas.y,  //
+                                                glyph_size.width,     //
+                                                glyph_size.height     //
                                                 ));
   }
 
@@ -100,7 +98,8 @@ static size_t PairsFitInAtlasOfSize(const FontGlyphPair::Vector& pairs,
 
 static ISize OptimumAtlasSizeForFontGlyphPairs(
     const FontGlyphPair::Vector& pairs,
-    std::vector<Rect>& glyph_positions) {
+    std::vector<Rect>& glyph_positions,
+    std::shared_ptr<RectanglePacker>& rect_packer) {
   static constexpr auto kMinAtlasSize = 8u;
   static constexpr auto kMaxAtlasSize = 4096u;
 
@@ -109,8 +108,9 @@ static ISize OptimumAtlasSizeForFontGlyphPairs(
   ISize current_size(kMinAtlasSize, kMinAtlasSize);
   size_t total_pairs = pairs.size() + 1;
   do {
+    rect_packer = RectanglePacker::Create(current_size);
     auto remaining_pairs =
-        PairsFitInAtlasOfSize(pairs, current_size, glyph_positions);
+        AppendToRectPacker(pairs, *rect_packer, glyph_positions);
     if (remaining_pairs == 0) {
       return current_size;
     } else if (remaining_pairs < std::ceil(total_pairs / 2)) {
@@ -125,6 +125,7 @@ static ISize OptimumAtlasSizeForFontGlyphPairs(
     }
   } while (current_size.width <= kMaxAtlasSize &&
            current_size.height <= kMaxAtlasSize);
+  rect_packer.reset();
   return ISize{0, 0};
 }
 
@@ -243,6 +244,39 @@ static void ConvertBitmapToSignedDistanceField(uint8_t* pixels,
 #undef nearestpt
 }
 
+static void DrawGlyph(SkCanvas* canvas,
+                      const FontGlyphPair& font_glyph,
+                      const Rect& location,
+                      bool has_color) {
+  const auto& metrics = font_glyph.font.GetMetrics();
+  const auto position = SkPoint::Make(location.origin.x / metrics.scale,
+                                      location.origin.y / metrics.scale);
+  SkGlyphID glyph_id = font_glyph.glyph.index;
+
+  SkFont sk_font(
+      TypefaceSkia::Cast(*font_glyph.font.GetTypeface()).GetSkiaTypeface(),
+      metrics.point_size, metrics.scaleX, metrics.skewX);
+  sk_font.setEdging(SkFont::Edging::kAntiAlias);
+  sk_font.setHinting(SkFontHinting::kSlight);
+  sk_font.setEmbolden(metrics.embolden);
+
+  auto glyph_color = has_color ? SK_ColorWHITE : SK_ColorBLACK;
+
+  SkPaint glyph_paint;
+  glyph_paint.setColor(glyph_color);
+  canvas->resetMatrix();
+  canvas->scale(metrics.scale, metrics.scale);
+  canvas->drawGlyphs(
+      1u,         // count
+      &glyph_id,  // glyphs
+      &position,  // positions
+      SkPoint::Make(-font_glyph.glyph.bounds.GetLeft(),
+                    -font_glyph.glyph.bounds.GetTop()),  // origin
+      sk_font,                                           // font
+      glyph_paint                                        // paint
+  );
+}
+
 static std::shared_ptr<SkBitmap> CreateAtlasBitmap(const GlyphAtlas& atlas,
                                                    const ISize& atlas_size) {
   TRACE_EVENT0("impeller", __FUNCTION__);
@@ -263,6 +297,9 @@ static std::shared_ptr<SkBitmap> CreateAtlasBitmap(const GlyphAtlas& atlas,
   if (!bitmap->tryAllocPixels(image_info)) {
     return nullptr;
   }
+  // Glyphs appended later are drawn into the free space, which must not
+  // contain garbage when it is uploaded.
+  bitmap->eraseColor(SK_ColorTRANSPARENT);
   auto surface = SkSurface::MakeRasterDirect(bitmap->pixmap());
   if (!surface) {
     return nullptr;
@@ -276,39 +313,40 @@ static std::shared_ptr<SkBitmap> CreateAtlasBitmap(const GlyphAtlas& atlas,
 
   atlas.IterateGlyphs([canvas, has_color](const FontGlyphPair& font_glyph,
                                           const Rect& location) -> bool {
-    const auto& metrics = font_glyph.font.GetMetrics();
-    const auto position = SkPoint::Make(location.origin.x / metrics.scale,
-                                        location.origin.y / metrics.scale);
-    SkGlyphID glyph_id = font_glyph.glyph.index;
-
-    SkFont sk_font(
-        TypefaceSkia::Cast(*font_glyph.font.GetTypeface()).GetSkiaTypeface(),
-        metrics.point_size, metrics.scaleX, metrics.skewX);
-    sk_font.setEdging(SkFont::Edging::kAntiAlias);
-    sk_font.setHinting(SkFontHinting::kSlight);
-    sk_font.setEmbolden(metrics.embolden);
-
-    auto glyph_color = has_color ? SK_ColorWHITE : SK_ColorBLACK;
-
-    SkPaint glyph_paint;
-    glyph_paint.setColor(glyph_color);
-    canvas->resetMatrix();
-    canvas->scale(metrics.scale, metrics.scale);
-    canvas->drawGlyphs(
-        1u,         // count
-        &glyph_id,  // glyphs
-        &position,  // positions
-        SkPoint::Make(-font_glyph.glyph.bounds.GetLeft(),
-                      -font_glyph.glyph.bounds.GetTop()),  // origin
-        sk_font,                                           // font
-        glyph_paint                                        // paint
-    );
+    DrawGlyph(canvas, font_glyph, location, has_color);
     return true;
   });
 
   return bitmap;
 }
 
+static bool UpdateAtlasBitmap(const GlyphAtlas& atlas,
+                              const std::shared_ptr<SkBitmap>& bitmap,
+                              const FontGlyphPair::Vector& new_pairs) {
+  TRACE_EVENT0("impeller", __FUNCTION__);
+  FML_DCHECK(bitmap != nullptr);
+
+  auto surface = SkSurface::MakeRasterDirect(bitmap->pixmap());
+  if (!surface) {
+    return false;
+  }
+  auto canvas = surface->getCanvas();
+  if (!canvas) {
+    return false;
+  }
+
+  bool has_color = atlas.GetType() == GlyphAtlas::Type::kColorBitmap;
+
+  for (const auto& pair : new_pairs) {
+    auto location = atlas.FindFontGlyphPosition(pair);
+    if (!location.has_value()) {
+      return false;
+    }
+    DrawGlyph(canvas, pair, location.value(), has_color);
+  }
+  return true;
+}
+
 static std::shared_ptr<Texture> UploadGlyphTextureAtlas(
     const std::shared_ptr<Allocator>& allocator,
     std::shared_ptr<SkBitmap> bitmap,
@@ -350,6 +388,47 @@ static std::shared_ptr<Texture> UploadGlyphTextureAtlas(
   return texture;
 }
 
+static IRect ComputeDirtyRegion(const std::vector<Rect>& glyph_positions,
+                                const ISize& atlas_size) {
+  std::optional<Rect> dirty;
+  for (const auto& position : glyph_positions) {
+    dirty = dirty.has_value() ? dirty->Union(position) : position;
+  }
+  if (!dirty.has_value()) {
+    return {};
+  }
+  auto ltrb = dirty->GetLTRB();
+  return IRect::MakeLTRB(
+      std::max<int64_t>(0, std::floor(ltrb[0])),
+      std::max<int64_t>(0, std::floor(ltrb[1])),
+      std::min<int64_t>(atlas_size.width, std::ceil(ltrb[2])),
+      std::min<int64_t>(atlas_size.height, std::ceil(ltrb[3])));
+}
+
+static bool UpdateGlyphTextureAtlas(std::shared_ptr<SkBitmap> bitmap,
+                                    const std::shared_ptr<Texture>& texture,
+                                    const IRect& dirty_region) {
+  TRACE_EVENT0("impeller", __FUNCTION__);
+
+  FML_DCHECK(bitmap != nullptr);
+  if (texture->SetRegionContents(
+          reinterpret_cast<const uint8_t*>(
+              bitmap->getAddr(dirty_region.origin.x, dirty_region.origin.y)),
+          bitmap->rowBytes(), dirty_region)) {
+    return true;
+  }
+
+  // The backend can't update a region in place. Upload the whole bitmap
+  // instead, which still avoids rasterizing the existing glyphs again.
+  const auto& texture_descriptor = texture->GetTextureDescriptor();
+  auto mapping = std::make_shared<fml::NonOwnedMapping>(
+      reinterpret_cast<const uint8_t*>(bitmap->getAddr(0, 0)),  // data
+      texture_descriptor.GetByteSizeOfBaseMipLevel(),           // size
+      [bitmap](auto, auto) mutable { bitmap.reset(); }          // proc
+  );
+  return texture->SetContents(mapping);
+}
+
 std::shared_ptr<GlyphAtlas> TextRenderContextSkia::CreateGlyphAtlas(
     GlyphAtlas::Type type,
     std::shared_ptr<GlyphAtlasContext> atlas_context,
@@ -378,21 +457,61 @@ std::shared_ptr<GlyphAtlas> TextRenderContextSkia::CreateGlyphAtlas(
     return last_atlas;
   }
 
+  // ---------------------------------------------------------------------------
+  // Step 3: If the current atlas has room for the new font-glyph pairs, append
+  //         them. Only the new glyphs are rasterized and only the region they
+  //         occupy is uploaded. Existing glyphs never move, so work already
+  //         submitted against the atlas remains valid.
+  //
+  //         Signed distance fields are computed over the whole bitmap and are
+  //         always rebuilt.
+  // ---------------------------------------------------------------------------
+  if (last_atlas->GetType() == type &&
+      type != GlyphAtlas::Type::kSignedDistanceField &&
+      last_atlas->IsValid() && atlas_context->GetBitmap() &&
+      atlas_context->GetRectPacker()) {
+    auto new_pairs = last_atlas->GetMissingPairs(font_glyph_pairs);
+    std::vector<Rect> new_positions;
+    if (AppendToRectPacker(new_pairs, *atlas_context->GetRectPacker(),
+                           new_positions) == 0) {
+      for (size_t i = 0, count = new_positions.size(); i < count; i++) {
+        last_atlas->AddTypefaceGlyphPosition(new_pairs[i], new_positions[i]);
+      }
+      const auto& bitmap = atlas_context->GetBitmap();
+      if (!UpdateAtlasBitmap(*last_atlas, bitmap, new_pairs)) {
+        return nullptr;
+      }
+      if (!UpdateGlyphTextureAtlas(
+              bitmap, last_atlas->GetTexture(),
+              ComputeDirtyRegion(new_positions,
+                                 last_atlas->GetTexture()->GetSize()))) {
+        return nullptr;
+      }
+      return last_atlas;
+    }
+  }
+
+  // ---------------------------------------------------------------------------
+  // Step 4: The atlas is full or incompatible. Start a new one that only
+  //         contains the glyphs used by this frame, evicting the ones that
+  //         have gone unused.
+  // ---------------------------------------------------------------------------
   auto glyph_atlas = std::make_shared<GlyphAtlas>(type);
   atlas_context->UpdateGlyphAtlas(glyph_atlas);
 
   // ---------------------------------------------------------------------------
-  // Step 3: Get the optimum size of the texture atlas.
+  // Step 5: Get the optimum size of the texture atlas.
   // ---------------------------------------------------------------------------
   std::vector<Rect> glyph_positions;
-  const auto atlas_size =
-      OptimumAtlasSizeForFontGlyphPairs(font_glyph_pairs, glyph_positions);
+  std::shared_ptr<RectanglePacker> rect_packer;
+  const auto atlas_size = OptimumAtlasSizeForFontGlyphPairs(
+      font_glyph_pairs, glyph_positions, rect_packer);
   if (atlas_size.IsEmpty()) {
     return nullptr;
   }
 
   // ---------------------------------------------------------------------------
-  // Step 4: Find location of font-glyph pairs in the atlas. We have this from
+  // Step 6: Find location of font-glyph pairs in the atlas. We have this from
   // the last step. So no need to do create another rect packer. But just do a
   // sanity check of counts. This could also be just an assertion as only a
   // construction issue would cause such a failure.
@@ -402,7 +521,7 @@ std::shared_ptr<GlyphAtlas> TextRenderContextSkia::CreateGlyphAtlas(
   }
 
   // ---------------------------------------------------------------------------
-  // Step 5: Record the positions in the glyph atlas.
+  // Step 7: Record the positions in the glyph atlas.
   // ---------------------------------------------------------------------------
   for (size_t i = 0, count = glyph_positions.size(); i < count; i++) {
     glyph_atlas->AddTypefaceGlyphPosition(font_glyph_pairs[i],
@@ -410,7 +529,7 @@ std::shared_ptr<GlyphAtlas> TextRenderContextSkia::CreateGlyphAtlas(
   }
 
   // ---------------------------------------------------------------------------
-  // Step 6: Draw font-glyph pairs in the correct spot in the atlas.
+  // Step 8: Draw font-glyph pairs in the correct spot in the atlas.
   // ---------------------------------------------------------------------------
   auto bitmap = CreateAtlasBitmap(*glyph_atlas, atlas_size);
   if (!bitmap) {
@@ -418,7 +537,7 @@ std::shared_ptr<GlyphAtlas> TextRenderContextSkia::CreateGlyphAtlas(
   }
 
   // ---------------------------------------------------------------------------
-  // Step 7: Upload the atlas as a texture.
+  // Step 9: Upload the atlas as a texture.
   // ---------------------------------------------------------------------------
   PixelFormat format;
   switch (type) {
@@ -440,9 +559,14 @@ std::shared_ptr<GlyphAtlas> TextRenderContextSkia::CreateGlyphAtlas(
   }
 
   // ---------------------------------------------------------------------------
-  // Step 8: Record the texture in the glyph atlas.
+  // Step 10: Record the texture in the glyph atlas and keep the bitmap and the
+  //          packer around so that glyphs can be appended later.
   // ---------------------------------------------------------------------------
   glyph_atlas->SetTexture(std::move(texture));
+  if (type != GlyphAtlas::Type::kSignedDistanceField) {
+    atlas_context->UpdateAtlasStorage(std::move(bitmap),
+                                      std::move(rect_packer));
+  }
 
   return glyph_atlas;
 }
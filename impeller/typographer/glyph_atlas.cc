@@ -17,8 +17,26 @@ std::shared_ptr<GlyphAtlas> GlyphAtlasContext::GetGlyphAtlas() const {
   return atlas_;
 }
 
+const std::shared_ptr<SkBitmap>& GlyphAtlasContext::GetBitmap() const {
+  return bitmap_;
+}
+
+const std::shared_ptr<RectanglePacker>& GlyphAtlasContext::GetRectPacker()
+    const {
+  return rect_packer_;
+}
+
 void GlyphAtlasContext::UpdateGlyphAtlas(std::shared_ptr<GlyphAtlas> atlas) {
   atlas_ = std::move(atlas);
+  bitmap_.reset();
+  rect_packer_.reset();
+}
+
+void GlyphAtlasContext::UpdateAtlasStorage(
+    std::shared_ptr<SkBitmap> bitmap,
+    std::shared_ptr<RectanglePacker> rect_packer) {
+  bitmap_ = std::move(bitmap);
+  rect_packer_ = std::move(rect_packer);
 }
 
 GlyphAtlas::GlyphAtlas(Type type) : type_(type) {}
@@ -85,4 +103,15 @@ bool GlyphAtlas::HasSamePairs(const FontGlyphPair::Vector& new_glyphs) {
   return true;
 }
 
+FontGlyphPair::Vector GlyphAtlas::GetMissingPairs(
+    const FontGlyphPair::Vector& new_glyphs) const {
+  FontGlyphPair::Vector missing;
+  for (const auto& pair : new_glyphs) {
+    if (positions_.find(pair) == positions_.end()) {
+      missing.push_back(pair);
+    }
+  }
+  return missing;
+}
+
 }  // namespace impeller
@@ -14,6 +14,9 @@
 #include "impeller/renderer/pipeline.h"
 #include "impeller/renderer/texture.h"
 #include "impeller/typographer/font_glyph_pair.h"
+#include "impeller/typographer/rectangle_packer.h"
+
+class SkBitmap;
 
 namespace impeller {
 
@@ -126,6 +129,17 @@ class GlyphAtlas {
   ///
   bool HasSamePairs(const FontGlyphPair::Vector& new_glyphs);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Find the font-glyph pairs in the vector that are not in this
+  ///             atlas yet.
+  ///
+  /// @param[in]  new_glyphs  The full set of new glyphs
+  ///
+  /// @return     The pairs missing from this atlas.
+  ///
+  FontGlyphPair::Vector GetMissingPairs(
+      const FontGlyphPair::Vector& new_glyphs) const;
+
  private:
   const Type type_;
   std::shared_ptr<Texture> texture_;
@@ -142,6 +156,11 @@ class GlyphAtlas {
 //------------------------------------------------------------------------------
 /// @brief      A container for caching a glyph atlas across frames.
 ///
+///             Besides the atlas itself, the context holds on to the bitmap
+///             the atlas was rasterized into and the packer tracking its free
+///             space. This allows new glyphs to be appended to the atlas
+///             without rasterizing and uploading the existing ones again.
+///
 class GlyphAtlasContext {
  public:
   GlyphAtlasContext();
@@ -152,12 +171,28 @@ class GlyphAtlasContext {
   /// @brief      Retrieve the current glyph atlas.
   std::shared_ptr<GlyphAtlas> GetGlyphAtlas() const;
 
+  //----------------------------------------------------------------------------
+  /// @brief      Retrieve the bitmap the current atlas was rasterized into.
+  const std::shared_ptr<SkBitmap>& GetBitmap() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Retrieve the packer tracking the free space of the current
+  ///             atlas.
+  const std::shared_ptr<RectanglePacker>& GetRectPacker() const;
+
   //----------------------------------------------------------------------------
   /// @brief      Update the context with a newly constructed glyph atlas.
   void UpdateGlyphAtlas(std::shared_ptr<GlyphAtlas> atlas);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Update the bitmap and the packer backing the current atlas.
+  void UpdateAtlasStorage(std::shared_ptr<SkBitmap> bitmap,
+                          std::shared_ptr<RectanglePacker> rect_packer);
+
  private:
   std::shared_ptr<GlyphAtlas> atlas_;
+  std::shared_ptr<SkBitmap> bitmap_;
+  std::shared_ptr<RectanglePacker> rect_packer_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(GlyphAtlasContext);
 };
@@ -0,0 +1,133 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "impeller/typographer/rectangle_packer.h"
+
+#include <algorithm>
+#include <optional>
+
+namespace impeller {
+
+std::unique_ptr<RectanglePacker> RectanglePacker::Create(ISize size) {
+  if (size.IsEmpty()) {
+    return nullptr;
+  }
+  return std::unique_ptr<RectanglePacker>(new RectanglePacker(size));
+}
+
+RectanglePacker::RectanglePacker(ISize size) : size_(size) {
+  Reset();
+}
+
+RectanglePacker::~RectanglePacker() = default;
+
+void RectanglePacker::Reset() {
+  area_so_far_ = 0;
+  skyline_.clear();
+  skyline_.push_back(Segment{0, 0, size_.width});
+}
+
+ISize RectanglePacker::GetSize() const {
+  return size_;
+}
+
+Scalar RectanglePacker::GetPercentFull() const {
+  return area_so_far_ / static_cast<Scalar>(size_.Area());
+}
+
+bool RectanglePacker::AddRect(ISize size, IPoint* location) {
+  if (size.width <= 0 || size.height <= 0 || size.width > size_.width ||
+      size.height > size_.height) {
+    return false;
+  }
+
+  // Find the lowest position the rectangle fits at. Ties are broken in favor
+  // of the narrowest segment to keep wide gaps available for wide rectangles.
+  std::optional<size_t> best_index;
+  int64_t best_width = size_.width + 1;
+  int64_t best_x = 0;
+  int64_t best_y = size_.height + 1;
+  for (size_t i = 0; i < skyline_.size(); i++) {
+    int64_t y = 0;
+    if (!RectangleFits(i, size, &y)) {
+      continue;
+    }
+    if (y < best_y || (y == best_y && skyline_[i].width < best_width)) {
+      best_index = i;
+      best_width = skyline_[i].width;
+      best_x = skyline_[i].x;
+      best_y = y;
+    }
+  }
+
+  if (!best_index.has_value()) {
+    return false;
+  }
+
+  AddSkylineLevel(best_index.value(), {best_x, best_y}, size);
+  *location = {best_x, best_y};
+  area_so_far_ += size.Area();
+  return true;
+}
+
+bool RectanglePacker::RectangleFits(size_t index,
+                                    ISize size,
+                                    int64_t* y_position) const {
+  const auto x = skyline_[index].x;
+  if (x + size.width > size_.width) {
+    return false;
+  }
+
+  // The rectangle rests on the highest segment it spans.
+  int64_t width_left = size.width;
+  int64_t y = skyline_[index].y;
+  for (size_t i = index; width_left > 0; i++) {
+    if (i >= skyline_.size()) {
+      return false;
+    }
+    y = std::max(y, skyline_[i].y);
+    if (y + size.height > size_.height) {
+      return false;
+    }
+    width_left -= skyline_[i].width;
+  }
+
+  *y_position = y;
+  return true;
+}
+
+void RectanglePacker::AddSkylineLevel(size_t index,
+                                      IPoint location,
+                                      ISize size) {
+  skyline_.insert(skyline_.begin() + index,
+                  Segment{location.x, location.y + size.height, size.width});
+
+  // Shrink or remove the segments now covered by the new one.
+  for (size_t i = index + 1; i < skyline_.size();) {
+    const auto& previous = skyline_[i - 1];
+    const auto previous_end = previous.x + previous.width;
+    if (skyline_[i].x >= previous_end) {
+      break;
+    }
+    const auto shrink = previous_end - skyline_[i].x;
+    skyline_[i].x += shrink;
+    skyline_[i].width -= shrink;
+    if (skyline_[i].width > 0) {
+      break;
+    }
+    skyline_.erase(skyline_.begin() + i);
+  }
+
+  // Merge neighboring segments at the same height.
+  for (size_t i = 0; i + 1 < skyline_.size();) {
+    if (skyline_[i].y == skyline_[i + 1].y) {
+      skyline_[i].width += skyline_[i + 1].width;
+      skyline_.erase(skyline_.begin() + i + 1);
+    } else {
+      i++;
+    }
+  }
+}
+
+}  // namespace impeller
@@ -0,0 +1,83 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "flutter/fml/macros.h"
+#include "impeller/geometry/point.h"
+#include "impeller/geometry/scalar.h"
+#include "impeller/geometry/size.h"
+
+namespace impeller {
+
+//------------------------------------------------------------------------------
+/// @brief      Packs rectangles into a fixed size area using the skyline
+///             bottom-left heuristic.
+///
+///             The packer keeps its state between calls so that rectangles
+///             can be appended into the remaining free space of an area that
+///             has already been partially filled.
+///
+class RectanglePacker {
+ public:
+  //----------------------------------------------------------------------------
+  /// @brief      Create a packer for an area of the given size.
+  ///
+  static std::unique_ptr<RectanglePacker> Create(ISize size);
+
+  ~RectanglePacker();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Attempt to place a rectangle of the given size.
+  ///
+  /// @param[in]  size      The size of the rectangle.
+  /// @param[out] location  The location of the top-left corner of the
+  ///                       rectangle if it was placed.
+  ///
+  /// @return     If the rectangle was placed. The packer is not modified if
+  ///             there is no room for the rectangle.
+  ///
+  bool AddRect(ISize size, IPoint* location);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Remove all rectangles from the packer.
+  ///
+  void Reset();
+
+  //----------------------------------------------------------------------------
+  /// @brief      The size of the area rectangles are packed into.
+  ///
+  ISize GetSize() const;
+
+  //----------------------------------------------------------------------------
+  /// @brief      The fraction of the area covered by rectangles.
+  ///
+  Scalar GetPercentFull() const;
+
+ private:
+  // A horizontal segment of the skyline. Everything below the segment is
+  // considered occupied.
+  struct Segment {
+    int64_t x;
+    int64_t y;
+    int64_t width;
+  };
+
+  const ISize size_;
+  std::vector<Segment> skyline_;
+  int64_t area_so_far_ = 0;
+
+  explicit RectanglePacker(ISize size);
+
+  bool RectangleFits(size_t index, ISize size, int64_t* y) const;
+
+  void AddSkylineLevel(size_t index, IPoint location, ISize size);
+
+  FML_DISALLOW_COPY_AND_ASSIGN(RectanglePacker);
+};
+
+}  // namespace impeller
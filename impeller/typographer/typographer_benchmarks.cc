@@ -0,0 +1,137 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/benchmarking/benchmarking.h"
+
+#include <algorithm>
+#include <cstring>
+#include <optional>
+#include <vector>
+
+#include "impeller/geometry/rect.h"
+#include "impeller/typographer/rectangle_packer.h"
+
+namespace impeller {
+
+namespace {
+/// The size of an alpha glyph atlas, which has one byte per pixel.
+constexpr ISize kAtlasSize(1024, 1024);
+/// The padding added around each glyph in the atlas.
+constexpr int64_t kPadding = 2;
+/// The number of glyphs used by every frame.
+constexpr size_t kResidentGlyphCount = 512;
+
+/// Glyph sizes in the range of body text at common device pixel ratios.
+std::vector<ISize> CreateGlyphSizes(size_t count);
+
+/// Copies the rows of a region of the atlas bitmap into a staging buffer, the
+/// way backends that can't update a region of a texture in place do.
+void CopyRegion(const std::vector<uint8_t>& bitmap,
+                std::vector<uint8_t>& staging,
+                const IRect& region);
+}  // namespace
+
+// Appends the glyphs each frame adds to the glyph atlas and uploads the region
+// they occupy. When the atlas is full it is rebuilt from the glyphs of the
+// frame, as |TextRenderContextSkia::CreateGlyphAtlas| does.
+static void BM_GlyphAtlasAppend(benchmark::State& state) {
+  const size_t new_glyph_count = state.range(0);
+  auto glyph_sizes = CreateGlyphSizes(kResidentGlyphCount + 4096);
+  std::vector<uint8_t> bitmap(kAtlasSize.Area(), 0x7f);
+  std::vector<uint8_t> staging(kAtlasSize.Area());
+
+  auto packer = RectanglePacker::Create(kAtlasSize);
+  IPoint location;
+  for (size_t i = 0; i < kResidentGlyphCount; i++) {
+    packer->AddRect(glyph_sizes[i], &location);
+  }
+
+  size_t next_glyph = kResidentGlyphCount;
+  size_t rebuild_count = 0;
+  size_t uploaded_bytes = 0;
+  for (auto _ : state) {
+    std::optional<IRect> dirty;
+    for (size_t i = 0; i < new_glyph_count; i++) {
+      const auto& size = glyph_sizes[next_glyph];
+      next_glyph = next_glyph + 1 < glyph_sizes.size() ? next_glyph + 1
+                                                        : kResidentGlyphCount;
+      if (!packer->AddRect(size, &location)) {
+        // Start over with the glyphs of this frame.
+        rebuild_count++;
+        packer->Reset();
+        for (size_t j = 0; j < kResidentGlyphCount; j++) {
+          packer->AddRect(glyph_sizes[j], &location);
+        }
+        packer->AddRect(size, &location);
+        dirty = IRect::MakeSize(kAtlasSize);
+        continue;
+      }
+      auto rect = IRect(location, size);
+      dirty = dirty.has_value() ? dirty->Union(rect) : rect;
+    }
+    if (dirty.has_value()) {
+      CopyRegion(bitmap, staging, dirty.value());
+      uploaded_bytes += dirty->size.Area();
+    }
+    benchmark::DoNotOptimize(staging.data());
+  }
+  state.counters["Rebuilds"] = rebuild_count;
+  state.counters["UploadedBytesPerFrame"] =
+      benchmark::Counter(uploaded_bytes, benchmark::Counter::kAvgIterations);
+}
+
+// Packs all of the glyphs of each frame into a new atlas and uploads all of it,
+// which is what adding a glyph to the atlas cost before glyphs were appended.
+static void BM_GlyphAtlasRebuild(benchmark::State& state) {
+  const size_t new_glyph_count = state.range(0);
+  auto glyph_sizes = CreateGlyphSizes(kResidentGlyphCount + new_glyph_count);
+  std::vector<uint8_t> bitmap(kAtlasSize.Area(), 0x7f);
+  std::vector<uint8_t> staging(kAtlasSize.Area());
+
+  auto packer = RectanglePacker::Create(kAtlasSize);
+  IPoint location;
+  size_t uploaded_bytes = 0;
+  for (auto _ : state) {
+    packer->Reset();
+    for (const auto& size : glyph_sizes) {
+      packer->AddRect(size, &location);
+    }
+    CopyRegion(bitmap, staging, IRect::MakeSize(kAtlasSize));
+    uploaded_bytes += kAtlasSize.Area();
+    benchmark::DoNotOptimize(staging.data());
+  }
+  state.counters["UploadedBytesPerFrame"] =
+      benchmark::Counter(uploaded_bytes, benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_GlyphAtlasAppend)->Arg(1)->Arg(16)->Arg(128);
+BENCHMARK(BM_GlyphAtlasRebuild)->Arg(1)->Arg(16)->Arg(128);
+
+namespace {
+std::vector<ISize> CreateGlyphSizes(size_t count) {
+  std::vector<ISize> sizes;
+  sizes.reserve(count);
+  uint32_t seed = 1u;
+  for (size_t i = 0; i < count; i++) {
+    // A linear congruential generator keeps the sizes stable across runs.
+    seed = seed * 1664525u + 1013904223u;
+    sizes.emplace_back(6 + (seed >> 8) % 19 + kPadding,
+                       10 + (seed >> 16) % 19 + kPadding);
+  }
+  return sizes;
+}
+
+void CopyRegion(const std::vector<uint8_t>& bitmap,
+                std::vector<uint8_t>& staging,
+                const IRect& region) {
+  const size_t row_bytes = kAtlasSize.width;
+  for (int64_t row = region.origin.y; row < region.GetBottom(); row++) {
+    const size_t offset = row * row_bytes + region.origin.x;
+    ::memcpy(staging.data() + offset, bitmap.data() + offset,
+             region.size.width);
+  }
+}
+}  // namespace
+
+}  // namespace impeller
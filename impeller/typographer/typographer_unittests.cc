@@ -7,6 +7,7 @@
 #include "impeller/typographer/backends/skia/text_frame_skia.h"
 #include "impeller/typographer/backends/skia/text_render_context_skia.h"
 #include "impeller/typographer/lazy_glyph_atlas.h"
+#include "impeller/typographer/rectangle_packer.h"
 #include "third_party/skia/include/core/SkData.h"
 #include "third_party/skia/include/core/SkTextBlob.h"
 
@@ -168,5 +169,74 @@ TEST_P(TypographerTest, GlyphAtlasWithLotsOfdUniqueGlyphSize) {
             atlas->GetTexture()->GetSize().height);
 }
 
+TEST_P(TypographerTest, GlyphAtlasAppendsNewGlyphsInPlace) {
+  auto context = TextRenderContext::Create(GetContext());
+  auto atlas_context = std::make_shared<GlyphAtlasContext>();
+  ASSERT_TRUE(context && context->IsValid());
+  SkFont sk_font;
+
+  // A single glyph is packed into the smallest atlas that fits it, which
+  // leaves room for a period next to it.
+  auto atlas = context->CreateGlyphAtlas(
+      GlyphAtlas::Type::kAlphaBitmap, atlas_context,
+      TextFrameFromTextBlob(SkTextBlob::MakeFromString("A", sk_font)));
+  ASSERT_NE(atlas, nullptr);
+  ASSERT_NE(atlas->GetTexture(), nullptr);
+  auto texture = atlas->GetTexture();
+  auto glyph_count = atlas->GetGlyphCount();
+
+  auto next_atlas = context->CreateGlyphAtlas(
+      GlyphAtlas::Type::kAlphaBitmap, atlas_context,
+      TextFrameFromTextBlob(SkTextBlob::MakeFromString("A.", sk_font)));
+  ASSERT_NE(next_atlas, nullptr);
+
+  // The new glyph went into the free space of the same atlas and texture.
+  ASSERT_EQ(next_atlas, atlas);
+  ASSERT_EQ(next_atlas->GetTexture(), texture);
+  ASSERT_EQ(next_atlas->GetGlyphCount(), glyph_count + 1);
+}
+
+TEST(RectanglePackerTest, PacksWithoutOverlap) {
+  auto packer = RectanglePacker::Create({64, 64});
+  ASSERT_NE(packer, nullptr);
+
+  std::vector<IRect> placed;
+  IPoint location;
+  while (packer->AddRect({10, 7}, &location)) {
+    auto rect = IRect::MakeXYWH(location.x, location.y, 10, 7);
+    ASSERT_TRUE(IRect::MakeSize(ISize{64, 64}).Contains(rect));
+    for (const auto& other : placed) {
+      ASSERT_FALSE(rect.IntersectsWithRect(other));
+    }
+    placed.push_back(rect);
+  }
+
+  // 6 columns of 9 rows fit in 64x64.
+  ASSERT_EQ(placed.size(), 54u);
+  ASSERT_GT(packer->GetPercentFull(), 0.9);
+}
+
+TEST(RectanglePackerTest, AppendsIntoRemainingSpace) {
+  auto packer = RectanglePacker::Create({32, 32});
+  ASSERT_NE(packer, nullptr);
+
+  IPoint location;
+  ASSERT_TRUE(packer->AddRect({32, 16}, &location));
+  ASSERT_EQ(location, IPoint(0, 0));
+
+  // Too large for what is left. This must not disturb the packer.
+  ASSERT_FALSE(packer->AddRect({32, 17}, &location));
+
+  ASSERT_TRUE(packer->AddRect({16, 16}, &location));
+  ASSERT_EQ(location, IPoint(0, 16));
+  ASSERT_TRUE(packer->AddRect({16, 16}, &location));
+  ASSERT_EQ(location, IPoint(16, 16));
+  ASSERT_FALSE(packer->AddRect({1, 1}, &location));
+
+  packer->Reset();
+  ASSERT_EQ(packer->GetPercentFull(), 0.0);
+  ASSERT_TRUE(packer->AddRect({32, 32}, &location));
+}
+
 }  // namespace testing
 }  // namespace impeller
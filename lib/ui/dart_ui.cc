@@ -198,6 +198,7 @@ typedef CanvasPath Path;
   V(ImageShader, dispose, 1)                           \
   V(ImageShader, initWithImage, 6)                     \
   V(ImmutableBuffer, dispose, 1)                       \
+  V(ImmutableBuffer, getRange, 3)                      \
   V(ImmutableBuffer, length, 1)                        \
   V(ParagraphBuilder, addPlaceholder, 6)               \
   V(ParagraphBuilder, addText, 2)                      \
@@ -216,6 +217,7 @@ typedef CanvasPath Path;
   V(Paragraph, height, 1)                              \
   V(Paragraph, ideographicBaseline, 1)                 \
   V(Paragraph, layout, 2)                              \
+  V(Paragraph, layoutAsync, 3)                         \
   V(Paragraph, longestLine, 1)                         \
   V(Paragraph, maxIntrinsicWidth, 1)                   \
   V(Paragraph, minIntrinsicWidth, 1)                   \
@@ -6190,8 +6190,32 @@ class ImmutableBuffer extends NativeFieldWrapperClass1 {
   int get length => _length;
   int _length;
 
+  /// Copies `length` bytes starting at `offset` out of the buffer.
+  ///
+  /// Buffers created with [fromAsset] from assets that are stored
+  /// uncompressed reference the asset file instead of a copy of it, and
+  /// reading a range only reads that part of the file. This allows large
+  /// assets to be read in chunks without loading them into memory.
+  ///
+  /// Throws a [RangeError] if the range is not within the buffer, and a
+  /// [StateError] if the buffer has been disposed.
+  Uint8List getRange(int offset, int length) {
+    if (_disposed) {
+      throw StateError('ImmutableBuffer.getRange called after dispose.');
+    }
+    RangeError.checkValidRange(offset, offset + length, _length);
+    return _getRange(offset, length);
+  }
+
+  @FfiNative<Handle Function(Pointer<Void>, Int64, Int64)>('ImmutableBuffer::getRange')
+  external Uint8List _getRange(int offset, int length);
+
   bool _debugDisposed = false;
 
+  // Set by [dispose] in all build modes, since [getRange] must not reach the
+  // native method once the native object is gone.
+  bool _disposed = false;
+
   /// Whether [dispose] has been called.
   ///
   /// This must only be used when asserts are enabled. Otherwise, it will throw.
@@ -6219,6 +6243,7 @@ class ImmutableBuffer extends NativeFieldWrapperClass1 {
       _debugDisposed = true;
       return true;
     }());
+    _disposed = true;
     _dispose();
   }
 
@@ -0,0 +1,155 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/image_decode_cache.h"
+
+#include <string_view>
+
+#include "flutter/fml/hash_combine.h"
+#include "flutter/fml/trace_event.h"
+#include "flutter/lib/ui/painting/image_descriptor.h"
+
+namespace flutter {
+
+static constexpr size_t kMegaByteSizeInBytes = (1 << 20);
+
+ImageDecodeCacheKey ImageDecodeCacheKey::Make(const ImageDescriptor& descriptor,
+                                              uint64_t content_hash,
+                                              uint32_t target_width,
+                                              uint32_t target_height) {
+  ImageDecodeCacheKey key;
+  key.content_hash = content_hash;
+  key.data = descriptor.data();
+  key.width = descriptor.width();
+  key.height = descriptor.height();
+  key.row_bytes = descriptor.row_bytes();
+  key.color_type = static_cast<int32_t>(descriptor.image_info().colorType());
+  key.is_compressed = descriptor.is_compressed();
+  key.target_width = target_width;
+  key.target_height = target_height;
+  return key;
+}
+
+uint64_t ImageDecodeCacheKey::HashContents(const SkData& data) {
+  TRACE_EVENT0("flutter", "ImageDecodeCacheKey::HashContents");
+  return std::hash<std::string_view>{}(std::string_view(
+      static_cast<const char*>(data.data()), data.size()));
+}
+
+std::size_t ImageDecodeCacheKey::Hash::operator()(
+    const ImageDecodeCacheKey& key) const {
+  return fml::HashCombine(key.content_hash, key.width, key.height,
+                          key.row_bytes, key.color_type, key.is_compressed,
+                          key.target_width, key.target_height);
+}
+
+bool ImageDecodeCacheKey::operator==(const ImageDecodeCacheKey& other) const {
+  if (content_hash != other.content_hash || width != other.width ||
+      height != other.height || row_bytes != other.row_bytes ||
+      color_type != other.color_type ||
+      is_compressed != other.is_compressed ||
+      target_width != other.target_width ||
+      target_height != other.target_height) {
+    return false;
+  }
+  // Matching hashes are only a hint. Compare the bytes unless both keys refer
+  // to the same data.
+  if (data == other.data) {
+    return true;
+  }
+  return data && other.data && data->equals(other.data.get());
+}
+
+ImageDecodeCache::ImageDecodeCache(size_t max_bytes) : max_bytes_(max_bytes) {}
+
+ImageDecodeCache::~ImageDecodeCache() = default;
+
+sk_sp<DlImage> ImageDecodeCache::Get(const ImageDecodeCacheKey& key) {
+  auto found = entries_.find(key);
+  if (found == entries_.end()) {
+    miss_count_++;
+    TraceStatsToTimeline();
+    return nullptr;
+  }
+  hit_count_++;
+  lru_.splice(lru_.begin(), lru_, found->second);
+  TraceStatsToTimeline();
+  return found->second->image;
+}
+
+bool ImageDecodeCache::AddPendingRequest(const ImageDecodeCacheKey& key,
+                                         Callback callback) {
+  auto& callbacks = pending_[key];
+  callbacks.push_back(std::move(callback));
+  if (callbacks.size() > 1) {
+    coalesced_count_++;
+    TraceStatsToTimeline();
+    return false;
+  }
+  return true;
+}
+
+void ImageDecodeCache::Complete(const ImageDecodeCacheKey& key,
+                                const sk_sp<DlImage>& image) {
+  std::vector<Callback> callbacks;
+  auto found = pending_.find(key);
+  if (found != pending_.end()) {
+    callbacks = std::move(found->second);
+    pending_.erase(found);
+  }
+
+  // Failed decodes are not cached so that later requests may retry them.
+  if (image && !image->get_error().has_value() && entries_.count(key) == 0) {
+    // The key retains the encoded data, so it counts against the budget too.
+    const size_t bytes =
+        image->GetApproximateByteSize() + (key.data ? key.data->size() : 0u);
+    if (bytes <= max_bytes_) {
+      EvictToBudget(max_bytes_ - bytes);
+      lru_.push_front({key, image, bytes});
+      entries_[key] = lru_.begin();
+      current_bytes_ += bytes;
+    }
+  }
+  TraceStatsToTimeline();
+
+  // Callbacks may make new decode requests and must be invoked only after the
+  // cache is in a consistent state.
+  for (const auto& callback : callbacks) {
+    callback(image);
+  }
+}
+
+void ImageDecodeCache::SetMaxBytes(size_t max_bytes) {
+  max_bytes_ = max_bytes;
+  EvictToBudget(max_bytes_);
+  TraceStatsToTimeline();
+}
+
+void ImageDecodeCache::Purge() {
+  EvictToBudget(0u);
+  TraceStatsToTimeline();
+}
+
+void ImageDecodeCache::EvictToBudget(size_t max_bytes) {
+  while (current_bytes_ > max_bytes && !lru_.empty()) {
+    const auto& entry = lru_.back();
+    current_bytes_ -= entry.bytes;
+    entries_.erase(entry.key);
+    lru_.pop_back();
+  }
+}
+
+void ImageDecodeCache::TraceStatsToTimeline() const {
+#if !FLUTTER_RELEASE
+  FML_TRACE_COUNTER("flutter",                                          //
+                    "ImageDecodeCache", reinterpret_cast<int64_t>(this),  //
+                    "Hits", hit_count_,                                 //
+                    "Misses", miss_count_,                              //
+                    "Coalesced", coalesced_count_,                      //
+                    "ImageCount", entries_.size(),                      //
+                    "MBytes", current_bytes_ / kMegaByteSizeInBytes);
+#endif  // !FLUTTER_RELEASE
+}
+
+}  // namespace flutter
@@ -0,0 +1,163 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_IMAGE_DECODE_CACHE_H_
+#define FLUTTER_LIB_UI_PAINTING_IMAGE_DECODE_CACHE_H_
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "flutter/display_list/display_list_image.h"
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkData.h"
+
+namespace flutter {
+
+class ImageDescriptor;
+
+//------------------------------------------------------------------------------
+/// @brief      Identifies the result of decoding the contents of an image
+///             descriptor at a specific target size.
+///
+///             Keys with the same content hash are only equal if their data
+///             has the same bytes, so a hash collision is never mistaken for
+///             a hit.
+///
+struct ImageDecodeCacheKey {
+  uint64_t content_hash = 0;
+  sk_sp<SkData> data;
+  int32_t width = 0;
+  int32_t height = 0;
+  int32_t row_bytes = 0;
+  int32_t color_type = 0;
+  bool is_compressed = false;
+  uint32_t target_width = 0;
+  uint32_t target_height = 0;
+
+  //----------------------------------------------------------------------------
+  /// @brief      Makes the key for a descriptor whose data hashes to
+  ///             |content_hash|, as computed by |HashContents|.
+  ///
+  static ImageDecodeCacheKey Make(const ImageDescriptor& descriptor,
+                                  uint64_t content_hash,
+                                  uint32_t target_width,
+                                  uint32_t target_height);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Hashes the bytes of |data|. This reads all of the data, so
+  ///             it should not be called on the UI thread.
+  ///
+  static uint64_t HashContents(const SkData& data);
+
+  struct Hash {
+    std::size_t operator()(const ImageDecodeCacheKey& key) const;
+  };
+
+  bool operator==(const ImageDecodeCacheKey& other) const;
+};
+
+//------------------------------------------------------------------------------
+/// @brief      A byte budgeted, least recently used cache of decoded images
+///             that also coalesces requests for images that are still being
+///             decoded.
+///
+///             Only the first request for a key that is neither cached nor
+///             pending needs to decode the image. Every other request for
+///             the same key is serviced when that decode completes.
+///
+///             This object is not thread safe and must only be accessed on
+///             the UI task runner, which is where image decode requests are
+///             made and where their results are delivered.
+///
+class ImageDecodeCache {
+ public:
+  using Callback = std::function<void(sk_sp<DlImage>)>;
+
+  explicit ImageDecodeCache(size_t max_bytes = 0);
+
+  ~ImageDecodeCache();
+
+  //----------------------------------------------------------------------------
+  /// @brief      Looks up a decoded image and marks it as recently used.
+  ///
+  /// @return     The decoded image or null if there is no such image in the
+  ///             cache.
+  ///
+  sk_sp<DlImage> Get(const ImageDecodeCacheKey& key);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Records a request for an image that is not in the cache.
+  ///
+  /// @return     True if this is the first pending request for the key and
+  ///             the caller must decode the image and report the result via
+  ///             |Complete|. False if the request was attached to a decode
+  ///             that is already in flight.
+  ///
+  bool AddPendingRequest(const ImageDecodeCacheKey& key, Callback callback);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Stores the result of a decode started after a call to
+  ///             |AddPendingRequest| and services all pending requests for
+  ///             the key. Failed decodes are reported but not cached.
+  ///
+  void Complete(const ImageDecodeCacheKey& key, const sk_sp<DlImage>& image);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Updates the byte budget of the cache, evicting the least
+  ///             recently used images if necessary. A budget of zero
+  ///             disables caching but still coalesces pending requests.
+  ///
+  void SetMaxBytes(size_t max_bytes);
+
+  size_t GetMaxBytes() const { return max_bytes_; }
+
+  size_t GetCurrentBytes() const { return current_bytes_; }
+
+  size_t GetImageCount() const { return entries_.size(); }
+
+  size_t GetPendingCount() const { return pending_.size(); }
+
+  //----------------------------------------------------------------------------
+  /// @brief      Drops all cached images. Pending requests are unaffected.
+  ///
+  void Purge();
+
+ private:
+  struct Entry {
+    ImageDecodeCacheKey key;
+    sk_sp<DlImage> image;
+    size_t bytes = 0;
+  };
+
+  using EntryList = std::list<Entry>;
+
+  size_t max_bytes_ = 0;
+  size_t current_bytes_ = 0;
+  size_t hit_count_ = 0;
+  size_t miss_count_ = 0;
+  size_t coalesced_count_ = 0;
+  // Most recently used entries are at the front.
+  EntryList lru_;
+  std::unordered_map<ImageDecodeCacheKey,
+                     EntryList::iterator,
+                     ImageDecodeCacheKey::Hash>
+      entries_;
+  std::unordered_map<ImageDecodeCacheKey,
+                     std::vector<Callback>,
+                     ImageDecodeCacheKey::Hash>
+      pending_;
+
+  void EvictToBudget(size_t max_bytes);
+
+  void TraceStatsToTimeline() const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(ImageDecodeCache);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_IMAGE_DECODE_CACHE_H_
@@ -0,0 +1,121 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/image_decode_cache.h"
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkImage.h"
+
+namespace flutter {
+namespace testing {
+
+static sk_sp<DlImage> MakeRasterImage(int width, int height) {
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(width, height);
+  bitmap.eraseColor(SK_ColorRED);
+  bitmap.setImmutable();
+  return DlImage::Make(SkImage::MakeFromBitmap(bitmap));
+}
+
+static ImageDecodeCacheKey MakeKey(uint64_t content_hash) {
+  ImageDecodeCacheKey key;
+  key.content_hash = content_hash;
+  key.width = 10;
+  key.height = 10;
+  key.target_width = 10;
+  key.target_height = 10;
+  return key;
+}
+
+TEST(ImageDecodeCacheTest, CoalescesPendingRequests) {
+  ImageDecodeCache cache(1024 * 1024);
+  auto key = MakeKey(1);
+  auto image = MakeRasterImage(10, 10);
+
+  size_t callback_count = 0;
+  auto callback = [&](const sk_sp<DlImage>& result) {
+    ASSERT_EQ(result, image);
+    callback_count++;
+  };
+
+  ASSERT_EQ(cache.Get(key), nullptr);
+  ASSERT_TRUE(cache.AddPendingRequest(key, callback));
+  ASSERT_FALSE(cache.AddPendingRequest(key, callback));
+  ASSERT_FALSE(cache.AddPendingRequest(key, callback));
+  ASSERT_EQ(cache.GetPendingCount(), 1u);
+
+  cache.Complete(key, image);
+  ASSERT_EQ(callback_count, 3u);
+  ASSERT_EQ(cache.GetPendingCount(), 0u);
+  ASSERT_EQ(cache.Get(key), image);
+}
+
+TEST(ImageDecodeCacheTest, FailedDecodesAreNotCached) {
+  ImageDecodeCache cache(1024 * 1024);
+  auto key = MakeKey(1);
+
+  bool called = false;
+  ASSERT_TRUE(cache.AddPendingRequest(
+      key, [&](const sk_sp<DlImage>& result) { called = !result; }));
+  cache.Complete(key, nullptr);
+
+  ASSERT_TRUE(called);
+  ASSERT_EQ(cache.GetImageCount(), 0u);
+  ASSERT_TRUE(cache.AddPendingRequest(key, [](const sk_sp<DlImage>&) {}));
+}
+
+TEST(ImageDecodeCacheTest, EvictsLeastRecentlyUsedImagesToStayInBudget) {
+  auto image_bytes = MakeRasterImage(10, 10)->GetApproximateByteSize();
+  ImageDecodeCache cache(image_bytes * 2);
+  auto noop = [](const sk_sp<DlImage>&) {};
+
+  for (uint64_t i = 1; i <= 2; i++) {
+    ASSERT_TRUE(cache.AddPendingRequest(MakeKey(i), noop));
+    cache.Complete(MakeKey(i), MakeRasterImage(10, 10));
+  }
+  ASSERT_EQ(cache.GetImageCount(), 2u);
+  ASSERT_EQ(cache.GetCurrentBytes(), image_bytes * 2);
+
+  // Touch the first image so that the second one is evicted next.
+  ASSERT_NE(cache.Get(MakeKey(1)), nullptr);
+
+  ASSERT_TRUE(cache.AddPendingRequest(MakeKey(3), noop));
+  cache.Complete(MakeKey(3), MakeRasterImage(10, 10));
+  ASSERT_EQ(cache.GetImageCount(), 2u);
+  ASSERT_NE(cache.Get(MakeKey(1)), nullptr);
+  ASSERT_EQ(cache.Get(MakeKey(2)), nullptr);
+  ASSERT_NE(cache.Get(MakeKey(3)), nullptr);
+
+  cache.SetMaxBytes(image_bytes);
+  ASSERT_EQ(cache.GetImageCount(), 1u);
+  ASSERT_NE(cache.Get(MakeKey(3)), nullptr);
+
+  cache.Purge();
+  ASSERT_EQ(cache.GetImageCount(), 0u);
+  ASSERT_EQ(cache.GetCurrentBytes(), 0u);
+}
+
+TEST(ImageDecodeCacheTest, HashCollisionsAreNotHits) {
+  ImageDecodeCache cache(1024 * 1024);
+  const char bytes_a[] = "first image";
+  const char bytes_b[] = "other image";
+  auto key_a = MakeKey(1);
+  key_a.data = SkData::MakeWithCopy(bytes_a, sizeof(bytes_a));
+  auto key_b = MakeKey(1);
+  key_b.data = SkData::MakeWithCopy(bytes_b, sizeof(bytes_b));
+  auto key_a_copy = MakeKey(1);
+  key_a_copy.data = SkData::MakeWithCopy(bytes_a, sizeof(bytes_a));
+
+  auto image = MakeRasterImage(10, 10);
+  ASSERT_TRUE(cache.AddPendingRequest(key_a, [](const sk_sp<DlImage>&) {}));
+  cache.Complete(key_a, image);
+
+  ASSERT_EQ(cache.Get(key_b), nullptr);
+  ASSERT_EQ(cache.Get(key_a_copy), image);
+  ASSERT_EQ(cache.GetCurrentBytes(),
+            image->GetApproximateByteSize() + sizeof(bytes_a));
+}
+
+}  // namespace testing
+}  // namespace flutter
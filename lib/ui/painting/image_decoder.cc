@@ -12,6 +12,10 @@
 
 namespace flutter {
 
+// JPEG decoders can produce an image at one eighth of its size with little
+// more than the entropy decoding work.
+static constexpr float kPreviewScale = 1.0f / 8.0f;
+
 std::unique_ptr<ImageDecoder> ImageDecoder::Make(
     const Settings& settings,
     const TaskRunners& runners,
@@ -40,6 +44,7 @@ ImageDecoder::ImageDecoder(
     : runners_(runners),
       concurrent_task_runner_(std::move(concurrent_task_runner)),
       io_manager_(std::move(io_manager)),
+      decode_cache_(std::make_shared<ImageDecodeCache>()),
       weak_factory_(this) {
   FML_DCHECK(runners_.IsValid());
   FML_DCHECK(runners_.GetUITaskRunner()->RunsTasksOnCurrentThread())
@@ -48,6 +53,133 @@ ImageDecoder::ImageDecoder(
 
 ImageDecoder::~ImageDecoder() = default;
 
+void ImageDecoder::Decode(fml::RefPtr<ImageDescriptor> descriptor,
+                          uint32_t target_width,
+                          uint32_t target_height,
+                          const ImageResult& result) {
+  FML_DCHECK(descriptor);
+  FML_DCHECK(result);
+  FML_DCHECK(runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+
+  // Let the backend report the error for descriptors without any data.
+  if (!descriptor->data() || descriptor->data()->size() == 0) {
+    DecodeImage(std::move(descriptor), target_width, target_height, result);
+    return;
+  }
+
+  // Without a cache budget, results are never reused, so there is no point in
+  // hashing the data to find identical requests.
+  if (decode_cache_->GetMaxBytes() == 0u) {
+    DecodeImage(std::move(descriptor), target_width, target_height, result);
+    return;
+  }
+
+  if (auto content_hash = descriptor->content_hash()) {
+    DecodeWithCache(std::move(descriptor), content_hash.value(), target_width,
+                    target_height, result);
+    return;
+  }
+
+  // Hashing reads all of the encoded data, which may be large and not yet
+  // paged in, so it is done on a worker. The descriptor has a Dart peer and
+  // must be released on the UI thread, see |ImageDecoderSkia::DecodeImage|.
+  auto raw_descriptor = descriptor.get();
+  raw_descriptor->AddRef();
+  concurrent_task_runner_->PostTask(
+      [raw_descriptor, data = raw_descriptor->data(), target_width,
+       target_height, result, decoder = weak_factory_.GetWeakPtr(),
+       ui_runner = runners_.GetUITaskRunner()]() {
+        const uint64_t content_hash = ImageDecodeCacheKey::HashContents(*data);
+        ui_runner->PostTask([raw_descriptor, content_hash, target_width,
+                             target_height, result, decoder]() {
+          fml::RefPtr<ImageDescriptor> descriptor(raw_descriptor);
+          raw_descriptor->Release();
+          descriptor->set_content_hash(content_hash);
+          if (!decoder) {
+            result(nullptr);
+            return;
+          }
+          decoder->DecodeWithCache(std::move(descriptor), content_hash,
+                                   target_width, target_height, result);
+        });
+      });
+}
+
+void ImageDecoder::DecodeWithCache(fml::RefPtr<ImageDescriptor> descriptor,
+                                   uint64_t content_hash,
+                                   uint32_t target_width,
+                                   uint32_t target_height,
+                                   const ImageResult& result) {
+  const auto key = ImageDecodeCacheKey::Make(*descriptor, content_hash,
+                                             target_width, target_height);
+
+  if (auto image = decode_cache_->Get(key)) {
+    // Callers expect the result to be delivered asynchronously.
+    runners_.GetUITaskRunner()->PostTask(
+        [result, image = std::move(image)]() { result(image); });
+    return;
+  }
+
+  if (!decode_cache_->AddPendingRequest(key, result)) {
+    return;
+  }
+
+  DecodeImage(std::move(descriptor), target_width, target_height,
+              [cache = decode_cache_, key](sk_sp<DlImage> image) {
+                cache->Complete(key, image);
+              });
+}
+
+void ImageDecoder::DecodeWithPreview(fml::RefPtr<ImageDescriptor> descriptor,
+                                     uint32_t target_width,
+                                     uint32_t target_height,
+                                     const ImageResult& preview,
+                                     const ImageResult& result) {
+  FML_DCHECK(descriptor);
+  FML_DCHECK(preview);
+  FML_DCHECK(runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+
+  const SkISize target_size =
+      target_width > 0 && target_height > 0
+          ? SkISize::Make(target_width, target_height)
+          : SkISize::Make(descriptor->width(), descriptor->height());
+  const SkISize preview_size =
+      descriptor->is_compressed()
+          ? descriptor->get_scaled_dimensions(kPreviewScale)
+          : target_size;
+
+  // Only bother with a preview if it is much smaller than the final image.
+  if (preview_size.isEmpty() ||
+      preview_size.area() * 4 > static_cast<int64_t>(target_size.area())) {
+    Decode(std::move(descriptor), target_width, target_height, result);
+    return;
+  }
+
+  // Both callbacks are invoked on the UI thread.
+  auto final_delivered = std::make_shared<bool>(false);
+  Decode(descriptor, preview_size.width(), preview_size.height(),
+         [preview, final_delivered](sk_sp<DlImage> image) {
+           if (image && !*final_delivered) {
+             preview(std::move(image));
+           }
+         });
+  Decode(std::move(descriptor), target_width, target_height,
+         [result, final_delivered](sk_sp<DlImage> image) {
+           *final_delivered = true;
+           result(std::move(image));
+         });
+}
+
+void ImageDecoder::SetDecodeCacheMaxBytes(size_t max_bytes) {
+  FML_DCHECK(runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+  decode_cache_->SetMaxBytes(max_bytes);
+}
+
+void ImageDecoder::PurgeDecodeCache() {
+  FML_DCHECK(runners_.GetUITaskRunner()->RunsTasksOnCurrentThread());
+  decode_cache_->Purge();
+}
+
 fml::WeakPtr<ImageDecoder> ImageDecoder::GetWeakPtr() const {
   return weak_factory_.GetWeakPtr();
 }
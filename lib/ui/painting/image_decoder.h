@@ -12,6 +12,7 @@
 #include "flutter/display_list/display_list_image.h"
 #include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/lib/ui/io_manager.h"
+#include "flutter/lib/ui/painting/image_decode_cache.h"
 #include "flutter/lib/ui/painting/image_descriptor.h"
 
 namespace flutter {
@@ -38,10 +39,36 @@ class ImageDecoder {
   // concurrently. Texture upload is done on the IO thread and the result
   // returned back on the UI thread. On error, the texture is null but the
   // callback is guaranteed to return on the UI thread.
-  virtual void Decode(fml::RefPtr<ImageDescriptor> descriptor,
-                      uint32_t target_width,
-                      uint32_t target_height,
-                      const ImageResult& result) = 0;
+  //
+  // While the decode cache has a budget, requests for the contents of a
+  // descriptor at a size that was recently decoded are serviced from the
+  // cache, and requests that match a decode that is still in flight wait for
+  // its result instead of decoding again. The contents are hashed on a worker
+  // the first time a descriptor is decoded.
+  void Decode(fml::RefPtr<ImageDescriptor> descriptor,
+              uint32_t target_width,
+              uint32_t target_height,
+              const ImageResult& result);
+
+  // Like |Decode|, but first delivers a low resolution preview of the image to
+  // |preview| if the codec can produce one much more cheaply than the final
+  // image, for example by using the scaled IDCT of a JPEG decoder. The preview
+  // is never delivered after the final image and is skipped if it cannot be
+  // decoded. |result| is always invoked exactly once.
+  void DecodeWithPreview(fml::RefPtr<ImageDescriptor> descriptor,
+                         uint32_t target_width,
+                         uint32_t target_height,
+                         const ImageResult& preview,
+                         const ImageResult& result);
+
+  // Updates the byte budget of the decoded image cache. A budget of zero
+  // disables caching of decoded images and coalescing of identical requests.
+  void SetDecodeCacheMaxBytes(size_t max_bytes);
+
+  // Drops all decoded images held by the cache.
+  void PurgeDecodeCache();
+
+  const ImageDecodeCache& GetDecodeCache() const { return *decode_cache_; }
 
   fml::WeakPtr<ImageDecoder> GetWeakPtr() const;
 
@@ -50,12 +77,30 @@ class ImageDecoder {
   std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner_;
   fml::WeakPtr<IOManager> io_manager_;
 
+  // Decodes an image that is not in the decode cache. The result must be
+  // returned on the UI thread as described in |Decode|.
+  virtual void DecodeImage(fml::RefPtr<ImageDescriptor> descriptor,
+                           uint32_t target_width,
+                           uint32_t target_height,
+                           const ImageResult& result) = 0;
+
   ImageDecoder(
       const TaskRunners& runners,
       std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner,
       fml::WeakPtr<IOManager> io_manager);
 
  private:
+  // Looks up the decode cache for the contents of |descriptor|, which hash to
+  // |content_hash|, and decodes them if they are neither cached nor pending.
+  void DecodeWithCache(fml::RefPtr<ImageDescriptor> descriptor,
+                       uint64_t content_hash,
+                       uint32_t target_width,
+                       uint32_t target_height,
+                       const ImageResult& result);
+
+  // Shared with pending decodes so that their results may be delivered even if
+  // the decoder is collected first.
+  std::shared_ptr<ImageDecodeCache> decode_cache_;
   fml::WeakPtrFactory<ImageDecoder> weak_factory_;
 
   FML_DISALLOW_COPY_AND_ASSIGN(ImageDecoder);
@@ -15,6 +15,7 @@
 #include "flutter/impeller/renderer/context.h"
 #include "flutter/impeller/renderer/texture.h"
 #include "flutter/lib/ui/painting/image_decoder_skia.h"
+#include "flutter/lib/ui/painting/pixel_conversions.h"
 #include "impeller/base/strings.h"
 #include "impeller/geometry/size.h"
 #include "include/core/SkSize.h"
@@ -97,6 +98,17 @@ std::shared_ptr<SkBitmap> ImageDecoderImpeller::DecompressTexture(
     return nullptr;
   }
 
+  // If the codec can decode regions, decode and resize the image in strips so
+  // that the whole decoded image is never held in memory.
+  if (descriptor->is_compressed() && decode_size != target_size) {
+    auto scaled_bitmap = std::make_shared<SkBitmap>();
+    if (scaled_bitmap->tryAllocPixels(image_info.makeDimensions(target_size)) &&
+        descriptor->get_scaled_pixels(scaled_bitmap->pixmap(), decode_size)) {
+      scaled_bitmap->setImmutable();
+      return scaled_bitmap;
+    }
+  }
+
   auto bitmap = std::make_shared<SkBitmap>();
   if (descriptor->is_compressed()) {
     if (!bitmap->tryAllocPixels(image_info)) {
@@ -109,6 +121,21 @@ std::shared_ptr<SkBitmap> ImageDecoderImpeller::DecompressTexture(
       FML_DLOG(ERROR) << "Could not decompress image.";
       return nullptr;
     }
+  } else if (base_image_info.colorType() != image_info.colorType()) {
+    // Raw pixels in a color type Impeller does not support (BGRA8888) must be
+    // converted before upload.
+    if (!bitmap->tryAllocPixels(image_info)) {
+      FML_DLOG(ERROR) << "Could not allocate intermediate for conversion.";
+      return nullptr;
+    }
+    const SkPixmap raw_pixmap(base_image_info, descriptor->data()->data(),
+                              descriptor->row_bytes());
+    if (!ConvertPixels(raw_pixmap, bitmap->pixmap()) &&
+        !raw_pixmap.readPixels(bitmap->pixmap())) {
+      FML_DLOG(ERROR) << "Could not convert raw pixels.";
+      return nullptr;
+    }
+    bitmap->setImmutable();
   } else {
     bitmap->setInfo(image_info);
     auto pixel_ref = SkMallocPixelRef::MakeWithData(
@@ -212,10 +239,11 @@ sk_sp<DlImage> ImageDecoderImpeller::UploadTexture(
 }
 
 // |ImageDecoder|
-void ImageDecoderImpeller::Decode(fml::RefPtr<ImageDescriptor> descriptor,
-                                  uint32_t target_width,
-                                  uint32_t target_height,
-                                  const ImageResult& p_result) {
+void ImageDecoderImpeller::DecodeImage(
+    fml::RefPtr<ImageDescriptor> descriptor,
+    uint32_t target_width,
+    uint32_t target_height,
+    const ImageResult& p_result) {
   FML_DCHECK(descriptor);
   FML_DCHECK(p_result);
 
@@ -26,12 +26,6 @@ class ImageDecoderImpeller final : public ImageDecoder {
 
   ~ImageDecoderImpeller() override;
 
-  // |ImageDecoder|
-  void Decode(fml::RefPtr<ImageDescriptor> descriptor,
-              uint32_t target_width,
-              uint32_t target_height,
-              const ImageResult& result) override;
-
   static std::shared_ptr<SkBitmap> DecompressTexture(
       ImageDescriptor* descriptor,
       SkISize target_size,
@@ -42,6 +36,12 @@ class ImageDecoderImpeller final : public ImageDecoder {
       std::shared_ptr<SkBitmap> bitmap);
 
  private:
+  // |ImageDecoder|
+  void DecodeImage(fml::RefPtr<ImageDescriptor> descriptor,
+                   uint32_t target_width,
+                   uint32_t target_height,
+                   const ImageResult& result) override;
+
   using FutureContext = std::shared_future<std::shared_ptr<impeller::Context>>;
   FutureContext context_;
 
@@ -49,6 +49,9 @@ static sk_sp<SkImage> ResizeRasterImage(const sk_sp<SkImage>& image,
     return nullptr;
   }
 
+  // This is a resample rather than a conversion, so |ConvertPixels| does not
+  // apply. Skia uploads the decoded color type as-is, so unlike the Impeller
+  // decoder there is no conversion to do either.
   if (!image->scalePixels(
           scaled_bitmap.pixmap(),
           SkSamplingOptions(SkFilterMode::kLinear, SkMipmapMode::kNone),
@@ -118,6 +121,24 @@ sk_sp<SkImage> ImageDecoderSkia::ImageFromCompressedData(
                static_cast<double>(resized_dimensions.height()) /
                    source_dimensions.height()));
 
+  // If the codec can decode regions, decode and resize the image in strips so
+  // that the whole decoded image is never held in memory.
+  if (decode_dimensions != resized_dimensions) {
+    SkBitmap resized_bitmap;
+    if (resized_bitmap.tryAllocPixels(
+            descriptor->image_info().makeDimensions(resized_dimensions)) &&
+        descriptor->get_scaled_pixels(resized_bitmap.pixmap(),
+                                      decode_dimensions)) {
+      // Marking this as immutable makes the MakeFromBitmap call share
+      // the pixels instead of copying.
+      resized_bitmap.setImmutable();
+      auto resized_image = SkImage::MakeFromBitmap(resized_bitmap);
+      if (resized_image) {
+        return resized_image;
+      }
+    }
+  }
+
   // If the codec supports efficient sub-pixel decoding, decoded at a resolution
   // close to the target resolution before resizing.
   if (decode_dimensions != source_dimensions) {
@@ -213,10 +234,11 @@ static SkiaGPUObject<SkImage> UploadRasterImage(
 }
 
 // |ImageDecoder|
-void ImageDecoderSkia::Decode(fml::RefPtr<ImageDescriptor> descriptor_ref_ptr,
-                              uint32_t target_width,
-                              uint32_t target_height,
-                              const ImageResult& callback) {
+void ImageDecoderSkia::DecodeImage(
+    fml::RefPtr<ImageDescriptor> descriptor_ref_ptr,
+    uint32_t target_width,
+    uint32_t target_height,
+    const ImageResult& callback) {
   TRACE_EVENT0("flutter", __FUNCTION__);
   fml::tracing::TraceFlow flow(__FUNCTION__);
 
@@ -2,6 +2,12 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include <cmath>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
 #include "flutter/common/task_runners.h"
 #include "flutter/fml/mapping.h"
 #include "flutter/fml/synchronization/waitable_event.h"
@@ -464,6 +470,82 @@ TEST_F(ImageDecoderFixtureTest, CanDecodeWithResizes) {
   PostTaskSync(runners.GetUITaskRunner(), [&]() { image_decoder.reset(); });
 }
 
+TEST_F(ImageDecoderFixtureTest, IdenticalDecodesAreCoalescedAndCached) {
+  auto loop = fml::ConcurrentMessageLoop::Create();
+  TaskRunners runners(GetCurrentTestName(),         // label
+                      CreateNewThread("platform"),  // platform
+                      CreateNewThread("raster"),    // raster
+                      CreateNewThread("ui"),        // ui
+                      CreateNewThread("io")         // io
+  );
+
+  fml::AutoResetWaitableEvent latch;
+  std::unique_ptr<IOManager> io_manager;
+  std::unique_ptr<ImageDecoder> image_decoder;
+
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() {
+    io_manager = std::make_unique<TestIOManager>(runners.GetIOTaskRunner());
+  });
+
+  PostTaskSync(runners.GetUITaskRunner(), [&]() {
+    Settings settings;
+    image_decoder = ImageDecoder::Make(settings, runners, loop->GetTaskRunner(),
+                                       io_manager->GetWeakIOManager());
+    image_decoder->SetDecodeCacheMaxBytes(100 * 1024 * 1024);
+  });
+
+  auto make_descriptor = []() {
+    auto data = OpenFixtureAsSkData("DashInNooglerHat.jpg");
+    ImageGeneratorRegistry registry;
+    std::shared_ptr<ImageGenerator> generator =
+        registry.CreateCompatibleGenerator(data);
+    return fml::MakeRefCounted<ImageDescriptor>(std::move(data),
+                                                std::move(generator));
+  };
+
+  // Two concurrent requests for the same image share a single decode, and so
+  // receive the same image.
+  std::vector<sk_sp<DlImage>> images;
+  runners.GetUITaskRunner()->PostTask([&]() {
+    ImageDecoder::ImageResult callback = [&](const sk_sp<DlImage>& image) {
+      ASSERT_TRUE(runners.GetUITaskRunner()->RunsTasksOnCurrentThread());
+      images.push_back(image);
+      if (images.size() == 2u) {
+        latch.Signal();
+      }
+    };
+    image_decoder->Decode(make_descriptor(), 100, 100, callback);
+    image_decoder->Decode(make_descriptor(), 100, 100, callback);
+  });
+  latch.Wait();
+
+  ASSERT_EQ(images.size(), 2u);
+  ASSERT_TRUE(images[0] && images[0]->skia_image());
+  ASSERT_EQ(images[0], images[1]);
+
+  // A later request for the same image is serviced from the cache.
+  runners.GetUITaskRunner()->PostTask([&]() {
+    ASSERT_EQ(image_decoder->GetDecodeCache().GetImageCount(), 1u);
+    image_decoder->Decode(make_descriptor(), 100, 100,
+                          [&](const sk_sp<DlImage>& image) {
+                            images.push_back(image);
+                            latch.Signal();
+                          });
+  });
+  latch.Wait();
+
+  ASSERT_EQ(images.size(), 3u);
+  ASSERT_EQ(images[2], images[0]);
+
+  // Release the images before the IO manager that owns their unref queue.
+  PostTaskSync(runners.GetUITaskRunner(), [&]() {
+    images.clear();
+    image_decoder.reset();
+  });
+
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() { io_manager.reset(); });
+}
+
 // Verifies https://skia-review.googlesource.com/c/skia/+/259161 is present in
 // Flutter.
 TEST(ImageDecoderTest,
@@ -551,6 +633,238 @@ TEST(ImageDecoderTest, VerifySubpixelDecodingPreservesExifOrientation) {
   assert_image(decode(300, 100));
 }
 
+TEST(ImageDecoderTest, RegionDecodingMatchesFullDecode) {
+  auto data = OpenFixtureAsSkData("Horizontal.png");
+  ImageGeneratorRegistry registry;
+  std::shared_ptr<ImageGenerator> generator =
+      registry.CreateCompatibleGenerator(data);
+  ASSERT_TRUE(generator);
+  auto descriptor = fml::MakeRefCounted<ImageDescriptor>(std::move(data),
+                                                         std::move(generator));
+  ASSERT_EQ(SkISize::Make(300, 100), descriptor->image_info().dimensions());
+
+  SkBitmap full;
+  ASSERT_TRUE(full.tryAllocPixels(descriptor->image_info()));
+  ASSERT_TRUE(descriptor->get_pixels(full.pixmap()));
+
+  const auto region = SkIRect::MakeXYWH(120, 30, 50, 40);
+  SkBitmap partial;
+  ASSERT_TRUE(partial.tryAllocPixels(
+      descriptor->image_info().makeDimensions(region.size())));
+  ASSERT_TRUE(descriptor->get_pixels_in_region(
+      partial.pixmap(), descriptor->image_info().dimensions(), region));
+
+  for (int y = 0; y < region.height(); y++) {
+    ASSERT_EQ(std::memcmp(partial.getAddr32(0, y),
+                          full.getAddr32(region.left(), region.top() + y),
+                          region.width() * sizeof(uint32_t)),
+              0)
+        << "Row " << y << " differs.";
+  }
+
+  // Regions outside the image are rejected.
+  ASSERT_FALSE(descriptor->get_pixels_in_region(
+      partial.pixmap(), descriptor->image_info().dimensions(),
+      SkIRect::MakeXYWH(280, 30, 50, 40)));
+}
+
+TEST(ImageDecoderTest, RegionDecodingOfLargeImagesOnlyAllocatesTheRegion) {
+  auto data = OpenFixtureAsSkData("DashInNooglerHat.jpg");
+  ImageGeneratorRegistry registry;
+  std::shared_ptr<ImageGenerator> generator =
+      registry.CreateCompatibleGenerator(data);
+  ASSERT_TRUE(generator);
+  auto descriptor = fml::MakeRefCounted<ImageDescriptor>(std::move(data),
+                                                         std::move(generator));
+  const auto& info = descriptor->image_info();
+  ASSERT_EQ(SkISize::Make(3024, 4032), info.dimensions());
+
+  // Decode a tile from the middle of the image at full resolution and at the
+  // smallest scale supported by the scaled IDCT.
+  for (float scale : {1.0f, 1.0f / 8.0f}) {
+    const auto decode_dimensions = descriptor->get_scaled_dimensions(scale);
+    const auto tile_size = static_cast<int32_t>(256 * scale);
+    const auto region =
+        SkIRect::MakeXYWH(decode_dimensions.width() / 2,
+                          decode_dimensions.height() / 2, tile_size, tile_size);
+    SkBitmap tile;
+    ASSERT_TRUE(tile.tryAllocPixels(info.makeDimensions(region.size())));
+    ASSERT_TRUE(descriptor->get_pixels_in_region(tile.pixmap(),
+                                                 decode_dimensions, region));
+
+    const size_t full_bytes =
+        info.makeDimensions(decode_dimensions).computeMinByteSize();
+    const size_t tile_bytes = tile.computeByteSize();
+    FML_LOG(INFO) << "Decoding a " << region.width() << "x" << region.height()
+                  << " region of a " << decode_dimensions.width() << "x"
+                  << decode_dimensions.height() << " image needed "
+                  << tile_bytes << "B instead of " << full_bytes << "B.";
+    ASSERT_LT(tile_bytes * 100, full_bytes);
+  }
+}
+
+TEST(ImageDecoderTest, ScaledDecodingInStripsMatchesFullDecode) {
+  struct TestCase {
+    const char* fixture;
+    float decode_scale;
+    SkISize target_dimensions;
+  };
+  for (const auto& test_case :
+       {TestCase{"Horizontal.png", 1.0f, SkISize::Make(150, 50)},
+        TestCase{"DashInNooglerHat.jpg", 1.0f / 8.0f,
+                 SkISize::Make(100, 133)}}) {
+    auto data = OpenFixtureAsSkData(test_case.fixture);
+    ImageGeneratorRegistry registry;
+    std::shared_ptr<ImageGenerator> generator =
+        registry.CreateCompatibleGenerator(data);
+    ASSERT_TRUE(generator);
+    auto descriptor = fml::MakeRefCounted<ImageDescriptor>(
+        std::move(data), std::move(generator));
+    const auto& info = descriptor->image_info();
+    const auto decode_dimensions =
+        descriptor->get_scaled_dimensions(test_case.decode_scale);
+
+    // The reference decodes the whole image before resizing it.
+    SkBitmap full;
+    ASSERT_TRUE(full.tryAllocPixels(info.makeDimensions(decode_dimensions)));
+    ASSERT_TRUE(descriptor->get_pixels(full.pixmap()));
+    SkBitmap expected;
+    ASSERT_TRUE(expected.tryAllocPixels(
+        info.makeDimensions(test_case.target_dimensions)));
+    ASSERT_TRUE(full.pixmap().scalePixels(
+        expected.pixmap(),
+        SkSamplingOptions(SkFilterMode::kLinear, SkMipmapMode::kNone)));
+
+    SkBitmap actual;
+    ASSERT_TRUE(actual.tryAllocPixels(
+        info.makeDimensions(test_case.target_dimensions)));
+    ASSERT_TRUE(
+        descriptor->get_scaled_pixels(actual.pixmap(), decode_dimensions));
+
+    for (int y = 0; y < actual.height(); y++) {
+      for (int x = 0; x < actual.width(); x++) {
+        const auto* expected_pixel =
+            reinterpret_cast<const uint8_t*>(expected.getAddr32(x, y));
+        const auto* actual_pixel =
+            reinterpret_cast<const uint8_t*>(actual.getAddr32(x, y));
+        for (int channel = 0; channel < 4; channel++) {
+          ASSERT_LE(std::abs(expected_pixel[channel] - actual_pixel[channel]),
+                    1)
+              << test_case.fixture << " differs at " << x << "," << y << ".";
+        }
+      }
+    }
+  }
+}
+
+TEST(ImageDecoderTest, SkiaResizesCompressedImagesInStrips) {
+  auto data = OpenFixtureAsSkData("DashInNooglerHat.jpg");
+  ImageGeneratorRegistry registry;
+  std::shared_ptr<ImageGenerator> generator =
+      registry.CreateCompatibleGenerator(data);
+  ASSERT_TRUE(generator);
+  auto descriptor = fml::MakeRefCounted<ImageDescriptor>(std::move(data),
+                                                         std::move(generator));
+
+  auto image = ImageDecoderSkia::ImageFromCompressedData(
+      descriptor.get(), 301, 403, fml::tracing::TraceFlow(""));
+  ASSERT_TRUE(image);
+  ASSERT_EQ(image->dimensions(), SkISize::Make(301, 403));
+  ASSERT_FALSE(image->isTextureBacked());
+}
+
+TEST_F(ImageDecoderFixtureTest, PreviewIsDeliveredBeforeTheFinalImage) {
+  auto loop = fml::ConcurrentMessageLoop::Create();
+  TaskRunners runners(GetCurrentTestName(),         // label
+                      CreateNewThread("platform"),  // platform
+                      CreateNewThread("raster"),    // raster
+                      CreateNewThread("ui"),        // ui
+                      CreateNewThread("io")         // io
+  );
+
+  fml::AutoResetWaitableEvent latch;
+  std::unique_ptr<IOManager> io_manager;
+  std::unique_ptr<ImageDecoder> image_decoder;
+
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() {
+    io_manager = std::make_unique<TestIOManager>(runners.GetIOTaskRunner());
+  });
+
+  sk_sp<DlImage> preview_image;
+  sk_sp<DlImage> final_image;
+  runners.GetUITaskRunner()->PostTask([&]() {
+    Settings settings;
+    image_decoder = ImageDecoder::Make(settings, runners, loop->GetTaskRunner(),
+                                       io_manager->GetWeakIOManager());
+
+    auto data = OpenFixtureAsSkData("DashInNooglerHat.jpg");
+    ImageGeneratorRegistry registry;
+    std::shared_ptr<ImageGenerator> generator =
+        registry.CreateCompatibleGenerator(data);
+    ASSERT_TRUE(generator);
+    auto descriptor = fml::MakeRefCounted<ImageDescriptor>(
+        std::move(data), std::move(generator));
+
+    image_decoder->DecodeWithPreview(
+        descriptor, descriptor->width(), descriptor->height(),
+        [&](const sk_sp<DlImage>& image) {
+          ASSERT_FALSE(final_image);
+          preview_image = image;
+        },
+        [&](const sk_sp<DlImage>& image) {
+          final_image = image;
+          latch.Signal();
+        });
+  });
+  latch.Wait();
+
+  // The preview is decoded with one sixty-fourth of the pixels of the final
+  // image, so it is expected to win the race.
+  ASSERT_TRUE(preview_image);
+  ASSERT_TRUE(final_image);
+  ASSERT_EQ(final_image->dimensions(), SkISize::Make(3024, 4032));
+  ASSERT_EQ(preview_image->dimensions(), SkISize::Make(378, 504));
+
+  PostTaskSync(runners.GetUITaskRunner(), [&]() {
+    preview_image.reset();
+    final_image.reset();
+    image_decoder.reset();
+  });
+
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() { io_manager.reset(); });
+}
+
+TEST(ImageDecoderTest, ClonedGeneratorsDecodeTheSameFrames) {
+  auto data = OpenFixtureAsSkData("hello_loop_2.webp");
+  ImageGeneratorRegistry registry;
+  std::shared_ptr<ImageGenerator> generator =
+      registry.CreateCompatibleGenerator(data);
+  ASSERT_TRUE(generator);
+  ASSERT_GT(generator->GetFrameCount(), 1u);
+
+  auto clone = generator->Clone();
+  ASSERT_TRUE(clone);
+  ASSERT_EQ(clone->GetFrameCount(), generator->GetFrameCount());
+
+  const auto info = generator->GetInfo().makeColorType(kN32_SkColorType);
+  for (unsigned int frame = 0; frame < generator->GetFrameCount(); frame++) {
+    if (generator->GetFrameInfo(frame).required_frame.has_value()) {
+      continue;
+    }
+    SkBitmap expected;
+    SkBitmap actual;
+    ASSERT_TRUE(expected.tryAllocPixels(info));
+    ASSERT_TRUE(actual.tryAllocPixels(info));
+    ASSERT_TRUE(generator->GetPixels(info, expected.getPixels(),
+                                     expected.rowBytes(), frame));
+    ASSERT_TRUE(
+        clone->GetPixels(info, actual.getPixels(), actual.rowBytes(), frame));
+    ASSERT_EQ(std::memcmp(expected.getPixels(), actual.getPixels(),
+                          expected.computeByteSize()),
+              0);
+  }
+}
+
 TEST_F(ImageDecoderFixtureTest,
        MultiFrameCodecCanBeCollectedBeforeIOTasksFinish) {
   // This test verifies that the MultiFrameCodec safely shares state between
@@ -706,5 +1020,114 @@ TEST_F(ImageDecoderFixtureTest, MultiFrameCodecDidAccessGpuDisabledSyncSwitch) {
   PostTaskSync(runners.GetIOTaskRunner(), [&]() { io_manager.reset(); });
 }
 
+/// A generator for an animation of tiny frames that counts how many frames
+/// have been decoded.
+class CountingImageGenerator : public ImageGenerator {
+ public:
+  static constexpr unsigned int kFrameCount = 20;
+
+  CountingImageGenerator() : info_(SkImageInfo::MakeN32Premul(1, 1)) {}
+
+  ~CountingImageGenerator() = default;
+
+  const SkImageInfo& GetInfo() { return info_; }
+
+  unsigned int GetFrameCount() const { return kFrameCount; }
+
+  // Played once, so that frames are not served from the loop cache.
+  unsigned int GetPlayCount() const { return 1; }
+
+  const ImageGenerator::FrameInfo GetFrameInfo(unsigned int frame_index) const {
+    return {std::nullopt, 100, SkCodecAnimation::DisposalMethod::kKeep};
+  }
+
+  SkISize GetScaledDimensions(float scale) { return info_.dimensions(); }
+
+  bool GetPixels(const SkImageInfo& info,
+                 void* pixels,
+                 size_t row_bytes,
+                 unsigned int frame_index,
+                 std::optional<unsigned int> prior_frame) {
+    std::memset(pixels, 0, row_bytes * info.height());
+    std::scoped_lock lock(mutex_);
+    decoded_frames_++;
+    decoded_cv_.notify_all();
+    return true;
+  }
+
+  // Waits for |count| frames to have been decoded, then for any decodes that
+  // would follow them, and returns the number of decoded frames.
+  size_t WaitForDecodedFrames(size_t count) {
+    {
+      std::unique_lock lock(mutex_);
+      decoded_cv_.wait(lock, [&]() { return decoded_frames_ >= count; });
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    std::scoped_lock lock(mutex_);
+    return decoded_frames_;
+  }
+
+ private:
+  SkImageInfo info_;
+  std::mutex mutex_;
+  std::condition_variable decoded_cv_;
+  size_t decoded_frames_ = 0;
+};
+
+TEST_F(ImageDecoderFixtureTest, MultiFrameCodecOnlyDecodesAheadWithinWindow) {
+  auto settings = CreateSettingsForFixture();
+  auto vm_ref = DartVMRef::Create(settings);
+  auto vm_data = vm_ref.GetVMData();
+  auto loop = fml::ConcurrentMessageLoop::Create();
+
+  auto generator = std::make_shared<CountingImageGenerator>();
+
+  TaskRunners runners(GetCurrentTestName(),         // label
+                      CreateNewThread("platform"),  // platform
+                      CreateNewThread("raster"),    // raster
+                      CreateNewThread("ui"),        // ui
+                      CreateNewThread("io")         // io
+  );
+
+  std::unique_ptr<TestIOManager> io_manager;
+  fml::RefPtr<MultiFrameCodec> codec;
+
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() {
+    io_manager = std::make_unique<TestIOManager>(runners.GetIOTaskRunner());
+  });
+
+  auto isolate = RunDartCodeInIsolate(
+      vm_ref, settings, runners, "main", {}, GetDefaultKernelFilePath(),
+      io_manager->GetWeakIOManager(), nullptr, loop->GetTaskRunner());
+
+  auto get_next_frame = [&]() {
+    EXPECT_TRUE(isolate->RunInIsolateScope([&]() -> bool {
+      Dart_Handle closure = Dart_GetField(
+          Dart_RootLibrary(), Dart_NewStringFromCString("frameCallback"));
+      if (Dart_IsError(closure) || !Dart_IsClosure(closure)) {
+        return false;
+      }
+      if (!codec) {
+        codec = fml::MakeRefCounted<MultiFrameCodec>(generator);
+      }
+      codec->getNextFrame(closure);
+      return true;
+    }));
+  };
+
+  // The first frame is decoded on the IO thread. Once it has been delivered,
+  // the next four frames are decoded ahead of time and no more.
+  get_next_frame();
+  EXPECT_EQ(generator->WaitForDecodedFrames(5u), 5u);
+
+  // Requesting a frame moves the window by one frame.
+  get_next_frame();
+  EXPECT_EQ(generator->WaitForDecodedFrames(6u), 6u);
+
+  isolate = nullptr;
+  PostTaskSync(runners.GetUITaskRunner(), [&]() { codec = nullptr; });
+  PostTaskSync(runners.GetIOTaskRunner(), [&]() { io_manager.reset(); });
+}
+
 }  // namespace testing
 }  // namespace flutter
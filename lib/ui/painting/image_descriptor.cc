@@ -4,12 +4,21 @@
 
 #include "flutter/lib/ui/painting/image_descriptor.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 #include "flutter/fml/build_config.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/trace_event.h"
 #include "flutter/lib/ui/painting/multi_frame_codec.h"
 #include "flutter/lib/ui/painting/single_frame_codec.h"
 #include "flutter/lib/ui/ui_dart_state.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkPaint.h"
+#include "third_party/skia/include/core/SkSurface.h"
 #include "third_party/tonic/dart_binding_macros.h"
 #include "third_party/tonic/logging/dart_invoke.h"
 
@@ -111,7 +120,13 @@ void ImageDescriptor::instantiateCodec(Dart_Handle codec_handle,
         static_cast<fml::RefPtr<ImageDescriptor>>(this), target_width,
         target_height);
   } else {
-    ui_codec = fml::MakeRefCounted<MultiFrameCodec>(generator_);
+    // Codecs decode frames on worker threads and generators are not thread
+    // safe, so every codec gets a generator of its own when possible.
+    std::shared_ptr<ImageGenerator> generator = generator_->Clone();
+    ui_codec = generator
+                   ? fml::MakeRefCounted<MultiFrameCodec>(std::move(generator))
+                   : fml::MakeRefCounted<MultiFrameCodec>(
+                         generator_, /*generator_is_shared=*/true);
   }
   ui_codec->AssociateWithDartWrapper(codec_handle);
 }
@@ -126,4 +141,115 @@ bool ImageDescriptor::get_pixels(const SkPixmap& pixmap) const {
                                pixmap.rowBytes());
 }
 
+bool ImageDescriptor::get_pixels_in_region(const SkPixmap& pixmap,
+                                           const SkISize& decode_dimensions,
+                                           const SkIRect& region) const {
+  if (!generator_ || pixmap.dimensions() != region.size()) {
+    return false;
+  }
+  return generator_->GetPixelsInRegion(
+      pixmap.info().makeDimensions(decode_dimensions), pixmap.writable_addr(),
+      pixmap.rowBytes(), region);
+}
+
+// The number of decoded rows in each strip of |get_scaled_pixels|.
+static constexpr int kScaledDecodeStripRows = 64;
+// The rows decoded above and below each strip, so that linear filtering of
+// the rows at the edges of a strip samples the same pixels as it would in the
+// whole image.
+static constexpr int kScaledDecodeStripPadding = 2;
+
+bool ImageDescriptor::get_scaled_pixels(
+    const SkPixmap& pixmap,
+    const SkISize& decode_dimensions) const {
+  TRACE_EVENT0("flutter", "ImageDescriptor::get_scaled_pixels");
+  if (!generator_ || pixmap.dimensions().isEmpty() ||
+      decode_dimensions.isEmpty()) {
+    return false;
+  }
+
+  auto surface = SkSurface::MakeRasterDirect(pixmap);
+  if (!surface) {
+    return false;
+  }
+  auto canvas = surface->getCanvas();
+
+  // Each strip is drawn into the rows of the pixmap whose samples fall in it.
+  const double scale_y =
+      static_cast<double>(decode_dimensions.height()) / pixmap.height();
+  const int target_rows_per_strip =
+      std::max(1, static_cast<int>(kScaledDecodeStripRows / scale_y));
+  const SkImageInfo decode_info =
+      pixmap.info().makeDimensions(decode_dimensions);
+  SkBitmap strip;
+  if (!strip.tryAllocPixels(decode_info.makeWH(
+          decode_dimensions.width(),
+          std::min(decode_dimensions.height(),
+                   static_cast<int>(std::ceil(target_rows_per_strip *
+                                              scale_y)) +
+                       1 + 2 * kScaledDecodeStripPadding)))) {
+    return false;
+  }
+  const size_t strip_row_bytes = strip.rowBytes();
+  auto strip_pixels = static_cast<uint8_t*>(strip.getPixels());
+
+  SkPaint paint;
+  paint.setBlendMode(SkBlendMode::kSrc);
+  // The decoded rows held in the strip.
+  int strip_top = 0;
+  int strip_bottom = 0;
+  for (int top = 0; top < pixmap.height(); top += target_rows_per_strip) {
+    const int bottom = std::min(pixmap.height(), top + target_rows_per_strip);
+    const int decode_top =
+        std::max(0, static_cast<int>(std::floor(top * scale_y)) -
+                        kScaledDecodeStripPadding);
+    const int decode_bottom = std::min(
+        decode_dimensions.height(),
+        static_cast<int>(std::ceil(bottom * scale_y)) +
+            kScaledDecodeStripPadding);
+    FML_DCHECK(decode_bottom - decode_top <= strip.height());
+
+    // Keep the rows shared with the last strip, so that the generator decodes
+    // each row once, from the top of the image down.
+    int decoded_rows = 0;
+    if (decode_top < strip_bottom) {
+      decoded_rows = strip_bottom - decode_top;
+      std::memmove(strip_pixels,
+                   strip_pixels + (decode_top - strip_top) * strip_row_bytes,
+                   decoded_rows * strip_row_bytes);
+    }
+    const auto region = SkIRect::MakeLTRB(0, decode_top + decoded_rows,
+                                          decode_dimensions.width(),
+                                          decode_bottom);
+    if (!region.isEmpty()) {
+      SkPixmap region_pixmap(decode_info.makeDimensions(region.size()),
+                             strip_pixels + decoded_rows * strip_row_bytes,
+                             strip_row_bytes);
+      if (!get_pixels_in_region(region_pixmap, decode_dimensions, region)) {
+        return false;
+      }
+    }
+    strip_top = decode_top;
+    strip_bottom = decode_bottom;
+
+    SkPixmap strip_pixmap(
+        decode_info.makeDimensions(
+            {decode_dimensions.width(), strip_bottom - strip_top}),
+        strip_pixels, strip_row_bytes);
+    auto strip_image = SkImage::MakeFromRaster(strip_pixmap, nullptr, nullptr);
+    if (!strip_image) {
+      return false;
+    }
+    canvas->save();
+    canvas->clipRect(SkRect::MakeLTRB(0, top, pixmap.width(), bottom));
+    canvas->scale(
+        static_cast<SkScalar>(pixmap.width()) / decode_dimensions.width(),
+        static_cast<SkScalar>(pixmap.height()) / decode_dimensions.height());
+    canvas->drawImage(strip_image, 0, strip_top,
+                      SkSamplingOptions(SkFilterMode::kLinear), &paint);
+    canvas->restore();
+  }
+  return true;
+}
+
 }  // namespace flutter
@@ -87,6 +87,16 @@ class ImageDescriptor : public RefCountedDartWrappable<ImageDescriptor> {
 
   sk_sp<SkImage> image() const;
 
+  /// @brief  A hash of the contents of the underlying buffer, if one has been
+  ///         computed by the image decoder. Only accessed on the UI thread.
+  std::optional<uint64_t> content_hash() const { return content_hash_; }
+
+  /// @brief  Remembers the hash of the underlying buffer so that it is only
+  ///         computed once for the lifetime of the descriptor.
+  void set_content_hash(uint64_t content_hash) {
+    content_hash_ = content_hash;
+  }
+
   /// @brief  Whether this descriptor represents compressed (encoded) data or
   ///         not.
   bool is_compressed() const { return !!generator_; }
@@ -108,6 +118,30 @@ class ImageDescriptor : public RefCountedDartWrappable<ImageDescriptor> {
   ///         orientation tag, if applicable.
   bool get_pixels(const SkPixmap& pixmap) const;
 
+  /// @brief  Gets the pixels of a region of this image as it would appear if
+  ///         the whole image were decoded at `decode_dimensions`. Only the
+  ///         parts of the image that intersect the region are decoded.
+  ///         `decode_dimensions` must be the image size or a size returned by
+  ///         `get_scaled_dimensions`, and the pixmap must be the size of
+  ///         `region`.
+  /// @return False if this descriptor does not represent encoded data, or if
+  ///         its `ImageGenerator` cannot decode regions of this image.
+  /// @see    `ImageGenerator::GetPixelsInRegion`
+  bool get_pixels_in_region(const SkPixmap& pixmap,
+                            const SkISize& decode_dimensions,
+                            const SkIRect& region) const;
+
+  /// @brief  Decodes this image at `decode_dimensions` and resizes it to the
+  ///         dimensions of the pixmap with linear filtering, like decoding
+  ///         the whole image and calling `SkPixmap::scalePixels` does. The
+  ///         image is decoded and resized in strips of rows, so only one
+  ///         strip of the decoded image is held in memory at a time.
+  /// @return False if this descriptor cannot decode regions of this image,
+  ///         in which case callers should decode the whole image instead.
+  /// @see    `get_pixels_in_region`
+  bool get_scaled_pixels(const SkPixmap& pixmap,
+                         const SkISize& decode_dimensions) const;
+
   void dispose() {
     buffer_.reset();
     generator_.reset();
@@ -125,6 +159,7 @@ class ImageDescriptor : public RefCountedDartWrappable<ImageDescriptor> {
   std::shared_ptr<ImageGenerator> generator_;
   const SkImageInfo image_info_;
   std::optional<size_t> row_bytes_;
+  std::optional<uint64_t> content_hash_;
 
   const SkImageInfo CreateImageInfo() const;
 
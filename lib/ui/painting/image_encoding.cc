@@ -17,6 +17,7 @@
 #include "flutter/lib/ui/painting/image_encoding_impeller.h"
 #endif  // IMPELLER_SUPPORTS_RENDERING
 #include "flutter/lib/ui/painting/image_encoding_skia.h"
+#include "flutter/lib/ui/painting/pixel_conversions.h"
 #include "third_party/skia/include/core/SkEncodedImageFormat.h"
 #include "third_party/tonic/dart_persistent_value.h"
 #include "third_party/tonic/logging/dart_invoke.h"
@@ -84,6 +85,15 @@ sk_sp<SkData> CopyImageByteData(const sk_sp<SkImage>& raster_image,
     return SkData::MakeWithCopy(pixmap.addr(), pixmap.computeByteSize());
   }
 
+  // Convert the pixels directly into the returned data where possible.
+  const auto dst_info = SkImageInfo::Make(
+      raster_image->width(), raster_image->height(), color_type, alpha_type);
+  auto dst_data = SkData::MakeUninitialized(dst_info.computeMinByteSize());
+  if (ConvertPixels(pixmap, SkPixmap(dst_info, dst_data->writable_data(),
+                                     dst_info.minRowBytes()))) {
+    return dst_data;
+  }
+
   // Perform swizzle if the type doesnt match the specification.
   auto surface = SkSurface::MakeRaster(
       SkImageInfo::Make(raster_image->width(), raster_image->height(),
@@ -4,9 +4,12 @@
 
 #include "flutter/lib/ui/painting/image_generator.h"
 
+#include <cstring>
 #include <utility>
+#include <vector>
 
 #include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
 
 namespace flutter {
 
@@ -31,6 +34,17 @@ sk_sp<SkImage> ImageGenerator::GetImage() {
   return SkImage::MakeFromBitmap(bitmap);
 }
 
+bool ImageGenerator::GetPixelsInRegion(const SkImageInfo& info,
+                                       void* pixels,
+                                       size_t row_bytes,
+                                       const SkIRect& region) {
+  return false;
+}
+
+std::unique_ptr<ImageGenerator> ImageGenerator::Clone() const {
+  return nullptr;
+}
+
 BuiltinSkiaImageGenerator::~BuiltinSkiaImageGenerator() = default;
 
 BuiltinSkiaImageGenerator::BuiltinSkiaImageGenerator(
@@ -84,11 +98,18 @@ BuiltinSkiaCodecImageGenerator::BuiltinSkiaCodecImageGenerator(
     : codec_generator_(static_cast<SkCodecImageGenerator*>(
           SkCodecImageGenerator::MakeFromCodec(std::move(codec)).release())) {}
 
+BuiltinSkiaCodecImageGenerator::BuiltinSkiaCodecImageGenerator(
+    std::unique_ptr<SkCodec> codec,
+    sk_sp<SkData> data)
+    : codec_generator_(static_cast<SkCodecImageGenerator*>(
+          SkCodecImageGenerator::MakeFromCodec(std::move(codec)).release())),
+      data_(std::move(data)) {}
+
 BuiltinSkiaCodecImageGenerator::BuiltinSkiaCodecImageGenerator(
     sk_sp<SkData> buffer)
     : codec_generator_(static_cast<SkCodecImageGenerator*>(
-          SkCodecImageGenerator::MakeFromEncodedCodec(std::move(buffer))
-              .release())) {}
+          SkCodecImageGenerator::MakeFromEncodedCodec(buffer).release())),
+      data_(std::move(buffer)) {}
 
 const SkImageInfo& BuiltinSkiaCodecImageGenerator::GetInfo() {
   return codec_generator_->getInfo();
@@ -134,13 +155,110 @@ bool BuiltinSkiaCodecImageGenerator::GetPixels(
   return codec_generator_->getPixels(info, pixels, row_bytes, &options);
 }
 
+bool BuiltinSkiaCodecImageGenerator::GetPixelsInRegion(
+    const SkImageInfo& info,
+    void* pixels,
+    size_t row_bytes,
+    const SkIRect& region) {
+  TRACE_EVENT0("flutter", "BuiltinSkiaCodecImageGenerator::GetPixelsInRegion");
+  if (region.isEmpty() ||
+      !SkIRect::MakeSize(info.dimensions()).contains(region)) {
+    return false;
+  }
+
+  auto codec = GetRegionCodec();
+  // The generator applies the EXIF orientation of the image, which the
+  // scanline decoder does not. Leave such images to full decodes.
+  if (!codec || codec->getOrigin() != kTopLeft_SkEncodedOrigin) {
+    return false;
+  }
+
+  // A region below the last one decoded with the same columns continues its
+  // scanline decode, so decoding an image in strips from the top only decodes
+  // each row once.
+  const bool continues_decode =
+      region_next_row_ >= 0 && region_info_ == info &&
+      region_columns_.left() == region.left() &&
+      region_columns_.right() == region.right() &&
+      region.top() >= region_next_row_;
+  if (!continues_decode && !StartRegionDecode(codec, info, region)) {
+    return false;
+  }
+  const int next_row = region_next_row_;
+  region_next_row_ = -1;
+
+  // Rows above the region are skipped and rows below it are never decoded.
+  if (!codec->skipScanlines(region.top() - next_row)) {
+    return false;
+  }
+  if (region_crops_columns_) {
+    if (codec->getScanlines(pixels, region.height(), row_bytes) !=
+        region.height()) {
+      return false;
+    }
+  } else {
+    // The codec cannot crop columns itself. Decode whole rows one at a time
+    // and copy out the columns in the region.
+    std::vector<uint8_t> row(info.minRowBytes());
+    const size_t bytes_per_pixel = info.bytesPerPixel();
+    auto destination = static_cast<uint8_t*>(pixels);
+    for (int y = 0; y < region.height(); y++) {
+      if (codec->getScanlines(row.data(), 1, row.size()) != 1) {
+        return false;
+      }
+      std::memcpy(destination, row.data() + region.left() * bytes_per_pixel,
+                  region.width() * bytes_per_pixel);
+      destination += row_bytes;
+    }
+  }
+  region_next_row_ = region.bottom();
+  return true;
+}
+
+bool BuiltinSkiaCodecImageGenerator::StartRegionDecode(SkCodec* codec,
+                                                       const SkImageInfo& info,
+                                                       const SkIRect& region) {
+  region_next_row_ = -1;
+  // Scanline decoders can only crop columns. The codec refers to the subset
+  // for as long as it decodes, so it is kept in a member.
+  region_columns_ =
+      SkIRect::MakeLTRB(region.left(), 0, region.right(), info.height());
+  SkCodec::Options options;
+  options.fSubset = &region_columns_;
+  if (codec->startScanlineDecode(info, &options) == SkCodec::kSuccess &&
+      codec->getScanlineOrder() == SkCodec::kTopDown_SkScanlineOrder) {
+    region_crops_columns_ = true;
+  } else if (codec->startScanlineDecode(info) == SkCodec::kSuccess &&
+             codec->getScanlineOrder() ==
+                 SkCodec::kTopDown_SkScanlineOrder) {
+    region_crops_columns_ = false;
+  } else {
+    return false;
+  }
+  region_info_ = info;
+  region_next_row_ = 0;
+  return true;
+}
+
+SkCodec* BuiltinSkiaCodecImageGenerator::GetRegionCodec() {
+  if (!region_codec_ && data_) {
+    region_codec_ = SkCodec::MakeFromData(data_);
+  }
+  return region_codec_.get();
+}
+
+std::unique_ptr<ImageGenerator> BuiltinSkiaCodecImageGenerator::Clone() const {
+  return data_ ? MakeFromData(data_) : nullptr;
+}
+
 std::unique_ptr<ImageGenerator> BuiltinSkiaCodecImageGenerator::MakeFromData(
     sk_sp<SkData> data) {
-  auto codec = SkCodec::MakeFromData(std::move(data));
+  auto codec = SkCodec::MakeFromData(data);
   if (!codec) {
     return nullptr;
   }
-  return std::make_unique<BuiltinSkiaCodecImageGenerator>(std::move(codec));
+  return std::make_unique<BuiltinSkiaCodecImageGenerator>(std::move(codec),
+                                                          std::move(data));
 }
 
 }  // namespace flutter
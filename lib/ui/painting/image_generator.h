@@ -124,6 +124,41 @@ class ImageGenerator {
       unsigned int frame_index = 0,
       std::optional<unsigned int> prior_frame = std::nullopt) = 0;
 
+  /// @brief      Decode a rectangular region of the image into a given
+  ///             buffer. Only the rows and, where the codec allows it, the
+  ///             columns that intersect the region are decoded, so the memory
+  ///             needed is proportional to the size of the region instead of
+  ///             the size of the image.
+  /// @param[in]  info       The size and color info of the entire decoded
+  ///                        image. As with `GetPixels`, the dimensions must be
+  ///                        the full image size or a size returned by
+  ///                        `GetScaledDimensions`.
+  /// @param[in]  pixels     The location where the decoded region should be
+  ///                        written. It must be large enough for
+  ///                        `region.height()` rows of `row_bytes` each.
+  /// @param[in]  row_bytes  The total number of bytes that make up a single
+  ///                        row of the decoded region.
+  /// @param[in]  region     The region to decode, in the coordinate space of
+  ///                        `info`.
+  /// @return     True if the region was successfully decoded. False if the
+  ///             region is invalid or if region decoding is not supported by
+  ///             this generator, in which case callers should decode the
+  ///             whole image instead.
+  /// @note       Like `GetPixels`, this method performs potentially long
+  ///             synchronous work and should never be executed on the UI
+  ///             thread.
+  virtual bool GetPixelsInRegion(const SkImageInfo& info,
+                                 void* pixels,
+                                 size_t row_bytes,
+                                 const SkIRect& region);
+
+  /// @brief   Creates a new generator for the same encoded image that does
+  ///          not share any decoding state with this one. Since generators
+  ///          are not thread safe, this allows frames of an animated image to
+  ///          be decoded in parallel.
+  /// @return  The new generator, or null if this generator cannot be cloned.
+  virtual std::unique_ptr<ImageGenerator> Clone() const;
+
   /// @brief   Creates an `SkImage` based on the current `ImageInfo` of this
   ///          `ImageGenerator`.
   /// @return  A new `SkImage` containing the decoded image data.
@@ -175,6 +210,9 @@ class BuiltinSkiaCodecImageGenerator : public ImageGenerator {
 
   explicit BuiltinSkiaCodecImageGenerator(std::unique_ptr<SkCodec> codec);
 
+  BuiltinSkiaCodecImageGenerator(std::unique_ptr<SkCodec> codec,
+                                 sk_sp<SkData> data);
+
   explicit BuiltinSkiaCodecImageGenerator(sk_sp<SkData> buffer);
 
   // |ImageGenerator|
@@ -201,11 +239,38 @@ class BuiltinSkiaCodecImageGenerator : public ImageGenerator {
       unsigned int frame_index = 0,
       std::optional<unsigned int> prior_frame = std::nullopt) override;
 
+  // |ImageGenerator|
+  bool GetPixelsInRegion(const SkImageInfo& info,
+                         void* pixels,
+                         size_t row_bytes,
+                         const SkIRect& region) override;
+
+  // |ImageGenerator|
+  std::unique_ptr<ImageGenerator> Clone() const override;
+
   static std::unique_ptr<ImageGenerator> MakeFromData(sk_sp<SkData> data);
 
  private:
   FML_DISALLOW_COPY_ASSIGN_AND_MOVE(BuiltinSkiaCodecImageGenerator);
   std::unique_ptr<SkCodecImageGenerator> codec_generator_;
+  // The encoded data, if known. Region decodes use a codec of their own since
+  // the codec owned by the generator is not accessible.
+  sk_sp<SkData> data_;
+  std::unique_ptr<SkCodec> region_codec_;
+  // The scanline decode of the last region. |region_next_row_| is the next
+  // row the codec decodes, or -1 if there is no decode to continue.
+  SkImageInfo region_info_;
+  SkIRect region_columns_ = SkIRect::MakeEmpty();
+  bool region_crops_columns_ = false;
+  int region_next_row_ = -1;
+
+  SkCodec* GetRegionCodec();
+
+  // Starts a scanline decode of the columns of |region|, cropped by the codec
+  // if it can.
+  bool StartRegionDecode(SkCodec* codec,
+                         const SkImageInfo& info,
+                         const SkIRect& region);
 };
 
 }  // namespace flutter
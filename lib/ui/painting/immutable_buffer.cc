@@ -72,8 +72,7 @@ Dart_Handle ImmutableBuffer::initFromAsset(Dart_Handle buffer_handle,
   }
 
   auto size = data->GetSize();
-  const void* bytes = static_cast<const void*>(data->GetMapping());
-  auto sk_data = MakeSkDataWithCopy(bytes, size);
+  auto sk_data = MakeSkDataFromMapping(std::move(data));
   auto buffer = fml::MakeRefCounted<ImmutableBuffer>(sk_data);
   buffer->AssociateWithDartWrapper(buffer_handle);
   tonic::DartInvoke(callback_handle, {tonic::ToDart(size)});
@@ -146,6 +145,45 @@ Dart_Handle ImmutableBuffer::initFromFile(Dart_Handle raw_buffer_handle,
   return Dart_Null();
 }
 
+Dart_Handle ImmutableBuffer::getRange(int64_t offset, int64_t length) {
+  if (!data_) {
+    Dart_ThrowException(
+        tonic::ToDart("ImmutableBuffer.getRange called after dispose."));
+    return Dart_Null();
+  }
+  if (offset < 0 || length < 0 ||
+      static_cast<uint64_t>(offset) > data_->size() ||
+      static_cast<uint64_t>(length) > data_->size() - offset) {
+    Dart_ThrowException(
+        tonic::ToDart("ImmutableBuffer.getRange range is out of bounds."));
+    return Dart_Null();
+  }
+  tonic::Uint8List range(Dart_NewTypedData(Dart_TypedData_kUint8, length));
+  if (length > 0) {
+    ::memcpy(&range[0], data_->bytes() + offset, length);
+  }
+  return range.dart_handle();
+}
+
+sk_sp<SkData> ImmutableBuffer::MakeSkDataFromMapping(
+    std::unique_ptr<fml::Mapping> mapping) {
+  // Only mappings of files that can't change while they are mapped, such as an
+  // uncompressed asset in an APK, are wrapped so that their pages are only
+  // read when used. Assets in a directory bundle are rewritten in place by
+  // DevFS during hot reload, and a truncated file would fault on access, so
+  // those are copied like any other mapping.
+  if (!mapping->IsImmutableFile() || !mapping->IsDontNeedSafe() ||
+      mapping->GetSize() == 0) {
+    return MakeSkDataWithCopy(mapping->GetMapping(), mapping->GetSize());
+  }
+  const auto* bytes = mapping->GetMapping();
+  const auto size = mapping->GetSize();
+  SkData::ReleaseProc proc = [](const void* ptr, void* context) {
+    delete reinterpret_cast<fml::Mapping*>(context);
+  };
+  return SkData::MakeWithProc(bytes, size, proc, mapping.release());
+}
+
 #if FML_OS_ANDROID
 
 // Compressed image buffers are allocated on the UI thread but are deleted on a
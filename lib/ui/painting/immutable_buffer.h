@@ -6,8 +6,10 @@
 #define FLUTTER_LIB_UI_PAINTNIG_IMMUTABLE_BUFER_H_
 
 #include <cstdint>
+#include <memory>
 
 #include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
 #include "flutter/lib/ui/dart_wrapper.h"
 #include "third_party/skia/include/core/SkData.h"
 #include "third_party/tonic/dart_library_natives.h"
@@ -79,6 +81,13 @@ class ImmutableBuffer : public RefCountedDartWrappable<ImmutableBuffer> {
   /// Callers should not modify the returned data. This is not exposed to Dart.
   sk_sp<SkData> data() const { return data_; }
 
+  /// Copies `length` bytes starting at `offset` into a new Uint8List.
+  ///
+  /// Buffers backed by a file mapping only page in the requested range, which
+  /// lets Dart stream large assets without reading the whole file. Throws a
+  /// Dart exception if the range is out of bounds or the buffer was disposed.
+  Dart_Handle getRange(int64_t offset, int64_t length);
+
   /// Clears the Dart native fields and removes the reference to the underlying
   /// byte buffer.
   ///
@@ -96,6 +105,11 @@ class ImmutableBuffer : public RefCountedDartWrappable<ImmutableBuffer> {
 
   static sk_sp<SkData> MakeSkDataWithCopy(const void* data, size_t length);
 
+  // Wraps mappings of immutable files without copying them. Other mappings
+  // are copied with |MakeSkDataWithCopy|.
+  static sk_sp<SkData> MakeSkDataFromMapping(
+      std::unique_ptr<fml::Mapping> mapping);
+
   DEFINE_WRAPPERTYPEINFO();
   FML_FRIEND_MAKE_REF_COUNTED(ImmutableBuffer);
   FML_DISALLOW_COPY_AND_ASSIGN(ImmutableBuffer);
@@ -4,13 +4,16 @@
 
 #include "flutter/lib/ui/painting/multi_frame_codec.h"
 
+#include <algorithm>
 #include <utility>
 
 #include "flutter/fml/make_copyable.h"
+#include "flutter/fml/trace_event.h"
 #include "flutter/lib/ui/painting/image.h"
 #if IMPELLER_SUPPORTS_RENDERING
 #include "flutter/lib/ui/painting/image_decoder_impeller.h"
 #endif  // IMPELLER_SUPPORTS_RENDERING
+#include "flutter/lib/ui/painting/pixel_conversions.h"
 #include "third_party/dart/runtime/include/dart_api.h"
 #include "third_party/skia/include/codec/SkCodecAnimation.h"
 #include "third_party/skia/include/core/SkPixelRef.h"
@@ -18,12 +21,50 @@
 
 namespace flutter {
 
-MultiFrameCodec::MultiFrameCodec(std::shared_ptr<ImageGenerator> generator)
-    : state_(new State(std::move(generator))) {}
+MultiFrameCodec::MultiFrameCodec(std::shared_ptr<ImageGenerator> generator,
+                                 bool generator_is_shared)
+    : state_(new State(std::move(generator), generator_is_shared)) {}
 
 MultiFrameCodec::~MultiFrameCodec() = default;
 
-MultiFrameCodec::State::State(std::shared_ptr<ImageGenerator> generator)
+// Frames are decoded at most this far ahead of the frame being displayed.
+static constexpr uint64_t kMaxDecodeAheadFrames = 4;
+
+// The memory budget for frames decoded ahead of time. Large animations decode
+// fewer frames ahead to stay within this budget.
+static constexpr size_t kDecodeAheadMaxBytes = 16 * 1024 * 1024;
+
+// Animations whose frames fit in this many bytes keep the frames of their first
+// loop and never decode again.
+static constexpr size_t kLoopCacheMaxBytes = 4 * 1024 * 1024;
+
+static SkImageInfo CreateFrameInfo(ImageGenerator& generator) {
+  SkImageInfo info = generator.GetInfo().makeColorType(kN32_SkColorType);
+  if (info.alphaType() == kUnpremul_SkAlphaType) {
+    info = info.makeAlphaType(kPremul_SkAlphaType);
+  }
+  return info;
+}
+
+static std::vector<ImageGenerator::FrameInfo> GetFrameInfos(
+    ImageGenerator& generator,
+    int frame_count) {
+  std::vector<ImageGenerator::FrameInfo> frame_infos;
+  frame_infos.reserve(frame_count);
+  for (int i = 0; i < frame_count; i++) {
+    frame_infos.push_back(generator.GetFrameInfo(i));
+  }
+  return frame_infos;
+}
+
+static uint64_t GetDecodeAheadFrames(const SkImageInfo& info) {
+  const size_t frame_bytes = std::max<size_t>(info.computeMinByteSize(), 1u);
+  return std::clamp<uint64_t>(kDecodeAheadMaxBytes / frame_bytes, 1u,
+                              kMaxDecodeAheadFrames);
+}
+
+MultiFrameCodec::State::State(std::shared_ptr<ImageGenerator> generator,
+                              bool generator_is_shared)
     : generator_(std::move(generator)),
       frameCount_(generator_->GetFrameCount()),
       repetitionCount_(generator_->GetPlayCount() ==
@@ -31,7 +72,30 @@ MultiFrameCodec::State::State(std::shared_ptr<ImageGenerator> generator)
                            ? -1
                            : generator_->GetPlayCount() - 1),
       is_impeller_enabled_(UIDartState::Current()->IsImpellerEnabled()),
-      nextFrameIndex_(0) {}
+      info_(CreateFrameInfo(*generator_)),
+      frameInfos_(GetFrameInfos(*generator_, frameCount_)),
+      concurrent_task_runner_(
+          generator_is_shared
+              ? nullptr
+              : UIDartState::Current()->GetConcurrentTaskRunner()),
+      decodeAheadFrames_(GetDecodeAheadFrames(info_)),
+      cacheLoop_(frameCount_ > 1 && repetitionCount_ != 0 &&
+                 frameCount_ * info_.computeMinByteSize() <=
+                     kLoopCacheMaxBytes) {
+  idleGenerators_.push_back(generator_);
+  if (cacheLoop_) {
+    cachedLoop_.resize(frameCount_);
+  }
+}
+
+MultiFrameCodec::State::~State() {
+  // The callbacks of requests that were never serviced must be collected on
+  // the UI thread.
+  for (auto& request : pendingRequests_) {
+    request->ui_task_runner->PostTask(fml::MakeCopyable(
+        [callback = std::move(request->callback)]() { callback->Clear(); }));
+  }
+}
 
 static void InvokeNextFrameCallback(
     const fml::RefPtr<CanvasImage>& image,
@@ -74,7 +138,7 @@ static bool CopyToBitmap(SkBitmap* dst,
     return false;
   }
 
-  if (!srcPM.readPixels(dstPM)) {
+  if (!ConvertPixels(srcPM, dstPM) && !srcPM.readPixels(dstPM)) {
     return false;
   }
 
@@ -82,69 +146,62 @@ static bool CopyToBitmap(SkBitmap* dst,
   return true;
 }
 
-sk_sp<DlImage> MultiFrameCodec::State::GetNextFrameImage(
-    fml::WeakPtr<GrDirectContext> resourceContext,
-    const std::shared_ptr<const fml::SyncSwitch>& gpu_disable_sync_switch,
-    std::shared_ptr<impeller::Context> impeller_context_,
-    fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue) {
-  SkBitmap bitmap = SkBitmap();
-  SkImageInfo info = generator_->GetInfo().makeColorType(kN32_SkColorType);
-  if (info.alphaType() == kUnpremul_SkAlphaType) {
-    SkImageInfo updated = info.makeAlphaType(kPremul_SkAlphaType);
-    info = updated;
-  }
-  if (!bitmap.tryAllocPixels(info)) {
+std::shared_ptr<SkBitmap> MultiFrameCodec::State::DecodeFrame(
+    const DecodeJob& job) const {
+  TRACE_EVENT0("flutter", "MultiFrameCodec::State::DecodeFrame");
+  const int frame_index = job.sequence % frameCount_;
+
+  auto bitmap = std::make_shared<SkBitmap>();
+  if (!bitmap->tryAllocPixels(info_)) {
     FML_LOG(ERROR) << "Failed to allocate memory for bitmap of size "
-                   << info.computeMinByteSize() << "B";
+                   << info_.computeMinByteSize() << "B";
     return nullptr;
   }
 
-  ImageGenerator::FrameInfo frameInfo =
-      generator_->GetFrameInfo(nextFrameIndex_);
-
   const int requiredFrameIndex =
-      frameInfo.required_frame.value_or(SkCodec::kNoFrame);
-  std::optional<unsigned int> prior_frame_index = std::nullopt;
+      frameInfos_[frame_index].required_frame.value_or(SkCodec::kNoFrame);
 
   if (requiredFrameIndex != SkCodec::kNoFrame) {
-    if (lastRequiredFrame_ == nullptr) {
-      FML_LOG(ERROR) << "Frame " << nextFrameIndex_ << " depends on frame "
+    if (job.required_frame == nullptr) {
+      FML_LOG(ERROR) << "Frame " << frame_index << " depends on frame "
                      << requiredFrameIndex
                      << " and no required frames are cached.";
       return nullptr;
-    } else if (lastRequiredFrameIndex_ != requiredFrameIndex) {
+    } else if (job.required_frame_index != requiredFrameIndex) {
       FML_DLOG(INFO) << "Required frame " << requiredFrameIndex
-                     << " is not cached. Using " << lastRequiredFrameIndex_
+                     << " is not cached. Using " << job.required_frame_index
                      << " instead";
     }
 
-    if (lastRequiredFrame_->getPixels() &&
-        CopyToBitmap(&bitmap, lastRequiredFrame_->colorType(),
-                     *lastRequiredFrame_)) {
-      prior_frame_index = requiredFrameIndex;
+    if (job.required_frame->getPixels()) {
+      CopyToBitmap(bitmap.get(), job.required_frame->colorType(),
+                   *job.required_frame);
     }
   }
 
-  if (!generator_->GetPixels(info, bitmap.getPixels(), bitmap.rowBytes(),
-                             nextFrameIndex_, requiredFrameIndex)) {
-    FML_LOG(ERROR) << "Could not getPixels for frame " << nextFrameIndex_;
+  if (!job.generator->GetPixels(info_, bitmap->getPixels(), bitmap->rowBytes(),
+                                frame_index, requiredFrameIndex)) {
+    FML_LOG(ERROR) << "Could not getPixels for frame " << frame_index;
     return nullptr;
   }
 
-  // Hold onto this if we need it to decode future frames.
-  if (frameInfo.disposal_method == SkCodecAnimation::DisposalMethod::kKeep) {
-    lastRequiredFrame_ = std::make_unique<SkBitmap>(bitmap);
-    lastRequiredFrameIndex_ = nextFrameIndex_;
-  }
+  return bitmap;
+}
 
+sk_sp<DlImage> MultiFrameCodec::State::UploadFrame(
+    const SkBitmap& bitmap,
+    fml::WeakPtr<GrDirectContext> resourceContext,
+    const std::shared_ptr<const fml::SyncSwitch>& gpu_disable_sync_switch,
+    const std::shared_ptr<impeller::Context>& impeller_context,
+    fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue) const {
 #if IMPELLER_SUPPORTS_RENDERING
   if (is_impeller_enabled_) {
     sk_sp<DlImage> result;
     // impeller, transfer to DlImageImpeller
     gpu_disable_sync_switch->Execute(fml::SyncSwitch::Handlers().SetIfFalse(
-        [&result, &bitmap, &impeller_context_] {
+        [&result, &bitmap, &impeller_context] {
           result = ImageDecoderImpeller::UploadTexture(
-              impeller_context_, std::make_shared<SkBitmap>(bitmap));
+              impeller_context, std::make_shared<SkBitmap>(bitmap));
         }));
 
     return result;
@@ -177,35 +234,201 @@ sk_sp<DlImage> MultiFrameCodec::State::GetNextFrameImage(
   return DlImageGPU::Make({skImage, std::move(unref_queue)});
 }
 
-void MultiFrameCodec::State::GetNextFrameAndInvokeCallback(
-    std::unique_ptr<DartPersistentValue> callback,
-    const fml::RefPtr<fml::TaskRunner>& ui_task_runner,
-    fml::WeakPtr<GrDirectContext> resourceContext,
-    fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue,
-    const std::shared_ptr<const fml::SyncSwitch>& gpu_disable_sync_switch,
-    size_t trace_id,
-    std::shared_ptr<impeller::Context> impeller_context) {
+std::optional<MultiFrameCodec::State::DecodeJob>
+MultiFrameCodec::State::ClaimNextFrameLocked() {
+  const uint64_t sequence = nextSequenceToDecode_;
+
+  // Later loops of short animations are served from the loop cache.
+  if (cacheLoop_ && sequence >= static_cast<uint64_t>(frameCount_)) {
+    return std::nullopt;
+  }
+
+  if (sequence >= nextSequenceToDeliver_ + decodeAheadFrames_) {
+    return std::nullopt;
+  }
+
+  // A frame that is blended with earlier frames can only be decoded once all
+  // of those have been decoded. Other frames may be decoded in parallel.
+  const bool has_required_frame =
+      frameInfos_[sequence % frameCount_].required_frame.has_value();
+  if (has_required_frame && !inFlight_.empty()) {
+    return std::nullopt;
+  }
+
+  if (idleGenerators_.empty()) {
+    if (generatorCount_ >= decodeAheadFrames_) {
+      return std::nullopt;
+    }
+    std::shared_ptr<ImageGenerator> clone = generator_->Clone();
+    if (!clone) {
+      // Don't try again. This generator decodes one frame at a time.
+      generatorCount_ = decodeAheadFrames_;
+      return std::nullopt;
+    }
+    generatorCount_++;
+    idleGenerators_.push_back(std::move(clone));
+  }
+
+  DecodeJob job = {
+      .sequence = sequence,
+      .generator = std::move(idleGenerators_.back()),
+      .required_frame = has_required_frame ? lastRequiredFrame_ : nullptr,
+      .required_frame_index =
+          lastRequiredFrameSequence_ < 0
+              ? -1
+              : static_cast<int>(lastRequiredFrameSequence_ % frameCount_),
+  };
+  idleGenerators_.pop_back();
+  inFlight_.insert(sequence);
+  nextSequenceToDecode_++;
+  return job;
+}
+
+void MultiFrameCodec::State::ScheduleDecodesLocked() {
+  if (!concurrent_task_runner_) {
+    return;
+  }
+  while (auto job = ClaimNextFrameLocked()) {
+    concurrent_task_runner_->PostTask(
+        [weak_state = weak_from_this(), job = std::move(job.value())]() {
+          auto state = weak_state.lock();
+          if (!state) {
+            return;
+          }
+          state->OnFrameDecodedAhead(job, state->DecodeFrame(job));
+        });
+  }
+}
+
+void MultiFrameCodec::State::FinishDecodeLocked(
+    const DecodeJob& job,
+    const std::shared_ptr<SkBitmap>& bitmap) {
+  idleGenerators_.push_back(job.generator);
+  inFlight_.erase(job.sequence);
+
+  // Hold onto this if we need it to decode future frames.
+  const auto& frameInfo = frameInfos_[job.sequence % frameCount_];
+  if (bitmap &&
+      frameInfo.disposal_method == SkCodecAnimation::DisposalMethod::kKeep &&
+      static_cast<int64_t>(job.sequence) > lastRequiredFrameSequence_) {
+    lastRequiredFrame_ = bitmap;
+    lastRequiredFrameSequence_ = job.sequence;
+  }
+}
+
+void MultiFrameCodec::State::OnFrameDecodedAhead(
+    const DecodeJob& job,
+    std::shared_ptr<SkBitmap> bitmap) {
+  std::scoped_lock lock(decode_mutex_);
+  FinishDecodeLocked(job, bitmap);
+  decodedFrames_[job.sequence] = std::move(bitmap);
+
+  if (!pendingRequests_.empty() &&
+      decodedFrames_.count(nextSequenceToDeliver_) > 0) {
+    pendingRequests_.front()->io_task_runner->PostTask(
+        [weak_state = weak_from_this()]() {
+          if (auto state = weak_state.lock()) {
+            state->ProcessPendingRequests();
+          }
+        });
+  }
+
+  ScheduleDecodesLocked();
+}
+
+void MultiFrameCodec::State::ProcessPendingRequests() {
+  while (true) {
+    std::unique_lock lock(decode_mutex_);
+    if (pendingRequests_.empty()) {
+      return;
+    }
+    const uint64_t sequence = nextSequenceToDeliver_;
+    const int frame_index = sequence % frameCount_;
+
+    if (cacheLoop_ && sequence >= static_cast<uint64_t>(frameCount_)) {
+      auto request = std::move(pendingRequests_.front());
+      pendingRequests_.pop_front();
+      nextSequenceToDeliver_++;
+      lock.unlock();
+      InvokeCallback(std::move(request), cachedLoop_[frame_index],
+                     frame_index);
+      continue;
+    }
+
+    std::shared_ptr<SkBitmap> bitmap;
+    auto decoded = decodedFrames_.find(sequence);
+    if (decoded != decodedFrames_.end()) {
+      bitmap = std::move(decoded->second);
+      decodedFrames_.erase(decoded);
+    } else if (inFlight_.count(sequence) > 0) {
+      // The frame is being decoded ahead of time. This will be called again
+      // once it is ready.
+      return;
+    } else {
+      // Nothing is being decoded, so the frame can be decoded right here.
+      FML_DCHECK(nextSequenceToDecode_ == sequence);
+      auto job = ClaimNextFrameLocked();
+      FML_DCHECK(job.has_value());
+      if (!job.has_value()) {
+        return;
+      }
+      lock.unlock();
+      bitmap = DecodeFrame(job.value());
+      lock.lock();
+      FinishDecodeLocked(job.value(), bitmap);
+    }
+
+    auto request = std::move(pendingRequests_.front());
+    pendingRequests_.pop_front();
+    nextSequenceToDeliver_++;
+    if (cacheLoop_ && sequence + 1 == static_cast<uint64_t>(frameCount_)) {
+      // The loop cache has every frame now.
+      lastRequiredFrame_.reset();
+    }
+    ScheduleDecodesLocked();
+    lock.unlock();
+
+    sk_sp<DlImage> dlImage =
+        bitmap ? UploadFrame(*bitmap, request->resourceContext,
+                             request->gpu_disable_sync_switch,
+                             request->impeller_context, request->unref_queue)
+               : nullptr;
+    if (cacheLoop_) {
+      if (dlImage) {
+        cachedLoop_[frame_index] = dlImage;
+      } else {
+        // Rather than serving the missing frame on every later loop, decode
+        // each loop again.
+        std::scoped_lock disable_lock(decode_mutex_);
+        cacheLoop_ = false;
+        cachedLoop_.clear();
+        ScheduleDecodesLocked();
+      }
+    }
+    InvokeCallback(std::move(request), std::move(dlImage), frame_index);
+  }
+}
+
+void MultiFrameCodec::State::InvokeCallback(
+    std::unique_ptr<FrameRequest> request,
+    sk_sp<DlImage> dlImage,
+    int frame_index) const {
   fml::RefPtr<CanvasImage> image = nullptr;
   int duration = 0;
-  sk_sp<DlImage> dlImage =
-      GetNextFrameImage(std::move(resourceContext), gpu_disable_sync_switch,
-                        std::move(impeller_context), std::move(unref_queue));
   if (dlImage) {
     image = CanvasImage::Create();
-    image->set_image(dlImage);
-    ImageGenerator::FrameInfo frameInfo =
-        generator_->GetFrameInfo(nextFrameIndex_);
-    duration = frameInfo.duration;
+    image->set_image(std::move(dlImage));
+    duration = frameInfos_[frame_index].duration;
   }
-  nextFrameIndex_ = (nextFrameIndex_ + 1) % frameCount_;
 
   // The static leak checker gets confused by the use of fml::MakeCopyable.
   // NOLINTNEXTLINE(clang-analyzer-cplusplus.NewDeleteLeaks)
-  ui_task_runner->PostTask(fml::MakeCopyable([callback = std::move(callback),
-                                              image = std::move(image),
-                                              duration, trace_id]() mutable {
-    InvokeNextFrameCallback(image, duration, std::move(callback), trace_id);
-  }));
+  request->ui_task_runner->PostTask(fml::MakeCopyable(
+      [callback = std::move(request->callback), image = std::move(image),
+       duration, trace_id = request->trace_id]() mutable {
+        InvokeNextFrameCallback(image, duration, std::move(callback),
+                                trace_id);
+      }));
 }
 
 Dart_Handle MultiFrameCodec::getNextFrame(Dart_Handle callback_handle) {
@@ -236,6 +459,7 @@ Dart_Handle MultiFrameCodec::getNextFrame(Dart_Handle callback_handle) {
            tonic::DartState::Current(), callback_handle),
        weak_state = std::weak_ptr<MultiFrameCodec::State>(state_), trace_id,
        ui_task_runner = task_runners.GetUITaskRunner(),
+       io_task_runner = task_runners.GetIOTaskRunner(),
        io_manager = dart_state->GetIOManager()]() mutable {
         auto state = weak_state.lock();
         if (!state) {
@@ -243,11 +467,21 @@ Dart_Handle MultiFrameCodec::getNextFrame(Dart_Handle callback_handle) {
               [callback = std::move(callback)]() { callback->Clear(); }));
           return;
         }
-        state->GetNextFrameAndInvokeCallback(
-            std::move(callback), ui_task_runner,
-            io_manager->GetResourceContext(), io_manager->GetSkiaUnrefQueue(),
-            io_manager->GetIsGpuDisabledSyncSwitch(), trace_id,
-            io_manager->GetImpellerContext());
+        auto request = std::make_unique<State::FrameRequest>();
+        request->callback = std::move(callback);
+        request->ui_task_runner = std::move(ui_task_runner);
+        request->io_task_runner = std::move(io_task_runner);
+        request->resourceContext = io_manager->GetResourceContext();
+        request->unref_queue = io_manager->GetSkiaUnrefQueue();
+        request->gpu_disable_sync_switch =
+            io_manager->GetIsGpuDisabledSyncSwitch();
+        request->trace_id = trace_id;
+        request->impeller_context = io_manager->GetImpellerContext();
+        {
+          std::scoped_lock lock(state->decode_mutex_);
+          state->pendingRequests_.push_back(std::move(request));
+        }
+        state->ProcessPendingRequests();
       }));
 
   return Dart_Null();
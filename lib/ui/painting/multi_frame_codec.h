@@ -5,6 +5,15 @@
 #ifndef FLUTTER_LIB_UI_PAINTING_MUTLI_FRAME_CODEC_H_
 #define FLUTTER_LIB_UI_PAINTING_MUTLI_FRAME_CODEC_H_
 
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <vector>
+
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "flutter/lib/ui/painting/codec.h"
 #include "flutter/lib/ui/painting/image_generator.h"
@@ -15,7 +24,11 @@ namespace flutter {
 
 class MultiFrameCodec : public Codec {
  public:
-  explicit MultiFrameCodec(std::shared_ptr<ImageGenerator> generator);
+  // Frames are decoded ahead of time on worker threads, so |generator| must
+  // not be used by anything else at the same time. If it has to be shared,
+  // pass |generator_is_shared| and frames are only decoded on the IO thread.
+  explicit MultiFrameCodec(std::shared_ptr<ImageGenerator> generator,
+                           bool generator_is_shared = false);
 
   ~MultiFrameCodec() override;
 
@@ -32,44 +45,109 @@ class MultiFrameCodec : public Codec {
   // Captures the state shared between the IO and UI task runners.
   //
   // The state is initialized on the UI task runner when the Dart object is
-  // created. Decoding occurs on the IO task runner. Since it is possible for
+  // created. Decoding occurs on the IO task runner and, ahead of the frames
+  // being requested, on the concurrent task runner. Since it is possible for
   // the UI object to be collected independently of the IO task runner work,
   // it is not safe for this state to live directly on the MultiFrameCodec.
   // Instead, the MultiFrameCodec creates this object when it is constructed,
   // shares it with the IO task runner's decoding work, and sets the live_
   // member to false when it is destructed.
-  struct State {
-    explicit State(std::shared_ptr<ImageGenerator> generator);
+  struct State : public std::enable_shared_from_this<State> {
+    State(std::shared_ptr<ImageGenerator> generator,
+          bool generator_is_shared);
+
+    ~State();
+
+    // A request for the next frame of the animation.
+    struct FrameRequest {
+      std::unique_ptr<DartPersistentValue> callback;
+      fml::RefPtr<fml::TaskRunner> ui_task_runner;
+      fml::RefPtr<fml::TaskRunner> io_task_runner;
+      fml::WeakPtr<GrDirectContext> resourceContext;
+      fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue;
+      std::shared_ptr<const fml::SyncSwitch> gpu_disable_sync_switch;
+      size_t trace_id;
+      std::shared_ptr<impeller::Context> impeller_context;
+    };
+
+    // A frame that has been claimed for decoding along with everything
+    // needed to decode it.
+    struct DecodeJob {
+      uint64_t sequence;
+      std::shared_ptr<ImageGenerator> generator;
+      std::shared_ptr<const SkBitmap> required_frame;
+      int required_frame_index;
+    };
 
     const std::shared_ptr<ImageGenerator> generator_;
     const int frameCount_;
     const int repetitionCount_;
     bool is_impeller_enabled_ = false;
 
-    // The non-const members and functions below here are only read or written
-    // to on the IO thread. They are not safe to access or write on the UI
-    // thread.
-    int nextFrameIndex_;
+    // The members below are immutable after construction and may be read on
+    // any thread.
+    const SkImageInfo info_;
+    const std::vector<ImageGenerator::FrameInfo> frameInfos_;
+    const std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner_;
+    // The number of frames, including the next frame to be delivered, that
+    // may be decoded ahead of time.
+    const uint64_t decodeAheadFrames_;
+    // Whether the uploaded frames of the first loop are kept and reused for
+    // subsequent loops. Only written to on the IO thread while holding
+    // decode_mutex_, and cleared if a frame of the first loop fails.
+    bool cacheLoop_;
+
+    // Only read or written to on the IO thread.
+    std::vector<sk_sp<DlImage>> cachedLoop_;
+
+    // The members below are guarded by decode_mutex_. Frames are identified
+    // by a sequence number that keeps increasing across loops.
+    std::mutex decode_mutex_;
+    uint64_t nextSequenceToDeliver_ = 0;
+    uint64_t nextSequenceToDecode_ = 0;
+    std::vector<std::shared_ptr<ImageGenerator>> idleGenerators_;
+    size_t generatorCount_ = 1;
+    std::set<uint64_t> inFlight_;
+    // Frames decoded ahead of time. A null bitmap marks a failed decode.
+    std::map<uint64_t, std::shared_ptr<SkBitmap>> decodedFrames_;
+    // Requests that are waiting for their frame to be decoded, in the order
+    // in which they were made.
+    std::deque<std::unique_ptr<FrameRequest>> pendingRequests_;
     // The last decoded frame that's required to decode any subsequent frames.
-    std::unique_ptr<SkBitmap> lastRequiredFrame_;
+    std::shared_ptr<const SkBitmap> lastRequiredFrame_;
+    // The sequence number of the last decoded required frame.
+    int64_t lastRequiredFrameSequence_ = -1;
 
-    // The index of the last decoded required frame.
-    int lastRequiredFrameIndex_ = -1;
+    std::shared_ptr<SkBitmap> DecodeFrame(const DecodeJob& job) const;
 
-    sk_sp<DlImage> GetNextFrameImage(
+    sk_sp<DlImage> UploadFrame(
+        const SkBitmap& bitmap,
         fml::WeakPtr<GrDirectContext> resourceContext,
         const std::shared_ptr<const fml::SyncSwitch>& gpu_disable_sync_switch,
-        std::shared_ptr<impeller::Context> impeller_context_,
-        fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue);
+        const std::shared_ptr<impeller::Context>& impeller_context,
+        fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue) const;
 
-    void GetNextFrameAndInvokeCallback(
-        std::unique_ptr<DartPersistentValue> callback,
-        const fml::RefPtr<fml::TaskRunner>& ui_task_runner,
-        fml::WeakPtr<GrDirectContext> resourceContext,
-        fml::RefPtr<flutter::SkiaUnrefQueue> unref_queue,
-        const std::shared_ptr<const fml::SyncSwitch>& gpu_disable_sync_switch,
-        size_t trace_id,
-        std::shared_ptr<impeller::Context> impeller_context_);
+    // Claims the next frame to be decoded if its dependencies and the decode
+    // ahead window allow it.
+    std::optional<DecodeJob> ClaimNextFrameLocked();
+
+    // Claims and posts decodes for as many frames as are allowed.
+    void ScheduleDecodesLocked();
+
+    // Records the result of a decode and returns its generator to the pool.
+    void FinishDecodeLocked(const DecodeJob& job,
+                            const std::shared_ptr<SkBitmap>& bitmap);
+
+    void OnFrameDecodedAhead(const DecodeJob& job,
+                             std::shared_ptr<SkBitmap> bitmap);
+
+    // Services pending requests in order until one has to wait for a frame
+    // that is being decoded ahead of time. Runs on the IO task runner.
+    void ProcessPendingRequests();
+
+    void InvokeCallback(std::unique_ptr<FrameRequest> request,
+                        sk_sp<DlImage> dlImage,
+                        int frame_index) const;
   };
 
   // Shared across the UI and IO task runners.
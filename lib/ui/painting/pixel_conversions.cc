@@ -0,0 +1,515 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/pixel_conversions.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <optional>
+#include <vector>
+
+#include "flutter/fml/build_config.h"
+#include "third_party/skia/include/core/SkColorSpace.h"
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Every architecture supported by build_config.h is little endian, so the
+// alpha channel is always in the most significant byte of a 32-bit pixel.
+
+namespace flutter {
+
+// round(x * y / 255) for x, y in [0, 255].
+static inline uint32_t MulDiv255Round(uint32_t x, uint32_t y) {
+  const uint32_t t = x * y + 128;
+  return (t + (t >> 8)) >> 8;
+}
+
+#if defined(__SSE2__)
+// MulDiv255Round for each 16-bit lane. Lanes must not exceed 255.
+static inline __m128i MulDiv255RoundEpi16(__m128i x, __m128i y) {
+  const __m128i t = _mm_add_epi16(_mm_mullo_epi16(x, y), _mm_set1_epi16(128));
+  return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+// Premultiplies two pixels that have been widened to 16-bit lanes. The alpha
+// lanes are multiplied by themselves and must be restored by the caller.
+static inline __m128i PremultiplyEpi16(__m128i pixels) {
+  const __m128i alpha = _mm_shufflehi_epi16(
+      _mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)),
+      _MM_SHUFFLE(3, 3, 3, 3));
+  return MulDiv255RoundEpi16(pixels, alpha);
+}
+#endif  // defined(__SSE2__)
+
+#if defined(__AVX2__)
+static inline __m256i PremultiplyEpi16(__m256i pixels) {
+  const __m256i alpha = _mm256_shufflehi_epi16(
+      _mm256_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)),
+      _MM_SHUFFLE(3, 3, 3, 3));
+  const __m256i t = _mm256_add_epi16(_mm256_mullo_epi16(pixels, alpha),
+                                     _mm256_set1_epi16(128));
+  return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+}
+#endif  // defined(__AVX2__)
+
+#if defined(__ARM_NEON)
+static inline uint8x8_t MulDiv255Round(uint8x8_t x, uint8x8_t y) {
+  const uint16x8_t t = vmull_u8(x, y);
+  return vraddhn_u16(t, vrshrq_n_u16(t, 8));
+}
+#endif  // defined(__ARM_NEON)
+
+void SwapRedAndBlue(uint32_t* dst, const uint32_t* src, size_t count) {
+  size_t i = 0;
+#if defined(__AVX2__)
+  {
+    const __m256i green_alpha = _mm256_set1_epi32(static_cast<int>(0xFF00FF00));
+    const __m256i low_byte = _mm256_set1_epi32(0xFF);
+    for (; i + 8 <= count; i += 8) {
+      const __m256i p =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+      const __m256i red_blue = _mm256_or_si256(
+          _mm256_and_si256(_mm256_srli_epi32(p, 16), low_byte),
+          _mm256_slli_epi32(_mm256_and_si256(p, low_byte), 16));
+      _mm256_storeu_si256(
+          reinterpret_cast<__m256i*>(dst + i),
+          _mm256_or_si256(_mm256_and_si256(p, green_alpha), red_blue));
+    }
+  }
+#endif  // defined(__AVX2__)
+#if defined(__SSE2__)
+  {
+    const __m128i green_alpha = _mm_set1_epi32(static_cast<int>(0xFF00FF00));
+    const __m128i low_byte = _mm_set1_epi32(0xFF);
+    for (; i + 4 <= count; i += 4) {
+      const __m128i p =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+      const __m128i red_blue =
+          _mm_or_si128(_mm_and_si128(_mm_srli_epi32(p, 16), low_byte),
+                       _mm_slli_epi32(_mm_and_si128(p, low_byte), 16));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                       _mm_or_si128(_mm_and_si128(p, green_alpha), red_blue));
+    }
+  }
+#elif defined(__ARM_NEON)
+  for (; i + 16 <= count; i += 16) {
+    uint8x16x4_t p = vld4q_u8(reinterpret_cast<const uint8_t*>(src + i));
+    std::swap(p.val[0], p.val[2]);
+    vst4q_u8(reinterpret_cast<uint8_t*>(dst + i), p);
+  }
+#endif
+  for (; i < count; i++) {
+    const uint32_t p = src[i];
+    dst[i] = (p & 0xFF00FF00) | ((p >> 16) & 0xFF) | ((p & 0xFF) << 16);
+  }
+}
+
+void PremultiplyAlpha(uint32_t* dst, const uint32_t* src, size_t count) {
+  size_t i = 0;
+#if defined(__AVX2__)
+  {
+    const __m256i alpha_mask = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+    const __m256i zero = _mm256_setzero_si256();
+    for (; i + 8 <= count; i += 8) {
+      const __m256i p =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+      const __m256i colors = _mm256_packus_epi16(
+          PremultiplyEpi16(_mm256_unpacklo_epi8(p, zero)),
+          PremultiplyEpi16(_mm256_unpackhi_epi8(p, zero)));
+      _mm256_storeu_si256(
+          reinterpret_cast<__m256i*>(dst + i),
+          _mm256_or_si256(_mm256_andnot_si256(alpha_mask, colors),
+                          _mm256_and_si256(alpha_mask, p)));
+    }
+  }
+#endif  // defined(__AVX2__)
+#if defined(__SSE2__)
+  {
+    const __m128i alpha_mask = _mm_set1_epi32(static_cast<int>(0xFF000000));
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 4 <= count; i += 4) {
+      const __m128i p =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+      const __m128i colors =
+          _mm_packus_epi16(PremultiplyEpi16(_mm_unpacklo_epi8(p, zero)),
+                           PremultiplyEpi16(_mm_unpackhi_epi8(p, zero)));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                       _mm_or_si128(_mm_andnot_si128(alpha_mask, colors),
+                                    _mm_and_si128(alpha_mask, p)));
+    }
+  }
+#elif defined(__ARM_NEON)
+  for (; i + 8 <= count; i += 8) {
+    uint8x8x4_t p = vld4_u8(reinterpret_cast<const uint8_t*>(src + i));
+    p.val[0] = MulDiv255Round(p.val[0], p.val[3]);
+    p.val[1] = MulDiv255Round(p.val[1], p.val[3]);
+    p.val[2] = MulDiv255Round(p.val[2], p.val[3]);
+    vst4_u8(reinterpret_cast<uint8_t*>(dst + i), p);
+  }
+#endif
+  for (; i < count; i++) {
+    const uint32_t p = src[i];
+    const uint32_t a = p >> 24;
+    dst[i] = (a << 24) | (MulDiv255Round((p >> 16) & 0xFF, a) << 16) |
+             (MulDiv255Round((p >> 8) & 0xFF, a) << 8) |
+             MulDiv255Round(p & 0xFF, a);
+  }
+}
+
+// Fixed point reciprocals for which (c * scale + 0x8000) >> 16 is exactly
+// round(c * 255 / a) for every c <= a.
+static constexpr std::array<uint32_t, 256> MakeUnpremultiplyScales() {
+  std::array<uint32_t, 256> scales = {};
+  for (uint32_t a = 1; a < 256; a++) {
+    scales[a] = ((255u << 16) + a - 1) / a;
+  }
+  return scales;
+}
+
+static constexpr std::array<uint32_t, 256> kUnpremultiplyScales =
+    MakeUnpremultiplyScales();
+
+void UnpremultiplyAlpha(uint32_t* dst, const uint32_t* src, size_t count) {
+  // Division has no integer SIMD equivalent. A table of reciprocals keeps
+  // this a multiply per channel, and opaque pixels are skipped entirely.
+  for (size_t i = 0; i < count; i++) {
+    const uint32_t p = src[i];
+    const uint32_t a = p >> 24;
+    if (a == 255) {
+      dst[i] = p;
+      continue;
+    }
+    const uint32_t scale = kUnpremultiplyScales[a];
+    auto unpremultiply = [scale](uint32_t c) -> uint32_t {
+      return std::min<uint32_t>((c * scale + 0x8000) >> 16, 255);
+    };
+    dst[i] = (a << 24) | (unpremultiply((p >> 16) & 0xFF) << 16) |
+             (unpremultiply((p >> 8) & 0xFF) << 8) | unpremultiply(p & 0xFF);
+  }
+}
+
+// round(c5 * 255 / 31) and round(c6 * 255 / 63) without a division.
+static inline uint32_t Expand5(uint32_t c) {
+  return (c * 527 + 23) >> 6;
+}
+
+static inline uint32_t Expand6(uint32_t c) {
+  return (c * 259 + 33) >> 6;
+}
+
+void PackRGB565(uint16_t* dst, const uint32_t* src, size_t count) {
+  size_t i = 0;
+#if defined(__SSE2__)
+  {
+    const __m128i low_byte = _mm_set1_epi32(0xFF);
+    const __m128i max5 = _mm_set1_epi32(31);
+    const __m128i max6 = _mm_set1_epi32(63);
+    // Each pixel occupies a 32-bit lane whose upper 16 bits remain zero, so
+    // the 16-bit multiplies never overflow into a neighbouring channel.
+    auto pack = [&](__m128i p) {
+      const __m128i r = MulDiv255RoundEpi16(_mm_and_si128(p, low_byte), max5);
+      const __m128i g = MulDiv255RoundEpi16(
+          _mm_and_si128(_mm_srli_epi32(p, 8), low_byte), max6);
+      const __m128i b = MulDiv255RoundEpi16(
+          _mm_and_si128(_mm_srli_epi32(p, 16), low_byte), max5);
+      const __m128i packed = _mm_or_si128(
+          _mm_or_si128(_mm_slli_epi32(r, 11), _mm_slli_epi32(g, 5)), b);
+      // Sign extend so that the saturating pack keeps all 16 bits.
+      return _mm_srai_epi32(_mm_slli_epi32(packed, 16), 16);
+    };
+    for (; i + 8 <= count; i += 8) {
+      const __m128i lo = pack(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+      const __m128i hi = pack(
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 4)));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                       _mm_packs_epi32(lo, hi));
+    }
+  }
+#elif defined(__ARM_NEON)
+  {
+    const uint8x8_t max5 = vdup_n_u8(31);
+    const uint8x8_t max6 = vdup_n_u8(63);
+    for (; i + 8 <= count; i += 8) {
+      const uint8x8x4_t p = vld4_u8(reinterpret_cast<const uint8_t*>(src + i));
+      const uint16x8_t r = vmovl_u8(MulDiv255Round(p.val[0], max5));
+      const uint16x8_t g = vmovl_u8(MulDiv255Round(p.val[1], max6));
+      const uint16x8_t b = vmovl_u8(MulDiv255Round(p.val[2], max5));
+      vst1q_u16(dst + i, vorrq_u16(vorrq_u16(vshlq_n_u16(r, 11),
+                                             vshlq_n_u16(g, 5)),
+                                   b));
+    }
+  }
+#endif
+  for (; i < count; i++) {
+    const uint32_t p = src[i];
+    dst[i] = static_cast<uint16_t>((MulDiv255Round(p & 0xFF, 31) << 11) |
+                                   (MulDiv255Round((p >> 8) & 0xFF, 63) << 5) |
+                                   MulDiv255Round((p >> 16) & 0xFF, 31));
+  }
+}
+
+void UnpackRGB565(uint32_t* dst, const uint16_t* src, size_t count) {
+  size_t i = 0;
+#if defined(__SSE2__)
+  {
+    const __m128i mask5 = _mm_set1_epi16(0x1F);
+    const __m128i mask6 = _mm_set1_epi16(0x3F);
+    const __m128i opaque = _mm_set1_epi16(static_cast<int16_t>(0xFF00));
+    auto expand = [](__m128i c, int16_t scale, int16_t bias) {
+      const __m128i scaled = _mm_mullo_epi16(c, _mm_set1_epi16(scale));
+      return _mm_srli_epi16(_mm_add_epi16(scaled, _mm_set1_epi16(bias)), 6);
+    };
+    for (; i + 8 <= count; i += 8) {
+      const __m128i p =
+          _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+      const __m128i r = expand(_mm_srli_epi16(p, 11), 527, 23);
+      const __m128i g =
+          expand(_mm_and_si128(_mm_srli_epi16(p, 5), mask6), 259, 33);
+      const __m128i b = expand(_mm_and_si128(p, mask5), 527, 23);
+      const __m128i rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+      const __m128i ba = _mm_or_si128(b, opaque);
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i),
+                       _mm_unpacklo_epi16(rg, ba));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 4),
+                       _mm_unpackhi_epi16(rg, ba));
+    }
+  }
+#elif defined(__ARM_NEON)
+  for (; i + 8 <= count; i += 8) {
+    const uint16x8_t p = vld1q_u16(src + i);
+    const uint16x8_t r = vshrq_n_u16(p, 11);
+    const uint16x8_t g = vandq_u16(vshrq_n_u16(p, 5), vdupq_n_u16(0x3F));
+    const uint16x8_t b = vandq_u16(p, vdupq_n_u16(0x1F));
+    uint8x8x4_t out;
+    out.val[0] = vshrn_n_u16(vmlaq_n_u16(vdupq_n_u16(23), r, 527), 6);
+    out.val[1] = vshrn_n_u16(vmlaq_n_u16(vdupq_n_u16(33), g, 259), 6);
+    out.val[2] = vshrn_n_u16(vmlaq_n_u16(vdupq_n_u16(23), b, 527), 6);
+    out.val[3] = vdup_n_u8(255);
+    vst4_u8(reinterpret_cast<uint8_t*>(dst + i), out);
+  }
+#endif
+  for (; i < count; i++) {
+    const uint32_t p = src[i];
+    dst[i] = 0xFF000000 | (Expand5(p & 0x1F) << 16) |
+             (Expand6((p >> 5) & 0x3F) << 8) | Expand5(p >> 11);
+  }
+}
+
+using TransferTable = std::array<uint8_t, 256>;
+
+static const TransferTable& GetLinearToSRGBTable() {
+  static const TransferTable table = [] {
+    TransferTable table;
+    for (size_t i = 0; i < table.size(); i++) {
+      const double v = i / 255.0;
+      const double encoded =
+          v <= 0.0031308 ? v * 12.92 : 1.055 * std::pow(v, 1.0 / 2.4) - 0.055;
+      table[i] = static_cast<uint8_t>(std::lround(encoded * 255.0));
+    }
+    return table;
+  }();
+  return table;
+}
+
+static const TransferTable& GetSRGBToLinearTable() {
+  static const TransferTable table = [] {
+    TransferTable table;
+    for (size_t i = 0; i < table.size(); i++) {
+      const double v = i / 255.0;
+      const double decoded =
+          v <= 0.04045 ? v / 12.92 : std::pow((v + 0.055) / 1.055, 2.4);
+      table[i] = static_cast<uint8_t>(std::lround(decoded * 255.0));
+    }
+    return table;
+  }();
+  return table;
+}
+
+static void ApplyTransferTable(const TransferTable& table,
+                               uint32_t* dst,
+                               const uint32_t* src,
+                               size_t count) {
+  // Lookups have no profitable SIMD equivalent without gathers.
+  for (size_t i = 0; i < count; i++) {
+    const uint32_t p = src[i];
+    dst[i] = (p & 0xFF000000) | (table[(p >> 16) & 0xFF] << 16) |
+             (table[(p >> 8) & 0xFF] << 8) | table[p & 0xFF];
+  }
+}
+
+void LinearToSRGB(uint32_t* dst, const uint32_t* src, size_t count) {
+  ApplyTransferTable(GetLinearToSRGBTable(), dst, src, count);
+}
+
+void SRGBToLinear(uint32_t* dst, const uint32_t* src, size_t count) {
+  ApplyTransferTable(GetSRGBToLinearTable(), dst, src, count);
+}
+
+namespace {
+
+enum class PixelLayout {
+  kRGBA8888,
+  kBGRA8888,
+  kRGB565,
+};
+
+enum class TransferFunction {
+  kNone,
+  kSRGBToLinear,
+  kLinearToSRGB,
+};
+
+}  // namespace
+
+static std::optional<PixelLayout> GetPixelLayout(SkColorType type) {
+  switch (type) {
+    case kRGBA_8888_SkColorType:
+      return PixelLayout::kRGBA8888;
+    case kBGRA_8888_SkColorType:
+      return PixelLayout::kBGRA8888;
+    case kRGB_565_SkColorType:
+      return PixelLayout::kRGB565;
+    default:
+      return std::nullopt;
+  }
+}
+
+static std::optional<TransferFunction> GetTransferFunction(
+    SkColorSpace* src,
+    SkColorSpace* dst) {
+  if (!dst || SkColorSpace::Equals(src, dst)) {
+    return TransferFunction::kNone;
+  }
+  if (!src) {
+    return std::nullopt;
+  }
+  static const SkColorSpace* linear = SkColorSpace::MakeSRGBLinear().release();
+  if (src->isSRGB() && SkColorSpace::Equals(dst, linear)) {
+    return TransferFunction::kSRGBToLinear;
+  }
+  if (dst->isSRGB() && SkColorSpace::Equals(src, linear)) {
+    return TransferFunction::kLinearToSRGB;
+  }
+  return std::nullopt;
+}
+
+bool ConvertPixels(const SkPixmap& src, const SkPixmap& dst) {
+  if (src.dimensions() != dst.dimensions() || !src.addr() ||
+      !dst.writable_addr()) {
+    return false;
+  }
+
+  const auto src_layout = GetPixelLayout(src.colorType());
+  const auto dst_layout = GetPixelLayout(dst.colorType());
+  const auto transfer =
+      GetTransferFunction(src.colorSpace(), dst.colorSpace());
+  if (!src_layout.has_value() || !dst_layout.has_value() ||
+      !transfer.has_value()) {
+    return false;
+  }
+
+  const SkAlphaType src_alpha = src.alphaType();
+  const SkAlphaType dst_alpha = dst.alphaType();
+  if (src_alpha == kUnknown_SkAlphaType || dst_alpha == kUnknown_SkAlphaType) {
+    return false;
+  }
+  const bool src_opaque = src_alpha == kOpaque_SkAlphaType ||
+                          src_layout == PixelLayout::kRGB565;
+  const bool dst_opaque = dst_alpha == kOpaque_SkAlphaType ||
+                          dst_layout == PixelLayout::kRGB565;
+  // Converting to an opaque format would have to discard alpha.
+  if (!src_opaque && dst_opaque) {
+    return false;
+  }
+
+  const bool has_transfer = transfer.value() != TransferFunction::kNone;
+  const bool unpremultiply =
+      !src_opaque && src_alpha == kPremul_SkAlphaType &&
+      (has_transfer || dst_alpha == kUnpremul_SkAlphaType);
+  const bool premultiply =
+      !src_opaque && dst_alpha == kPremul_SkAlphaType &&
+      (has_transfer || src_alpha == kUnpremul_SkAlphaType);
+
+  const int width = src.width();
+  const int height = src.height();
+
+  if (src_layout == dst_layout && !has_transfer && !unpremultiply &&
+      !premultiply) {
+    const size_t row_bytes = src.info().minRowBytes();
+    for (int y = 0; y < height; y++) {
+      std::memcpy(dst.writable_addr(0, y), src.addr(0, y), row_bytes);
+    }
+    return true;
+  }
+
+  // Pixels are converted in place in each destination row, or in a scratch
+  // row if the destination is not a 32-bit format.
+  const PixelLayout working_layout = dst_layout == PixelLayout::kRGB565
+                                         ? PixelLayout::kRGBA8888
+                                         : dst_layout.value();
+  std::vector<uint32_t> scratch;
+  if (dst_layout == PixelLayout::kRGB565) {
+    scratch.resize(width);
+  }
+
+  for (int y = 0; y < height; y++) {
+    uint32_t* row = scratch.empty()
+                        ? static_cast<uint32_t*>(dst.writable_addr(0, y))
+                        : scratch.data();
+    const uint32_t* pixels = nullptr;
+
+    if (src_layout == PixelLayout::kRGB565) {
+      UnpackRGB565(row, src.addr16(0, y), width);
+      pixels = row;
+      if (working_layout == PixelLayout::kBGRA8888) {
+        SwapRedAndBlue(row, pixels, width);
+      }
+    } else {
+      pixels = src.addr32(0, y);
+      if (src_layout != working_layout) {
+        SwapRedAndBlue(row, pixels, width);
+        pixels = row;
+      }
+    }
+
+    if (unpremultiply) {
+      UnpremultiplyAlpha(row, pixels, width);
+      pixels = row;
+    }
+    switch (transfer.value()) {
+      case TransferFunction::kNone:
+        break;
+      case TransferFunction::kSRGBToLinear:
+        SRGBToLinear(row, pixels, width);
+        pixels = row;
+        break;
+      case TransferFunction::kLinearToSRGB:
+        LinearToSRGB(row, pixels, width);
+        pixels = row;
+        break;
+    }
+    if (premultiply) {
+      PremultiplyAlpha(row, pixels, width);
+      pixels = row;
+    }
+
+    if (pixels != row) {
+      std::memcpy(row, pixels, width * sizeof(uint32_t));
+    }
+    if (dst_layout == PixelLayout::kRGB565) {
+      PackRGB565(dst.writable_addr16(0, y), row, width);
+    }
+  }
+
+  return true;
+}
+
+}  // namespace flutter
@@ -0,0 +1,79 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_PAINTING_PIXEL_CONVERSIONS_H_
+#define FLUTTER_LIB_UI_PAINTING_PIXEL_CONVERSIONS_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "third_party/skia/include/core/SkPixmap.h"
+
+namespace flutter {
+
+// Kernels for converting runs of pixels between the formats used when
+// decoding and uploading images.
+//
+// 32-bit pixels are four 8-bit channels with the alpha channel last in memory
+// (RGBA8888 or BGRA8888). All kernels produce the same results regardless of
+// the instruction set they were compiled for, and all of them may be used in
+// place (dst == src).
+
+//------------------------------------------------------------------------------
+/// @brief      Swaps the first and third channel of each pixel, converting
+///             between RGBA8888 and BGRA8888.
+///
+void SwapRedAndBlue(uint32_t* dst, const uint32_t* src, size_t count);
+
+//------------------------------------------------------------------------------
+/// @brief      Multiplies the color channels by alpha. Each channel becomes
+///             round(c * a / 255).
+///
+void PremultiplyAlpha(uint32_t* dst, const uint32_t* src, size_t count);
+
+//------------------------------------------------------------------------------
+/// @brief      Divides the color channels by alpha. Each channel becomes
+///             min(255, round(c * 255 / a)), or zero if alpha is zero.
+///
+void UnpremultiplyAlpha(uint32_t* dst, const uint32_t* src, size_t count);
+
+//------------------------------------------------------------------------------
+/// @brief      Packs opaque RGBA8888 pixels into RGB565, rounding each channel
+///             to the nearest representable value. Alpha is dropped.
+///
+void PackRGB565(uint16_t* dst, const uint32_t* src, size_t count);
+
+//------------------------------------------------------------------------------
+/// @brief      Expands RGB565 pixels into opaque RGBA8888 pixels.
+///
+void UnpackRGB565(uint32_t* dst, const uint16_t* src, size_t count);
+
+//------------------------------------------------------------------------------
+/// @brief      Applies the linear to sRGB (or sRGB to linear) transfer
+///             function to the color channels of unpremultiplied pixels.
+///             Alpha is unchanged.
+///
+void LinearToSRGB(uint32_t* dst, const uint32_t* src, size_t count);
+void SRGBToLinear(uint32_t* dst, const uint32_t* src, size_t count);
+
+//------------------------------------------------------------------------------
+/// @brief      Converts pixels between pixmaps of the same dimensions using
+///             the kernels above.
+///
+///             Supports the RGBA8888, BGRA8888 and RGB565 color types, any
+///             conversion between premultiplied, unpremultiplied and opaque
+///             alpha that does not discard alpha, and conversions between the
+///             sRGB and linear sRGB color spaces. A destination without a
+///             color space is never color converted, which matches
+///             |SkPixmap::readPixels|.
+///
+/// @return     False if the conversion is not supported, in which case the
+///             destination is unmodified and callers should fall back to
+///             |SkPixmap::readPixels|.
+///
+bool ConvertPixels(const SkPixmap& src, const SkPixmap& dst);
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_PAINTING_PIXEL_CONVERSIONS_H_
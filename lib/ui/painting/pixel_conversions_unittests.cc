@@ -0,0 +1,253 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/painting/pixel_conversions.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "third_party/skia/include/core/SkColorSpace.h"
+
+namespace flutter {
+namespace testing {
+
+// Scalar reference implementations that the kernels must match exactly.
+
+static uint32_t Channel(uint32_t pixel, int index) {
+  return (pixel >> (8 * index)) & 0xFF;
+}
+
+static uint32_t MakePixel(uint32_t c0, uint32_t c1, uint32_t c2, uint32_t a) {
+  return c0 | (c1 << 8) | (c2 << 16) | (a << 24);
+}
+
+static uint32_t ReferencePremultiply(uint32_t pixel) {
+  const uint32_t a = Channel(pixel, 3);
+  auto premultiply = [a](uint32_t c) {
+    return static_cast<uint32_t>(std::lround(c * a / 255.0));
+  };
+  return MakePixel(premultiply(Channel(pixel, 0)),
+                   premultiply(Channel(pixel, 1)),
+                   premultiply(Channel(pixel, 2)), a);
+}
+
+static uint32_t ReferenceUnpremultiply(uint32_t pixel) {
+  const uint32_t a = Channel(pixel, 3);
+  auto unpremultiply = [a](uint32_t c) -> uint32_t {
+    if (a == 0) {
+      return 0;
+    }
+    return std::min<uint32_t>(std::lround(c * 255.0 / a), 255);
+  };
+  return MakePixel(unpremultiply(Channel(pixel, 0)),
+                   unpremultiply(Channel(pixel, 1)),
+                   unpremultiply(Channel(pixel, 2)), a);
+}
+
+static uint16_t ReferencePackRGB565(uint32_t pixel) {
+  const uint32_t r = std::lround(Channel(pixel, 0) * 31 / 255.0);
+  const uint32_t g = std::lround(Channel(pixel, 1) * 63 / 255.0);
+  const uint32_t b = std::lround(Channel(pixel, 2) * 31 / 255.0);
+  return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+}
+
+static uint32_t ReferenceUnpackRGB565(uint16_t pixel) {
+  const uint32_t r = std::lround((pixel >> 11) * 255 / 31.0);
+  const uint32_t g = std::lround(((pixel >> 5) & 0x3F) * 255 / 63.0);
+  const uint32_t b = std::lround((pixel & 0x1F) * 255 / 31.0);
+  return MakePixel(r, g, b, 255);
+}
+
+static uint32_t ReferenceSRGBToLinear(uint32_t pixel) {
+  auto decode = [](uint32_t c) -> uint32_t {
+    const double v = c / 255.0;
+    return std::lround(
+        (v <= 0.04045 ? v / 12.92 : std::pow((v + 0.055) / 1.055, 2.4)) *
+        255.0);
+  };
+  return MakePixel(decode(Channel(pixel, 0)), decode(Channel(pixel, 1)),
+                   decode(Channel(pixel, 2)), Channel(pixel, 3));
+}
+
+static uint32_t ReferenceLinearToSRGB(uint32_t pixel) {
+  auto encode = [](uint32_t c) -> uint32_t {
+    const double v = c / 255.0;
+    return std::lround(
+        (v <= 0.0031308 ? v * 12.92 : 1.055 * std::pow(v, 1.0 / 2.4) - 0.055) *
+        255.0);
+  };
+  return MakePixel(encode(Channel(pixel, 0)), encode(Channel(pixel, 1)),
+                   encode(Channel(pixel, 2)), Channel(pixel, 3));
+}
+
+// Every combination of color and alpha, followed by random pixels. The odd
+// count exercises the scalar tail after the vectorized loops.
+static std::vector<uint32_t> MakeTestPixels() {
+  std::vector<uint32_t> pixels;
+  for (uint32_t a = 0; a < 256; a++) {
+    for (uint32_t c = 0; c < 256; c++) {
+      pixels.push_back(MakePixel(c, 255 - c, (c * 7) & 0xFF, a));
+    }
+  }
+  std::mt19937 random(42);
+  for (int i = 0; i < 1027; i++) {
+    pixels.push_back(random());
+  }
+  return pixels;
+}
+
+TEST(PixelConversionsTest, SwapRedAndBlueMatchesReference) {
+  const auto src = MakeTestPixels();
+  std::vector<uint32_t> dst(src.size());
+  SwapRedAndBlue(dst.data(), src.data(), src.size());
+  for (size_t i = 0; i < src.size(); i++) {
+    ASSERT_EQ(dst[i], MakePixel(Channel(src[i], 2), Channel(src[i], 1),
+                                Channel(src[i], 0), Channel(src[i], 3)))
+        << "at index " << i;
+  }
+}
+
+TEST(PixelConversionsTest, PremultiplyAlphaMatchesReference) {
+  const auto src = MakeTestPixels();
+  std::vector<uint32_t> dst(src.size());
+  PremultiplyAlpha(dst.data(), src.data(), src.size());
+  for (size_t i = 0; i < src.size(); i++) {
+    ASSERT_EQ(dst[i], ReferencePremultiply(src[i])) << "at index " << i;
+  }
+}
+
+TEST(PixelConversionsTest, UnpremultiplyAlphaMatchesReference) {
+  const auto src = MakeTestPixels();
+  std::vector<uint32_t> dst(src.size());
+  UnpremultiplyAlpha(dst.data(), src.data(), src.size());
+  for (size_t i = 0; i < src.size(); i++) {
+    ASSERT_EQ(dst[i], ReferenceUnpremultiply(src[i])) << "at index " << i;
+  }
+}
+
+TEST(PixelConversionsTest, RGB565MatchesReference) {
+  const auto src = MakeTestPixels();
+  std::vector<uint16_t> packed(src.size());
+  PackRGB565(packed.data(), src.data(), src.size());
+  for (size_t i = 0; i < src.size(); i++) {
+    ASSERT_EQ(packed[i], ReferencePackRGB565(src[i])) << "at index " << i;
+  }
+
+  std::vector<uint16_t> all_565(65536 + 13);
+  for (size_t i = 0; i < all_565.size(); i++) {
+    all_565[i] = static_cast<uint16_t>(i);
+  }
+  std::vector<uint32_t> unpacked(all_565.size());
+  UnpackRGB565(unpacked.data(), all_565.data(), all_565.size());
+  for (size_t i = 0; i < all_565.size(); i++) {
+    ASSERT_EQ(unpacked[i], ReferenceUnpackRGB565(all_565[i]))
+        << "at index " << i;
+  }
+}
+
+TEST(PixelConversionsTest, TransferFunctionsMatchReference) {
+  const auto src = MakeTestPixels();
+  std::vector<uint32_t> dst(src.size());
+  SRGBToLinear(dst.data(), src.data(), src.size());
+  for (size_t i = 0; i < src.size(); i++) {
+    ASSERT_EQ(dst[i], ReferenceSRGBToLinear(src[i])) << "at index " << i;
+  }
+  LinearToSRGB(dst.data(), src.data(), src.size());
+  for (size_t i = 0; i < src.size(); i++) {
+    ASSERT_EQ(dst[i], ReferenceLinearToSRGB(src[i])) << "at index " << i;
+  }
+}
+
+TEST(PixelConversionsTest, KernelsMayRunInPlace) {
+  const auto src = MakeTestPixels();
+  std::vector<uint32_t> expected(src.size());
+  PremultiplyAlpha(expected.data(), src.data(), src.size());
+  SwapRedAndBlue(expected.data(), expected.data(), expected.size());
+
+  auto in_place = src;
+  PremultiplyAlpha(in_place.data(), in_place.data(), in_place.size());
+  SwapRedAndBlue(in_place.data(), in_place.data(), in_place.size());
+  ASSERT_EQ(in_place, expected);
+}
+
+TEST(PixelConversionsTest, ConvertPixelsSwizzlesAndPremultipliesRows) {
+  const int width = 37;
+  const int height = 5;
+  const auto pixels = MakeTestPixels();
+  // Padded rows check that row bytes are respected.
+  const size_t src_row_bytes = (width + 3) * sizeof(uint32_t);
+  std::vector<uint32_t> src_storage(height * (width + 3));
+  for (int y = 0; y < height; y++) {
+    std::copy_n(pixels.begin() + y * width * 311, width,
+                src_storage.begin() + y * (width + 3));
+  }
+  const SkPixmap src(SkImageInfo::Make(width, height, kRGBA_8888_SkColorType,
+                                       kUnpremul_SkAlphaType),
+                     src_storage.data(), src_row_bytes);
+
+  std::vector<uint32_t> dst_storage(width * height);
+  const SkPixmap dst(SkImageInfo::Make(width, height, kBGRA_8888_SkColorType,
+                                       kPremul_SkAlphaType),
+                     dst_storage.data(), width * sizeof(uint32_t));
+  ASSERT_TRUE(ConvertPixels(src, dst));
+
+  for (int y = 0; y < height; y++) {
+    for (int x = 0; x < width; x++) {
+      const uint32_t premul = ReferencePremultiply(*src.addr32(x, y));
+      ASSERT_EQ(*dst.addr32(x, y),
+                MakePixel(Channel(premul, 2), Channel(premul, 1),
+                          Channel(premul, 0), Channel(premul, 3)));
+    }
+  }
+}
+
+TEST(PixelConversionsTest, ConvertPixelsMatchesSkiaForSwizzles) {
+  const int width = 64;
+  const int height = 64;
+  const auto pixels = MakeTestPixels();
+  const SkPixmap src(SkImageInfo::Make(width, height, kRGBA_8888_SkColorType,
+                                       kPremul_SkAlphaType),
+                     pixels.data(), width * sizeof(uint32_t));
+  const auto dst_info = src.info().makeColorType(kBGRA_8888_SkColorType);
+
+  std::vector<uint32_t> converted(width * height);
+  std::vector<uint32_t> expected(width * height);
+  ASSERT_TRUE(ConvertPixels(
+      src, SkPixmap(dst_info, converted.data(), dst_info.minRowBytes())));
+  ASSERT_TRUE(src.readPixels(
+      SkPixmap(dst_info, expected.data(), dst_info.minRowBytes())));
+  ASSERT_EQ(converted, expected);
+}
+
+TEST(PixelConversionsTest, ConvertPixelsRejectsUnsupportedConversions) {
+  uint32_t src_pixel = MakePixel(10, 20, 30, 40);
+  uint32_t dst_pixel = 0;
+  const SkPixmap src(
+      SkImageInfo::Make(1, 1, kRGBA_8888_SkColorType, kPremul_SkAlphaType),
+      &src_pixel, sizeof(uint32_t));
+
+  // Discards alpha.
+  ASSERT_FALSE(ConvertPixels(
+      src, SkPixmap(SkImageInfo::Make(1, 1, kRGBA_8888_SkColorType,
+                                      kOpaque_SkAlphaType),
+                    &dst_pixel, sizeof(uint32_t))));
+  // Unsupported color type.
+  ASSERT_FALSE(ConvertPixels(
+      src, SkPixmap(SkImageInfo::MakeA8(1, 1), &dst_pixel, sizeof(uint32_t))));
+  // Unsupported color space conversion.
+  const auto rec2020 = SkColorSpace::MakeRGB(SkNamedTransferFn::kSRGB,
+                                             SkNamedGamut::kRec2020);
+  ASSERT_FALSE(ConvertPixels(
+      SkPixmap(src.info().makeColorSpace(SkColorSpace::MakeSRGB()), &src_pixel,
+               sizeof(uint32_t)),
+      SkPixmap(src.info().makeColorSpace(rec2020), &dst_pixel,
+               sizeof(uint32_t))));
+  ASSERT_EQ(dst_pixel, 0u);
+}
+
+}  // namespace testing
+}  // namespace flutter
@@ -2760,6 +2760,45 @@ class Paragraph extends NativeFieldWrapperClass1 {
   @FfiNative<Void Function(Pointer<Void>, Double)>('Paragraph::layout', isLeaf: true)
   external void _layout(double width);
 
+  /// Computes the size and position of each glyph in the paragraph on a
+  /// background thread, so that laying out a large paragraph does not block
+  /// the UI thread.
+  ///
+  /// The returned future completes with this paragraph once it has been laid
+  /// out. Reading the metrics of the paragraph or painting it before then
+  /// waits for the layout to finish.
+  ///
+  /// If [layout] or [layoutAsync] is called again before the returned future
+  /// completes, the request is superseded and its future completes with a
+  /// [StateError]. The future also completes with a [StateError] if the
+  /// paragraph is disposed first.
+  Future<Paragraph> layoutAsync(ParagraphConstraints constraints) {
+    final Completer<Paragraph> completer = Completer<Paragraph>();
+    final String? error = _layoutAsync(constraints.width, (int result) {
+      // The values of Paragraph::LayoutAsyncResult in paragraph.h.
+      switch (result) {
+        case 0:
+          assert(() {
+            _needsLayout = false;
+            return true;
+          }());
+          completer.complete(this);
+          break;
+        case 1:
+          completer.completeError(StateError('The layout was superseded by a later layout of the paragraph.'));
+          break;
+        default:
+          completer.completeError(StateError('The paragraph was disposed before its layout finished.'));
+      }
+    });
+    if (error != null) {
+      throw Exception(error);
+    }
+    return completer.future;
+  }
+  @FfiNative<Handle Function(Pointer<Void>, Double, Handle)>('Paragraph::layoutAsync')
+  external String? _layoutAsync(double width, void Function(int) callback);
+
   List<TextBox> _decodeTextBoxes(Float32List encoded) {
     final int count = encoded.length ~/ 5;
     final List<TextBox> boxes = <TextBox>[];
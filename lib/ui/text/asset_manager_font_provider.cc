@@ -7,21 +7,12 @@
 #include <utility>
 
 #include "flutter/fml/logging.h"
-#include "third_party/skia/include/core/SkData.h"
-#include "third_party/skia/include/core/SkStream.h"
+#include "flutter/lib/ui/text/typeface_registry.h"
 #include "third_party/skia/include/core/SkString.h"
 #include "third_party/skia/include/core/SkTypeface.h"
 
 namespace flutter {
 
-namespace {
-
-void MappingReleaseProc(const void* ptr, void* context) {
-  delete reinterpret_cast<fml::Mapping*>(context);
-}
-
-}  // anonymous namespace
-
 AssetManagerFontProvider::AssetManagerFontProvider(
     std::shared_ptr<AssetManager> asset_manager)
     : asset_manager_(std::move(asset_manager)) {}
@@ -111,14 +102,8 @@ SkTypeface* AssetManagerFontStyleSet::createTypeface(int i) {
       return nullptr;
     }
 
-    fml::Mapping* asset_mapping_ptr = asset_mapping.release();
-    sk_sp<SkData> asset_data = SkData::MakeWithProc(
-        asset_mapping_ptr->GetMapping(), asset_mapping_ptr->GetSize(),
-        MappingReleaseProc, asset_mapping_ptr);
-    std::unique_ptr<SkMemoryStream> stream = SkMemoryStream::Make(asset_data);
-
-    // Ownership of the stream is transferred.
-    asset.typeface = SkTypeface::MakeFromStream(std::move(stream));
+    // Engines that bundle the same font share the typeface.
+    asset.typeface = TypefaceRegistry::GetTypeface(std::move(asset_mapping));
     if (!asset.typeface) {
       FML_DLOG(ERROR) << "Unable to load font asset for family: "
                       << family_name_;
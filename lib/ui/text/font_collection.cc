@@ -5,11 +5,16 @@
 #include "flutter/lib/ui/text/font_collection.h"
 
 #include <mutex>
+#include <utility>
 
+#include "flutter/common/graphics/persistent_cache.h"
+#include "flutter/fml/trace_event.h"
 #include "flutter/lib/ui/text/asset_manager_font_provider.h"
+#include "flutter/lib/ui/text/typeface_registry.h"
 #include "flutter/lib/ui/ui_dart_state.h"
 #include "flutter/lib/ui/window/platform_configuration.h"
 #include "flutter/runtime/test_font_data.h"
+#include "minikin/Layout.h"
 #include "rapidjson/document.h"
 #include "rapidjson/rapidjson.h"
 #include "third_party/skia/include/core/SkFontMgr.h"
@@ -25,15 +30,77 @@
 
 namespace flutter {
 
+namespace {
+
+constexpr char kFallbackCacheFileName[] = "io.flutter.fonts.fallback";
+
+// A common character of each script that the default font of the platform
+// may not cover, by the languages written in it.
+struct ScriptCharacter {
+  const char* language;
+  uint32_t code_point;
+};
+constexpr ScriptCharacter kScriptCharacters[] = {
+    {"ar", 0x0627}, {"fa", 0x0627}, {"ur", 0x0627}, {"he", 0x05D0},
+    {"iw", 0x05D0}, {"hi", 0x0915}, {"mr", 0x0915}, {"ne", 0x0915},
+    {"bn", 0x0995}, {"ta", 0x0B95}, {"te", 0x0C15}, {"th", 0x0E01},
+    {"ja", 0x3042}, {"ja", 0x4E00}, {"ko", 0xAC00}, {"zh", 0x4E00},
+};
+
+// Emoji are not covered by the default font of most platforms.
+constexpr uint32_t kGrinningFaceEmoji = 0x1F600;
+
+// Returns the BCP 47 tag of a locale as it is passed to the fallback font
+// provider, e.g. "zh-Hant-TW".
+std::string GetLanguageTag(const std::string& language,
+                           const std::string& country,
+                           const std::string& script) {
+  std::string tag = language;
+  if (!script.empty()) {
+    tag += "-" + script;
+  }
+  if (!country.empty()) {
+    tag += "-" + country;
+  }
+  return tag;
+}
+
+// Keeps the fallback fonts next to the shaders in the persistent cache.
+class PersistentFallbackCacheStorage
+    : public txt::FontCollection::FallbackCacheStorage {
+ public:
+  // |txt::FontCollection::FallbackCacheStorage|
+  std::string Load() override {
+    auto mapping =
+        PersistentCache::GetCacheForProcess()->LoadData(kFallbackCacheFileName);
+    if (!mapping) {
+      return std::string();
+    }
+    return std::string(reinterpret_cast<const char*>(mapping->GetMapping()),
+                       mapping->GetSize());
+  }
+
+  // |txt::FontCollection::FallbackCacheStorage|
+  void Store(const std::string& data) override {
+    PersistentCache::GetCacheForProcess()->StoreData(
+        kFallbackCacheFileName, std::make_unique<fml::DataMapping>(data));
+  }
+};
+
+}  // namespace
+
 FontCollection::FontCollection()
     : collection_(std::make_shared<txt::FontCollection>()) {
   dynamic_font_manager_ = sk_make_sp<txt::DynamicFontManager>();
   collection_->SetDynamicFontManager(dynamic_font_manager_);
+  collection_->SetFallbackCacheStorage(
+      std::make_shared<PersistentFallbackCacheStorage>());
 }
 
 FontCollection::~FontCollection() {
   collection_.reset();
   SkGraphics::PurgeFontCache();
+  TypefaceRegistry::PurgeUnusedTypefaces();
 }
 
 std::shared_ptr<txt::FontCollection> FontCollection::GetFontCollection() const {
@@ -143,6 +210,37 @@ void FontCollection::RegisterTestFonts() {
   collection_->DisableFontFallback();
 }
 
+void FontCollection::PrewarmFallbackFonts(
+    const std::vector<std::string>& locale_data,
+    const std::shared_ptr<fml::ConcurrentTaskRunner>& task_runner) {
+  if (!task_runner) {
+    return;
+  }
+  const size_t strings_per_locale = 4;
+  std::vector<std::pair<std::string, std::vector<uint32_t>>> locales;
+  for (size_t i = 0; i + strings_per_locale <= locale_data.size();
+       i += strings_per_locale) {
+    const std::string& language = locale_data[i];
+    std::vector<uint32_t> code_points = {kGrinningFaceEmoji};
+    for (const ScriptCharacter& character : kScriptCharacters) {
+      if (language == character.language) {
+        code_points.push_back(character.code_point);
+      }
+    }
+    locales.emplace_back(
+        GetLanguageTag(language, locale_data[i + 1], locale_data[i + 2]),
+        std::move(code_points));
+  }
+  // The persisted fallback fonts are restored even if there are no locales.
+  task_runner->PostTask(
+      [collection = collection_, locales = std::move(locales)]() {
+        collection->PrewarmFallbackFonts({}, {});
+        for (const auto& [locale, code_points] : locales) {
+          collection->PrewarmFallbackFonts({locale}, code_points);
+        }
+      });
+}
+
 void FontCollection::LoadFontFromList(Dart_Handle font_data_handle,
                                       Dart_Handle callback,
                                       const std::string& family_name) {
@@ -153,21 +251,30 @@ void FontCollection::LoadFontFromList(Dart_Handle font_data_handle,
                                         ->client()
                                         ->GetFontCollection();
 
-  std::unique_ptr<SkStreamAsset> font_stream = std::make_unique<SkMemoryStream>(
-      font_data.data(), font_data.num_elements(), true);
-  sk_sp<SkTypeface> typeface =
-      SkTypeface::MakeFromStream(std::move(font_stream));
-  txt::TypefaceFontAssetProvider& font_provider =
-      font_collection.dynamic_font_manager_->font_provider();
-  if (family_name.empty()) {
-    font_provider.RegisterTypeface(typeface);
-  } else {
-    font_provider.RegisterTypeface(typeface, family_name);
-  }
-  font_collection.collection_->ClearFontFamilyCache();
+  sk_sp<SkTypeface> typeface = TypefaceRegistry::GetTypefaceFromCopy(
+      font_data.data(), font_data.num_elements());
+  font_collection.collection_->RegisterDynamicTypeface(
+      *font_collection.dynamic_font_manager_, std::move(typeface),
+      family_name);
 
   font_data.Release();
   tonic::DartInvoke(callback, {tonic::ToDart(0)});
 }
 
+void FontCollection::SetLayoutCacheBudget(size_t bytes) {
+  minikin::Layout::setCacheBudget(bytes);
+}
+
+void FontCollection::TraceLayoutCacheStatsToTimeline() {
+#if !FLUTTER_RELEASE
+  const auto stats = minikin::Layout::getCacheStatistics();
+  FML_TRACE_COUNTER("flutter",                  //
+                    "TextLayoutCache", 0,       //
+                    "Hits", stats.hits,         //
+                    "Misses", stats.misses,     //
+                    "Entries", stats.entries,   //
+                    "KBytes", stats.bytes / 1024);
+#endif  // !FLUTTER_RELEASE
+}
+
 }  // namespace flutter
@@ -6,9 +6,11 @@
 #define FLUTTER_LIB_UI_TEXT_FONT_COLLECTION_H_
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "flutter/assets/asset_manager.h"
+#include "flutter/fml/concurrent_message_loop.h"
 #include "flutter/fml/macros.h"
 #include "flutter/fml/memory/ref_ptr.h"
 #include "third_party/tonic/typed_data/typed_list.h"
@@ -30,10 +32,39 @@ class FontCollection {
 
   void RegisterTestFonts();
 
+  //----------------------------------------------------------------------------
+  /// @brief      Restores the fallback fonts found by earlier runs from the
+  ///             persistent cache and finds the fallback fonts for emoji and
+  ///             the scripts of the given locales on a worker thread. Text
+  ///             using them is then laid out without waiting on the platform
+  ///             font manager.
+  ///
+  /// @param[in]  locale_data  The locales of the platform, in groups of 4
+  ///                          strings: the language, country, script and
+  ///                          variant codes of each locale.
+  /// @param[in]  task_runner  The runner of the worker thread.
+  ///
+  void PrewarmFallbackFonts(
+      const std::vector<std::string>& locale_data,
+      const std::shared_ptr<fml::ConcurrentTaskRunner>& task_runner);
+
   static void LoadFontFromList(Dart_Handle font_data_handle,
                                Dart_Handle callback,
                                const std::string& family_name);
 
+  //----------------------------------------------------------------------------
+  /// @brief      Sets the number of bytes the process wide cache of shaped
+  ///             words may use. Entries are evicted right away if the cache is
+  ///             over the new budget.
+  ///
+  static void SetLayoutCacheBudget(size_t bytes);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Adds the hits, misses and size of the cache of shaped words
+  ///             to the timeline.
+  ///
+  static void TraceLayoutCacheStatsToTimeline();
+
  private:
   std::shared_ptr<txt::FontCollection> collection_;
   sk_sp<txt::DynamicFontManager> dynamic_font_manager_;
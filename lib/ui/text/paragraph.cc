@@ -7,7 +7,12 @@
 #include "flutter/common/settings.h"
 #include "flutter/common/task_runners.h"
 #include "flutter/fml/logging.h"
+#include "flutter/fml/make_copyable.h"
 #include "flutter/fml/task_runner.h"
+#include "flutter/fml/trace_event.h"
+#include "flutter/lib/ui/ui_dart_state.h"
+#include "third_party/tonic/dart_persistent_value.h"
+#include "third_party/tonic/logging/dart_invoke.h"
 #include "third_party/tonic/converter/dart_converter.h"
 #include "third_party/tonic/dart_args.h"
 #include "third_party/tonic/dart_binding_macros.h"
@@ -18,60 +23,134 @@ namespace flutter {
 IMPLEMENT_WRAPPERTYPEINFO(ui, Paragraph);
 
 Paragraph::Paragraph(std::unique_ptr<txt::Paragraph> paragraph)
-    : m_paragraph(std::move(paragraph)) {}
+    : m_state(std::make_shared<LayoutState>()) {
+  m_state->paragraph = std::move(paragraph);
+}
 
 Paragraph::~Paragraph() = default;
 
+std::unique_lock<std::mutex> Paragraph::WaitForPendingLayouts() {
+  if (m_state->pending_layouts == 0) {
+    return std::unique_lock<std::mutex>();
+  }
+  return std::unique_lock<std::mutex>(m_state->mutex);
+}
+
 double Paragraph::width() {
-  return m_paragraph->GetMaxWidth();
+  auto lock = WaitForPendingLayouts();
+  return m_state->paragraph->GetMaxWidth();
 }
 
 double Paragraph::height() {
-  return m_paragraph->GetHeight();
+  auto lock = WaitForPendingLayouts();
+  return m_state->paragraph->GetHeight();
 }
 
 double Paragraph::longestLine() {
-  return m_paragraph->GetLongestLine();
+  auto lock = WaitForPendingLayouts();
+  return m_state->paragraph->GetLongestLine();
 }
 
 double Paragraph::minIntrinsicWidth() {
-  return m_paragraph->GetMinIntrinsicWidth();
+  auto lock = WaitForPendingLayouts();
+  return m_state->paragraph->GetMinIntrinsicWidth();
 }
 
 double Paragraph::maxIntrinsicWidth() {
-  return m_paragraph->GetMaxIntrinsicWidth();
+  auto lock = WaitForPendingLayouts();
+  return m_state->paragraph->GetMaxIntrinsicWidth();
 }
 
 double Paragraph::alphabeticBaseline() {
-  return m_paragraph->GetAlphabeticBaseline();
+  auto lock = WaitForPendingLayouts();
+  return m_state->paragraph->GetAlphabeticBaseline();
 }
 
 double Paragraph::ideographicBaseline() {
-  return m_paragraph->GetIdeographicBaseline();
+  auto lock = WaitForPendingLayouts();
+  return m_state->paragraph->GetIdeographicBaseline();
 }
 
 bool Paragraph::didExceedMaxLines() {
-  return m_paragraph->DidExceedMaxLines();
+  auto lock = WaitForPendingLayouts();
+  return m_state->paragraph->DidExceedMaxLines();
 }
 
 void Paragraph::layout(double width) {
-  m_paragraph->Layout(width);
+  // Supersedes the requests of layoutAsync that have not started.
+  m_state->generation++;
+  auto lock = WaitForPendingLayouts();
+  m_state->paragraph->Layout(width);
+}
+
+Dart_Handle Paragraph::layoutAsync(double width, Dart_Handle callback_handle) {
+  if (!Dart_IsClosure(callback_handle)) {
+    return tonic::ToDart("Callback must be a function");
+  }
+  if (!m_state->paragraph) {
+    return tonic::ToDart("Paragraph has been disposed");
+  }
+
+  auto* dart_state = UIDartState::Current();
+  auto ui_task_runner = dart_state->GetTaskRunners().GetUITaskRunner();
+  const uint64_t generation = ++m_state->generation;
+  m_state->pending_layouts++;
+
+  // The result is decided on the UI thread, where the paragraph is laid out
+  // again and disposed, so it does not depend on when the worker ran.
+  auto ui_task = fml::MakeCopyable(
+      [state = m_state, generation,
+       callback = std::make_unique<tonic::DartPersistentValue>(
+           dart_state, callback_handle)]() {
+        state->pending_layouts--;
+        LayoutAsyncResult result = LayoutAsyncResult::kLaidOut;
+        if (!state->paragraph) {
+          result = LayoutAsyncResult::kDisposed;
+        } else if (state->generation != generation) {
+          result = LayoutAsyncResult::kSuperseded;
+        }
+        auto dart_state = callback->dart_state().lock();
+        if (!dart_state) {
+          return;
+        }
+        tonic::DartState::Scope scope(dart_state);
+        tonic::DartInvoke(callback->Get(),
+                          {tonic::ToDart(static_cast<int>(result))});
+      });
+
+  dart_state->GetConcurrentTaskRunner()->PostTask(
+      [state = m_state, width, generation,
+       ui_task_runner = std::move(ui_task_runner),
+       ui_task = std::move(ui_task)]() mutable {
+        {
+          std::scoped_lock lock(state->mutex);
+          if (state->generation == generation && state->paragraph) {
+            TRACE_EVENT0("flutter", "Paragraph::layoutAsync");
+            state->paragraph->Layout(width);
+          }
+        }
+        // The callback must be released on the UI thread, so it is moved to
+        // the UI task instead of being copied.
+        ui_task_runner->PostTask(std::move(ui_task));
+      });
+  return Dart_Null();
 }
 
 void Paragraph::paint(Canvas* canvas, double x, double y) {
-  if (!m_paragraph || !canvas) {
+  auto lock = WaitForPendingLayouts();
+  if (!m_state->paragraph || !canvas) {
     // disposed.
     return;
   }
 
   DisplayListBuilder* builder = canvas->builder();
-  if (builder && m_paragraph->Paint(builder, x, y)) {
+  if (builder && m_state->paragraph->Paint(builder, x, y)) {
     return;
   }
   // Fall back to SkCanvas if painting to DisplayListBuilder is not supported.
   SkCanvas* sk_canvas = canvas->canvas();
   if (sk_canvas) {
-    m_paragraph->Paint(sk_canvas, x, y);
+    m_state->paragraph->Paint(sk_canvas, x, y);
   }
 }
 
@@ -99,21 +178,26 @@ tonic::Float32List Paragraph::getRectsForRange(unsigned start,
                                                unsigned end,
                                                unsigned boxHeightStyle,
                                                unsigned boxWidthStyle) {
-  std::vector<txt::Paragraph::TextBox> boxes = m_paragraph->GetRectsForRange(
-      start, end, static_cast<txt::Paragraph::RectHeightStyle>(boxHeightStyle),
-      static_cast<txt::Paragraph::RectWidthStyle>(boxWidthStyle));
+  auto lock = WaitForPendingLayouts();
+  std::vector<txt::Paragraph::TextBox> boxes =
+      m_state->paragraph->GetRectsForRange(
+          start, end,
+          static_cast<txt::Paragraph::RectHeightStyle>(boxHeightStyle),
+          static_cast<txt::Paragraph::RectWidthStyle>(boxWidthStyle));
   return EncodeTextBoxes(boxes);
 }
 
 tonic::Float32List Paragraph::getRectsForPlaceholders() {
+  auto lock = WaitForPendingLayouts();
   std::vector<txt::Paragraph::TextBox> boxes =
-      m_paragraph->GetRectsForPlaceholders();
+      m_state->paragraph->GetRectsForPlaceholders();
   return EncodeTextBoxes(boxes);
 }
 
 Dart_Handle Paragraph::getPositionForOffset(double dx, double dy) {
+  auto lock = WaitForPendingLayouts();
   txt::Paragraph::PositionWithAffinity pos =
-      m_paragraph->GetGlyphPositionAtCoordinate(dx, dy);
+      m_state->paragraph->GetGlyphPositionAtCoordinate(dx, dy);
   std::vector<size_t> result = {
       pos.position,                      // size_t already
       static_cast<size_t>(pos.affinity)  // affinity (enum)
@@ -122,13 +206,16 @@ Dart_Handle Paragraph::getPositionForOffset(double dx, double dy) {
 }
 
 Dart_Handle Paragraph::getWordBoundary(unsigned offset) {
-  txt::Paragraph::Range<size_t> point = m_paragraph->GetWordBoundary(offset);
+  auto lock = WaitForPendingLayouts();
+  txt::Paragraph::Range<size_t> point =
+      m_state->paragraph->GetWordBoundary(offset);
   std::vector<size_t> result = {point.start, point.end};
   return tonic::DartConverter<decltype(result)>::ToDart(result);
 }
 
 Dart_Handle Paragraph::getLineBoundary(unsigned offset) {
-  std::vector<txt::LineMetrics> metrics = m_paragraph->GetLineMetrics();
+  auto lock = WaitForPendingLayouts();
+  std::vector<txt::LineMetrics> metrics = m_state->paragraph->GetLineMetrics();
   int line_start = -1;
   int line_end = -1;
   for (txt::LineMetrics& line : metrics) {
@@ -143,7 +230,8 @@ Dart_Handle Paragraph::getLineBoundary(unsigned offset) {
 }
 
 tonic::Float64List Paragraph::computeLineMetrics() {
-  std::vector<txt::LineMetrics> metrics = m_paragraph->GetLineMetrics();
+  auto lock = WaitForPendingLayouts();
+  std::vector<txt::LineMetrics> metrics = m_state->paragraph->GetLineMetrics();
 
   // Layout:
   // boxes.size() groups of 9 which are the line metrics
@@ -171,7 +259,8 @@ tonic::Float64List Paragraph::computeLineMetrics() {
 }
 
 void Paragraph::dispose() {
-  m_paragraph.reset();
+  auto lock = WaitForPendingLayouts();
+  m_state->paragraph.reset();
   ClearDartWrapper();
 }
 
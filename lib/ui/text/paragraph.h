@@ -5,6 +5,10 @@
 #ifndef FLUTTER_LIB_UI_TEXT_PARAGRAPH_H_
 #define FLUTTER_LIB_UI_TEXT_PARAGRAPH_H_
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+
 #include "flutter/fml/message_loop.h"
 #include "flutter/lib/ui/dart_wrapper.h"
 #include "flutter/lib/ui/painting/canvas.h"
@@ -37,6 +41,21 @@ class Paragraph : public RefCountedDartWrappable<Paragraph> {
   bool didExceedMaxLines();
 
   void layout(double width);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Lays out the paragraph on a worker of the concurrent task
+  ///             runner, then invokes the callback on the UI thread with a
+  ///             |LayoutAsyncResult|.
+  ///
+  ///             A request is superseded if the paragraph is laid out again
+  ///             before its callback runs, and the result says whether it was
+  ///             superseded or the paragraph was disposed. Workers skip
+  ///             requests that are superseded before they start. Other
+  ///             methods wait for running layouts to finish before they
+  ///             access the paragraph.
+  ///
+  Dart_Handle layoutAsync(double width, Dart_Handle callback_handle);
+
   void paint(Canvas* canvas, double x, double y);
 
   tonic::Float32List getRectsForRange(unsigned start,
@@ -52,9 +71,33 @@ class Paragraph : public RefCountedDartWrappable<Paragraph> {
   void dispose();
 
  private:
-  std::unique_ptr<txt::Paragraph> m_paragraph;
+  // The values passed to the callback of layoutAsync. Must match the values
+  // checked in text.dart.
+  enum class LayoutAsyncResult {
+    kLaidOut = 0,
+    kSuperseded = 1,
+    kDisposed = 2,
+  };
+
+  // The paragraph and the state shared with the workers that lay it out.
+  struct LayoutState {
+    // Held while a worker lays out the paragraph.
+    std::mutex mutex;
+    std::unique_ptr<txt::Paragraph> paragraph;
+    // Identifies the latest layout. Workers skip the requests before it.
+    std::atomic<uint64_t> generation = 0;
+    // The requests whose callbacks have not run yet. Only used on the UI
+    // thread.
+    size_t pending_layouts = 0;
+  };
+
+  std::shared_ptr<LayoutState> m_state;
 
   explicit Paragraph(std::unique_ptr<txt::Paragraph> paragraph);
+
+  // Waits for the layouts that run on workers. The returned lock must be held
+  // while the paragraph is used. It only locks if a layout may be running.
+  std::unique_lock<std::mutex> WaitForPendingLayouts();
 };
 
 }  // namespace flutter
@@ -0,0 +1,175 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/text/typeface_registry.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "flutter/fml/logging.h"
+#include "flutter/fml/trace_event.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkStream.h"
+
+namespace flutter {
+
+namespace {
+
+struct Entry {
+  // A weak reference to the typeface.
+  SkTypeface* typeface;
+  // The font data of the typeface, which is compared to the data of new
+  // typefaces.
+  sk_sp<SkData> data;
+};
+
+// The typefaces that may be found for data of a size, and their data.
+using Candidates = std::vector<std::pair<sk_sp<SkTypeface>, sk_sp<SkData>>>;
+
+std::mutex gRegistryMutex;
+
+// Keyed by the size of the font data. Fonts of the same size are rare, so
+// they are told apart by comparing their data only when a typeface is
+// looked up, instead of hashing the data of every font that is loaded.
+std::multimap<size_t, Entry>& Registry() {
+  static auto* registry = new std::multimap<size_t, Entry>();
+  return *registry;
+}
+
+void MappingReleaseProc(const void* ptr, void* context) {
+  delete reinterpret_cast<fml::Mapping*>(context);
+}
+
+// A weak reference keeps the typeface and its data from being freed, so it
+// has to be dropped once the typeface is no longer used. Must be called with
+// the registry locked.
+void PurgeUnusedLocked() {
+  for (auto it = Registry().begin(); it != Registry().end();) {
+    if (it->second.typeface->weak_expired()) {
+      it->second.typeface->weak_unref();
+      it = Registry().erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+// Returns strong references to the live typefaces registered for data of the
+// given size. Must be called with the registry locked.
+Candidates FindCandidatesLocked(size_t size) {
+  Candidates candidates;
+  auto range = Registry().equal_range(size);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second.typeface->try_ref()) {
+      candidates.emplace_back(sk_sp<SkTypeface>(it->second.typeface),
+                              it->second.data);
+    }
+  }
+  return candidates;
+}
+
+// Returns the candidate whose data is equal to the given data.
+sk_sp<SkTypeface> FindMatch(const Candidates& candidates,
+                            const uint8_t* data,
+                            size_t size) {
+  TRACE_EVENT0("flutter", "TypefaceRegistry::CompareFontData");
+  for (const auto& [typeface, typeface_data] : candidates) {
+    if (typeface_data->size() == size &&
+        memcmp(typeface_data->data(), data, size) == 0) {
+      return typeface;
+    }
+  }
+  return nullptr;
+}
+
+sk_sp<SkTypeface> GetOrCreateTypeface(
+    const uint8_t* data,
+    size_t size,
+    const std::function<sk_sp<SkData>()>& make_data) {
+  Candidates candidates;
+  {
+    std::scoped_lock lock(gRegistryMutex);
+    candidates = FindCandidatesLocked(size);
+  }
+  // The data is compared without holding the lock, as large fonts may take
+  // a while to compare.
+  if (auto typeface = FindMatch(candidates, data, size)) {
+    return typeface;
+  }
+
+  // Creating the typeface may take a while, so it is done without holding
+  // the lock.
+  sk_sp<SkData> typeface_data = make_data();
+  sk_sp<SkTypeface> typeface =
+      SkTypeface::MakeFromStream(SkMemoryStream::Make(typeface_data));
+  if (!typeface) {
+    return nullptr;
+  }
+
+  std::scoped_lock lock(gRegistryMutex);
+  // Another engine may have registered the same font in the meantime. The
+  // candidates found before are known to differ.
+  Candidates registered = FindCandidatesLocked(size);
+  registered.erase(
+      std::remove_if(registered.begin(), registered.end(),
+                     [&candidates](const auto& candidate) {
+                       return std::any_of(
+                           candidates.begin(), candidates.end(),
+                           [&candidate](const auto& known) {
+                             return known.first == candidate.first;
+                           });
+                     }),
+      registered.end());
+  if (auto match = FindMatch(registered, typeface_data->bytes(), size)) {
+    return match;
+  }
+  PurgeUnusedLocked();
+  typeface->weak_ref();
+  Registry().emplace(size, Entry{typeface.get(), std::move(typeface_data)});
+  return typeface;
+}
+
+}  // namespace
+
+sk_sp<SkTypeface> TypefaceRegistry::GetTypeface(
+    std::unique_ptr<fml::Mapping> mapping) {
+  if (!mapping || mapping->GetMapping() == nullptr) {
+    return nullptr;
+  }
+  const uint8_t* data = mapping->GetMapping();
+  const size_t size = mapping->GetSize();
+  return GetOrCreateTypeface(data, size, [&mapping]() {
+    fml::Mapping* mapping_ptr = mapping.release();
+    return SkData::MakeWithProc(mapping_ptr->GetMapping(),
+                                mapping_ptr->GetSize(), MappingReleaseProc,
+                                mapping_ptr);
+  });
+}
+
+sk_sp<SkTypeface> TypefaceRegistry::GetTypefaceFromCopy(const uint8_t* data,
+                                                        size_t size) {
+  if (data == nullptr) {
+    return nullptr;
+  }
+  return GetOrCreateTypeface(
+      data, size, [data, size]() { return SkData::MakeWithCopy(data, size); });
+}
+
+void TypefaceRegistry::PurgeUnusedTypefaces() {
+  std::scoped_lock lock(gRegistryMutex);
+  PurgeUnusedLocked();
+}
+
+size_t TypefaceRegistry::GetTypefaceCount() {
+  std::scoped_lock lock(gRegistryMutex);
+  PurgeUnusedLocked();
+  return Registry().size();
+}
+
+}  // namespace flutter
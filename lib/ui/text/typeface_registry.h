@@ -0,0 +1,68 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_LIB_UI_TEXT_TYPEFACE_REGISTRY_H_
+#define FLUTTER_LIB_UI_TEXT_TYPEFACE_REGISTRY_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "flutter/fml/macros.h"
+#include "flutter/fml/mapping.h"
+#include "third_party/skia/include/core/SkTypeface.h"
+
+namespace flutter {
+
+//------------------------------------------------------------------------------
+/// @brief      A process wide registry of the typefaces created from font
+///             files, which finds the typeface of a file by its contents.
+///
+///             Every engine has its own font collection, which loads the font
+///             assets of the engine. Engines that load the same font, such as
+///             a large CJK font bundled with the app, share a single typeface
+///             and a single copy of the font data. The typefaces also share
+///             the coverage computed by the text engine.
+///
+///             The registry does not keep typefaces in use, but the data of
+///             a typeface that is no longer used is only freed when the
+///             registry is purged. This happens when a typeface is created
+///             and when a font collection is destroyed.
+///
+class TypefaceRegistry {
+ public:
+  //----------------------------------------------------------------------------
+  /// @brief      Returns the typeface for the font data in the mapping. If
+  ///             there is no live typeface for the same data, a typeface
+  ///             backed by the mapping is created. Otherwise the mapping is
+  ///             released right away.
+  ///
+  /// @return     The typeface, or null if the data is not a valid font.
+  ///
+  static sk_sp<SkTypeface> GetTypeface(std::unique_ptr<fml::Mapping> mapping);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Like |GetTypeface|, but copies the data if a new typeface is
+  ///             created.
+  ///
+  static sk_sp<SkTypeface> GetTypefaceFromCopy(const uint8_t* data,
+                                               size_t size);
+
+  //----------------------------------------------------------------------------
+  /// @brief      Frees the data of the typefaces that are no longer used.
+  ///
+  static void PurgeUnusedTypefaces();
+
+  //----------------------------------------------------------------------------
+  /// @return     The number of typefaces in use in the registry.
+  ///
+  static size_t GetTypefaceCount();
+
+ private:
+  FML_DISALLOW_IMPLICIT_CONSTRUCTORS(TypefaceRegistry);
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_LIB_UI_TEXT_TYPEFACE_REGISTRY_H_
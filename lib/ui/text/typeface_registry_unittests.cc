@@ -0,0 +1,79 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/lib/ui/text/typeface_registry.h"
+
+#include <memory>
+#include <vector>
+
+#include "flutter/runtime/test_font_data.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+namespace testing {
+
+namespace {
+
+std::vector<uint8_t> ReadTestFont() {
+  std::vector<std::unique_ptr<SkStreamAsset>> fonts = GetTestFontData();
+  EXPECT_FALSE(fonts.empty());
+  std::vector<uint8_t> data(fonts[0]->getLength());
+  fonts[0]->read(data.data(), data.size());
+  return data;
+}
+
+}  // namespace
+
+TEST(TypefaceRegistryTest, SharesTypefacesWithTheSameData) {
+  std::vector<uint8_t> data = ReadTestFont();
+  const size_t count = TypefaceRegistry::GetTypefaceCount();
+
+  sk_sp<SkTypeface> mapped =
+      TypefaceRegistry::GetTypeface(std::make_unique<fml::DataMapping>(data));
+  ASSERT_TRUE(mapped);
+  sk_sp<SkTypeface> copied =
+      TypefaceRegistry::GetTypefaceFromCopy(data.data(), data.size());
+  EXPECT_EQ(mapped.get(), copied.get());
+  EXPECT_EQ(TypefaceRegistry::GetTypefaceCount(), count + 1);
+
+  mapped.reset();
+  EXPECT_EQ(TypefaceRegistry::GetTypefaceCount(), count + 1);
+  copied.reset();
+  EXPECT_EQ(TypefaceRegistry::GetTypefaceCount(), count);
+}
+
+TEST(TypefaceRegistryTest, DoesNotShareTypefacesWithOtherDataOfTheSameSize) {
+  std::vector<uint8_t> data = ReadTestFont();
+  // Change the checksum of the first table in the table directory, which
+  // font loaders do not verify.
+  std::vector<uint8_t> other_data = data;
+  ASSERT_GT(other_data.size(), 20u);
+  other_data[16] ^= 0xFF;
+  const size_t count = TypefaceRegistry::GetTypefaceCount();
+
+  sk_sp<SkTypeface> typeface =
+      TypefaceRegistry::GetTypefaceFromCopy(data.data(), data.size());
+  sk_sp<SkTypeface> other_typeface = TypefaceRegistry::GetTypefaceFromCopy(
+      other_data.data(), other_data.size());
+  ASSERT_TRUE(typeface);
+  ASSERT_TRUE(other_typeface);
+  EXPECT_NE(typeface.get(), other_typeface.get());
+  EXPECT_EQ(TypefaceRegistry::GetTypefaceCount(), count + 2);
+
+  sk_sp<SkTypeface> same_typeface =
+      TypefaceRegistry::GetTypefaceFromCopy(data.data(), data.size());
+  EXPECT_EQ(typeface.get(), same_typeface.get());
+}
+
+TEST(TypefaceRegistryTest, IgnoresInvalidData) {
+  const size_t count = TypefaceRegistry::GetTypefaceCount();
+  std::vector<uint8_t> data(64, 0xAB);
+  EXPECT_FALSE(
+      TypefaceRegistry::GetTypeface(std::make_unique<fml::DataMapping>(data)));
+  EXPECT_FALSE(TypefaceRegistry::GetTypefaceFromCopy(data.data(), 0));
+  EXPECT_EQ(TypefaceRegistry::GetTypefaceCount(), count);
+}
+
+}  // namespace testing
+}  // namespace flutter
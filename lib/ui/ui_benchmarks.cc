@@ -4,6 +4,7 @@
 
 #include "flutter/benchmarking/benchmarking.h"
 #include "flutter/common/settings.h"
+#include "flutter/lib/ui/painting/pixel_conversions.h"
 #include "flutter/lib/ui/volatile_path_tracker.h"
 #include "flutter/lib/ui/window/platform_message_response_dart.h"
 #include "flutter/runtime/dart_vm_lifecycle.h"
@@ -11,7 +12,10 @@
 #include "flutter/testing/dart_isolate_runner.h"
 #include "flutter/testing/fixture_test.h"
 
+#include <algorithm>
+#include <functional>
 #include <future>
+#include <random>
 
 namespace flutter {
 
@@ -112,9 +116,67 @@ static void BM_PathVolatilityTracker(benchmark::State& state) {
   }
 }
 
+// A 1024x1024 image of random pixels.
+static const std::vector<uint32_t>& GetBenchmarkPixels() {
+  static const std::vector<uint32_t> pixels = [] {
+    std::vector<uint32_t> pixels(1024 * 1024);
+    std::mt19937 random(42);
+    std::generate(pixels.begin(), pixels.end(), std::ref(random));
+    return pixels;
+  }();
+  return pixels;
+}
+
+static void BM_PixelConversion(benchmark::State& state,
+                               void (*convert)(uint32_t*,
+                                               const uint32_t*,
+                                               size_t)) {
+  const auto& src = GetBenchmarkPixels();
+  std::vector<uint32_t> dst(src.size());
+  for (auto _ : state) {
+    convert(dst.data(), src.data(), src.size());
+    benchmark::DoNotOptimize(dst.data());
+  }
+  state.SetBytesProcessed(state.iterations() * src.size() * sizeof(uint32_t));
+}
+
+static void BM_PackRGB565(benchmark::State& state) {
+  const auto& src = GetBenchmarkPixels();
+  std::vector<uint16_t> dst(src.size());
+  for (auto _ : state) {
+    PackRGB565(dst.data(), src.data(), src.size());
+    benchmark::DoNotOptimize(dst.data());
+  }
+  state.SetBytesProcessed(state.iterations() * src.size() * sizeof(uint32_t));
+}
+
+static void BM_UnpackRGB565(benchmark::State& state) {
+  const auto& pixels = GetBenchmarkPixels();
+  std::vector<uint16_t> src(pixels.begin(), pixels.end());
+  std::vector<uint32_t> dst(src.size());
+  for (auto _ : state) {
+    UnpackRGB565(dst.data(), src.data(), src.size());
+    benchmark::DoNotOptimize(dst.data());
+  }
+  state.SetBytesProcessed(state.iterations() * src.size() * sizeof(uint16_t));
+}
+
 BENCHMARK(BM_PlatformMessageResponseDartComplete)
     ->Unit(benchmark::kMicrosecond);
 
 BENCHMARK(BM_PathVolatilityTracker)->Unit(benchmark::kMillisecond);
 
+BENCHMARK_CAPTURE(BM_PixelConversion, SwapRedAndBlue, SwapRedAndBlue)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_PixelConversion, PremultiplyAlpha, PremultiplyAlpha)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_PixelConversion, UnpremultiplyAlpha, UnpremultiplyAlpha)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_PixelConversion, SRGBToLinear, SRGBToLinear)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK_CAPTURE(BM_PixelConversion, LinearToSRGB, LinearToSRGB)
+    ->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_PackRGB565)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_UnpackRGB565)->Unit(benchmark::kMicrosecond);
+
 }  // namespace flutter
@@ -737,6 +737,15 @@ class ImmutableBuffer {
   int get length => _length;
   final int _length;
 
+  Uint8List getRange(int offset, int length) {
+    final Uint8List? list = _list;
+    if (list == null) {
+      throw StateError('ImmutableBuffer.getRange called after dispose.');
+    }
+    RangeError.checkValidRange(offset, offset + length, _length);
+    return list.sublist(offset, offset + length);
+  }
+
   bool get debugDisposed {
     late bool disposed;
     assert(() {
@@ -788,6 +788,13 @@ class CkParagraph extends SkiaObject<SkParagraph> implements ui.Paragraph {
     return ui.TextRange(start: skRange.start.toInt(), end: skRange.end.toInt());
   }
 
+  @override
+  Future<ui.Paragraph> layoutAsync(ui.ParagraphConstraints constraints) {
+    // The web has no background threads for layout.
+    layout(constraints);
+    return Future<ui.Paragraph>.value(this);
+  }
+
   @override
   void layout(ui.ParagraphConstraints constraints) {
     if (_lastLayoutConstraints == constraints) {
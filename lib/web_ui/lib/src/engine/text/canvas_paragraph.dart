@@ -88,6 +88,13 @@ class CanvasParagraph implements ui.Paragraph {
   late final TextLayoutService _layoutService = TextLayoutService(this);
   late final TextPaintService _paintService = TextPaintService(this);
 
+  @override
+  Future<ui.Paragraph> layoutAsync(ui.ParagraphConstraints constraints) {
+    // The web has no background threads for layout.
+    layout(constraints);
+    return Future<ui.Paragraph>.value(this);
+  }
+
   @override
   void layout(ui.ParagraphConstraints constraints) {
     // When constraint width has a decimal place, we floor it to avoid getting
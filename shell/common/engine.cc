@@ -184,6 +184,11 @@ bool Engine::UpdateAssetManager(
     font_collection_->RegisterTestFonts();
   }
 
+  // Restore the fallback fonts found by earlier runs now that all the fonts
+  // known at startup are registered. The fonts of the locales are prewarmed
+  // again when the platform changes them.
+  PrewarmFallbackFonts();
+
   return true;
 }
 
@@ -251,6 +256,7 @@ Engine::RunStatus Engine::Run(RunConfiguration configuration) {
 
 void Engine::BeginFrame(fml::TimePoint frame_time, uint64_t frame_number) {
   runtime_controller_->BeginFrame(frame_time, frame_number);
+  FontCollection::TraceLayoutCacheStatsToTimeline();
 }
 
 void Engine::ReportTimings(std::vector<int64_t> timings) {
@@ -394,11 +400,22 @@ bool Engine::HandleLocalizationPlatformMessage(PlatformMessage* message) {
       locale_data.push_back(args->value[locale_index + 3].GetString());
     }
 
-    return runtime_controller_->SetLocales(locale_data);
+    const bool result = runtime_controller_->SetLocales(locale_data);
+    PrewarmFallbackFonts();
+    return result;
   }
   return false;
 }
 
+void Engine::PrewarmFallbackFonts() {
+  DartVM* vm = runtime_controller_ ? runtime_controller_->GetDartVM() : nullptr;
+  if (vm) {
+    font_collection_->PrewarmFallbackFonts(
+        runtime_controller_->GetPlatformData().locale_data,
+        vm->GetConcurrentWorkerTaskRunner());
+  }
+}
+
 void Engine::HandleSettingsPlatformMessage(PlatformMessage* message) {
   const auto& data = message->data();
   std::string jsonData(reinterpret_cast<const char*>(data.GetMapping()),
@@ -928,6 +928,10 @@ class Engine final : public RuntimeDelegate, PointerDataDispatcher::Delegate {
 
   bool HandleLocalizationPlatformMessage(PlatformMessage* message);
 
+  // Finds the fallback fonts for the locales of the platform on a worker
+  // thread, see |FontCollection::PrewarmFallbackFonts|.
+  void PrewarmFallbackFonts();
+
   void HandleSettingsPlatformMessage(PlatformMessage* message);
 
   void HandleAssetPlatformMessage(std::unique_ptr<PlatformMessage> message);
@@ -7,6 +7,7 @@
 #include <memory>
 
 #include "flutter/assets/directory_asset_bundle.h"
+#include "flutter/common/graphics/persistent_cache_pack.h"
 #include "flutter/flow/layers/container_layer.h"
 #include "flutter/flow/layers/layer.h"
 #include "flutter/flow/layers/physical_shape_layer.h"
@@ -19,6 +20,7 @@
 #include "flutter/shell/version/version.h"
 #include "flutter/testing/testing.h"
 #include "include/core/SkPicture.h"
+#include "include/gpu/GrDirectContext.h"
 
 namespace flutter {
 namespace testing {
@@ -362,5 +364,359 @@ TEST_F(PersistentCacheTest, PurgeAllowsFutureSkSLCache) {
   DestroyShell(std::move(shell));
 }
 
+TEST_F(PersistentCacheTest, LoadsSkSLsUsedBeforeFirstFrameFirst) {
+  // Avoid polluting unit tests output with the warnings about writing the
+  // cache without a worker task runner.
+  fml::LogSettings error_only = {fml::LOG_ERROR};
+  fml::ScopedSetLogSettings scoped_set_log_settings(error_only);
+
+  fml::ScopedTemporaryDirectory base_dir;
+  ASSERT_TRUE(base_dir.fd().is_valid());
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::ResetCacheForProcess();
+  PersistentCache::SetCacheSkSL(true);
+  auto concurrent_loop = fml::ConcurrentMessageLoop::Create(4);
+
+  // Store enough SkSLs for them to be loaded by several concurrent tasks.
+  auto persistent_cache = PersistentCache::GetCacheForProcess();
+  persistent_cache->SetConcurrentTaskRunner(concurrent_loop->GetTaskRunner());
+  sk_sp<SkData> shader_value = SkData::MakeWithCString("value");
+  std::vector<sk_sp<SkData>> shader_keys;
+  for (int i = 0; i < 100; i++) {
+    shader_keys.push_back(
+        SkData::MakeWithCString(("key" + std::to_string(i)).c_str()));
+    StorePersistentCache(persistent_cache, *shader_keys.back(), *shader_value);
+  }
+  size_t critical_count = 0;
+  ASSERT_EQ(persistent_cache->LoadSkSLs(&critical_count).size(), 100u);
+  ASSERT_EQ(critical_count, 0u);
+
+  // Skia looks up shaders when they are first used. Only the lookups before
+  // the first frame are recorded.
+  persistent_cache->load(*shader_keys[42]);
+  persistent_cache->load(*shader_keys[7]);
+  persistent_cache->load(*shader_keys[42]);
+  persistent_cache->MarkFirstFrameRasterized();
+  persistent_cache->load(*shader_keys[3]);
+
+  // The next run loads the recorded shaders first, in order.
+  PersistentCache::ResetCacheForProcess();
+  persistent_cache = PersistentCache::GetCacheForProcess();
+  persistent_cache->SetConcurrentTaskRunner(concurrent_loop->GetTaskRunner());
+  auto sksls = persistent_cache->LoadSkSLs(&critical_count);
+  ASSERT_EQ(sksls.size(), 100u);
+  ASSERT_EQ(critical_count, 2u);
+  ASSERT_TRUE(sksls[0].key->equals(shader_keys[42].get()));
+  ASSERT_TRUE(sksls[1].key->equals(shader_keys[7].get()));
+
+  // Cleanup
+  PersistentCache::SetCacheSkSL(false);
+  fml::RemoveFilesInDirectory(base_dir.fd());
+}
+
+TEST_F(PersistentCacheTest, RecordsPrecompiledCriticalSkSLsAsUsed) {
+  // Avoid polluting unit tests output with the warnings about writing the
+  // cache without a worker task runner.
+  fml::LogSettings error_only = {fml::LOG_ERROR};
+  fml::ScopedSetLogSettings scoped_set_log_settings(error_only);
+
+  fml::ScopedTemporaryDirectory base_dir;
+  ASSERT_TRUE(base_dir.fd().is_valid());
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::ResetCacheForProcess();
+  PersistentCache::SetCacheSkSL(true);
+
+  auto persistent_cache = PersistentCache::GetCacheForProcess();
+  sk_sp<SkData> shader_value = SkData::MakeWithCString("value");
+  std::vector<sk_sp<SkData>> shader_keys;
+  for (size_t i = 0; i < PersistentCache::kMaxFirstUseCount + 10; i++) {
+    shader_keys.push_back(
+        SkData::MakeWithCString(("key" + std::to_string(i)).c_str()));
+    StorePersistentCache(persistent_cache, *shader_keys.back(), *shader_value);
+  }
+  auto context = GrDirectContext::MakeMock(nullptr);
+  ASSERT_TRUE(context);
+
+  // Without a recorded order nothing is precompiled before the first frame,
+  // so that Skia looks up the shaders it uses.
+  ASSERT_EQ(persistent_cache->PrecompileKnownSkSLs(context.get(),
+                                                   /*defer_non_critical=*/true),
+            0u);
+  persistent_cache->load(*shader_keys[4]);
+  persistent_cache->load(*shader_keys[2]);
+  persistent_cache->MarkFirstFrameRasterized();
+
+  // The critical SkSLs are precompiled, and so are not looked up by Skia.
+  // They are still recorded as used, along with the shaders that are looked
+  // up.
+  PersistentCache::ResetCacheForProcess();
+  persistent_cache = PersistentCache::GetCacheForProcess();
+  persistent_cache->PrecompileKnownSkSLs(context.get(),
+                                         /*defer_non_critical=*/true);
+  persistent_cache->load(*shader_keys[7]);
+  persistent_cache->MarkFirstFrameRasterized();
+
+  PersistentCache::ResetCacheForProcess();
+  persistent_cache = PersistentCache::GetCacheForProcess();
+  size_t critical_count = 0;
+  auto sksls = persistent_cache->LoadSkSLs(&critical_count);
+  ASSERT_EQ(critical_count, 3u);
+  ASSERT_TRUE(sksls[0].key->equals(shader_keys[4].get()));
+  ASSERT_TRUE(sksls[1].key->equals(shader_keys[2].get()));
+  ASSERT_TRUE(sksls[2].key->equals(shader_keys[7].get()));
+
+  // The order of a run replaces that of the last run, and is capped.
+  persistent_cache->PrecompileKnownSkSLs(context.get(),
+                                         /*defer_non_critical=*/true);
+  for (size_t i = shader_keys.size(); i > 0; i--) {
+    persistent_cache->load(*shader_keys[i - 1]);
+  }
+  persistent_cache->MarkFirstFrameRasterized();
+
+  PersistentCache::ResetCacheForProcess();
+  persistent_cache = PersistentCache::GetCacheForProcess();
+  sksls = persistent_cache->LoadSkSLs(&critical_count);
+  ASSERT_EQ(critical_count, PersistentCache::kMaxFirstUseCount);
+  ASSERT_TRUE(sksls[0].key->equals(shader_keys[4].get()));
+  ASSERT_TRUE(sksls[3].key->equals(shader_keys.back().get()));
+
+  // Cleanup
+  PersistentCache::SetCacheSkSL(false);
+  fml::RemoveFilesInDirectory(base_dir.fd());
+}
+
+TEST_F(PersistentCacheTest, DefersNonCriticalSkSLs) {
+  // Avoid polluting unit tests output with the warnings about writing the
+  // cache without a worker task runner.
+  fml::LogSettings error_only = {fml::LOG_ERROR};
+  fml::ScopedSetLogSettings scoped_set_log_settings(error_only);
+
+  fml::ScopedTemporaryDirectory base_dir;
+  ASSERT_TRUE(base_dir.fd().is_valid());
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::ResetCacheForProcess();
+  PersistentCache::SetCacheSkSL(true);
+
+  auto persistent_cache = PersistentCache::GetCacheForProcess();
+  sk_sp<SkData> shader_value = SkData::MakeWithCString("value");
+  std::vector<sk_sp<SkData>> shader_keys;
+  for (int i = 0; i < 10; i++) {
+    shader_keys.push_back(
+        SkData::MakeWithCString(("key" + std::to_string(i)).c_str()));
+    StorePersistentCache(persistent_cache, *shader_keys.back(), *shader_value);
+  }
+  persistent_cache->load(*shader_keys[4]);
+  persistent_cache->load(*shader_keys[2]);
+  persistent_cache->MarkFirstFrameRasterized();
+
+  PersistentCache::ResetCacheForProcess();
+  persistent_cache = PersistentCache::GetCacheForProcess();
+  auto context = GrDirectContext::MakeMock(nullptr);
+  auto other_context = GrDirectContext::MakeMock(nullptr);
+  ASSERT_TRUE(context);
+  ASSERT_TRUE(other_context);
+
+  // Without deferral, nothing is left for later.
+  persistent_cache->PrecompileKnownSkSLs(context.get());
+  ASSERT_EQ(persistent_cache->PrecompileDeferredSkSLs(
+                context.get(), fml::TimeDelta::FromSeconds(60)),
+            0u);
+
+  // Only the two SkSLs used before the first frame are compiled up front.
+  persistent_cache->PrecompileKnownSkSLs(context.get(),
+                                         /*defer_non_critical=*/true);
+
+  // Deferred SkSLs are only compiled in the context they were loaded for.
+  ASSERT_EQ(persistent_cache->PrecompileDeferredSkSLs(
+                other_context.get(), fml::TimeDelta::FromSeconds(60)),
+            0u);
+
+  // An exhausted budget still compiles one SkSL per call.
+  ASSERT_EQ(persistent_cache->PrecompileDeferredSkSLs(context.get(),
+                                                      fml::TimeDelta::Zero()),
+            7u);
+  ASSERT_EQ(persistent_cache->PrecompileDeferredSkSLs(context.get(),
+                                                      fml::TimeDelta::Zero()),
+            6u);
+
+  // A large budget compiles the rest.
+  ASSERT_EQ(persistent_cache->PrecompileDeferredSkSLs(
+                context.get(), fml::TimeDelta::FromSeconds(60)),
+            0u);
+
+  // Cleanup
+  PersistentCache::SetCacheSkSL(false);
+  fml::RemoveFilesInDirectory(base_dir.fd());
+}
+
+TEST_F(PersistentCacheTest, StoresObjectsInPack) {
+  // Avoid polluting unit tests output with the warnings about writing the
+  // cache without a worker task runner.
+  fml::LogSettings error_only = {fml::LOG_ERROR};
+  fml::ScopedSetLogSettings scoped_set_log_settings(error_only);
+
+  fml::ScopedTemporaryDirectory base_dir;
+  ASSERT_TRUE(base_dir.fd().is_valid());
+  auto cache_dir = fml::CreateDirectory(
+      base_dir.fd(),
+      {"flutter_engine", GetFlutterEngineVersion(), "skia", GetSkiaVersion()},
+      fml::FilePermission::kReadWrite);
+
+  auto make_data = [](const std::string& string) {
+    return SkData::MakeWithCopy(string.data(), string.size());
+  };
+
+  // An object stored in its own file by an earlier version of the cache.
+  sk_sp<SkData> old_key = make_data("old_key");
+  std::string old_file_name = PersistentCache::SkKeyToFilePath(*old_key);
+  ASSERT_TRUE(fml::WriteAtomically(
+      cache_dir, old_file_name.c_str(),
+      *PersistentCache::BuildCacheObject(*old_key, *make_data("old_value"))));
+
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::ResetCacheForProcess();
+  auto persistent_cache = PersistentCache::GetCacheForProcess();
+  CheckTextSkData(persistent_cache->load(*old_key), "old_value");
+
+  std::vector<sk_sp<SkData>> keys;
+  for (int i = 0; i < 10; i++) {
+    keys.push_back(make_data("key" + std::to_string(i)));
+    StorePersistentCache(persistent_cache, *keys.back(),
+                         *make_data("value" + std::to_string(i)));
+  }
+  // Storing a key again replaces its value.
+  StorePersistentCache(persistent_cache, *keys[3], *make_data("new_value"));
+
+  // The first store builds the pack, including the object from the old file.
+  // Later objects are appended to the log.
+  ASSERT_FALSE(
+      fml::OpenFileReadOnly(cache_dir, old_file_name.c_str()).is_valid());
+  auto pack = PersistentCachePack::Open(cache_dir);
+  ASSERT_TRUE(pack != nullptr);
+  ASSERT_EQ(pack->GetObjectCount(), 2u);
+  ASSERT_TRUE(fml::FileExists(cache_dir, PersistentCachePack::kLogFileName));
+
+  // A new cache finds the objects in the pack.
+  PersistentCache::ResetCacheForProcess();
+  persistent_cache = PersistentCache::GetCacheForProcess();
+  CheckTextSkData(persistent_cache->load(*old_key), "old_value");
+  CheckTextSkData(persistent_cache->load(*keys[0]), "value0");
+  CheckTextSkData(persistent_cache->load(*keys[3]), "new_value");
+  ASSERT_EQ(persistent_cache->load(*make_data("missing")), nullptr);
+
+  // Cleanup
+  fml::RemoveFilesInDirectory(base_dir.fd());
+}
+
+TEST_F(PersistentCacheTest, AppendsToPackLogAndCompactsIt) {
+  // Avoid polluting unit tests output with the warnings about writing the
+  // cache without a worker task runner.
+  fml::LogSettings error_only = {fml::LOG_ERROR};
+  fml::ScopedSetLogSettings scoped_set_log_settings(error_only);
+
+  fml::ScopedTemporaryDirectory base_dir;
+  ASSERT_TRUE(base_dir.fd().is_valid());
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::ResetCacheForProcess();
+  auto persistent_cache = PersistentCache::GetCacheForProcess();
+  auto cache_dir = fml::CreateDirectory(
+      base_dir.fd(),
+      {"flutter_engine", GetFlutterEngineVersion(), "skia", GetSkiaVersion()},
+      fml::FilePermission::kReadWrite);
+  ASSERT_TRUE(cache_dir.is_valid());
+
+  auto make_data = [](const std::string& string) {
+    return SkData::MakeWithCopy(string.data(), string.size());
+  };
+  auto log_size = [&cache_dir]() -> size_t {
+    auto file =
+        fml::OpenFileReadOnly(cache_dir, PersistentCachePack::kLogFileName);
+    return file.is_valid() ? fml::FileMapping(file).GetSize() : 0;
+  };
+
+  StorePersistentCache(persistent_cache, *make_data("key0"),
+                       *make_data("value0"));
+  auto pack = PersistentCachePack::Open(cache_dir);
+  ASSERT_TRUE(pack != nullptr);
+  const size_t pack_size = pack->GetSize();
+
+  // Stores append to the log and leave the pack as it is.
+  size_t last_log_size = 0;
+  for (int i = 1; i < 4; i++) {
+    StorePersistentCache(persistent_cache,
+                         *make_data("key" + std::to_string(i)),
+                         *make_data("value" + std::to_string(i)));
+    ASSERT_GT(log_size(), last_log_size);
+    last_log_size = log_size();
+  }
+  ASSERT_EQ(PersistentCachePack::Open(cache_dir)->GetSize(), pack_size);
+  ASSERT_EQ(PersistentCachePack::Open(cache_dir)->GetObjectCount(), 1u);
+
+  // A record whose append was interrupted is dropped when the log is read, so
+  // that later records can be appended after the valid ones.
+  std::vector<uint8_t> torn_record(sizeof(uint64_t) + 4, 0);
+  torn_record[0] = 100;
+  ASSERT_TRUE(fml::AppendToFile(cache_dir, PersistentCachePack::kLogFileName,
+                                fml::DataMapping(torn_record)));
+  PersistentCache::ResetCacheForProcess();
+  persistent_cache = PersistentCache::GetCacheForProcess();
+  ASSERT_EQ(log_size(), last_log_size);
+  CheckTextSkData(persistent_cache->load(*make_data("key0")), "value0");
+  CheckTextSkData(persistent_cache->load(*make_data("key3")), "value3");
+  StorePersistentCache(persistent_cache, *make_data("key4"),
+                       *make_data("value4"));
+  PersistentCache::ResetCacheForProcess();
+  persistent_cache = PersistentCache::GetCacheForProcess();
+  CheckTextSkData(persistent_cache->load(*make_data("key4")), "value4");
+
+  // Once the log is large enough, it is compacted into a new pack.
+  std::string large_value(PersistentCachePack::kMinLogSizeToCompact / 4, 'x');
+  for (int i = 0; i < 4; i++) {
+    StorePersistentCache(persistent_cache,
+                         *make_data("large" + std::to_string(i)),
+                         *make_data(large_value));
+  }
+  ASSERT_FALSE(fml::FileExists(cache_dir, PersistentCachePack::kLogFileName));
+  pack = PersistentCachePack::Open(cache_dir);
+  ASSERT_TRUE(pack != nullptr);
+  ASSERT_EQ(pack->GetObjectCount(), 9u);
+  CheckTextSkData(persistent_cache->load(*make_data("key2")), "value2");
+  CheckTextSkData(persistent_cache->load(*make_data("large3")), large_value);
+
+  // Cleanup
+  fml::RemoveFilesInDirectory(base_dir.fd());
+}
+
+TEST_F(PersistentCacheTest, StoresDataNextToShaders) {
+  // Avoid polluting unit tests output with the warnings about writing the
+  // cache without a worker task runner.
+  fml::LogSettings error_only = {fml::LOG_ERROR};
+  fml::ScopedSetLogSettings scoped_set_log_settings(error_only);
+
+  fml::ScopedTemporaryDirectory base_dir;
+  ASSERT_TRUE(base_dir.fd().is_valid());
+  PersistentCache::SetCacheDirectoryPath(base_dir.path());
+  PersistentCache::ResetCacheForProcess();
+  auto persistent_cache = PersistentCache::GetCacheForProcess();
+  ASSERT_EQ(persistent_cache->LoadData("data"), nullptr);
+
+  persistent_cache->StoreData(
+      "data", std::make_unique<fml::DataMapping>(std::string("first")));
+  persistent_cache->StoreData(
+      "data", std::make_unique<fml::DataMapping>(std::string("second")));
+
+  // A new cache finds the latest data.
+  PersistentCache::ResetCacheForProcess();
+  persistent_cache = PersistentCache::GetCacheForProcess();
+  auto data = persistent_cache->LoadData("data");
+  ASSERT_NE(data, nullptr);
+  ASSERT_EQ(std::string(reinterpret_cast<const char*>(data->GetMapping()),
+                        data->GetSize()),
+            "second");
+
+  // Cleanup
+  fml::RemoveFilesInDirectory(base_dir.fd());
+}
+
 }  // namespace testing
 }  // namespace flutter
@@ -22,6 +22,7 @@
 #include "flutter/fml/message_loop.h"
 #include "flutter/fml/paths.h"
 #include "flutter/fml/trace_event.h"
+#include "flutter/lib/ui/text/font_collection.h"
 #include "flutter/runtime/dart_vm.h"
 #include "flutter/shell/common/engine.h"
 #include "flutter/shell/common/skia_event_tracer_impl.h"
@@ -40,6 +41,9 @@ constexpr char kSkiaChannel[] = "flutter/skia";
 constexpr char kSystemChannel[] = "flutter/system";
 constexpr char kTypeKey[] = "type";
 constexpr char kFontChange[] = "fontsChange";
+// Decoded images are kept alive by the image decode cache for up to this
+// fraction of the GPU resource cache budget.
+constexpr size_t kImageDecodeCacheBudgetDivisor = 4;
 
 namespace {
 
@@ -109,6 +113,11 @@ void PerformInitializationTasks(Settings& settings) {
         FML_DLOG(WARNING) << "Skipping ICU initialization in the shell.";
       }
     }
+
+    if (settings.text_layout_cache_max_bytes > 0) {
+      FontCollection::SetLayoutCacheBudget(
+          settings.text_layout_cache_max_bytes);
+    }
   });
   PersistentCache::SetCacheSkSL(settings.cache_sksl);
 }
@@ -567,6 +576,13 @@ void Shell::NotifyLowMemoryWarning() const {
         TRACE_EVENT_ASYNC_END0("flutter", "Shell::NotifyLowMemoryWarning",
                                trace_id);
       });
+  task_runners_.GetUITaskRunner()->PostTask([engine = engine_->GetWeakPtr()]() {
+    if (engine) {
+      if (auto image_decoder = engine->GetImageDecoderWeakPtr()) {
+        image_decoder->PurgeDecodeCache();
+      }
+    }
+  });
   // The IO Manager uses resource cache limits of 0, so it is not necessary
   // to purge them.
 }
@@ -698,6 +714,9 @@ bool Shell::Setup(std::unique_ptr<PlatformView> platform_view,
   PersistentCache::GetCacheForProcess()->AddWorkerTaskRunner(
       task_runners_.GetIOTaskRunner());
 
+  PersistentCache::GetCacheForProcess()->SetConcurrentTaskRunner(
+      vm_->GetConcurrentWorkerTaskRunner());
+
   PersistentCache::GetCacheForProcess()->SetIsDumpingSkp(
       settings_.dump_skp_on_shader_compilation);
 
@@ -947,9 +966,13 @@ void Shell::OnPlatformViewSetViewportMetrics(const ViewportMetrics& metrics) {
       });
 
   task_runners_.GetUITaskRunner()->PostTask(
-      [engine = engine_->GetWeakPtr(), metrics]() {
+      [engine = engine_->GetWeakPtr(), metrics, resource_cache_max_bytes]() {
         if (engine) {
           engine->SetViewportMetrics(metrics);
+          if (auto image_decoder = engine->GetImageDecoderWeakPtr()) {
+            image_decoder->SetDecodeCacheMaxBytes(
+                resource_cache_max_bytes / kImageDecodeCacheBudgetDivisor);
+          }
         }
       });
 
@@ -1445,6 +1468,11 @@ void Shell::OnFrameRasterized(const FrameTiming& timing) {
   FML_DCHECK(is_setup_);
   FML_DCHECK(task_runners_.GetRasterTaskRunner()->RunsTasksOnCurrentThread());
 
+  if (!persistent_cache_first_frame_marked_) {
+    persistent_cache_first_frame_marked_ = true;
+    PersistentCache::GetCacheForProcess()->MarkFirstFrameRasterized();
+  }
+
   // The C++ callback defined in settings.h and set by Flutter runner. This is
   // independent of the timings report to the Dart side.
   if (settings_.frame_rasterized_callback) {
@@ -443,6 +443,11 @@ class Shell final : public PlatformView::Delegate,
   uint64_t next_pointer_flow_id_ = 0;
 
   bool first_frame_rasterized_ = false;
+
+  // Whether the persistent cache has been told that the first frame was
+  // rasterized.
+  bool persistent_cache_first_frame_marked_ = false;
+
   std::atomic<bool> waiting_for_first_frame_ = true;
   std::mutex waiting_for_first_frame_mutex_;
   std::condition_variable waiting_for_first_frame_condition_;
@@ -11,6 +11,7 @@
 #include <utility>
 #include <vector>
 
+#include "assets/asset_index.h"
 #include "assets/directory_asset_bundle.h"
 #include "common/graphics/persistent_cache.h"
 #include "flutter/flow/layers/backdrop_filter_layer.h"
@@ -18,6 +19,7 @@
 #include "flutter/flow/layers/layer_raster_cache_item.h"
 #include "flutter/flow/layers/platform_view_layer.h"
 #include "flutter/flow/layers/transform_layer.h"
+#include "flutter/fml/build_config.h"
 #include "flutter/fml/command_line.h"
 #include "flutter/fml/dart/dart_converter.h"
 #include "flutter/fml/make_copyable.h"
@@ -45,6 +47,17 @@
 #include "flutter/vulkan/vulkan_application.h"  // nogncheck
 #endif
 
+#if defined(FML_OS_LINUX)
+#include <linux/filter.h>
+#include <linux/seccomp.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+
+#include <csignal>
+#include <cstddef>
+#include <cstdlib>
+#endif  // FML_OS_LINUX
+
 // CREATE_NATIVE_ENTRY is leaky by design
 // NOLINTBEGIN(clang-analyzer-core.StackAddressEscape)
 
@@ -2875,6 +2888,145 @@ TEST_F(ShellTest, AssetManagerSingle) {
   ASSERT_TRUE(result == content);
 }
 
+TEST_F(ShellTest, AssetManagerUsesAssetIndex) {
+  fml::ScopedTemporaryDirectory asset_dir;
+  fml::UniqueFD asset_dir_fd = fml::OpenDirectory(
+      asset_dir.path().c_str(), false, fml::FilePermission::kRead);
+
+  std::string content = "test_content";
+  for (auto filename : {"indexed", "unindexed"}) {
+    ASSERT_TRUE(fml::WriteAtomically(asset_dir_fd, filename,
+                                     fml::DataMapping(content)));
+  }
+  std::vector<AssetIndex::Entry> entries = {
+      {.name = "indexed", .length = content.size()},
+      {.name = "missing", .length = 1},
+  };
+  ASSERT_TRUE(fml::WriteAtomically(
+      asset_dir_fd, AssetIndex::kFileName,
+      fml::DataMapping(AssetIndex::Serialize(entries))));
+
+  AssetManager asset_manager;
+  asset_manager.PushBack(
+      std::make_unique<DirectoryAssetBundle>(std::move(asset_dir_fd), false));
+
+  auto mapping = asset_manager.GetAsMapping("indexed");
+  ASSERT_TRUE(mapping != nullptr);
+  std::string result(reinterpret_cast<const char*>(mapping->GetMapping()),
+                     mapping->GetSize());
+  ASSERT_EQ(result, content);
+
+  // Assets that are not in the index are rejected without opening files, so
+  // files added after the index was built are not found.
+  ASSERT_EQ(asset_manager.GetAsMapping("unindexed"), nullptr);
+  ASSERT_EQ(asset_manager.GetAsMapping("missing"), nullptr);
+}
+
+#if defined(FML_OS_LINUX)
+// Installs a seccomp filter that kills the process on any system call that
+// opens or stats a path. Only used in death test children.
+static void KillOnFileSystemLookup() {
+  const std::vector<uint32_t> syscalls = {
+    __NR_openat, __NR_newfstatat, __NR_faccessat, __NR_statx,
+#ifdef __NR_open
+    __NR_open,   __NR_stat,       __NR_lstat,     __NR_access,
+#endif
+  };
+  std::vector<sock_filter> filter;
+  filter.push_back(
+      BPF_STMT(BPF_LD | BPF_W | BPF_ABS, offsetof(seccomp_data, nr)));
+  for (uint32_t nr : syscalls) {
+    filter.push_back(BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, nr, 0, 1));
+    filter.push_back(BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_KILL));
+  }
+  filter.push_back(BPF_STMT(BPF_RET | BPF_K, SECCOMP_RET_ALLOW));
+  sock_fprog program = {static_cast<unsigned short>(filter.size()),
+                        filter.data()};
+  if (prctl(PR_SET_NO_NEW_PRIVS, 1, 0, 0, 0) != 0 ||
+      prctl(PR_SET_SECCOMP, SECCOMP_MODE_FILTER, &program) != 0) {
+    std::_Exit(2);
+  }
+}
+
+TEST_F(ShellTest, AssetIndexAvoidsFileSystemLookups) {
+  fml::ScopedTemporaryDirectory asset_dir;
+  fml::UniqueFD asset_dir_fd = fml::OpenDirectory(
+      asset_dir.path().c_str(), false, fml::FilePermission::kRead);
+  ASSERT_TRUE(fml::WriteAtomically(asset_dir_fd, "indexed",
+                                   fml::DataMapping(std::string("content"))));
+  std::vector<AssetIndex::Entry> entries = {{.name = "indexed", .length = 7}};
+  ASSERT_TRUE(fml::WriteAtomically(
+      asset_dir_fd, AssetIndex::kFileName,
+      fml::DataMapping(AssetIndex::Serialize(entries))));
+
+  // The resolvers are created before the filter is installed, as they are at
+  // startup before the first asset is requested.
+  AssetManager asset_manager;
+  for (int i = 0; i < 3; i++) {
+    asset_manager.PushBack(std::make_unique<DirectoryAssetBundle>(
+        fml::OpenDirectory(asset_dir.path().c_str(), false,
+                           fml::FilePermission::kRead),
+        false));
+  }
+
+  // Looking up assets that no index contains makes no file system calls at
+  // all, however many resolvers are probed.
+  EXPECT_EXIT(
+      {
+        KillOnFileSystemLookup();
+        for (int i = 0; i < 100; i++) {
+          if (asset_manager.GetAsMapping("missing_" + std::to_string(i))) {
+            std::_Exit(1);
+          }
+        }
+        std::_Exit(0);
+      },
+      ::testing::ExitedWithCode(0), "");
+
+  // An indexed asset is opened, which shows that the filter catches lookups.
+  EXPECT_EXIT(
+      {
+        KillOnFileSystemLookup();
+        asset_manager.GetAsMapping("indexed");
+        std::_Exit(0);
+      },
+      ::testing::KilledBySignal(SIGSYS), "");
+}
+#endif  // FML_OS_LINUX
+
+TEST_F(ShellTest, AssetIndexLookup) {
+  std::vector<AssetIndex::Entry> entries;
+  for (int i = 0; i < 1000; i++) {
+    entries.push_back({.name = "assets/image_" + std::to_string(i) + ".png",
+                       .length = static_cast<uint64_t>(i)});
+  }
+  auto index = AssetIndex::Create(
+      std::make_unique<fml::DataMapping>(AssetIndex::Serialize(entries)));
+  ASSERT_TRUE(index != nullptr);
+  ASSERT_EQ(index->GetAssetCount(), entries.size());
+  for (const auto& entry : entries) {
+    ASSERT_EQ(index->FindAsset(entry.name), entry.length);
+  }
+  ASSERT_FALSE(index->FindAsset("assets/image_1000.png").has_value());
+  ASSERT_FALSE(index->FindAsset("").has_value());
+
+  auto data = AssetIndex::Serialize(entries);
+  data.resize(data.size() / 2);
+  ASSERT_EQ(AssetIndex::Create(std::make_unique<fml::DataMapping>(data)),
+            nullptr);
+  ASSERT_EQ(AssetIndex::Create(nullptr), nullptr);
+
+  // A header whose counts would wrap the section offsets around on 32-bit
+  // targets must be rejected rather than read out of bounds.
+  data = AssetIndex::Serialize(entries);
+  const uint32_t bucket_count = 0x80000000;
+  const uint32_t entry_count = 0x7fffffff;
+  memcpy(data.data() + 8, &bucket_count, sizeof(bucket_count));
+  memcpy(data.data() + 12, &entry_count, sizeof(entry_count));
+  ASSERT_EQ(AssetIndex::Create(std::make_unique<fml::DataMapping>(data)),
+            nullptr);
+}
+
 TEST_F(ShellTest, AssetManagerMulti) {
   fml::ScopedTemporaryDirectory asset_dir;
   fml::UniqueFD asset_dir_fd = fml::OpenDirectory(
@@ -474,6 +474,14 @@ Settings SettingsFromCommandLine(const fml::CommandLine& command_line) {
         std::stoi(resource_cache_max_bytes_threshold);
   }
 
+  if (command_line.HasOption(FlagForSwitch(Switch::TextLayoutCacheMaxBytes))) {
+    std::string text_layout_cache_max_bytes;
+    command_line.GetOptionValue(FlagForSwitch(Switch::TextLayoutCacheMaxBytes),
+                                &text_layout_cache_max_bytes);
+    settings.text_layout_cache_max_bytes =
+        std::stoul(text_layout_cache_max_bytes);
+  }
+
   if (command_line.HasOption(FlagForSwitch(Switch::MsaaSamples))) {
     std::string msaa_samples;
     command_line.GetOptionValue(FlagForSwitch(Switch::MsaaSamples),
@@ -229,6 +229,10 @@ DEF_SWITCH(OldGenHeapSize,
 DEF_SWITCH(ResourceCacheMaxBytesThreshold,
            "resource-cache-max-bytes-threshold",
            "The max bytes threshold of resource cache, or 0 for unlimited.")
+DEF_SWITCH(TextLayoutCacheMaxBytes,
+           "text-layout-cache-max-bytes",
+           "The max bytes used by the cache of shaped words of the text "
+           "layout engine, or 0 for the default.")
 DEF_SWITCH(EnableSkParagraph,
            "enable-skparagraph",
            "Selects the SkParagraph implementation of the text layout engine.")
@@ -36,6 +36,11 @@ namespace flutter {
 // system channel.
 static const size_t kGrCacheMaxByteSize = 24 * (1 << 20);
 
+// The time spent precompiling deferred SkSLs after presenting each frame. This
+// is a small part of a 60Hz frame so that it does not delay the next one.
+static constexpr fml::TimeDelta kDeferredSkSLsBudgetPerFrame =
+    fml::TimeDelta::FromMilliseconds(2);
+
 sk_sp<GrDirectContext> GPUSurfaceGLSkia::MakeGLContext(
     GPUSurfaceGLDelegate* delegate) {
   auto context_switch = delegate->GLContextMakeCurrent();
@@ -57,7 +62,10 @@ sk_sp<GrDirectContext> GPUSurfaceGLSkia::MakeGLContext(
 
   context->setResourceCacheLimit(kGrCacheMaxByteSize);
 
-  PersistentCache::GetCacheForProcess()->PrecompileKnownSkSLs(context.get());
+  // Only the SkSLs needed by the first frame are precompiled before it. The
+  // rest are precompiled a few at a time after each frame is presented.
+  PersistentCache::GetCacheForProcess()->PrecompileKnownSkSLs(
+      context.get(), /*defer_non_critical=*/true);
 
   return context;
 }
@@ -306,6 +314,12 @@ bool GPUSurfaceGLSkia::PresentSurface(const SurfaceFrame& frame,
     existing_damage_ = fbo_info.existing_damage;
   }
 
+  if (has_deferred_sksls_) {
+    has_deferred_sksls_ =
+        PersistentCache::GetCacheForProcess()->PrecompileDeferredSkSLs(
+            context_.get(), kDeferredSkSLsBudgetPerFrame) > 0;
+  }
+
   return true;
 }
 
@@ -78,6 +78,9 @@ class GPUSurfaceGLSkia : public Surface {
   // external view embedder is present.
   const bool render_to_surface_ = true;
   bool valid_ = false;
+  // Whether SkSLs whose precompilation was deferred past the first frame may
+  // still be pending in the context.
+  bool has_deferred_sksls_ = true;
 
   // WeakPtrFactory must be the last member.
   fml::TaskRunnerAffineWeakPtrFactory<GPUSurfaceGLSkia> weak_factory_;
@@ -84,7 +84,9 @@ std::unique_ptr<SurfaceFrame> GPUSurfaceMetalImpeller::AcquireFrame(const SkISiz
             std::move(surface),
             fml::MakeCopyable([aiks_context, picture = std::move(picture)](
                                   impeller::RenderTarget& render_target) -> bool {
-              return aiks_context->Render(picture, render_target);
+              auto result = aiks_context->Render(picture, render_target);
+              aiks_context->EndFrame();
+              return result;
             }));
       });
 
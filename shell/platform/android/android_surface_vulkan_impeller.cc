@@ -8,8 +8,10 @@
 #include <utility>
 
 #include "flutter/fml/concurrent_message_loop.h"
+#include "flutter/fml/file.h"
 #include "flutter/fml/logging.h"
 #include "flutter/fml/memory/ref_ptr.h"
+#include "flutter/fml/paths.h"
 #include "flutter/impeller/renderer/backend/vulkan/context_vk.h"
 #include "flutter/shell/gpu/gpu_surface_vulkan_impeller.h"
 #include "flutter/vulkan/vulkan_native_surface_android.h"
@@ -31,10 +33,17 @@ std::shared_ptr<impeller::Context> CreateImpellerContext(
   PFN_vkGetInstanceProcAddr instance_proc_addr =
       proc_table->NativeGetInstanceProcAddr();
 
+  // The pipeline cache is persisted next to the other engine caches so that
+  // pipelines compiled in previous runs don't have to be recompiled.
+  auto cache_directory = fml::CreateDirectory(
+      fml::paths::GetCachesDirectory(), {"flutter_engine", "impeller"},
+      fml::FilePermission::kReadWrite);
+
   auto context =
       impeller::ContextVK::Create(instance_proc_addr,                //
                                   shader_mappings,                   //
                                   nullptr,                           //
+                                  std::move(cache_directory),        //
                                   concurrent_loop->GetTaskRunner(),  //
                                   "Android Impeller Vulkan Lib"      //
       );
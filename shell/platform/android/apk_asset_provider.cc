@@ -28,6 +28,9 @@ class APKAssetMapping : public fml::Mapping {
 
   bool IsDontNeedSafe() const override { return !AAsset_isAllocated(asset_); }
 
+  // Assets are read from the installed APK, which is never modified in place.
+  bool IsImmutableFile() const override { return true; }
+
  private:
   AAsset* const asset_;
 
@@ -4,6 +4,8 @@
 
 #include "accessibility_bridge.h"
 
+#include <algorithm>
+#include <cmath>
 #include <functional>
 #include <utility>
 
@@ -61,6 +63,12 @@ void AccessibilityBridge::CommitUpdates() {
     }
   }
 
+  // Large lists resend many nodes that did not change. Those are not applied
+  // to the tree again. This is done after the reparented nodes are removed,
+  // as they must be added back even if they did not change.
+  std::unordered_map<int32_t, uint32_t> changed_fields =
+      RemoveUnchangedNodeUpdates();
+
   // Second, apply the pending node updates. This also moves reparented nodes to
   // their new parents if needed.
   ui::AXTreeUpdate update{.tree_data = tree_.data()};
@@ -75,16 +83,17 @@ void AccessibilityBridge::CommitUpdates() {
   std::vector<std::vector<SemanticsNode>> results;
   while (!pending_semantics_node_updates_.empty()) {
     auto begin = pending_semantics_node_updates_.begin();
-    SemanticsNode target = begin->second;
-    std::vector<SemanticsNode> sub_tree_list;
-    GetSubTreeList(target, sub_tree_list);
-    results.push_back(sub_tree_list);
+    SemanticsNode target = std::move(begin->second);
     pending_semantics_node_updates_.erase(begin);
+    std::vector<SemanticsNode> sub_tree_list;
+    GetSubTreeList(std::move(target), sub_tree_list);
+    results.push_back(std::move(sub_tree_list));
   }
 
   for (size_t i = results.size(); i > 0; i--) {
-    for (SemanticsNode node : results[i - 1]) {
-      ConvertFlutterUpdate(node, update);
+    for (SemanticsNode& node : results[i - 1]) {
+      ConvertFlutterUpdate(node, changed_fields[node.id], update);
+      committed_semantics_nodes_[node.id] = std::move(node);
     }
   }
 
@@ -173,6 +182,7 @@ void AccessibilityBridge::OnNodeDeleted(ui::AXTree* tree,
   if (id_wrapper_map_.find(node_id) != id_wrapper_map_.end()) {
     id_wrapper_map_.erase(node_id);
   }
+  committed_semantics_nodes_.erase(node_id);
 }
 
 void AccessibilityBridge::OnAtomicUpdateFinished(
@@ -250,22 +260,136 @@ AccessibilityBridge::CreateRemoveReparentedNodesUpdate() {
   return update;
 }
 
+std::unordered_map<int32_t, uint32_t>
+AccessibilityBridge::RemoveUnchangedNodeUpdates() {
+  std::unordered_map<int32_t, uint32_t> changed_fields;
+  for (auto iter = pending_semantics_node_updates_.begin();
+       iter != pending_semantics_node_updates_.end();) {
+    uint32_t changed = kAllFields;
+    auto committed = committed_semantics_nodes_.find(iter->first);
+    if (committed != committed_semantics_nodes_.end() &&
+        tree_.GetFromId(iter->first)) {
+      changed = GetChangedFields(committed->second, iter->second);
+    }
+    if (changed == 0) {
+      iter = pending_semantics_node_updates_.erase(iter);
+    } else {
+      changed_fields[iter->first] = changed;
+      ++iter;
+    }
+  }
+  return changed_fields;
+}
+
+uint32_t AccessibilityBridge::GetChangedFields(
+    const SemanticsNode& previous,
+    const SemanticsNode& node) const {
+  auto same_double = [](double a, double b) {
+    return a == b || (std::isnan(a) && std::isnan(b));
+  };
+  uint32_t changed = 0;
+  if (previous.flags != node.flags) {
+    changed |= kFlagsField;
+  }
+  if (previous.actions != node.actions) {
+    changed |= kActionsField;
+  }
+  if (previous.text_selection_base != node.text_selection_base ||
+      previous.text_selection_extent != node.text_selection_extent) {
+    changed |= kTextSelectionField;
+  }
+  if (previous.scroll_child_count != node.scroll_child_count ||
+      previous.scroll_index != node.scroll_index ||
+      !same_double(previous.scroll_position, node.scroll_position) ||
+      !same_double(previous.scroll_extent_max, node.scroll_extent_max) ||
+      !same_double(previous.scroll_extent_min, node.scroll_extent_min)) {
+    changed |= kScrollField;
+  }
+  if (previous.elevation != node.elevation ||
+      previous.thickness != node.thickness) {
+    changed |= kElevationField;
+  }
+  if (previous.label != node.label) {
+    changed |= kLabelField;
+  }
+  if (previous.hint != node.hint) {
+    changed |= kHintField;
+  }
+  if (previous.value != node.value) {
+    changed |= kValueField;
+  }
+  if (previous.increased_value != node.increased_value) {
+    changed |= kIncreasedValueField;
+  }
+  if (previous.decreased_value != node.decreased_value) {
+    changed |= kDecreasedValueField;
+  }
+  if (previous.tooltip != node.tooltip) {
+    changed |= kTooltipField;
+  }
+  if (previous.text_direction != node.text_direction) {
+    changed |= kTextDirectionField;
+  }
+  if (previous.rect.left != node.rect.left ||
+      previous.rect.top != node.rect.top ||
+      previous.rect.right != node.rect.right ||
+      previous.rect.bottom != node.rect.bottom) {
+    changed |= kRectField;
+  }
+  const FlutterTransformation& a = previous.transform;
+  const FlutterTransformation& b = node.transform;
+  if (a.scaleX != b.scaleX || a.skewX != b.skewX || a.transX != b.transX ||
+      a.skewY != b.skewY || a.scaleY != b.scaleY || a.transY != b.transY ||
+      a.pers0 != b.pers0 || a.pers1 != b.pers1 || a.pers2 != b.pers2) {
+    changed |= kTransformField;
+  }
+  if (previous.children_in_traversal_order !=
+      node.children_in_traversal_order) {
+    changed |= kChildrenField;
+  }
+  // The descriptions of the custom actions come from the pending custom
+  // action updates.
+  bool custom_actions_updated = std::any_of(
+      node.custom_accessibility_actions.begin(),
+      node.custom_accessibility_actions.end(), [this](int32_t id) {
+        return pending_semantics_custom_action_updates_.count(id) > 0;
+      });
+  if (custom_actions_updated || previous.custom_accessibility_actions !=
+                                    node.custom_accessibility_actions) {
+    changed |= kCustomActionsField;
+  }
+  return changed;
+}
+
 // Private method.
-void AccessibilityBridge::GetSubTreeList(const SemanticsNode& target,
+void AccessibilityBridge::GetSubTreeList(SemanticsNode target,
                                          std::vector<SemanticsNode>& result) {
-  result.push_back(target);
-  for (int32_t child : target.children_in_traversal_order) {
+  result.push_back(std::move(target));
+  // |result| may reallocate while the children are added.
+  const std::vector<int32_t> children =
+      result.back().children_in_traversal_order;
+  for (int32_t child : children) {
     auto iter = pending_semantics_node_updates_.find(child);
     if (iter != pending_semantics_node_updates_.end()) {
-      SemanticsNode node = iter->second;
-      GetSubTreeList(node, result);
+      SemanticsNode node = std::move(iter->second);
       pending_semantics_node_updates_.erase(iter);
+      GetSubTreeList(std::move(node), result);
     }
   }
 }
 
 void AccessibilityBridge::ConvertFlutterUpdate(const SemanticsNode& node,
+                                               uint32_t changed_fields,
                                                ui::AXTreeUpdate& tree_update) {
+  // Moving a node only changes its location, so the rest of the data in the
+  // tree is kept.
+  if ((changed_fields & ~(kRectField | kTransformField)) == 0) {
+    ui::AXNodeData node_data = tree_.GetFromId(node.id)->data();
+    SetLocationFromFlutterUpdate(node_data, node);
+    tree_update.nodes.push_back(std::move(node_data));
+    return;
+  }
+
   ui::AXNodeData node_data;
   node_data.id = node.id;
   SetRoleFromFlutterUpdate(node_data, node);
@@ -278,6 +402,17 @@ void AccessibilityBridge::ConvertFlutterUpdate(const SemanticsNode& node,
   SetNameFromFlutterUpdate(node_data, node);
   SetValueFromFlutterUpdate(node_data, node);
   SetTooltipFromFlutterUpdate(node_data, node);
+  SetLocationFromFlutterUpdate(node_data, node);
+  for (auto child : node.children_in_traversal_order) {
+    node_data.child_ids.push_back(child);
+  }
+  SetTreeData(node, tree_update);
+  tree_update.nodes.push_back(std::move(node_data));
+}
+
+void AccessibilityBridge::SetLocationFromFlutterUpdate(
+    ui::AXNodeData& node_data,
+    const SemanticsNode& node) {
   node_data.relative_bounds.bounds.SetRect(node.rect.left, node.rect.top,
                                            node.rect.right - node.rect.left,
                                            node.rect.bottom - node.rect.top);
@@ -286,11 +421,6 @@ void AccessibilityBridge::ConvertFlutterUpdate(const SemanticsNode& node,
       node.transform.skewY, node.transform.scaleY, node.transform.transY, 0,
       node.transform.pers0, node.transform.pers1, node.transform.pers2, 0, 0, 0,
       0, 0);
-  for (auto child : node.children_in_traversal_order) {
-    node_data.child_ids.push_back(child);
-  }
-  SetTreeData(node, tree_update);
-  tree_update.nodes.push_back(node_data);
 }
 
 void AccessibilityBridge::SetRoleFromFlutterUpdate(ui::AXNodeData& node_data,
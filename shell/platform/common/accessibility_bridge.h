@@ -165,6 +165,29 @@ class AccessibilityBridge
     std::vector<int32_t> custom_accessibility_actions;
   } SemanticsNode;
 
+  // The fields of a |SemanticsNode| that an update can change. Nodes are
+  // updated in the tree according to the fields that changed since the last
+  // committed update.
+  enum SemanticsNodeField : uint32_t {
+    kFlagsField = 1 << 0,
+    kActionsField = 1 << 1,
+    kTextSelectionField = 1 << 2,
+    kScrollField = 1 << 3,
+    kElevationField = 1 << 4,
+    kLabelField = 1 << 5,
+    kHintField = 1 << 6,
+    kValueField = 1 << 7,
+    kIncreasedValueField = 1 << 8,
+    kDecreasedValueField = 1 << 9,
+    kTooltipField = 1 << 10,
+    kTextDirectionField = 1 << 11,
+    kRectField = 1 << 12,
+    kTransformField = 1 << 13,
+    kChildrenField = 1 << 14,
+    kCustomActionsField = 1 << 15,
+    kAllFields = (1 << 16) - 1,
+  };
+
   // See FlutterSemanticsCustomAction in embedder.h
   typedef struct {
     int32_t id;
@@ -179,6 +202,8 @@ class AccessibilityBridge
   ui::AXTree tree_;
   ui::AXEventGenerator event_generator_;
   std::unordered_map<int32_t, SemanticsNode> pending_semantics_node_updates_;
+  // The last update committed for each node in the tree.
+  std::unordered_map<int32_t, SemanticsNode> committed_semantics_nodes_;
   std::unordered_map<int32_t, SemanticsCustomAction>
       pending_semantics_custom_action_updates_;
   AccessibilityNodeId last_focused_id_ = ui::AXNode::kInvalidAXID;
@@ -189,10 +214,22 @@ class AccessibilityBridge
   // pending_semantics_updates_. Returns std::nullopt if none are reparented.
   std::optional<ui::AXTreeUpdate> CreateRemoveReparentedNodesUpdate();
 
-  void GetSubTreeList(const SemanticsNode& target,
+  // Drops the pending updates that do not change the committed nodes, and
+  // returns the fields changed by each remaining update. Updates of nodes
+  // that are not in the tree are kept, so this must be called after the
+  // reparented nodes are removed from it.
+  std::unordered_map<int32_t, uint32_t> RemoveUnchangedNodeUpdates();
+
+  uint32_t GetChangedFields(const SemanticsNode& previous,
+                            const SemanticsNode& node) const;
+
+  void GetSubTreeList(SemanticsNode target,
                       std::vector<SemanticsNode>& result);
   void ConvertFlutterUpdate(const SemanticsNode& node,
+                            uint32_t changed_fields,
                             ui::AXTreeUpdate& tree_update);
+  void SetLocationFromFlutterUpdate(ui::AXNodeData& node_data,
+                                    const SemanticsNode& node);
   void SetRoleFromFlutterUpdate(ui::AXNodeData& node_data,
                                 const SemanticsNode& node);
   void SetStateFromFlutterUpdate(ui::AXNodeData& node_data,
@@ -0,0 +1,107 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/shell/platform/common/test_accessibility_bridge.h"
+
+namespace flutter {
+
+namespace {
+
+// A list of |count| items under a root node, like a long scrollable list.
+class SemanticsList {
+ public:
+  explicit SemanticsList(size_t count) : children_(count) {
+    for (size_t i = 0; i < count; i++) {
+      children_[i] = static_cast<int32_t>(i + 1);
+      labels_.push_back("item " + std::to_string(i));
+      new_labels_.push_back("new item " + std::to_string(i));
+    }
+  }
+
+  // Sends every node of the list to the bridge. Each item is labeled with its
+  // new label if |relabel| is set.
+  void AddUpdates(AccessibilityBridge& bridge, bool relabel) const {
+    FlutterSemanticsNode root = CreateNode(0, "root");
+    root.child_count = children_.size();
+    root.children_in_traversal_order = children_.data();
+    bridge.AddFlutterSemanticsNodeUpdate(&root);
+    for (size_t i = 0; i < children_.size(); i++) {
+      FlutterSemanticsNode item =
+          CreateNode(children_[i],
+                     relabel ? new_labels_[i].c_str() : labels_[i].c_str());
+      item.rect = {0, i * 10.0, 100, (i + 1) * 10.0};
+      bridge.AddFlutterSemanticsNodeUpdate(&item);
+    }
+  }
+
+ private:
+  std::vector<int32_t> children_;
+  std::vector<std::string> labels_;
+  std::vector<std::string> new_labels_;
+
+  static FlutterSemanticsNode CreateNode(int32_t id, const char* label) {
+    return {
+        .id = id,
+        .flags = static_cast<FlutterSemanticsFlag>(0),
+        .actions = static_cast<FlutterSemanticsAction>(0),
+        .text_selection_base = -1,
+        .text_selection_extent = -1,
+        .label = label,
+        .hint = "",
+        .value = "",
+        .increased_value = "",
+        .decreased_value = "",
+        .child_count = 0,
+        .children_in_traversal_order = nullptr,
+        .custom_accessibility_actions_count = 0,
+        .tooltip = "",
+    };
+  }
+};
+
+}  // namespace
+
+// The framework resends the whole list although nothing changed.
+static void BM_AccessibilityBridgeCommitUnchangedNodes(
+    benchmark::State& state) {
+  SemanticsList list(state.range(0));
+  auto bridge = std::make_shared<TestAccessibilityBridge>();
+  list.AddUpdates(*bridge, false);
+  bridge->CommitUpdates();
+  while (state.KeepRunning()) {
+    list.AddUpdates(*bridge, false);
+    bridge->CommitUpdates();
+  }
+  state.SetItemsProcessed(state.iterations() * (state.range(0) + 1));
+}
+
+// Every item of the list changes its label in each update.
+static void BM_AccessibilityBridgeCommitChangedNodes(benchmark::State& state) {
+  SemanticsList list(state.range(0));
+  auto bridge = std::make_shared<TestAccessibilityBridge>();
+  list.AddUpdates(*bridge, false);
+  bridge->CommitUpdates();
+  bool relabel = true;
+  while (state.KeepRunning()) {
+    list.AddUpdates(*bridge, relabel);
+    bridge->CommitUpdates();
+    bridge->accessibility_events.clear();
+    relabel = !relabel;
+  }
+  state.SetItemsProcessed(state.iterations() * (state.range(0) + 1));
+}
+
+BENCHMARK(BM_AccessibilityBridgeCommitUnchangedNodes)
+    ->RangeMultiplier(10)
+    ->Range(10, 10000);
+BENCHMARK(BM_AccessibilityBridgeCommitChangedNodes)
+    ->RangeMultiplier(10)
+    ->Range(10, 10000);
+
+}  // namespace flutter
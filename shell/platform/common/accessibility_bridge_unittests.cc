@@ -483,5 +483,100 @@ TEST(AccessibilityBridgeTest, CanReparentNodeWithChild) {
               Contains(ui::AXEventGenerator::Event::ROLE_CHANGED).Times(1));
 }
 
+TEST(AccessibilityBridgeTest, CanReparentUnchangedNode) {
+  std::shared_ptr<TestAccessibilityBridge> bridge =
+      std::make_shared<TestAccessibilityBridge>();
+
+  std::vector<int32_t> root_children{1};
+  std::vector<int32_t> child1_children{2};
+  std::vector<int32_t> child2_children{3};
+  FlutterSemanticsNode root = CreateSemanticsNode(0, "root", &root_children);
+  FlutterSemanticsNode child1 =
+      CreateSemanticsNode(1, "child 1", &child1_children);
+  FlutterSemanticsNode child2 =
+      CreateSemanticsNode(2, "child 2", &child2_children);
+  FlutterSemanticsNode leaf = CreateSemanticsNode(3, "leaf");
+
+  bridge->AddFlutterSemanticsNodeUpdate(&root);
+  bridge->AddFlutterSemanticsNodeUpdate(&child1);
+  bridge->AddFlutterSemanticsNodeUpdate(&child2);
+  bridge->AddFlutterSemanticsNodeUpdate(&leaf);
+  bridge->CommitUpdates();
+
+  // Move child2 and its child from child1 to the root. Only the parents
+  // change, child2 and the leaf are resent as they were.
+  child1.child_count = 0;
+  child1.children_in_traversal_order = nullptr;
+  int32_t new_root_children[] = {1, 2};
+  root.child_count = 2;
+  root.children_in_traversal_order = new_root_children;
+
+  bridge->AddFlutterSemanticsNodeUpdate(&root);
+  bridge->AddFlutterSemanticsNodeUpdate(&child1);
+  bridge->AddFlutterSemanticsNodeUpdate(&child2);
+  bridge->AddFlutterSemanticsNodeUpdate(&leaf);
+  bridge->CommitUpdates();
+
+  auto root_node = bridge->GetFlutterPlatformNodeDelegateFromID(0).lock();
+  auto child2_node = bridge->GetFlutterPlatformNodeDelegateFromID(2).lock();
+  auto leaf_node = bridge->GetFlutterPlatformNodeDelegateFromID(3).lock();
+  ASSERT_TRUE(child2_node);
+  ASSERT_TRUE(leaf_node);
+  EXPECT_EQ(root_node->GetChildCount(), 2);
+  EXPECT_EQ(root_node->GetData().child_ids[1], 2);
+  EXPECT_EQ(child2_node->GetName(), "child 2");
+  EXPECT_EQ(child2_node->GetChildCount(), 1);
+  EXPECT_EQ(child2_node->GetData().child_ids[0], 3);
+  EXPECT_EQ(leaf_node->GetName(), "leaf");
+
+  // The moved nodes are committed again, so resending them changes nothing.
+  bridge->accessibility_events.clear();
+  bridge->AddFlutterSemanticsNodeUpdate(&child2);
+  bridge->AddFlutterSemanticsNodeUpdate(&leaf);
+  bridge->CommitUpdates();
+  EXPECT_TRUE(bridge->accessibility_events.empty());
+}
+
+TEST(AccessibilityBridgeTest, OnlyAppliesChangedNodes) {
+  std::shared_ptr<TestAccessibilityBridge> bridge =
+      std::make_shared<TestAccessibilityBridge>();
+
+  std::vector<int32_t> children{1};
+  FlutterSemanticsNode root = CreateSemanticsNode(0, "root", &children);
+  FlutterSemanticsNode child1 = CreateSemanticsNode(1, "child 1");
+  child1.rect = {0, 0, 10, 10};
+  bridge->AddFlutterSemanticsNodeUpdate(&root);
+  bridge->AddFlutterSemanticsNodeUpdate(&child1);
+  bridge->CommitUpdates();
+  bridge->accessibility_events.clear();
+
+  // Resending the same nodes does not change the tree.
+  bridge->AddFlutterSemanticsNodeUpdate(&root);
+  bridge->AddFlutterSemanticsNodeUpdate(&child1);
+  bridge->CommitUpdates();
+  EXPECT_TRUE(bridge->accessibility_events.empty());
+
+  // Moving a node keeps the rest of its data.
+  child1.rect = {5, 5, 15, 15};
+  bridge->AddFlutterSemanticsNodeUpdate(&root);
+  bridge->AddFlutterSemanticsNodeUpdate(&child1);
+  bridge->CommitUpdates();
+  auto child1_node = bridge->GetFlutterPlatformNodeDelegateFromID(1).lock();
+  EXPECT_EQ(child1_node->GetData().relative_bounds.bounds,
+            gfx::RectF(5, 5, 10, 10));
+  EXPECT_EQ(child1_node->GetName(), "child 1");
+  EXPECT_EQ(child1_node->GetData().role, ax::mojom::Role::kStaticText);
+
+  // Changing a label updates the node.
+  bridge->accessibility_events.clear();
+  child1.label = "new child 1";
+  bridge->AddFlutterSemanticsNodeUpdate(&child1);
+  bridge->CommitUpdates();
+  child1_node = bridge->GetFlutterPlatformNodeDelegateFromID(1).lock();
+  EXPECT_EQ(child1_node->GetName(), "new child 1");
+  EXPECT_THAT(bridge->accessibility_events,
+              Contains(ui::AXEventGenerator::Event::NAME_CHANGED));
+}
+
 }  // namespace testing
 }  // namespace flutter
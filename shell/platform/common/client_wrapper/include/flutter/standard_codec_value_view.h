@@ -0,0 +1,162 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_INCLUDE_FLUTTER_STANDARD_CODEC_VALUE_VIEW_H_
+#define FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_INCLUDE_FLUTTER_STANDARD_CODEC_VALUE_VIEW_H_
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "encodable_value.h"
+
+namespace flutter {
+
+// A typed data list in an encoded message, read in place.
+template <typename T>
+class TypedDataView {
+ public:
+  TypedDataView() = default;
+
+  TypedDataView(const T* data, size_t size) : data_(data), size_(size) {}
+
+  const T* data() const { return data_; }
+
+  size_t size() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+  const T* begin() const { return data_; }
+
+  const T* end() const { return data_ + size_; }
+
+  const T& operator[](size_t index) const {
+    assert(index < size_);
+    return data_[index];
+  }
+
+  // Returns a copy of the list.
+  std::vector<T> ToVector() const { return std::vector<T>(begin(), end()); }
+
+ private:
+  const T* data_ = nullptr;
+  size_t size_ = 0;
+};
+
+// A read-only view of a value encoded with the standard codec, such as a
+// message received on a channel.
+//
+// Unlike decoding the message into an EncodableValue, reading a view does not
+// copy the message: strings and typed data lists point into the encoded
+// bytes, which must outlive the view and every view obtained from it. Lists
+// and maps are walked on demand.
+//
+// Only the types supported by StandardCodecSerializer itself can be viewed.
+// Messages with types added by a serializer subclass should be decoded with
+// the codec instead.
+class StandardCodecValueView {
+ public:
+  enum class Type {
+    kNull,
+    kBool,
+    kInt32,
+    kInt64,
+    kDouble,
+    kString,
+    kUInt8List,
+    kInt32List,
+    kInt64List,
+    kFloat32List,
+    kFloat64List,
+    kList,
+    kMap,
+  };
+
+  // Returns a view of the value encoded in |message|, which has a length of
+  // |size|, or nullopt if it is not a valid encoding of a single value.
+  //
+  // Typed data lists are read in place, so they must be aligned in memory.
+  // They are whenever |message| is aligned to 8 bytes, like the messages
+  // the engine passes to channels. Messages with misaligned typed data are
+  // rejected.
+  static std::optional<StandardCodecValueView> FromMessage(
+      const uint8_t* message,
+      size_t size);
+
+  Type type() const { return type_; }
+
+  bool IsNull() const { return type_ == Type::kNull; }
+
+  // Returns the value of a kBool, kInt32, kInt64 or kDouble view. The view
+  // must be of the given type.
+  bool GetBool() const;
+  int32_t GetInt32() const;
+  int64_t GetInt64() const;
+  double GetDouble() const;
+
+  // Returns the value of a kInt32 or kInt64 view as a 64-bit integer. See
+  // EncodableValue::LongValue.
+  int64_t GetLong() const;
+
+  // Returns the contents of a kString view.
+  std::string_view GetString() const;
+
+  // Returns the contents of a typed data list. |T| must match the type of the
+  // view: uint8_t for kUInt8List, int32_t for kInt32List, int64_t for
+  // kInt64List, float for kFloat32List and double for kFloat64List.
+  template <typename T>
+  TypedDataView<T> GetTypedData() const {
+    return TypedDataView<T>(reinterpret_cast<const T*>(message_ + data_),
+                            length_);
+  }
+
+  // Returns the length of a string or typed data list, the number of
+  // elements of a list, or the number of entries of a map. Returns 0 for
+  // other types.
+  size_t GetLength() const { return length_; }
+
+  // Returns the elements of a kList view.
+  std::vector<StandardCodecValueView> GetListElements() const;
+
+  // Returns the entries of a kMap view, in encoding order.
+  std::vector<std::pair<StandardCodecValueView, StandardCodecValueView>>
+  GetMapEntries() const;
+
+  // Returns the value for the string key |key| in a kMap view, or nullopt if
+  // the map has no such key.
+  std::optional<StandardCodecValueView> FindMapValue(
+      std::string_view key) const;
+
+  // Returns a copy of the value as an EncodableValue.
+  EncodableValue ToEncodableValue() const;
+
+ private:
+  StandardCodecValueView() = default;
+
+  // Reads the value whose type byte is at |offset| in |message|, which has a
+  // length of |size|. On success, |offset| is moved past the value.
+  static std::optional<StandardCodecValueView>
+  ReadAt(const uint8_t* message, size_t size, size_t* offset);
+
+  // The start of the message, which alignment is relative to.
+  const uint8_t* message_ = nullptr;
+  // The length of the message.
+  size_t size_ = 0;
+  Type type_ = Type::kNull;
+  // The offset of the value's data in the message, past its type byte and
+  // size.
+  size_t data_ = 0;
+  // See |GetLength|.
+  size_t length_ = 0;
+  // The value of a kBool view.
+  bool bool_value_ = false;
+};
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_PLATFORM_COMMON_CLIENT_WRAPPER_INCLUDE_FLUTTER_STANDARD_CODEC_VALUE_VIEW_H_
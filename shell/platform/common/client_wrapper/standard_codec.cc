@@ -3,19 +3,24 @@
 // found in the LICENSE file.
 
 // This file contains what would normally be standard_codec_serializer.cc,
-// standard_message_codec.cc, and standard_method_codec.cc. They are grouped
-// together to simplify use of the client wrapper, since the common case is
-// that any client that needs one of these files needs all three.
+// standard_codec_value_view.cc, standard_message_codec.cc, and
+// standard_method_codec.cc. They are grouped together to simplify use of the
+// client wrapper, since the common case is that any client that needs one of
+// these files needs all of them.
 
 #include <cassert>
 #include <cstring>
 #include <iostream>
 #include <map>
+#include <memory>
+#include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "byte_buffer_streams.h"
 #include "include/flutter/standard_codec_serializer.h"
+#include "include/flutter/standard_codec_value_view.h"
 #include "include/flutter/standard_message_codec.h"
 #include "include/flutter/standard_method_codec.h"
 
@@ -78,6 +83,22 @@ EncodedType EncodedTypeForValue(const EncodableValue& value) {
   return EncodedType::kNull;
 }
 
+// The capacity the encoding buffer starts with. Most messages fit in it, so
+// the buffer is allocated once instead of growing byte by byte while the
+// message is written.
+constexpr size_t kInitialEncodingCapacity = 256;
+
+// Returns a buffer with the encoding written by |write|.
+template <typename WriteFunction>
+std::unique_ptr<std::vector<uint8_t>> EncodeToBuffer(
+    const WriteFunction& write) {
+  auto encoded = std::make_unique<std::vector<uint8_t>>();
+  encoded->reserve(kInitialEncodingCapacity);
+  ByteBufferStreamWriter stream(encoded.get());
+  write(&stream);
+  return encoded;
+}
+
 }  // namespace
 
 StandardCodecSerializer::StandardCodecSerializer() = default;
@@ -188,7 +209,7 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
       std::string string_value;
       string_value.resize(size);
       stream->ReadBytes(reinterpret_cast<uint8_t*>(&string_value[0]), size);
-      return EncodableValue(string_value);
+      return EncodableValue(std::move(string_value));
     }
     case EncodedType::kUInt8List:
       return ReadVector<uint8_t>(stream);
@@ -205,7 +226,7 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
       for (size_t i = 0; i < length; ++i) {
         list_value.push_back(ReadValue(stream));
       }
-      return EncodableValue(list_value);
+      return EncodableValue(std::move(list_value));
     }
     case EncodedType::kMap: {
       size_t length = ReadSize(stream);
@@ -215,7 +236,7 @@ EncodableValue StandardCodecSerializer::ReadValueOfType(
         EncodableValue value = ReadValue(stream);
         map_value.emplace(std::move(key), std::move(value));
       }
-      return EncodableValue(map_value);
+      return EncodableValue(std::move(map_value));
     }
     case EncodedType::kFloat32List: {
       return ReadVector<float>(stream);
@@ -268,7 +289,7 @@ EncodableValue StandardCodecSerializer::ReadVector(
   }
   stream->ReadBytes(reinterpret_cast<uint8_t*>(vector.data()),
                     count * type_size);
-  return EncodableValue(vector);
+  return EncodableValue(std::move(vector));
 }
 
 template <typename T>
@@ -287,6 +308,312 @@ void StandardCodecSerializer::WriteVector(const std::vector<T> vector,
                      count * type_size);
 }
 
+// ===== standard_codec_value_view.h =====
+
+namespace {
+
+// Reads a variable-length size at |offset| in |message|, which has a length
+// of |size|, and moves |offset| past it.
+bool ReadSizeAt(const uint8_t* message,
+                size_t size,
+                size_t* offset,
+                size_t* result) {
+  if (*offset >= size) {
+    return false;
+  }
+  uint8_t byte = message[(*offset)++];
+  if (byte < 254) {
+    *result = byte;
+    return true;
+  }
+  if (byte == 254) {
+    uint16_t value = 0;
+    if (size - *offset < sizeof(value)) {
+      return false;
+    }
+    std::memcpy(&value, message + *offset, sizeof(value));
+    *offset += sizeof(value);
+    *result = value;
+  } else {
+    uint32_t value = 0;
+    if (size - *offset < sizeof(value)) {
+      return false;
+    }
+    std::memcpy(&value, message + *offset, sizeof(value));
+    *offset += sizeof(value);
+    *result = value;
+  }
+  return true;
+}
+
+// Moves |offset| to the next multiple of |alignment|, as
+// ByteStreamReader::ReadAlignment does.
+bool AlignOffset(size_t size, size_t* offset, size_t alignment) {
+  size_t mod = *offset % alignment;
+  if (mod) {
+    *offset += alignment - mod;
+  }
+  return *offset <= size;
+}
+
+}  // namespace
+
+// static
+std::optional<StandardCodecValueView> StandardCodecValueView::FromMessage(
+    const uint8_t* message,
+    size_t size) {
+  if (!message) {
+    return std::nullopt;
+  }
+  size_t offset = 0;
+  auto view = ReadAt(message, size, &offset);
+  if (!view || offset != size) {
+    return std::nullopt;
+  }
+  return view;
+}
+
+// static
+std::optional<StandardCodecValueView> StandardCodecValueView::ReadAt(
+    const uint8_t* message,
+    size_t size,
+    size_t* offset) {
+  if (*offset >= size) {
+    return std::nullopt;
+  }
+  StandardCodecValueView view;
+  view.message_ = message;
+  view.size_ = size;
+  uint8_t type = message[(*offset)++];
+
+  // Reads a value of |length| bytes.
+  auto read_fixed = [&](Type value_type, size_t length) {
+    if (size - *offset < length) {
+      return false;
+    }
+    view.type_ = value_type;
+    view.data_ = *offset;
+    *offset += length;
+    return true;
+  };
+  // Reads a typed data list whose elements are |element_size| bytes.
+  auto read_typed_data = [&](Type value_type, size_t element_size) {
+    size_t count = 0;
+    if (!ReadSizeAt(message, size, offset, &count)) {
+      return false;
+    }
+    if (element_size > 1 && !AlignOffset(size, offset, element_size)) {
+      // ByteBufferStreamWriter does not pad empty lists.
+      if (count > 0) {
+        return false;
+      }
+      *offset = size;
+    }
+    if (count > 0 &&
+        reinterpret_cast<uintptr_t>(message + *offset) % element_size) {
+      return false;
+    }
+    if ((size - *offset) / element_size < count) {
+      return false;
+    }
+    view.type_ = value_type;
+    view.data_ = *offset;
+    view.length_ = count;
+    *offset += count * element_size;
+    return true;
+  };
+
+  bool valid = false;
+  switch (static_cast<EncodedType>(type)) {
+    case EncodedType::kNull:
+      view.type_ = Type::kNull;
+      valid = true;
+      break;
+    case EncodedType::kTrue:
+    case EncodedType::kFalse:
+      view.type_ = Type::kBool;
+      view.bool_value_ = static_cast<EncodedType>(type) == EncodedType::kTrue;
+      valid = true;
+      break;
+    case EncodedType::kInt32:
+      valid = read_fixed(Type::kInt32, 4);
+      break;
+    case EncodedType::kInt64:
+      valid = read_fixed(Type::kInt64, 8);
+      break;
+    case EncodedType::kFloat64:
+      valid = AlignOffset(size, offset, 8) && read_fixed(Type::kDouble, 8);
+      break;
+    case EncodedType::kLargeInt:
+    case EncodedType::kString: {
+      size_t length = 0;
+      valid = ReadSizeAt(message, size, offset, &length) &&
+              read_fixed(Type::kString, length);
+      view.length_ = length;
+      break;
+    }
+    case EncodedType::kUInt8List:
+      valid = read_typed_data(Type::kUInt8List, 1);
+      break;
+    case EncodedType::kInt32List:
+      valid = read_typed_data(Type::kInt32List, 4);
+      break;
+    case EncodedType::kInt64List:
+      valid = read_typed_data(Type::kInt64List, 8);
+      break;
+    case EncodedType::kFloat32List:
+      valid = read_typed_data(Type::kFloat32List, 4);
+      break;
+    case EncodedType::kFloat64List:
+      valid = read_typed_data(Type::kFloat64List, 8);
+      break;
+    case EncodedType::kList:
+    case EncodedType::kMap: {
+      bool is_map = static_cast<EncodedType>(type) == EncodedType::kMap;
+      size_t count = 0;
+      if (!ReadSizeAt(message, size, offset, &count)) {
+        break;
+      }
+      view.type_ = is_map ? Type::kMap : Type::kList;
+      view.data_ = *offset;
+      view.length_ = count;
+      size_t value_count = is_map ? count * 2 : count;
+      valid = true;
+      for (size_t i = 0; i < value_count && valid; ++i) {
+        valid = ReadAt(message, size, offset).has_value();
+      }
+      break;
+    }
+  }
+  if (!valid) {
+    return std::nullopt;
+  }
+  return view;
+}
+
+bool StandardCodecValueView::GetBool() const {
+  assert(type_ == Type::kBool);
+  return bool_value_;
+}
+
+int32_t StandardCodecValueView::GetInt32() const {
+  assert(type_ == Type::kInt32);
+  int32_t value = 0;
+  std::memcpy(&value, message_ + data_, sizeof(value));
+  return value;
+}
+
+int64_t StandardCodecValueView::GetInt64() const {
+  assert(type_ == Type::kInt64);
+  int64_t value = 0;
+  std::memcpy(&value, message_ + data_, sizeof(value));
+  return value;
+}
+
+double StandardCodecValueView::GetDouble() const {
+  assert(type_ == Type::kDouble);
+  double value = 0;
+  std::memcpy(&value, message_ + data_, sizeof(value));
+  return value;
+}
+
+int64_t StandardCodecValueView::GetLong() const {
+  if (type_ == Type::kInt32) {
+    return GetInt32();
+  }
+  return GetInt64();
+}
+
+std::string_view StandardCodecValueView::GetString() const {
+  assert(type_ == Type::kString);
+  return std::string_view(reinterpret_cast<const char*>(message_ + data_),
+                          length_);
+}
+
+std::vector<StandardCodecValueView> StandardCodecValueView::GetListElements()
+    const {
+  assert(type_ == Type::kList);
+  std::vector<StandardCodecValueView> elements;
+  elements.reserve(length_);
+  size_t offset = data_;
+  for (size_t i = 0; i < length_; ++i) {
+    elements.push_back(*ReadAt(message_, size_, &offset));
+  }
+  return elements;
+}
+
+std::vector<std::pair<StandardCodecValueView, StandardCodecValueView>>
+StandardCodecValueView::GetMapEntries() const {
+  assert(type_ == Type::kMap);
+  std::vector<std::pair<StandardCodecValueView, StandardCodecValueView>>
+      entries;
+  entries.reserve(length_);
+  size_t offset = data_;
+  for (size_t i = 0; i < length_; ++i) {
+    StandardCodecValueView key = *ReadAt(message_, size_, &offset);
+    StandardCodecValueView value = *ReadAt(message_, size_, &offset);
+    entries.emplace_back(key, value);
+  }
+  return entries;
+}
+
+std::optional<StandardCodecValueView> StandardCodecValueView::FindMapValue(
+    std::string_view key) const {
+  assert(type_ == Type::kMap);
+  size_t offset = data_;
+  for (size_t i = 0; i < length_; ++i) {
+    StandardCodecValueView entry_key = *ReadAt(message_, size_, &offset);
+    StandardCodecValueView entry_value = *ReadAt(message_, size_, &offset);
+    if (entry_key.type_ == Type::kString && entry_key.GetString() == key) {
+      return entry_value;
+    }
+  }
+  return std::nullopt;
+}
+
+EncodableValue StandardCodecValueView::ToEncodableValue() const {
+  switch (type_) {
+    case Type::kNull:
+      return EncodableValue();
+    case Type::kBool:
+      return EncodableValue(GetBool());
+    case Type::kInt32:
+      return EncodableValue(GetInt32());
+    case Type::kInt64:
+      return EncodableValue(GetInt64());
+    case Type::kDouble:
+      return EncodableValue(GetDouble());
+    case Type::kString:
+      return EncodableValue(std::string(GetString()));
+    case Type::kUInt8List:
+      return EncodableValue(GetTypedData<uint8_t>().ToVector());
+    case Type::kInt32List:
+      return EncodableValue(GetTypedData<int32_t>().ToVector());
+    case Type::kInt64List:
+      return EncodableValue(GetTypedData<int64_t>().ToVector());
+    case Type::kFloat32List:
+      return EncodableValue(GetTypedData<float>().ToVector());
+    case Type::kFloat64List:
+      return EncodableValue(GetTypedData<double>().ToVector());
+    case Type::kList: {
+      EncodableList list;
+      list.reserve(length_);
+      for (const auto& element : GetListElements()) {
+        list.push_back(element.ToEncodableValue());
+      }
+      return EncodableValue(std::move(list));
+    }
+    case Type::kMap: {
+      EncodableMap map;
+      for (const auto& [key, value] : GetMapEntries()) {
+        map.emplace(key.ToEncodableValue(), value.ToEncodableValue());
+      }
+      return EncodableValue(std::move(map));
+    }
+  }
+  return EncodableValue();
+}
+
 // ===== standard_message_codec.h =====
 
 // static
@@ -328,10 +655,9 @@ std::unique_ptr<EncodableValue> StandardMessageCodec::DecodeMessageInternal(
 std::unique_ptr<std::vector<uint8_t>>
 StandardMessageCodec::EncodeMessageInternal(
     const EncodableValue& message) const {
-  auto encoded = std::make_unique<std::vector<uint8_t>>();
-  ByteBufferStreamWriter stream(encoded.get());
-  serializer_->WriteValue(message, &stream);
-  return encoded;
+  return EncodeToBuffer([&](ByteStreamWriter* stream) {
+    serializer_->WriteValue(message, stream);
+  });
 }
 
 // ===== standard_method_codec.h =====
@@ -382,29 +708,28 @@ StandardMethodCodec::DecodeMethodCallInternal(const uint8_t* message,
 std::unique_ptr<std::vector<uint8_t>>
 StandardMethodCodec::EncodeMethodCallInternal(
     const MethodCall<EncodableValue>& method_call) const {
-  auto encoded = std::make_unique<std::vector<uint8_t>>();
-  ByteBufferStreamWriter stream(encoded.get());
-  serializer_->WriteValue(EncodableValue(method_call.method_name()), &stream);
-  if (method_call.arguments()) {
-    serializer_->WriteValue(*method_call.arguments(), &stream);
-  } else {
-    serializer_->WriteValue(EncodableValue(), &stream);
-  }
-  return encoded;
+  EncodableValue method_name(method_call.method_name());
+  return EncodeToBuffer([&](ByteStreamWriter* stream) {
+    serializer_->WriteValue(method_name, stream);
+    if (method_call.arguments()) {
+      serializer_->WriteValue(*method_call.arguments(), stream);
+    } else {
+      serializer_->WriteValue(EncodableValue(), stream);
+    }
+  });
 }
 
 std::unique_ptr<std::vector<uint8_t>>
 StandardMethodCodec::EncodeSuccessEnvelopeInternal(
     const EncodableValue* result) const {
-  auto encoded = std::make_unique<std::vector<uint8_t>>();
-  ByteBufferStreamWriter stream(encoded.get());
-  stream.WriteByte(0);
-  if (result) {
-    serializer_->WriteValue(*result, &stream);
-  } else {
-    serializer_->WriteValue(EncodableValue(), &stream);
-  }
-  return encoded;
+  return EncodeToBuffer([&](ByteStreamWriter* stream) {
+    stream->WriteByte(0);
+    if (result) {
+      serializer_->WriteValue(*result, stream);
+    } else {
+      serializer_->WriteValue(EncodableValue(), stream);
+    }
+  });
 }
 
 std::unique_ptr<std::vector<uint8_t>>
@@ -412,21 +737,19 @@ StandardMethodCodec::EncodeErrorEnvelopeInternal(
     const std::string& error_code,
     const std::string& error_message,
     const EncodableValue* error_details) const {
-  auto encoded = std::make_unique<std::vector<uint8_t>>();
-  ByteBufferStreamWriter stream(encoded.get());
-  stream.WriteByte(1);
-  serializer_->WriteValue(EncodableValue(error_code), &stream);
-  if (error_message.empty()) {
-    serializer_->WriteValue(EncodableValue(), &stream);
-  } else {
-    serializer_->WriteValue(EncodableValue(error_message), &stream);
-  }
-  if (error_details) {
-    serializer_->WriteValue(*error_details, &stream);
-  } else {
-    serializer_->WriteValue(EncodableValue(), &stream);
-  }
-  return encoded;
+  EncodableValue code(error_code);
+  EncodableValue message =
+      error_message.empty() ? EncodableValue() : EncodableValue(error_message);
+  return EncodeToBuffer([&](ByteStreamWriter* stream) {
+    stream->WriteByte(1);
+    serializer_->WriteValue(code, stream);
+    serializer_->WriteValue(message, stream);
+    if (error_details) {
+      serializer_->WriteValue(*error_details, stream);
+    } else {
+      serializer_->WriteValue(EncodableValue(), stream);
+    }
+  });
 }
 
 bool StandardMethodCodec::DecodeAndProcessResponseEnvelopeInternal(
@@ -0,0 +1,103 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <vector>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/shell/platform/common/client_wrapper/byte_buffer_streams.h"
+#include "flutter/shell/platform/common/client_wrapper/include/flutter/standard_codec_value_view.h"
+#include "flutter/shell/platform/common/client_wrapper/include/flutter/standard_message_codec.h"
+
+namespace flutter {
+
+namespace {
+
+// A message like the ones plugins send at high rates: a map with a few
+// properties and a large typed data list.
+EncodableValue CreateMessage(size_t sample_count) {
+  std::vector<double> samples(sample_count);
+  for (size_t i = 0; i < sample_count; ++i) {
+    samples[i] = static_cast<double>(i) * 0.5;
+  }
+  EncodableList tags;
+  for (size_t i = 0; i < 16; ++i) {
+    tags.push_back(EncodableValue("tag " + std::to_string(i)));
+  }
+  return EncodableValue(EncodableMap{
+      {EncodableValue("id"), EncodableValue(42)},
+      {EncodableValue("name"), EncodableValue("sensor")},
+      {EncodableValue("tags"), EncodableValue(std::move(tags))},
+      {EncodableValue("samples"), EncodableValue(std::move(samples))},
+  });
+}
+
+}  // namespace
+
+static void BM_StandardCodecDecodeValue(benchmark::State& state) {
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  auto encoded = codec.EncodeMessage(CreateMessage(state.range(0)));
+  double sum = 0;
+  while (state.KeepRunning()) {
+    auto decoded = codec.DecodeMessage(*encoded);
+    const auto& map = std::get<EncodableMap>(*decoded);
+    const auto& samples =
+        std::get<std::vector<double>>(map.at(EncodableValue("samples")));
+    sum += samples.back();
+  }
+  benchmark::DoNotOptimize(sum);
+  state.SetBytesProcessed(state.iterations() * encoded->size());
+}
+
+static void BM_StandardCodecDecodeView(benchmark::State& state) {
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  auto encoded = codec.EncodeMessage(CreateMessage(state.range(0)));
+  double sum = 0;
+  while (state.KeepRunning()) {
+    auto view =
+        StandardCodecValueView::FromMessage(encoded->data(), encoded->size());
+    auto samples = view->FindMapValue("samples")->GetTypedData<double>();
+    sum += samples[samples.size() - 1];
+  }
+  benchmark::DoNotOptimize(sum);
+  state.SetBytesProcessed(state.iterations() * encoded->size());
+}
+
+// Encodes into a buffer that grows as it is written, as the codec used to.
+static void BM_StandardCodecEncodeGrowing(benchmark::State& state) {
+  EncodableValue message = CreateMessage(state.range(0));
+  const StandardCodecSerializer& serializer =
+      StandardCodecSerializer::GetInstance();
+  size_t size = 0;
+  while (state.KeepRunning()) {
+    std::vector<uint8_t> encoded;
+    ByteBufferStreamWriter stream(&encoded);
+    serializer.WriteValue(message, &stream);
+    size = encoded.size();
+    benchmark::DoNotOptimize(encoded.data());
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+
+static void BM_StandardCodecEncodeMessage(benchmark::State& state) {
+  EncodableValue message = CreateMessage(state.range(0));
+  const StandardMessageCodec& codec = StandardMessageCodec::GetInstance();
+  size_t size = 0;
+  while (state.KeepRunning()) {
+    auto encoded = codec.EncodeMessage(message);
+    size = encoded->size();
+    benchmark::DoNotOptimize(encoded->data());
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+}
+
+BENCHMARK(BM_StandardCodecDecodeValue)->RangeMultiplier(8)->Range(8, 1 << 15);
+BENCHMARK(BM_StandardCodecDecodeView)->RangeMultiplier(8)->Range(8, 1 << 15);
+BENCHMARK(BM_StandardCodecEncodeGrowing)
+    ->RangeMultiplier(8)
+    ->Range(8, 1 << 15);
+BENCHMARK(BM_StandardCodecEncodeMessage)
+    ->RangeMultiplier(8)
+    ->Range(8, 1 << 15);
+
+}  // namespace flutter
@@ -7,6 +7,7 @@
 #include <map>
 #include <vector>
 
+#include "flutter/shell/platform/common/client_wrapper/include/flutter/standard_codec_value_view.h"
 #include "flutter/shell/platform/common/client_wrapper/testing/test_codec_extensions.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -49,6 +50,13 @@ static void CheckEncodeDecode(
   } else {
     EXPECT_EQ(value, *decoded);
   }
+
+  if (!serializer) {
+    auto view =
+        StandardCodecValueView::FromMessage(encoded->data(), encoded->size());
+    ASSERT_TRUE(view);
+    EXPECT_EQ(value, view->ToEncodableValue());
+  }
 }
 
 // Validates round-trip encoding and decoding of |value|, and checks that the
@@ -74,6 +82,11 @@ static void CheckEncodeDecodeWithEncodePrefix(
   auto decoded = codec.DecodeMessage(*encoded);
 
   EXPECT_EQ(value, *decoded);
+
+  auto view =
+      StandardCodecValueView::FromMessage(encoded->data(), encoded->size());
+  ASSERT_TRUE(view);
+  EXPECT_EQ(value, view->ToEncodableValue());
 }
 
 TEST(StandardMessageCodec, GetInstanceCachesInstance) {
@@ -259,4 +272,58 @@ TEST(StandardMessageCodec, CanEncodeAndDecodeVariableLengthCustomType) {
                     some_data_comparator);
 }
 
+TEST(StandardMessageCodec, ViewReadsTypedDataInPlace) {
+  EncodableValue value(EncodableMap{
+      {EncodableValue("name"), EncodableValue("points")},
+      {EncodableValue("count"), EncodableValue(3)},
+      {EncodableValue("values"),
+       EncodableValue(std::vector<double>{1.0, 2.0, 3.0})},
+  });
+  auto encoded = StandardMessageCodec::GetInstance().EncodeMessage(value);
+  ASSERT_TRUE(encoded);
+
+  auto view =
+      StandardCodecValueView::FromMessage(encoded->data(), encoded->size());
+  ASSERT_TRUE(view);
+  ASSERT_EQ(view->type(), StandardCodecValueView::Type::kMap);
+  EXPECT_EQ(view->GetLength(), 3u);
+  EXPECT_EQ(view->GetMapEntries().size(), 3u);
+
+  auto name = view->FindMapValue("name");
+  ASSERT_TRUE(name);
+  EXPECT_EQ(name->GetString(), "points");
+  auto count = view->FindMapValue("count");
+  ASSERT_TRUE(count);
+  EXPECT_EQ(count->GetLong(), 3);
+  EXPECT_FALSE(view->FindMapValue("missing"));
+
+  auto values = view->FindMapValue("values");
+  ASSERT_TRUE(values);
+  ASSERT_EQ(values->type(), StandardCodecValueView::Type::kFloat64List);
+  TypedDataView<double> data = values->GetTypedData<double>();
+  ASSERT_EQ(data.size(), 3u);
+  EXPECT_EQ(data[2], 3.0);
+  // The list is not copied out of the message.
+  EXPECT_GE(reinterpret_cast<const uint8_t*>(data.data()), encoded->data());
+  EXPECT_LT(reinterpret_cast<const uint8_t*>(data.data()),
+            encoded->data() + encoded->size());
+}
+
+TEST(StandardMessageCodec, ViewRejectsInvalidMessages) {
+  // Truncated string.
+  std::vector<uint8_t> truncated = {0x07, 0x05, 0x68, 0x65};
+  EXPECT_FALSE(
+      StandardCodecValueView::FromMessage(truncated.data(), truncated.size()));
+  // Trailing bytes.
+  std::vector<uint8_t> trailing = {0x00, 0x00};
+  EXPECT_FALSE(
+      StandardCodecValueView::FromMessage(trailing.data(), trailing.size()));
+  // Custom types are only known to serializer subclasses.
+  std::vector<uint8_t> custom = {0x80, 0x09, 0x00, 0x00, 0x00,
+                                 0x10, 0x00, 0x00, 0x00};
+  EXPECT_FALSE(
+      StandardCodecValueView::FromMessage(custom.data(), custom.size()));
+  EXPECT_FALSE(StandardCodecValueView::FromMessage(nullptr, 0));
+}
+
 }  // namespace flutter
@@ -5,6 +5,8 @@
 #include "flutter/shell/platform/common/json_method_codec.h"
 
 #include "flutter/shell/platform/common/json_message_codec.h"
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
 
 namespace flutter {
 
@@ -30,6 +32,31 @@ std::unique_ptr<rapidjson::Document> ExtractElement(
   return extracted;
 }
 
+// The envelopes are written around their contents rather than copying the
+// contents into a new document for JsonMessageCodec to encode.
+using JsonWriter = rapidjson::Writer<rapidjson::StringBuffer>;
+
+void WriteString(JsonWriter& writer, const std::string& value) {
+  writer.String(value.data(), static_cast<rapidjson::SizeType>(value.size()));
+}
+
+// Writes |value|, or null if there is no value.
+void WriteValue(JsonWriter& writer, const rapidjson::Document* value) {
+  if (value) {
+    // NOLINTNEXTLINE(clang-analyzer-core.*)
+    value->Accept(writer);
+  } else {
+    writer.Null();
+  }
+}
+
+std::unique_ptr<std::vector<uint8_t>> TakeMessage(
+    const rapidjson::StringBuffer& buffer) {
+  const char* buffer_start = buffer.GetString();
+  return std::make_unique<std::vector<uint8_t>>(
+      buffer_start, buffer_start + buffer.GetSize());
+}
+
 }  // namespace
 
 // static
@@ -66,34 +93,26 @@ JsonMethodCodec::DecodeMethodCallInternal(const uint8_t* message,
 
 std::unique_ptr<std::vector<uint8_t>> JsonMethodCodec::EncodeMethodCallInternal(
     const MethodCall<rapidjson::Document>& method_call) const {
-  // TODO(stuartmorgan): Consider revisiting the codec APIs to avoid the need
-  // to copy everything when doing encoding (e.g., by having a version that
-  // takes owership of the object to encode, so that it can be moved instead).
-  rapidjson::Document message(rapidjson::kObjectType);
-  auto& allocator = message.GetAllocator();
-  rapidjson::Value name(method_call.method_name(), allocator);
-  rapidjson::Value arguments;
-  if (method_call.arguments()) {
-    arguments.CopyFrom(*method_call.arguments(), allocator);
-  }
-  message.AddMember(kMessageMethodKey, name, allocator);
-  message.AddMember(kMessageArgumentsKey, arguments, allocator);
-
-  return JsonMessageCodec::GetInstance().EncodeMessage(message);
+  rapidjson::StringBuffer buffer;
+  JsonWriter writer(buffer);
+  writer.StartObject();
+  writer.Key(kMessageMethodKey);
+  WriteString(writer, method_call.method_name());
+  writer.Key(kMessageArgumentsKey);
+  WriteValue(writer, method_call.arguments());
+  writer.EndObject();
+  return TakeMessage(buffer);
 }
 
 std::unique_ptr<std::vector<uint8_t>>
 JsonMethodCodec::EncodeSuccessEnvelopeInternal(
     const rapidjson::Document* result) const {
-  rapidjson::Document envelope;
-  envelope.SetArray();
-  rapidjson::Value result_value;
-  if (result) {
-    result_value.CopyFrom(*result, envelope.GetAllocator());
-  }
-  envelope.PushBack(result_value, envelope.GetAllocator());
-
-  return JsonMessageCodec::GetInstance().EncodeMessage(envelope);
+  rapidjson::StringBuffer buffer;
+  JsonWriter writer(buffer);
+  writer.StartArray();
+  WriteValue(writer, result);
+  writer.EndArray();
+  return TakeMessage(buffer);
 }
 
 std::unique_ptr<std::vector<uint8_t>>
@@ -101,18 +120,14 @@ JsonMethodCodec::EncodeErrorEnvelopeInternal(
     const std::string& error_code,
     const std::string& error_message,
     const rapidjson::Document* error_details) const {
-  // NOLINTNEXTLINE(clang-analyzer-core.NullDereference)
-  rapidjson::Document envelope(rapidjson::kArrayType);
-  auto& allocator = envelope.GetAllocator();
-  envelope.PushBack(rapidjson::Value(error_code, allocator), allocator);
-  envelope.PushBack(rapidjson::Value(error_message, allocator), allocator);
-  rapidjson::Value details_value;
-  if (error_details) {
-    details_value.CopyFrom(*error_details, allocator);
-  }
-  envelope.PushBack(details_value, allocator);
-
-  return JsonMessageCodec::GetInstance().EncodeMessage(envelope);
+  rapidjson::StringBuffer buffer;
+  JsonWriter writer(buffer);
+  writer.StartArray();
+  WriteString(writer, error_code);
+  WriteString(writer, error_message);
+  WriteValue(writer, error_details);
+  writer.EndArray();
+  return TakeMessage(buffer);
 }
 
 bool JsonMethodCodec::DecodeAndProcessResponseEnvelopeInternal(
@@ -0,0 +1,131 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/common/text_input_json.h"
+
+#include <string>
+
+#include "rapidjson/stringbuffer.h"
+#include "rapidjson/writer.h"
+
+namespace flutter {
+
+namespace {
+
+using JsonWriter = rapidjson::Writer<rapidjson::StringBuffer>;
+
+// Keys used in MethodCall encoding.
+constexpr char kMessageMethodKey[] = "method";
+constexpr char kMessageArgumentsKey[] = "args";
+
+constexpr char kUpdateEditingStateMethod[] =
+    "TextInputClient.updateEditingState";
+constexpr char kUpdateEditingStateWithDeltasMethod[] =
+    "TextInputClient.updateEditingStateWithDeltas";
+
+constexpr char kDeltaOldTextKey[] = "oldText";
+constexpr char kDeltaTextKey[] = "deltaText";
+constexpr char kDeltaStartKey[] = "deltaStart";
+constexpr char kDeltaEndKey[] = "deltaEnd";
+constexpr char kDeltasKey[] = "deltas";
+constexpr char kComposingBaseKey[] = "composingBase";
+constexpr char kComposingExtentKey[] = "composingExtent";
+constexpr char kSelectionAffinityKey[] = "selectionAffinity";
+constexpr char kAffinityDownstream[] = "TextAffinity.downstream";
+constexpr char kSelectionBaseKey[] = "selectionBase";
+constexpr char kSelectionExtentKey[] = "selectionExtent";
+constexpr char kSelectionIsDirectionalKey[] = "selectionIsDirectional";
+constexpr char kTextKey[] = "text";
+
+void WriteString(JsonWriter& writer, const std::string& value) {
+  writer.String(value.data(), static_cast<rapidjson::SizeType>(value.size()));
+}
+
+// Starts a method call to |method| whose arguments are |client_id| followed
+// by an object, and returns with that object open.
+void StartMethodCall(JsonWriter& writer, const char* method, int client_id) {
+  writer.StartObject();
+  writer.Key(kMessageMethodKey);
+  writer.String(method);
+  writer.Key(kMessageArgumentsKey);
+  writer.StartArray();
+  writer.Int(client_id);
+  writer.StartObject();
+}
+
+void EndMethodCall(JsonWriter& writer) {
+  writer.EndObject();
+  writer.EndArray();
+  writer.EndObject();
+}
+
+void WriteSelectionAndComposing(JsonWriter& writer,
+                                const TextInputModel& model) {
+  TextRange selection = model.selection();
+  writer.Key(kSelectionAffinityKey);
+  writer.String(kAffinityDownstream);
+  writer.Key(kSelectionBaseKey);
+  writer.Int(static_cast<int>(selection.base()));
+  writer.Key(kSelectionExtentKey);
+  writer.Int(static_cast<int>(selection.extent()));
+  writer.Key(kSelectionIsDirectionalKey);
+  writer.Bool(false);
+
+  int composing_base = model.composing() ? model.composing_range().base() : -1;
+  int composing_extent =
+      model.composing() ? model.composing_range().extent() : -1;
+  writer.Key(kComposingBaseKey);
+  writer.Int(composing_base);
+  writer.Key(kComposingExtentKey);
+  writer.Int(composing_extent);
+}
+
+std::unique_ptr<std::vector<uint8_t>> TakeMessage(
+    const rapidjson::StringBuffer& buffer) {
+  const char* buffer_start = buffer.GetString();
+  return std::make_unique<std::vector<uint8_t>>(
+      buffer_start, buffer_start + buffer.GetSize());
+}
+
+}  // namespace
+
+std::unique_ptr<std::vector<uint8_t>> EncodeUpdateEditingState(
+    int client_id,
+    const TextInputModel& model) {
+  rapidjson::StringBuffer buffer;
+  JsonWriter writer(buffer);
+  StartMethodCall(writer, kUpdateEditingStateMethod, client_id);
+  WriteSelectionAndComposing(writer, model);
+  writer.Key(kTextKey);
+  WriteString(writer, model.GetText());
+  EndMethodCall(writer);
+  return TakeMessage(buffer);
+}
+
+std::unique_ptr<std::vector<uint8_t>> EncodeUpdateEditingStateWithDelta(
+    int client_id,
+    const TextInputModel& model,
+    const TextEditingDelta& delta) {
+  rapidjson::StringBuffer buffer;
+  JsonWriter writer(buffer);
+  StartMethodCall(writer, kUpdateEditingStateWithDeltasMethod, client_id);
+  writer.Key(kDeltasKey);
+  writer.StartArray();
+  writer.StartObject();
+  writer.Key(kDeltaOldTextKey);
+  WriteString(writer, delta.old_text());
+  writer.Key(kDeltaTextKey);
+  WriteString(writer, delta.delta_text());
+  writer.Key(kDeltaStartKey);
+  writer.Int(delta.delta_start());
+  writer.Key(kDeltaEndKey);
+  writer.Int(delta.delta_end());
+  WriteSelectionAndComposing(writer, model);
+  writer.EndObject();
+  writer.EndArray();
+  EndMethodCall(writer);
+  return TakeMessage(buffer);
+}
+
+}  // namespace flutter
@@ -0,0 +1,49 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef FLUTTER_SHELL_PLATFORM_COMMON_TEXT_INPUT_JSON_H_
+#define FLUTTER_SHELL_PLATFORM_COMMON_TEXT_INPUT_JSON_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "flutter/shell/platform/common/text_editing_delta.h"
+#include "flutter/shell/platform/common/text_input_model.h"
+
+namespace flutter {
+
+// Encoders for the text input channel messages that are sent on every
+// keystroke.
+//
+// The messages are the same as the JsonMethodCodec encoding of the method
+// calls, but they are written straight from the model instead of building a
+// rapidjson::Document first. They are sent with BinaryMessenger::Send on the
+// "flutter/textinput" channel.
+//
+// Incoming calls such as "TextInput.setEditingState" are still decoded by
+// the method channel. The framework only sends them when it changes the text
+// itself, not for every keystroke.
+//
+// The Linux embedding does not use these encoders. FlJsonMessageCodec
+// already writes its FlValues with a rapidjson::Writer and reads them with
+// a SAX handler, so no rapidjson::Document is built there.
+
+// Returns a "TextInputClient.updateEditingState" method call with the
+// state of |model| for the client |client_id|.
+std::unique_ptr<std::vector<uint8_t>> EncodeUpdateEditingState(
+    int client_id,
+    const TextInputModel& model);
+
+// Returns a "TextInputClient.updateEditingStateWithDeltas" method call with
+// |delta| and the selection and composing range of |model| for the client
+// |client_id|.
+std::unique_ptr<std::vector<uint8_t>> EncodeUpdateEditingStateWithDelta(
+    int client_id,
+    const TextInputModel& model,
+    const TextEditingDelta& delta);
+
+}  // namespace flutter
+
+#endif  // FLUTTER_SHELL_PLATFORM_COMMON_TEXT_INPUT_JSON_H_
@@ -0,0 +1,109 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+#include "flutter/benchmarking/benchmarking.h"
+#include "flutter/shell/platform/common/json_method_codec.h"
+#include "flutter/shell/platform/common/text_input_json.h"
+
+namespace {
+std::atomic<size_t> allocation_count = 0;
+}  // namespace
+
+// Count the heap allocations made by the benchmarks. Each benchmark reports
+// the number it made per iteration.
+void* operator new(size_t size) {
+  allocation_count.fetch_add(1, std::memory_order_relaxed);
+  void* pointer = std::malloc(size == 0 ? 1 : size);
+  if (pointer == nullptr) {
+    std::abort();
+  }
+  return pointer;
+}
+
+void operator delete(void* pointer) noexcept {
+  std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept {
+  std::free(pointer);
+}
+
+namespace flutter {
+
+namespace {
+
+std::unique_ptr<TextInputModel> CreateModel(size_t text_length) {
+  auto model = std::make_unique<TextInputModel>();
+  model->SetText(std::string(text_length, 'a'), TextRange(text_length));
+  return model;
+}
+
+// Encodes the editing state by building a document for JsonMethodCodec, as the
+// text input plugins used to.
+std::unique_ptr<std::vector<uint8_t>> EncodeUpdateEditingStateDocument(
+    int client_id,
+    const TextInputModel& model) {
+  auto args = std::make_unique<rapidjson::Document>(rapidjson::kArrayType);
+  auto& allocator = args->GetAllocator();
+  args->PushBack(client_id, allocator);
+
+  TextRange selection = model.selection();
+  rapidjson::Value editing_state(rapidjson::kObjectType);
+  editing_state.AddMember("selectionAffinity", "TextAffinity.downstream",
+                          allocator);
+  editing_state.AddMember("selectionBase", selection.base(), allocator);
+  editing_state.AddMember("selectionExtent", selection.extent(), allocator);
+  editing_state.AddMember("selectionIsDirectional", false, allocator);
+  editing_state.AddMember("composingBase", -1, allocator);
+  editing_state.AddMember("composingExtent", -1, allocator);
+  editing_state.AddMember(
+      "text", rapidjson::Value(model.GetText(), allocator).Move(), allocator);
+  args->PushBack(editing_state, allocator);
+
+  MethodCall<rapidjson::Document> call("TextInputClient.updateEditingState",
+                                       std::move(args));
+  return JsonMethodCodec::GetInstance().EncodeMethodCall(call);
+}
+
+}  // namespace
+
+static void BM_TextInputEncodeDocument(benchmark::State& state) {
+  auto model = CreateModel(state.range(0));
+  size_t size = 0;
+  const size_t allocations_before = allocation_count;
+  while (state.KeepRunning()) {
+    auto message = EncodeUpdateEditingStateDocument(1, *model);
+    size = message->size();
+    benchmark::DoNotOptimize(message->data());
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+  state.counters["Allocations"] =
+      benchmark::Counter(allocation_count - allocations_before,
+                         benchmark::Counter::kAvgIterations);
+}
+
+static void BM_TextInputEncodeStreaming(benchmark::State& state) {
+  auto model = CreateModel(state.range(0));
+  size_t size = 0;
+  const size_t allocations_before = allocation_count;
+  while (state.KeepRunning()) {
+    auto message = EncodeUpdateEditingState(1, *model);
+    size = message->size();
+    benchmark::DoNotOptimize(message->data());
+  }
+  state.SetBytesProcessed(state.iterations() * size);
+  state.counters["Allocations"] =
+      benchmark::Counter(allocation_count - allocations_before,
+                         benchmark::Counter::kAvgIterations);
+}
+
+BENCHMARK(BM_TextInputEncodeDocument)->RangeMultiplier(16)->Range(16, 1 << 16);
+BENCHMARK(BM_TextInputEncodeStreaming)->RangeMultiplier(16)->Range(16, 1 << 16);
+
+}  // namespace flutter
@@ -0,0 +1,91 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "flutter/shell/platform/common/text_input_json.h"
+
+#include "flutter/shell/platform/common/json_method_codec.h"
+#include "gtest/gtest.h"
+
+namespace flutter {
+
+namespace {
+
+std::unique_ptr<MethodCall<rapidjson::Document>> DecodeCall(
+    const std::vector<uint8_t>& message) {
+  return JsonMethodCodec::GetInstance().DecodeMethodCall(message);
+}
+
+}  // namespace
+
+TEST(TextInputJson, EncodesEditingState) {
+  TextInputModel model;
+  model.SetText("say \"hello\"\n");
+  model.SetSelection(TextRange(2, 5));
+
+  auto message = EncodeUpdateEditingState(7, model);
+  ASSERT_TRUE(message);
+  auto call = DecodeCall(*message);
+  ASSERT_TRUE(call);
+  EXPECT_EQ(call->method_name(), "TextInputClient.updateEditingState");
+
+  const rapidjson::Document& args = *call->arguments();
+  ASSERT_TRUE(args.IsArray());
+  ASSERT_EQ(args.Size(), 2u);
+  EXPECT_EQ(args[0].GetInt(), 7);
+  const rapidjson::Value& state = args[1];
+  EXPECT_STREQ(state["text"].GetString(), "say \"hello\"\n");
+  EXPECT_STREQ(state["selectionAffinity"].GetString(),
+               "TextAffinity.downstream");
+  EXPECT_EQ(state["selectionBase"].GetInt(), 2);
+  EXPECT_EQ(state["selectionExtent"].GetInt(), 5);
+  EXPECT_FALSE(state["selectionIsDirectional"].GetBool());
+  EXPECT_EQ(state["composingBase"].GetInt(), -1);
+  EXPECT_EQ(state["composingExtent"].GetInt(), -1);
+}
+
+TEST(TextInputJson, EncodesComposingRange) {
+  TextInputModel model;
+  model.BeginComposing();
+  model.UpdateComposingText("ni");
+
+  auto message = EncodeUpdateEditingState(1, model);
+  auto call = DecodeCall(*message);
+  ASSERT_TRUE(call);
+  const rapidjson::Value& state = (*call->arguments())[1];
+  EXPECT_STREQ(state["text"].GetString(), "ni");
+  EXPECT_EQ(state["composingBase"].GetInt(), 0);
+  EXPECT_EQ(state["composingExtent"].GetInt(), 2);
+}
+
+TEST(TextInputJson, EncodesEditingStateWithDelta) {
+  TextInputModel model;
+  model.SetText("hello");
+  model.SetSelection(TextRange(5));
+  TextEditingDelta delta("hell", TextRange(4), "o");
+
+  auto message = EncodeUpdateEditingStateWithDelta(3, model, delta);
+  ASSERT_TRUE(message);
+  auto call = DecodeCall(*message);
+  ASSERT_TRUE(call);
+  EXPECT_EQ(call->method_name(),
+            "TextInputClient.updateEditingStateWithDeltas");
+
+  const rapidjson::Document& args = *call->arguments();
+  ASSERT_EQ(args.Size(), 2u);
+  EXPECT_EQ(args[0].GetInt(), 3);
+  const rapidjson::Value& deltas = args[1]["deltas"];
+  ASSERT_TRUE(deltas.IsArray());
+  ASSERT_EQ(deltas.Size(), 1u);
+  const rapidjson::Value& encoded_delta = deltas[0];
+  EXPECT_STREQ(encoded_delta["oldText"].GetString(), "hell");
+  EXPECT_STREQ(encoded_delta["deltaText"].GetString(), "o");
+  EXPECT_EQ(encoded_delta["deltaStart"].GetInt(), 4);
+  EXPECT_EQ(encoded_delta["deltaEnd"].GetInt(), 4);
+  EXPECT_EQ(encoded_delta["selectionBase"].GetInt(), 5);
+  EXPECT_EQ(encoded_delta["selectionExtent"].GetInt(), 5);
+  EXPECT_EQ(encoded_delta["composingBase"].GetInt(), -1);
+  EXPECT_EQ(encoded_delta["composingExtent"].GetInt(), -1);
+}
+
+}  // namespace flutter
@@ -8,6 +8,7 @@
 #include <iostream>
 
 #include "flutter/shell/platform/common/json_method_codec.h"
+#include "flutter/shell/platform/common/text_input_json.h"
 
 static constexpr char kSetEditingStateMethod[] = "TextInput.setEditingState";
 static constexpr char kClearClientMethod[] = "TextInput.clearClient";
@@ -17,20 +18,13 @@ static constexpr char kHideMethod[] = "TextInput.hide";
 
 static constexpr char kMultilineInputType[] = "TextInputType.multiline";
 
-static constexpr char kUpdateEditingStateMethod[] =
-    "TextInputClient.updateEditingState";
 static constexpr char kPerformActionMethod[] = "TextInputClient.performAction";
 
 static constexpr char kTextInputAction[] = "inputAction";
 static constexpr char kTextInputType[] = "inputType";
 static constexpr char kTextInputTypeName[] = "name";
-static constexpr char kComposingBaseKey[] = "composingBase";
-static constexpr char kComposingExtentKey[] = "composingExtent";
-static constexpr char kSelectionAffinityKey[] = "selectionAffinity";
-static constexpr char kAffinityDownstream[] = "TextAffinity.downstream";
 static constexpr char kSelectionBaseKey[] = "selectionBase";
 static constexpr char kSelectionExtentKey[] = "selectionExtent";
-static constexpr char kSelectionIsDirectionalKey[] = "selectionIsDirectional";
 static constexpr char kTextKey[] = "text";
 
 static constexpr char kChannelName[] = "flutter/textinput";
@@ -97,7 +91,8 @@ void TextInputPlugin::KeyboardHook(GLFWwindow* window,
 }
 
 TextInputPlugin::TextInputPlugin(flutter::BinaryMessenger* messenger)
-    : channel_(std::make_unique<flutter::MethodChannel<rapidjson::Document>>(
+    : messenger_(messenger),
+      channel_(std::make_unique<flutter::MethodChannel<rapidjson::Document>>(
           messenger,
           kChannelName,
           &flutter::JsonMethodCodec::GetInstance())),
@@ -206,24 +201,11 @@ void TextInputPlugin::HandleMethodCall(
 }
 
 void TextInputPlugin::SendStateUpdate(const TextInputModel& model) {
-  auto args = std::make_unique<rapidjson::Document>(rapidjson::kArrayType);
-  auto& allocator = args->GetAllocator();
-  args->PushBack(client_id_, allocator);
-
-  TextRange selection = model.selection();
-  rapidjson::Value editing_state(rapidjson::kObjectType);
-  editing_state.AddMember(kComposingBaseKey, -1, allocator);
-  editing_state.AddMember(kComposingExtentKey, -1, allocator);
-  editing_state.AddMember(kSelectionAffinityKey, kAffinityDownstream,
-                          allocator);
-  editing_state.AddMember(kSelectionBaseKey, selection.base(), allocator);
-  editing_state.AddMember(kSelectionExtentKey, selection.extent(), allocator);
-  editing_state.AddMember(kSelectionIsDirectionalKey, false, allocator);
-  editing_state.AddMember(
-      kTextKey, rapidjson::Value(model.GetText(), allocator).Move(), allocator);
-  args->PushBack(editing_state, allocator);
-
-  channel_->InvokeMethod(kUpdateEditingStateMethod, std::move(args));
+  // Update messages are sent on every keystroke, so they are encoded directly
+  // rather than built as a document for |channel_| to encode.
+  std::unique_ptr<std::vector<uint8_t>> message =
+      EncodeUpdateEditingState(client_id_, model);
+  messenger_->Send(kChannelName, message->data(), message->size());
 }
 
 void TextInputPlugin::EnterPressed(TextInputModel* model) {
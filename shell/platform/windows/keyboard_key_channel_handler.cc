@@ -6,9 +6,13 @@
 
 #include <windows.h>
 
+#include <cstring>
+
 #include "flutter/fml/logging.h"
 #include "flutter/shell/platform/common/json_message_codec.h"
 #include "flutter/shell/platform/windows/keyboard_utils.h"
+#include "rapidjson/memorystream.h"
+#include "rapidjson/reader.h"
 
 namespace flutter {
 
@@ -97,6 +101,58 @@ int GetModsForKeyState() {
   return mods;
 }
 
+// Reads the "handled" value of a key event reply without building a
+// document for it, since a reply is received for every key event.
+class HandledReplyReader
+    : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>,
+                                          HandledReplyReader> {
+ public:
+  bool handled() const { return handled_; }
+
+  bool StartObject() {
+    depth_++;
+    return Default();
+  }
+
+  bool EndObject(rapidjson::SizeType) {
+    depth_--;
+    return true;
+  }
+
+  bool StartArray() {
+    depth_++;
+    return Default();
+  }
+
+  bool EndArray(rapidjson::SizeType) {
+    depth_--;
+    return true;
+  }
+
+  bool Key(const char* key, rapidjson::SizeType length, bool) {
+    reading_handled_ = depth_ == 1 && length == sizeof(kHandledKey) - 1 &&
+                       memcmp(key, kHandledKey, length) == 0;
+    return true;
+  }
+
+  bool Bool(bool value) {
+    if (reading_handled_) {
+      handled_ = value;
+    }
+    return Default();
+  }
+
+  bool Default() {
+    reading_handled_ = false;
+    return true;
+  }
+
+ private:
+  int depth_ = 0;
+  bool reading_handled_ = false;
+  bool handled_ = false;
+};
+
 }  // namespace
 
 KeyboardKeyChannelHandler::KeyboardKeyChannelHandler(
@@ -144,10 +200,12 @@ void KeyboardKeyChannelHandler::KeyboardHook(
   }
   channel_->Send(event, [callback = std::move(callback)](const uint8_t* reply,
                                                          size_t reply_size) {
-    auto decoded = flutter::JsonMessageCodec::GetInstance().DecodeMessage(
-        reply, reply_size);
-    bool handled = decoded ? (*decoded)[kHandledKey].GetBool() : false;
-    callback(handled);
+    HandledReplyReader handler;
+    rapidjson::MemoryStream stream(reinterpret_cast<const char*>(reply),
+                                   reply_size);
+    rapidjson::Reader reader;
+    bool parsed = reply && !reader.Parse(stream, handler).IsError();
+    callback(parsed && handler.handled());
   });
 }
 
@@ -149,6 +149,45 @@ TEST(KeyboardKeyChannelHandlerTest, DeadKeysDoNotCrash) {
   EXPECT_TRUE(received);
 }
 
+// Sends a key event to a handler whose events are replied to with |response|,
+// and returns whether the event was reported as handled.
+static bool SendKeyEventWithResponse(const std::string& response) {
+  TestBinaryMessenger messenger(
+      [&response](const std::string& channel, const uint8_t* message,
+                  size_t message_size, BinaryReply reply) {
+        if (channel == "flutter/keyevent") {
+          reply(reinterpret_cast<const uint8_t*>(response.data()),
+                response.size());
+        }
+        return true;
+      });
+
+  KeyboardKeyChannelHandler handler(&messenger);
+  bool last_handled = true;
+  handler.KeyboardHook(
+      64, kHandledScanCode, WM_KEYDOWN, L'a', false, false,
+      [&last_handled](bool handled) { last_handled = handled; });
+  return last_handled;
+}
+
+TEST(KeyboardKeyChannelHandlerTest, ResponsesWithoutHandledAreUnhandled) {
+  EXPECT_TRUE(SendKeyEventWithResponse("{\"handled\":true}"));
+  EXPECT_TRUE(SendKeyEventWithResponse("{\"other\":[1,{}],\"handled\":true}"));
+  EXPECT_FALSE(SendKeyEventWithResponse("{}"));
+  EXPECT_FALSE(SendKeyEventWithResponse("{\"other\":true}"));
+  EXPECT_FALSE(SendKeyEventWithResponse("{\"handled\":1}"));
+  // Only the top level "handled" key counts.
+  EXPECT_FALSE(SendKeyEventWithResponse("{\"other\":{\"handled\":true}}"));
+  EXPECT_FALSE(SendKeyEventWithResponse("[{\"handled\":true}]"));
+}
+
+TEST(KeyboardKeyChannelHandlerTest, MalformedResponsesAreUnhandled) {
+  EXPECT_FALSE(SendKeyEventWithResponse("{\"handled\":true"));
+  EXPECT_FALSE(SendKeyEventWithResponse("{\"handled\":tru}"));
+  EXPECT_FALSE(SendKeyEventWithResponse("{\"handled\":true}}"));
+  EXPECT_FALSE(SendKeyEventWithResponse("handled"));
+}
+
 TEST(KeyboardKeyChannelHandlerTest, EmptyResponsesDoNotCrash) {
   bool received = false;
   TestBinaryMessenger messenger(
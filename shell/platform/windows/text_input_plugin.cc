@@ -11,6 +11,7 @@
 #include <cstdint>
 
 #include "flutter/shell/platform/common/json_method_codec.h"
+#include "flutter/shell/platform/common/text_input_json.h"
 
 static constexpr char kSetEditingStateMethod[] = "TextInput.setEditingState";
 static constexpr char kClearClientMethod[] = "TextInput.clearClient";
@@ -23,28 +24,16 @@ static constexpr char kSetEditableSizeAndTransform[] =
 
 static constexpr char kMultilineInputType[] = "TextInputType.multiline";
 
-static constexpr char kUpdateEditingStateMethod[] =
-    "TextInputClient.updateEditingState";
-static constexpr char kUpdateEditingStateWithDeltasMethod[] =
-    "TextInputClient.updateEditingStateWithDeltas";
 static constexpr char kPerformActionMethod[] = "TextInputClient.performAction";
 
-static constexpr char kDeltaOldTextKey[] = "oldText";
-static constexpr char kDeltaTextKey[] = "deltaText";
-static constexpr char kDeltaStartKey[] = "deltaStart";
-static constexpr char kDeltaEndKey[] = "deltaEnd";
-static constexpr char kDeltasKey[] = "deltas";
 static constexpr char kEnableDeltaModel[] = "enableDeltaModel";
 static constexpr char kTextInputAction[] = "inputAction";
 static constexpr char kTextInputType[] = "inputType";
 static constexpr char kTextInputTypeName[] = "name";
 static constexpr char kComposingBaseKey[] = "composingBase";
 static constexpr char kComposingExtentKey[] = "composingExtent";
-static constexpr char kSelectionAffinityKey[] = "selectionAffinity";
-static constexpr char kAffinityDownstream[] = "TextAffinity.downstream";
 static constexpr char kSelectionBaseKey[] = "selectionBase";
 static constexpr char kSelectionExtentKey[] = "selectionExtent";
-static constexpr char kSelectionIsDirectionalKey[] = "selectionIsDirectional";
 static constexpr char kTextKey[] = "text";
 static constexpr char kXKey[] = "x";
 static constexpr char kYKey[] = "y";
@@ -102,7 +91,8 @@ void TextInputPlugin::KeyboardHook(int key,
 
 TextInputPlugin::TextInputPlugin(flutter::BinaryMessenger* messenger,
                                  TextInputPluginDelegate* delegate)
-    : channel_(std::make_unique<flutter::MethodChannel<rapidjson::Document>>(
+    : messenger_(messenger),
+      channel_(std::make_unique<flutter::MethodChannel<rapidjson::Document>>(
           messenger,
           kChannelName,
           &flutter::JsonMethodCodec::GetInstance())),
@@ -386,62 +376,18 @@ Rect TextInputPlugin::GetCursorRect() const {
 }
 
 void TextInputPlugin::SendStateUpdate(const TextInputModel& model) {
-  auto args = std::make_unique<rapidjson::Document>(rapidjson::kArrayType);
-  auto& allocator = args->GetAllocator();
-  args->PushBack(client_id_, allocator);
-
-  TextRange selection = model.selection();
-  rapidjson::Value editing_state(rapidjson::kObjectType);
-  editing_state.AddMember(kSelectionAffinityKey, kAffinityDownstream,
-                          allocator);
-  editing_state.AddMember(kSelectionBaseKey, selection.base(), allocator);
-  editing_state.AddMember(kSelectionExtentKey, selection.extent(), allocator);
-  editing_state.AddMember(kSelectionIsDirectionalKey, false, allocator);
-
-  int composing_base = model.composing() ? model.composing_range().base() : -1;
-  int composing_extent =
-      model.composing() ? model.composing_range().extent() : -1;
-  editing_state.AddMember(kComposingBaseKey, composing_base, allocator);
-  editing_state.AddMember(kComposingExtentKey, composing_extent, allocator);
-  editing_state.AddMember(
-      kTextKey, rapidjson::Value(model.GetText(), allocator).Move(), allocator);
-  args->PushBack(editing_state, allocator);
-
-  channel_->InvokeMethod(kUpdateEditingStateMethod, std::move(args));
+  // Update messages are sent on every keystroke, so they are encoded directly
+  // rather than built as a document for |channel_| to encode.
+  std::unique_ptr<std::vector<uint8_t>> message =
+      EncodeUpdateEditingState(client_id_, model);
+  messenger_->Send(kChannelName, message->data(), message->size());
 }
 
 void TextInputPlugin::SendStateUpdateWithDelta(const TextInputModel& model,
                                                const TextEditingDelta* delta) {
-  auto args = std::make_unique<rapidjson::Document>(rapidjson::kArrayType);
-  auto& allocator = args->GetAllocator();
-  args->PushBack(client_id_, allocator);
-
-  rapidjson::Value object(rapidjson::kObjectType);
-  rapidjson::Value deltas(rapidjson::kArrayType);
-  rapidjson::Value deltaJson(rapidjson::kObjectType);
-
-  deltaJson.AddMember(kDeltaOldTextKey, delta->old_text(), allocator);
-  deltaJson.AddMember(kDeltaTextKey, delta->delta_text(), allocator);
-  deltaJson.AddMember(kDeltaStartKey, delta->delta_start(), allocator);
-  deltaJson.AddMember(kDeltaEndKey, delta->delta_end(), allocator);
-
-  TextRange selection = model.selection();
-  deltaJson.AddMember(kSelectionAffinityKey, kAffinityDownstream, allocator);
-  deltaJson.AddMember(kSelectionBaseKey, selection.base(), allocator);
-  deltaJson.AddMember(kSelectionExtentKey, selection.extent(), allocator);
-  deltaJson.AddMember(kSelectionIsDirectionalKey, false, allocator);
-
-  int composing_base = model.composing() ? model.composing_range().base() : -1;
-  int composing_extent =
-      model.composing() ? model.composing_range().extent() : -1;
-  deltaJson.AddMember(kComposingBaseKey, composing_base, allocator);
-  deltaJson.AddMember(kComposingExtentKey, composing_extent, allocator);
-
-  deltas.PushBack(deltaJson, allocator);
-  object.AddMember(kDeltasKey, deltas, allocator);
-  args->PushBack(object, allocator);
-
-  channel_->InvokeMethod(kUpdateEditingStateWithDeltasMethod, std::move(args));
+  std::unique_ptr<std::vector<uint8_t>> message =
+      EncodeUpdateEditingStateWithDelta(client_id_, model, *delta);
+  messenger_->Send(kChannelName, message->data(), message->size());
 }
 
 void TextInputPlugin::EnterPressed(TextInputModel* model) {
@@ -67,6 +67,10 @@ class TextInputPlugin {
   // cursor rect in the PipelineOwner root coordinate system.
   Rect GetCursorRect() const;
 
+  // The messenger used to send editing state updates, which are encoded
+  // without |channel_|.
+  flutter::BinaryMessenger* messenger_;
+
   // The MethodChannel used for communication with the Flutter engine.
   std::unique_ptr<flutter::MethodChannel<rapidjson::Document>> channel_;
 
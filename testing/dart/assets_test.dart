@@ -51,6 +51,29 @@ void main() {
     expect(buffer.length == 354679, true);
   });
 
+  test('can read ranges of an asset', () async {
+    final ImmutableBuffer asset = await ImmutableBuffer.fromAsset('DashInNooglerHat.jpg');
+    final ImmutableBuffer file = await ImmutableBuffer.fromFilePath('flutter/lib/ui/fixtures/DashInNooglerHat.jpg');
+
+    // JPEG files start with a start of image marker.
+    expect(asset.getRange(0, 2), <int>[0xFF, 0xD8]);
+    expect(asset.getRange(asset.length - 2, 2), <int>[0xFF, 0xD9]);
+    expect(asset.getRange(1000, 4096), file.getRange(1000, 4096));
+    expect(asset.getRange(asset.length, 0), isEmpty);
+    expect(() => asset.getRange(asset.length - 1, 2), throwsRangeError);
+    expect(() => asset.getRange(-1, 1), throwsRangeError);
+
+    asset.dispose();
+    file.dispose();
+  });
+
+  test('getRange throws after dispose', () async {
+    final ImmutableBuffer buffer = await ImmutableBuffer.fromAsset('DashInNooglerHat.jpg');
+    buffer.dispose();
+
+    expect(() => buffer.getRange(0, 2), throwsStateError);
+  });
+
   test('can dispose immutable buffer', () async {
     final ImmutableBuffer buffer = await ImmutableBuffer.fromAsset('DashInNooglerHat.jpg');
 
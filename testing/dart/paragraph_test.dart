@@ -198,6 +198,100 @@ void main() {
     expect(line.end, 10);
   });
 
+  test('layoutAsync lays out the paragraph like layout', () async {
+    Paragraph build() {
+      final ParagraphBuilder builder = ParagraphBuilder(ParagraphStyle(
+        fontFamily: 'Ahem',
+        fontSize: 10.0,
+      ));
+      builder.addText('Test Test Test Test');
+      return builder.build();
+    }
+
+    final Paragraph expected = build();
+    expected.layout(const ParagraphConstraints(width: 100.0));
+
+    final Paragraph paragraph = build();
+    final Paragraph laidOut =
+        await paragraph.layoutAsync(const ParagraphConstraints(width: 100.0));
+    expect(identical(laidOut, paragraph), true);
+    expect(paragraph.width, expected.width);
+    expect(paragraph.height, expected.height);
+    expect(paragraph.longestLine, expected.longestLine);
+    expect(paragraph.computeLineMetrics().length,
+        expected.computeLineMetrics().length);
+  });
+
+  test('another paragraph can be laid out during layoutAsync', () async {
+    Paragraph build(String text) {
+      final ParagraphBuilder builder = ParagraphBuilder(ParagraphStyle(
+        fontFamily: 'Ahem',
+        fontSize: 10.0,
+      ));
+      builder.addText(text);
+      return builder.build();
+    }
+
+    final Paragraph long = build('Test ' * 10000);
+    final Future<Paragraph> pending =
+        long.layoutAsync(const ParagraphConstraints(width: 100.0));
+    final Paragraph short = build('Test Test');
+    short.layout(const ParagraphConstraints(width: 100.0));
+    expect(short.width, 100.0);
+    expect(short.computeLineMetrics().length, 1);
+
+    await pending;
+    final Paragraph expected = build('Test ' * 10000);
+    expected.layout(const ParagraphConstraints(width: 100.0));
+    expect(long.height, expected.height);
+    expect(long.computeLineMetrics().length,
+        expected.computeLineMetrics().length);
+  });
+
+  test('layoutAsync is superseded by a later layout', () async {
+    final ParagraphBuilder builder = ParagraphBuilder(ParagraphStyle(
+      fontFamily: 'Ahem',
+      fontSize: 10.0,
+    ));
+    builder.addText('Test Test Test Test');
+    final Paragraph paragraph = builder.build();
+
+    final Future<Paragraph> superseded =
+        paragraph.layoutAsync(const ParagraphConstraints(width: 50.0));
+    paragraph.layout(const ParagraphConstraints(width: 400.0));
+    Object? error;
+    try {
+      await superseded;
+    } catch (e) {
+      error = e;
+    }
+    expect(error is StateError, true);
+    expect((error! as StateError).message.contains('superseded'), true);
+    expect(paragraph.width, 400.0);
+    expect(paragraph.computeLineMetrics().length, 1);
+  });
+
+  test('layoutAsync reports that the paragraph was disposed', () async {
+    final ParagraphBuilder builder = ParagraphBuilder(ParagraphStyle(
+      fontFamily: 'Ahem',
+      fontSize: 10.0,
+    ));
+    builder.addText('Test Test Test Test');
+    final Paragraph paragraph = builder.build();
+
+    final Future<Paragraph> layout =
+        paragraph.layoutAsync(const ParagraphConstraints(width: 50.0));
+    paragraph.dispose();
+    Object? error;
+    try {
+      await layout;
+    } catch (e) {
+      error = e;
+    }
+    expect(error is StateError, true);
+    expect((error! as StateError).message.contains('disposed'), true);
+  });
+
   test('painting a disposed paragraph does not crash', () {
     final Paragraph paragraph = ParagraphBuilder(ParagraphStyle()).build();
     paragraph.dispose();
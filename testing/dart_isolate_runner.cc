@@ -72,7 +72,8 @@ std::unique_ptr<AutoIsolateShutdown> RunDartCodeInIsolateOnUITaskRunner(
     const std::vector<std::string>& args,
     const std::string& kernel_file_path,
     fml::WeakPtr<IOManager> io_manager,
-    const std::shared_ptr<VolatilePathTracker>& volatile_path_tracker) {
+    const std::shared_ptr<VolatilePathTracker>& volatile_path_tracker,
+    std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner) {
   FML_CHECK(task_runners.GetUITaskRunner()->RunsTasksOnCurrentThread());
 
   if (!vm_ref) {
@@ -121,6 +122,7 @@ std::unique_ptr<AutoIsolateShutdown> RunDartCodeInIsolateOnUITaskRunner(
 
   UIDartState::Context context(task_runners);
   context.io_manager = std::move(io_manager);
+  context.concurrent_task_runner = std::move(concurrent_task_runner);
   context.advisory_script_uri = "main.dart";
   context.advisory_script_entrypoint = entrypoint.c_str();
 
@@ -158,14 +160,16 @@ std::unique_ptr<AutoIsolateShutdown> RunDartCodeInIsolate(
     const std::vector<std::string>& args,
     const std::string& kernel_file_path,
     fml::WeakPtr<IOManager> io_manager,
-    std::shared_ptr<VolatilePathTracker> volatile_path_tracker) {
+    std::shared_ptr<VolatilePathTracker> volatile_path_tracker,
+    std::shared_ptr<fml::ConcurrentTaskRunner> concurrent_task_runner) {
   std::unique_ptr<AutoIsolateShutdown> result;
   fml::AutoResetWaitableEvent latch;
   fml::TaskRunner::RunNowOrPostTask(
       task_runners.GetUITaskRunner(), fml::MakeCopyable([&]() mutable {
         result = RunDartCodeInIsolateOnUITaskRunner(
             vm_ref, settings, task_runners, entrypoint, args, kernel_file_path,
-            io_manager, volatile_path_tracker);
+            io_manager, volatile_path_tracker,
+            std::move(concurrent_task_runner));
         latch.Signal();
       }));
   latch.Wait();
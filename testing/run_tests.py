@@ -477,8 +477,18 @@ def RunEngineBenchmarks(build_dir, filter):
 
   RunEngineExecutable(build_dir, 'geometry_benchmarks', filter, icu_flags)
 
+  RunEngineExecutable(build_dir, 'typographer_benchmarks', filter, icu_flags)
+
   if IsLinux():
     RunEngineExecutable(build_dir, 'txt_benchmarks', filter, icu_flags)
+    RunEngineExecutable(
+        build_dir, 'client_wrapper_benchmarks', filter, icu_flags
+    )
+    RunEngineExecutable(build_dir, 'common_cpp_benchmarks', filter, icu_flags)
+
+  # The accessibility bridge benchmarks are only built on macOS.
+  if IsMac():
+    RunEngineExecutable(build_dir, 'common_cpp_benchmarks', filter, icu_flags)
 
 
 def GatherDartTest(
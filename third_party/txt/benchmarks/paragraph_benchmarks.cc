@@ -17,6 +17,8 @@
 #include <minikin/Layout.h>
 
 #include <cstring>
+#include <string>
+#include <vector>
 
 #include "flutter/fml/command_line.h"
 #include "flutter/fml/logging.h"
@@ -27,6 +29,7 @@
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkColor.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
 #include "txt/font_collection.h"
 #include "txt/font_skia.h"
 #include "txt/font_style.h"
@@ -245,6 +248,35 @@ BENCHMARK_REGISTER_F(ParagraphFixture, StylesBigO)
     ->Range(1 << 3, 1 << 12)
     ->Complexity(benchmark::oN);
 
+// Lays out a paragraph at a different width each iteration without changing
+// anything else, like during a window resize. The text is measured once.
+BENCHMARK_F(ParagraphFixture, ResizeLayout)(benchmark::State& state) {
+  const char* text =
+      "This is a very long sentence to test if the text will properly wrap "
+      "around and go to the next line. Sometimes, short sentence. Longer "
+      "sentences are okay too because they are necessary. Very short. "
+      "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+      "tempor incididunt ut labore et dolore magna aliqua.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+  txt::ParagraphBuilderTxt builder(paragraph_style, font_collection_);
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = BuildParagraph(builder);
+
+  size_t frame = 0;
+  while (state.KeepRunning()) {
+    paragraph->Layout(300 + frame++ % 200);
+  }
+}
+
 BENCHMARK_F(ParagraphFixture, PaintSimple)(benchmark::State& state) {
   const char* text = "Hello world! This is a simple sentence to test drawing.";
   auto icu_text = icu::UnicodeString::fromUTF8(text);
@@ -352,6 +384,48 @@ BENCHMARK_F(ParagraphFixture, PaintDecoration)(benchmark::State& state) {
   }
 }
 
+// Paints a paragraph with many style runs, like rich text with links and
+// emphasis. Runs of the same color are drawn together.
+BENCHMARK_DEFINE_F(ParagraphFixture, PaintRichText)(benchmark::State& state) {
+  const char* text = "Hello world! This is a simple sentence to test drawing. ";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+  txt::ParagraphBuilderTxt builder(paragraph_style, font_collection_);
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  for (int i = 0; i < state.range(0); i++) {
+    text_style.font_weight =
+        i % 2 == 0 ? txt::FontWeight::w400 : txt::FontWeight::w700;
+    text_style.font_style =
+        i % 3 == 0 ? txt::FontStyle::italic : txt::FontStyle::normal;
+    text_style.color = i % 4 == 3 ? SK_ColorBLUE : SK_ColorBLACK;
+    text_style.decoration =
+        i % 4 == 3 ? TextDecoration::kUnderline : TextDecoration::kNone;
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text);
+    builder.Pop();
+  }
+  auto paragraph = BuildParagraph(builder);
+  paragraph->Layout(300);
+
+  SkPictureRecorder recorder;
+  paragraph->Paint(recorder.beginRecording(1000, 1000), 0, 0);
+  state.counters["DrawCalls"] =
+      recorder.finishRecordingAsPicture()->approximateOpCount();
+
+  int offset = 0;
+  while (state.KeepRunning()) {
+    paragraph->Paint(canvas_.get(), offset % 700, 10);
+    offset++;
+  }
+}
+BENCHMARK_REGISTER_F(ParagraphFixture, PaintRichText)
+    ->RangeMultiplier(4)
+    ->Range(1 << 2, 1 << 8);
+
 // -----------------------------------------------------------------------------
 //
 // The following benchmarks break down the layout function and attempts to time
@@ -443,4 +517,185 @@ BENCHMARK_REGISTER_F(ParagraphFixture, SkTextBlobAlloc)
     ->Range(1 << 7, 1 << 14)
     ->Complexity(benchmark::oN);
 
+// -----------------------------------------------------------------------------
+//
+// The following benchmarks lay out text on several threads at once, like
+// multiple engines do. Each thread uses its own font collection as each engine
+// has its own. Layout should scale with the number of threads instead of
+// serializing on shared caches.
+//
+// -----------------------------------------------------------------------------
+
+static void ParagraphLayoutMultiThreaded(benchmark::State& state) {
+  const char* text =
+      "This is a very long sentence to test if the text will properly wrap "
+      "around and go to the next line. Sometimes, short sentence. Longer "
+      "sentences are okay too because they are necessary. Very short. "
+      "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+      "tempor incididunt ut labore et dolore magna aliqua. Ut enim ad minim "
+      "veniam, quis nostrud exercitation ullamco laboris nisi ut aliquip ex ea "
+      "commodo consequat. Duis aute irure dolor in reprehenderit in voluptate "
+      "velit esse cillum dolore eu fugiat nulla pariatur.";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  auto font_collection = GetTestFontCollection();
+  txt::ParagraphBuilderTxt builder(paragraph_style, font_collection);
+
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = BuildParagraph(builder);
+  while (state.KeepRunning()) {
+    paragraph->SetDirty();
+    paragraph->Layout(300);
+  }
+}
+BENCHMARK(ParagraphLayoutMultiThreaded)->ThreadRange(1, 8)->UseRealTime();
+
+static void MinikinDoLayoutUncachedMultiThreaded(benchmark::State& state) {
+  std::vector<uint16_t> text;
+  for (uint16_t i = 0; i < 1024; ++i) {
+    text.push_back(i % 5 == 0 ? ' ' : 'a' + i % 26);
+  }
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  minikin::FontStyle font(4, false);
+  minikin::MinikinPaint paint;
+  paint.size = text_style.font_size;
+  // Font features bypass the layout cache, so every iteration shapes the text.
+  paint.fontFeatureSettings = "kern";
+
+  auto font_collection = GetTestFontCollection();
+  auto collection = font_collection->GetMinikinFontCollectionForFamilies(
+      text_style.font_families, "en-US");
+
+  while (state.KeepRunning()) {
+    minikin::Layout layout;
+    layout.doLayout(text.data(), 0, text.size(), text.size(), 0, font, paint,
+                    collection);
+  }
+}
+BENCHMARK(MinikinDoLayoutUncachedMultiThreaded)
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+// -----------------------------------------------------------------------------
+//
+// The following benchmarks measure the layout cache with the budget given in
+// kilobytes as the argument. Each reports the hit rate of the cache and the
+// bytes it used.
+//
+// -----------------------------------------------------------------------------
+
+static void SetLayoutCacheCounters(
+    benchmark::State& state,
+    const minikin::Layout::CacheStatistics& before) {
+  auto after = minikin::Layout::getCacheStatistics();
+  size_t hits = after.hits - before.hits;
+  size_t misses = after.misses - before.misses;
+  state.counters["HitRate"] =
+      hits + misses == 0 ? 0.0 : static_cast<double>(hits) / (hits + misses);
+  state.counters["CacheBytes"] = after.bytes;
+}
+
+// Scrolls through a chat history. Each frame lays out the visible messages
+// after the view moved by one message. Messages mix common words with names,
+// times and numbers that rarely repeat.
+BENCHMARK_DEFINE_F(ParagraphFixture, ChatScroll)(benchmark::State& state) {
+  const char* words[] = {"ok",      "sure",  "see",     "you",  "at",
+                         "the",     "party", "lol",     "thanks", "for",
+                         "sending", "that",  "when",    "are",  "we",
+                         "meeting", "tomorrow"};
+  const size_t kWordCount = sizeof(words) / sizeof(words[0]);
+  const size_t kMessageCount = 2000;
+  const size_t kVisibleMessages = 20;
+  std::vector<std::u16string> messages;
+  for (size_t i = 0; i < kMessageCount; i++) {
+    std::string message = "user" + std::to_string(i % 97) + " " +
+                           std::to_string(i % 24) + ":" +
+                           std::to_string(i % 60) + " ";
+    for (size_t j = 0; j < 4 + i % 9; j++) {
+      message += words[(i * 7 + j * 3) % kWordCount];
+      message += j % 5 == 4 ? " #" + std::to_string(i * 31 + j) + " " : " ";
+    }
+    auto icu_text = icu::UnicodeString::fromUTF8(message);
+    messages.emplace_back(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+  }
+
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+
+  minikin::Layout::purgeCaches();
+  minikin::Layout::setCacheBudget(state.range(0) * 1024);
+  auto before = minikin::Layout::getCacheStatistics();
+  size_t first = 0;
+  while (state.KeepRunning()) {
+    for (size_t i = 0; i < kVisibleMessages; i++) {
+      txt::ParagraphBuilderTxt builder(paragraph_style, font_collection_);
+      builder.PushStyle(text_style);
+      builder.AddText(messages[(first + i) % kMessageCount]);
+      builder.Pop();
+      auto paragraph = BuildParagraph(builder);
+      paragraph->Layout(300);
+    }
+    first++;
+  }
+  SetLayoutCacheCounters(state, before);
+  minikin::Layout::setCacheBudget(minikin::Layout::kDefaultCacheBudget);
+}
+BENCHMARK_REGISTER_F(ParagraphFixture, ChatScroll)
+    ->RangeMultiplier(4)
+    ->Range(1 << 4, 1 << 12);
+
+// Lays out a long document at a different width each frame, like a window
+// being resized.
+BENCHMARK_DEFINE_F(ParagraphFixture, DocumentReflow)(benchmark::State& state) {
+  std::string text;
+  for (size_t i = 0; i < 200; i++) {
+    text +=
+        "Section " + std::to_string(i) +
+        ". Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do "
+        "eiusmod tempor incididunt ut labore et dolore magna aliqua. Duis aute "
+        "irure dolor in reprehenderit in voluptate velit esse cillum dolore. ";
+  }
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+  txt::ParagraphBuilderTxt builder(paragraph_style, font_collection_);
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = BuildParagraph(builder);
+
+  minikin::Layout::purgeCaches();
+  minikin::Layout::setCacheBudget(state.range(0) * 1024);
+  auto before = minikin::Layout::getCacheStatistics();
+  size_t frame = 0;
+  while (state.KeepRunning()) {
+    paragraph->SetDirty();
+    paragraph->Layout(200 + (frame++ * 37) % 400);
+  }
+  SetLayoutCacheCounters(state, before);
+  minikin::Layout::setCacheBudget(minikin::Layout::kDefaultCacheBudget);
+}
+BENCHMARK_REGISTER_F(ParagraphFixture, DocumentReflow)
+    ->RangeMultiplier(4)
+    ->Range(1 << 4, 1 << 12);
+
 }  // namespace txt
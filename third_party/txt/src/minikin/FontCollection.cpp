@@ -43,7 +43,7 @@ static inline T max(T a, T b) {
 const uint32_t EMOJI_STYLE_VS = 0xFE0F;
 const uint32_t TEXT_STYLE_VS = 0xFE0E;
 
-uint32_t FontCollection::sNextId = 0;
+std::atomic<uint32_t> FontCollection::sNextId = 0;
 
 // libtxt: return a locale string for a language list ID
 std::string GetFontLocale(uint32_t langListId) {
@@ -65,7 +65,6 @@ FontCollection::FontCollection() : mMaxChar(0) {}
 
 bool FontCollection::init(
     const std::vector<std::shared_ptr<FontFamily>>& typefaces) {
-  std::scoped_lock _l(gMinikinLock);
   mId = sNextId++;
   vector<uint32_t> lastChar;
   size_t nTypefaces = typefaces.size();
@@ -375,6 +374,7 @@ const std::shared_ptr<FontFamily>& FontCollection::findFallbackFont(
     uint32_t langListId) const {
   std::string locale = GetFontLocale(langListId);
 
+  std::scoped_lock lock(mFallbackMutex);
   const auto it = mCachedFallbackFamilies.find(locale);
   if (it != mCachedFallbackFamilies.end()) {
     for (const auto& fallbackFamily : it->second) {
@@ -434,8 +434,6 @@ bool FontCollection::hasVariationSelector(uint32_t baseCodepoint,
     return false;
   }
 
-  std::scoped_lock _l(gMinikinLock);
-
   // Currently mRanges can not be used here since it isn't aware of the
   // variation sequence.
   for (size_t i = 0; i < mVSFamilyVec.size(); i++) {
@@ -17,8 +17,11 @@
 #ifndef MINIKIN_FONT_COLLECTION_H
 #define MINIKIN_FONT_COLLECTION_H
 
+#include <atomic>
+#include <deque>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <unordered_set>
 #include <vector>
 
@@ -124,7 +127,7 @@ class FontCollection {
                                            const FontFamily& fontFamily);
 
   // static for allocating unique id's
-  static uint32_t sNextId;
+  static std::atomic<uint32_t> sNextId;
 
   // unique id for this font collection (suitable for cache key)
   uint32_t mId;
@@ -156,8 +159,10 @@ class FontCollection {
   std::unique_ptr<FallbackFontProvider> mFallbackFontProvider;
 
   // libtxt extension: Fallback fonts discovered after this font collection
-  // was constructed.
-  mutable std::map<std::string, std::vector<std::shared_ptr<FontFamily>>>
+  // was constructed. The families are kept in deques so that references
+  // returned by |findFallbackFont| stay valid while other threads add to them.
+  mutable std::mutex mFallbackMutex;
+  mutable std::map<std::string, std::deque<std::shared_ptr<FontFamily>>>
       mCachedFallbackFamilies;
 };
 
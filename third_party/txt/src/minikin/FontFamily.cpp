@@ -20,6 +20,9 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <mutex>
+#include <unordered_map>
+
 #include <log/log.h>
 #include <utils/JenkinsHash.h>
 
@@ -56,7 +59,6 @@ android::hash_t FontStyle::hash() const {
 
 // static
 uint32_t FontStyle::registerLanguageList(const std::string& languages) {
-  std::scoped_lock _l(gMinikinLock);
   return FontLanguageListCache::getId(languages);
 }
 
@@ -72,7 +74,7 @@ Font::Font(const std::shared_ptr<MinikinFont>& typeface, FontStyle style)
 Font::Font(std::shared_ptr<MinikinFont>&& typeface, FontStyle style)
     : typeface(typeface), style(style) {}
 
-std::unordered_set<AxisTag> Font::getSupportedAxesLocked() const {
+std::unordered_set<AxisTag> Font::getSupportedAxes() const {
   const uint32_t fvarTag = MinikinFont::MakeTag('f', 'v', 'a', 'r');
   HbBlob fvarTable(getFontTable(typeface.get(), fvarTag));
   if (fvarTable.size() == 0) {
@@ -108,14 +110,14 @@ FontFamily::FontFamily(uint32_t langId, int variant, std::vector<Font>&& fonts)
     : mLangId(langId),
       mVariant(variant),
       mFonts(std::move(fonts)),
-      mHasVSTable(false) {
+      mHasVSTable(false),
+      mIsColorEmojiFamily(computeIsColorEmojiFamily()) {
   computeCoverage();
 }
 
 bool FontFamily::analyzeStyle(const std::shared_ptr<MinikinFont>& typeface,
                               int* weight,
                               bool* italic) {
-  std::scoped_lock _l(gMinikinLock);
   const uint32_t os2Tag = MinikinFont::MakeTag('O', 'S', '/', '2');
   HbBlob os2Table(getFontTable(typeface.get(), os2Tag));
   if (os2Table.get() == nullptr)
@@ -164,7 +166,7 @@ FakedFont FontFamily::getClosestMatch(FontStyle style) const {
   return FakedFont{nullptr, FontFakery()};
 }
 
-bool FontFamily::isColorEmojiFamily() const {
+bool FontFamily::computeIsColorEmojiFamily() const {
   const FontLanguages& languageList = FontLanguageListCache::getById(mLangId);
   for (size_t i = 0; i < languageList.size(); ++i) {
     if (languageList[i].getEmojiStyle() == FontLanguage::EMSTYLE_EMOJI) {
@@ -174,30 +176,71 @@ bool FontFamily::isColorEmojiFamily() const {
   return false;
 }
 
+namespace {
+
+// The coverage computed from the cmap table of a font, shared by the families
+// of the font while any of them is alive.
+struct SharedCoverage {
+  std::weak_ptr<const SparseBitSet> coverage;
+  bool hasVSTable;
+};
+
+std::mutex gSharedCoverageLock;
+
+// Keyed by the unique id of the font. Unique ids are not reused, so an entry
+// can not be found for another font.
+std::unordered_map<int32_t, SharedCoverage>& sharedCoverages() {
+  static auto* coverages = new std::unordered_map<int32_t, SharedCoverage>();
+  return *coverages;
+}
+
+}  // namespace
+
 void FontFamily::computeCoverage() {
-  std::scoped_lock _l(gMinikinLock);
   const FontStyle defaultStyle;
   const MinikinFont* typeface = getClosestMatch(defaultStyle).font;
-  const uint32_t cmapTag = MinikinFont::MakeTag('c', 'm', 'a', 'p');
-  HbBlob cmapTable(getFontTable(typeface, cmapTag));
-  if (cmapTable.get() == nullptr) {
-    // Missing or corrupt font cmap table; bail out.
-    // The cmap table maps charcodes to glyph indices in a font.
-    return;
+  if (typeface != nullptr) {
+    std::scoped_lock lock(gSharedCoverageLock);
+    auto it = sharedCoverages().find(typeface->GetUniqueId());
+    if (it != sharedCoverages().end()) {
+      mCoverage = it->second.coverage.lock();
+      mHasVSTable = it->second.hasVSTable;
+    }
+  }
+
+  if (mCoverage == nullptr) {
+    const uint32_t cmapTag = MinikinFont::MakeTag('c', 'm', 'a', 'p');
+    HbBlob cmapTable(getFontTable(typeface, cmapTag));
+    if (cmapTable.get() == nullptr) {
+      // Missing or corrupt font cmap table; bail out.
+      // The cmap table maps charcodes to glyph indices in a font.
+      mCoverage = std::make_shared<const SparseBitSet>();
+      return;
+    }
+    mCoverage = std::make_shared<const SparseBitSet>(CmapCoverage::getCoverage(
+        cmapTable.get(), cmapTable.size(), &mHasVSTable));
+
+    std::scoped_lock lock(gSharedCoverageLock);
+    // Drop the entries of the fonts that no family uses anymore.
+    for (auto it = sharedCoverages().begin(); it != sharedCoverages().end();) {
+      if (it->second.coverage.expired()) {
+        it = sharedCoverages().erase(it);
+      } else {
+        ++it;
+      }
+    }
+    sharedCoverages()[typeface->GetUniqueId()] = {mCoverage, mHasVSTable};
   }
-  mCoverage = CmapCoverage::getCoverage(cmapTable.get(), cmapTable.size(),
-                                        &mHasVSTable);
 
   for (size_t i = 0; i < mFonts.size(); ++i) {
     std::unordered_set<AxisTag> supportedAxes =
-        mFonts[i].getSupportedAxesLocked();
+        mFonts[i].getSupportedAxes();
     mSupportedAxes.insert(supportedAxes.begin(), supportedAxes.end());
   }
 }
 
 bool FontFamily::hasGlyph(uint32_t codepoint,
                           uint32_t variationSelector) const {
-  assertMinikinLocked();
   if (variationSelector != 0 && !mHasVSTable) {
     // Early exit if the variation selector is specified but the font doesn't
     // have a cmap format 14 subtable.
@@ -205,7 +248,7 @@ bool FontFamily::hasGlyph(uint32_t codepoint,
   }
 
   const FontStyle defaultStyle;
-  hb_font_t* font = getHbFontLocked(getClosestMatch(defaultStyle).font);
+  hb_font_t* font = getHbFont(getClosestMatch(defaultStyle).font);
   uint32_t unusedGlyph;
   bool result =
       hb_font_get_glyph(font, codepoint, variationSelector, &unusedGlyph);
@@ -234,8 +277,7 @@ std::shared_ptr<FontFamily> FontFamily::createFamilyWithVariation(
   std::vector<Font> fonts;
   for (const Font& font : mFonts) {
     bool supportedVariations = false;
-    std::scoped_lock _l(gMinikinLock);
-    std::unordered_set<AxisTag> supportedAxes = font.getSupportedAxesLocked();
+    std::unordered_set<AxisTag> supportedAxes = font.getSupportedAxes();
     if (!supportedAxes.empty()) {
       for (const FontVariation& variation : variations) {
         if (supportedAxes.find(variation.axisTag) != supportedAxes.end()) {
@@ -120,7 +120,7 @@ struct Font {
   std::shared_ptr<MinikinFont> typeface;
   FontStyle style;
 
-  std::unordered_set<AxisTag> getSupportedAxesLocked() const;
+  std::unordered_set<AxisTag> getSupportedAxes() const;
 };
 
 struct FontVariation {
@@ -152,16 +152,16 @@ class FontFamily {
     return mFonts[index].typeface;
   }
   FontStyle getStyle(size_t index) const { return mFonts[index].style; }
-  bool isColorEmojiFamily() const;
+  bool isColorEmojiFamily() const { return mIsColorEmojiFamily; }
   const std::unordered_set<AxisTag>& supportedAxes() const {
     return mSupportedAxes;
   }
 
   // Get Unicode coverage.
-  const SparseBitSet& getCoverage() const { return mCoverage; }
+  const SparseBitSet& getCoverage() const { return *mCoverage; }
 
   // Returns true if the font has a glyph for the code point and variation
-  // selector pair. Caller should acquire a lock before calling the method.
+  // selector pair.
   bool hasGlyph(uint32_t codepoint, uint32_t variationSelector) const;
 
   // Returns true if this font family has a variaion sequence table (cmap format
@@ -175,14 +175,21 @@ class FontFamily {
 
  private:
   void computeCoverage();
+  bool computeIsColorEmojiFamily() const;
 
   uint32_t mLangId;
   int mVariant;
   std::vector<Font> mFonts;
   std::unordered_set<AxisTag> mSupportedAxes;
 
-  SparseBitSet mCoverage;
+  // The coverage and language of a family do not change after it is
+  // constructed, so they can be read from any thread without locking.
+  // Families whose default font is the same font, such as the families that
+  // the font collections of several engines create for a typeface, share the
+  // coverage.
+  std::shared_ptr<const SparseBitSet> mCoverage;
   bool mHasVSTable;
+  bool mIsColorEmojiFamily;
 
   // Forbid copying and assignment.
   FontFamily(const FontFamily&) = delete;
@@ -17,6 +17,8 @@
 #ifndef MINIKIN_FONT_LANGUAGE_LIST_CACHE_H
 #define MINIKIN_FONT_LANGUAGE_LIST_CACHE_H
 
+#include <deque>
+#include <shared_mutex>
 #include <unordered_map>
 
 #include <minikin/FontFamily.h>
@@ -32,20 +34,25 @@ class FontLanguageListCache {
   const static uint32_t kEmptyListId = 0;
 
   // Returns language list ID for the given string representation of
-  // FontLanguages. Caller should acquire a lock before calling the method.
+  // FontLanguages.
   static uint32_t getId(const std::string& languages);
 
-  // Caller should acquire a lock before calling the method.
+  // The returned language list is never removed from the cache.
   static const FontLanguages& getById(uint32_t id);
 
  private:
   FontLanguageListCache() {}  // Singleton
   ~FontLanguageListCache() {}
 
-  // Caller should acquire a lock before calling the method.
   static FontLanguageListCache* getInstance();
 
-  std::vector<FontLanguages> mLanguageLists;
+  // Lists are looked up far more often than they are added, so lookups only
+  // take the lock in shared mode.
+  std::shared_mutex mMutex;
+
+  // A deque so that references returned by |getById| stay valid when lists
+  // are added.
+  std::deque<FontLanguages> mLanguageLists;
 
   // A map from string representation of the font language list to the ID.
   std::unordered_map<std::string, uint32_t> mLanguageListLookupTable;
@@ -22,9 +22,13 @@ struct hb_font_t;
 namespace minikin {
 class MinikinFont;
 
-void purgeHbFontCacheLocked();
-void purgeHbFontLocked(const MinikinFont* minikinFont);
-hb_font_t* getHbFontLocked(const MinikinFont* minikinFont);
+// The cache is shared by all threads and may be used without external locking.
+// The returned fonts are immutable so that they can be shaped with from
+// multiple threads at once. Callers that need to set font funcs must do so on
+// a sub font.
+void purgeHbFontCache();
+void purgeHbFont(const MinikinFont* minikinFont);
+hb_font_t* getHbFont(const MinikinFont* minikinFont);
 
 }  // namespace minikin
 #endif  // MINIKIN_HBFONT_CACHE_H
@@ -20,9 +20,14 @@
 #include <unicode/ubidi.h>
 #include <unicode/utf16.h>
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <fstream>
 #include <iostream>  // for debugging
+#include <memory>
+#include <mutex>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 #include <log/log.h>
@@ -48,11 +53,12 @@ const int kDirection_Mask = 0x1;
 struct LayoutContext {
   MinikinPaint paint;
   FontStyle style;
+  // Sub fonts of the cached fonts, owned by this context. The funcs and
+  // scale of the fonts are set for this layout, so they must not be shared.
   std::vector<hb_font_t*> hbFonts;  // parallel to mFaces
 
   void clearHbFonts() {
     for (size_t i = 0; i < hbFonts.size(); i++) {
-      hb_font_set_funcs(hbFonts[i], nullptr, nullptr, nullptr);
       hb_font_destroy(hbFonts[i]);
     }
     hbFonts.clear();
@@ -89,6 +95,8 @@ class LayoutCacheKey {
 
   android::hash_t hash() const { return mHash; }
 
+  size_t getTextSize() const { return mNchars * sizeof(uint16_t); }
+
   void copyText() {
     uint16_t* charsCopy = new uint16_t[mNchars];
     memcpy(charsCopy, mChars, mNchars * sizeof(uint16_t));
@@ -129,53 +137,204 @@ class LayoutCacheKey {
   android::hash_t computeHash() const;
 };
 
-class LayoutCache : private android::OnEntryRemoved<LayoutCacheKey, Layout*> {
+// A layout stored in the layout cache. The faces, glyphs and advances are
+// stored back to back in a single allocation of exactly their size instead of
+// in vectors with spare capacity. Pieces are immutable, so they can be shared
+// between threads.
+class LayoutPiece {
  public:
-  LayoutCache() : mCache(kMaxEntries) {
-    mCache.setOnEntryRemovedListener(this);
+  explicit LayoutPiece(const Layout& layout)
+      : mFaceCount(layout.mFaces.size()),
+        mGlyphCount(layout.mGlyphs.size()),
+        mAdvanceCount(layout.mAdvances.size()),
+        mAdvance(layout.mAdvance),
+        mBounds(layout.mBounds),
+        mStorage(new uint8_t[getStorageSize()]) {
+    static_assert(std::is_trivially_copyable_v<FakedFont>);
+    static_assert(std::is_trivially_copyable_v<LayoutGlyph>);
+    static_assert(alignof(FakedFont) >= alignof(LayoutGlyph));
+    static_assert(alignof(LayoutGlyph) >= alignof(float));
+    memcpy(mStorage.get(), layout.mFaces.data(),
+           mFaceCount * sizeof(FakedFont));
+    memcpy(mStorage.get() + getGlyphsOffset(), layout.mGlyphs.data(),
+           mGlyphCount * sizeof(LayoutGlyph));
+    memcpy(mStorage.get() + getAdvancesOffset(), layout.mAdvances.data(),
+           mAdvanceCount * sizeof(float));
+  }
+
+  size_t faceCount() const { return mFaceCount; }
+  const FakedFont* faces() const {
+    return reinterpret_cast<const FakedFont*>(mStorage.get());
+  }
+
+  size_t glyphCount() const { return mGlyphCount; }
+  const LayoutGlyph* glyphs() const {
+    return reinterpret_cast<const LayoutGlyph*>(mStorage.get() +
+                                                getGlyphsOffset());
+  }
+
+  size_t advanceCount() const { return mAdvanceCount; }
+  const float* advances() const {
+    return reinterpret_cast<const float*>(mStorage.get() +
+                                          getAdvancesOffset());
+  }
+
+  void getAdvances(float* advances) const {
+    memcpy(advances, this->advances(), mAdvanceCount * sizeof(float));
+  }
+
+  float getAdvance() const { return mAdvance; }
+
+  const MinikinRect& getBounds() const { return mBounds; }
+
+  // The number of bytes used by the piece.
+  size_t getFootprint() const { return sizeof(LayoutPiece) + getStorageSize(); }
+
+ private:
+  const size_t mFaceCount;
+  const size_t mGlyphCount;
+  const size_t mAdvanceCount;
+  const float mAdvance;
+  const MinikinRect mBounds;
+  const std::unique_ptr<uint8_t[]> mStorage;
+
+  size_t getGlyphsOffset() const { return mFaceCount * sizeof(FakedFont); }
+
+  size_t getAdvancesOffset() const {
+    return getGlyphsOffset() + mGlyphCount * sizeof(LayoutGlyph);
+  }
+
+  size_t getStorageSize() const {
+    return getAdvancesOffset() + mAdvanceCount * sizeof(float);
   }
 
-  void clear() { mCache.clear(); }
-
-  Layout* get(LayoutCacheKey& key,
-              LayoutContext* ctx,
-              const std::shared_ptr<FontCollection>& collection) {
-    Layout* layout = mCache.get(key);
-    if (layout == NULL) {
-      key.copyText();
-      layout = new Layout();
-      key.doLayout(layout, ctx, collection);
-      mCache.put(key, layout);
+  // Forbid copying and assignment.
+  LayoutPiece(const LayoutPiece&) = delete;
+  void operator=(const LayoutPiece&) = delete;
+};
+
+// The cache is shared by all threads. It is split into shards with separate
+// locks, and layouts are shaped without holding any lock, so that threads
+// laying out text at the same time rarely wait on each other.
+//
+// The cache is bounded by the number of bytes used by its entries rather than
+// by their number, as the size of the layout of a word varies with its length.
+// Each shard may use an equal part of the budget.
+class LayoutCache {
+ public:
+  LayoutCache() : mBudget(Layout::kDefaultCacheBudget) {}
+
+  void clear() {
+    for (Shard& shard : mShards) {
+      std::scoped_lock lock(shard.mutex);
+      shard.cache.clear();
+    }
+  }
+
+  std::shared_ptr<const LayoutPiece> get(
+      LayoutCacheKey& key,
+      LayoutContext* ctx,
+      const std::shared_ptr<FontCollection>& collection) {
+    Shard& shard = mShards[key.hash() % kShardCount];
+    {
+      std::scoped_lock lock(shard.mutex);
+      std::shared_ptr<const LayoutPiece> piece = shard.cache.get(key);
+      if (piece != nullptr) {
+        shard.hits++;
+        return piece;
+      }
+      shard.misses++;
+    }
+    Layout layout;
+    key.doLayout(&layout, ctx, collection);
+    auto piece = std::make_shared<const LayoutPiece>(layout);
+    key.copyText();
+    std::scoped_lock lock(shard.mutex);
+    if (shard.cache.put(key, piece)) {
+      shard.bytes += getEntrySize(key, *piece);
+      shard.evictToBudget(mBudget / kShardCount);
+    } else {
+      // Another thread cached the same layout first.
+      key.freeText();
     }
-    return layout;
+    return piece;
+  }
+
+  void setBudget(size_t bytes) {
+    mBudget = bytes;
+    for (Shard& shard : mShards) {
+      std::scoped_lock lock(shard.mutex);
+      shard.evictToBudget(bytes / kShardCount);
+    }
+  }
+
+  Layout::CacheStatistics getStatistics() {
+    Layout::CacheStatistics statistics;
+    for (Shard& shard : mShards) {
+      std::scoped_lock lock(shard.mutex);
+      statistics.hits += shard.hits;
+      statistics.misses += shard.misses;
+      statistics.entries += shard.cache.size();
+      statistics.bytes += shard.bytes;
+    }
+    statistics.budget = mBudget;
+    return statistics;
   }
 
  private:
-  // callback for OnEntryRemoved
-  void operator()(LayoutCacheKey& key, Layout*& value) {
-    key.freeText();
-    delete value;
+  using Entries = android::LruCache<LayoutCacheKey,
+                                    std::shared_ptr<const LayoutPiece>>;
+
+  static const size_t kShardCount = 16;
+
+  // Estimates the bytes used by the key and the bookkeeping of the LRU cache
+  // for an entry, in addition to the piece and the copied text.
+  static const size_t kEntryOverhead =
+      sizeof(LayoutCacheKey) + sizeof(std::shared_ptr<const LayoutPiece>) +
+      4 * sizeof(void*);
+
+  static size_t getEntrySize(const LayoutCacheKey& key,
+                             const LayoutPiece& piece) {
+    return kEntryOverhead + key.getTextSize() + piece.getFootprint();
   }
 
-  android::LruCache<LayoutCacheKey, Layout*> mCache;
+  struct Shard : private android::OnEntryRemoved<
+                     LayoutCacheKey,
+                     std::shared_ptr<const LayoutPiece>> {
+    Shard() : cache(Entries::kUnlimitedCapacity) {
+      cache.setOnEntryRemovedListener(this);
+    }
 
-  // static const size_t kMaxEntries = LruCache<LayoutCacheKey,
-  // Layout*>::kUnlimitedCapacity;
+    // callback for OnEntryRemoved
+    void operator()(LayoutCacheKey& key,
+                    std::shared_ptr<const LayoutPiece>& piece) override {
+      bytes -= getEntrySize(key, *piece);
+      key.freeText();
+    }
 
-  // TODO: eviction based on memory footprint; for now, we just use a constant
-  // number of strings
-  static const size_t kMaxEntries = 5000;
+    void evictToBudget(size_t budget) {
+      while (bytes > budget && cache.removeOldest()) {
+      }
+    }
+
+    std::mutex mutex;
+    size_t bytes = 0;
+    size_t hits = 0;
+    size_t misses = 0;
+    Entries cache;
+  };
+
+  std::atomic<size_t> mBudget;
+  std::array<Shard, kShardCount> mShards;
 };
 
 class LayoutEngine {
  public:
   LayoutEngine() {
     unicodeFunctions = hb_unicode_funcs_create(hb_icu_get_unicode_funcs());
-    hbBuffer = hb_buffer_create();
-    hb_buffer_set_unicode_funcs(hbBuffer, unicodeFunctions);
+    hb_unicode_funcs_make_immutable(unicodeFunctions);
   }
 
-  hb_buffer_t* hbBuffer;
   hb_unicode_funcs_t* unicodeFunctions;
   LayoutCache layoutCache;
 
@@ -183,6 +342,20 @@ class LayoutEngine {
     static LayoutEngine* instance = new LayoutEngine();
     return *instance;
   }
+
+  // Shaping fills in the buffer, so every thread shapes into its own.
+  static hb_buffer_t* getHbBuffer() {
+    thread_local std::unique_ptr<hb_buffer_t, decltype(&hb_buffer_destroy)>
+        buffer(createHbBuffer(), &hb_buffer_destroy);
+    return buffer.get();
+  }
+
+ private:
+  static hb_buffer_t* createHbBuffer() {
+    hb_buffer_t* buffer = hb_buffer_create();
+    hb_buffer_set_unicode_funcs(buffer, getInstance().unicodeFunctions);
+    return buffer;
+  }
 };
 
 bool LayoutCacheKey::operator==(const LayoutCacheKey& other) const {
@@ -254,34 +427,31 @@ static hb_bool_t harfbuzzGetGlyphHorizontalOrigin(hb_font_t* /* hbFont */,
   return true;
 }
 
-hb_font_funcs_t* getHbFontFuncs(bool forColorBitmapFont) {
-  assertMinikinLocked();
-
-  static hb_font_funcs_t* hbFuncs = nullptr;
-  static hb_font_funcs_t* hbFuncsForColorBitmap = nullptr;
-
-  hb_font_funcs_t** funcs =
-      forColorBitmapFont ? &hbFuncs : &hbFuncsForColorBitmap;
-  if (*funcs == nullptr) {
-    *funcs = hb_font_funcs_create();
-    if (forColorBitmapFont) {
-      // Don't override the h_advance function since we use HarfBuzz's
-      // implementation for emoji for performance reasons. Note that it is
-      // technically possible for a TrueType font to have outline and embedded
-      // bitmap at the same time. We ignore modified advances of hinted outline
-      // glyphs in that case.
-    } else {
-      // Override the h_advance function since we can't use HarfBuzz's
-      // implemenation. It may return the wrong value if the font uses hinting
-      // aggressively.
-      hb_font_funcs_set_glyph_h_advance_func(
-          *funcs, harfbuzzGetGlyphHorizontalAdvance, 0, 0);
-    }
-    hb_font_funcs_set_glyph_h_origin_func(
-        *funcs, harfbuzzGetGlyphHorizontalOrigin, 0, 0);
-    hb_font_funcs_make_immutable(*funcs);
+static hb_font_funcs_t* createHbFontFuncs(bool forColorBitmapFont) {
+  hb_font_funcs_t* funcs = hb_font_funcs_create();
+  if (forColorBitmapFont) {
+    // Don't override the h_advance function since we use HarfBuzz's
+    // implementation for emoji for performance reasons. Note that it is
+    // technically possible for a TrueType font to have outline and embedded
+    // bitmap at the same time. We ignore modified advances of hinted outline
+    // glyphs in that case.
+  } else {
+    // Override the h_advance function since we can't use HarfBuzz's
+    // implemenation. It may return the wrong value if the font uses hinting
+    // aggressively.
+    hb_font_funcs_set_glyph_h_advance_func(
+        funcs, harfbuzzGetGlyphHorizontalAdvance, 0, 0);
   }
-  return *funcs;
+  hb_font_funcs_set_glyph_h_origin_func(
+      funcs, harfbuzzGetGlyphHorizontalOrigin, 0, 0);
+  hb_font_funcs_make_immutable(funcs);
+  return funcs;
+}
+
+hb_font_funcs_t* getHbFontFuncs(bool forColorBitmapFont) {
+  static hb_font_funcs_t* hbFuncs = createHbFontFuncs(false);
+  static hb_font_funcs_t* hbFuncsForColorBitmap = createHbFontFuncs(true);
+  return forColorBitmapFont ? hbFuncsForColorBitmap : hbFuncs;
 }
 
 static bool isColorBitmapFont(hb_font_t* font) {
@@ -316,7 +486,9 @@ int Layout::findFace(const FakedFont& face, LayoutContext* ctx) {
   // Note: ctx == NULL means we're copying from the cache, no need to create
   // corresponding hb_font object.
   if (ctx != NULL) {
-    hb_font_t* font = getHbFontLocked(face.font);
+    hb_font_t* parent = getHbFont(face.font);
+    hb_font_t* font = hb_font_create_sub_font(parent);
+    hb_font_destroy(parent);
     hb_font_set_funcs(font, getHbFontFuncs(isColorBitmapFont(font)),
                       &ctx->paint, 0);
     ctx->hbFonts.push_back(font);
@@ -325,10 +497,7 @@ int Layout::findFace(const FakedFont& face, LayoutContext* ctx) {
 }
 
 static hb_script_t codePointToScript(hb_codepoint_t codepoint) {
-  static hb_unicode_funcs_t* u = 0;
-  if (!u) {
-    u = LayoutEngine::getInstance().unicodeFunctions;
-  }
+  static hb_unicode_funcs_t* u = LayoutEngine::getInstance().unicodeFunctions;
   return hb_unicode_script(u, codepoint);
 }
 
@@ -588,8 +757,6 @@ void Layout::doLayout(const uint16_t* buf,
                       const FontStyle& style,
                       const MinikinPaint& paint,
                       const std::shared_ptr<FontCollection>& collection) {
-  std::scoped_lock _l(gMinikinLock);
-
   LayoutContext ctx;
   ctx.style = style;
   ctx.paint = paint;
@@ -612,8 +779,6 @@ float Layout::measureText(const uint16_t* buf,
                           const MinikinPaint& paint,
                           const std::shared_ptr<FontCollection>& collection,
                           float* advances) {
-  std::scoped_lock _l(gMinikinLock);
-
   LayoutContext ctx;
   ctx.style = style;
   ctx.paint = paint;
@@ -708,27 +873,21 @@ float Layout::doLayoutWord(const uint16_t* buf,
   float wordSpacing =
       count == 1 && isWordSpace(buf[start]) ? ctx->paint.wordSpacing : 0;
 
-  float advance;
+  std::shared_ptr<const LayoutPiece> layoutForWord;
   if (ctx->paint.skipCache()) {
-    Layout layoutForWord;
-    key.doLayout(&layoutForWord, ctx, collection);
-    if (layout) {
-      layout->appendLayout(&layoutForWord, bufStart, wordSpacing);
-    }
-    if (advances) {
-      layoutForWord.getAdvances(advances);
-    }
-    advance = layoutForWord.getAdvance();
+    Layout uncachedLayout;
+    key.doLayout(&uncachedLayout, ctx, collection);
+    layoutForWord = std::make_shared<const LayoutPiece>(uncachedLayout);
   } else {
-    Layout* layoutForWord = cache.get(key, ctx, collection);
-    if (layout) {
-      layout->appendLayout(layoutForWord, bufStart, wordSpacing);
-    }
-    if (advances) {
-      layoutForWord->getAdvances(advances);
-    }
-    advance = layoutForWord->getAdvance();
+    layoutForWord = cache.get(key, ctx, collection);
+  }
+  if (layout) {
+    layout->appendLayout(*layoutForWord, bufStart, wordSpacing);
   }
+  if (advances) {
+    layoutForWord->getAdvances(advances);
+  }
+  float advance = layoutForWord->getAdvance();
 
   if (wordSpacing != 0) {
     advance += wordSpacing;
@@ -748,7 +907,7 @@ static void addFeatures(const std::string& str,
   const char* end = start + str.size();
 
   while (start < end) {
-    static hb_feature_t feature;
+    hb_feature_t feature;
     const char* p = strchr(start, ',');
     if (!p)
       p = end;
@@ -919,7 +1078,7 @@ void Layout::doLayoutRun(const uint16_t* buf,
                          bool isRtl,
                          LayoutContext* ctx,
                          const std::shared_ptr<FontCollection>& collection) {
-  hb_buffer_t* buffer = LayoutEngine::getInstance().hbBuffer;
+  hb_buffer_t* buffer = LayoutEngine::getHbBuffer();
   std::vector<FontCollection::Run> items;
   collection->itemize(buf + start, count, ctx->style, &items);
 
@@ -1105,23 +1264,25 @@ void Layout::doLayoutRun(const uint16_t* buf,
   mAdvance = x;
 }
 
-void Layout::appendLayout(Layout* src, size_t start, float extraAdvance) {
+void Layout::appendLayout(const LayoutPiece& src,
+                          size_t start,
+                          float extraAdvance) {
   int fontMapStack[16];
   int* fontMap;
-  if (src->mFaces.size() < sizeof(fontMapStack) / sizeof(fontMapStack[0])) {
+  if (src.faceCount() < sizeof(fontMapStack) / sizeof(fontMapStack[0])) {
     fontMap = fontMapStack;
   } else {
-    fontMap = new int[src->mFaces.size()];
+    fontMap = new int[src.faceCount()];
   }
-  for (size_t i = 0; i < src->mFaces.size(); i++) {
-    int font_ix = findFace(src->mFaces[i], NULL);
+  for (size_t i = 0; i < src.faceCount(); i++) {
+    int font_ix = findFace(src.faces()[i], NULL);
     fontMap[i] = font_ix;
   }
   // LibTxt: Changed x0 from int to float to prevent rounding that causes text
   // jitter.
   float x0 = mAdvance;
-  for (size_t i = 0; i < src->mGlyphs.size(); i++) {
-    LayoutGlyph& srcGlyph = src->mGlyphs[i];
+  for (size_t i = 0; i < src.glyphCount(); i++) {
+    const LayoutGlyph& srcGlyph = src.glyphs()[i];
     int font_ix = fontMap[srcGlyph.font_ix];
     unsigned int glyph_id = srcGlyph.glyph_id;
     float x = x0 + srcGlyph.x;
@@ -1130,15 +1291,15 @@ void Layout::appendLayout(Layout* src, size_t start, float extraAdvance) {
                          static_cast<uint32_t>(srcGlyph.cluster + start)};
     mGlyphs.push_back(glyph);
   }
-  for (size_t i = 0; i < src->mAdvances.size(); i++) {
-    mAdvances[i + start] = src->mAdvances[i];
+  for (size_t i = 0; i < src.advanceCount(); i++) {
+    mAdvances[i + start] = src.advances()[i];
     if (i == 0)
       mAdvances[i + start] += extraAdvance;
   }
-  MinikinRect srcBounds(src->mBounds);
+  MinikinRect srcBounds(src.getBounds());
   srcBounds.offset(x0, 0);
   mBounds.join(srcBounds);
-  mAdvance += src->mAdvance + extraAdvance;
+  mAdvance += src.getAdvance() + extraAdvance;
 
   if (fontMap != fontMapStack) {
     delete[] fontMap;
@@ -1192,11 +1353,18 @@ void Layout::getBounds(MinikinRect* bounds) const {
   bounds->set(mBounds);
 }
 
+Layout::CacheStatistics Layout::getCacheStatistics() {
+  return LayoutEngine::getInstance().layoutCache.getStatistics();
+}
+
+void Layout::setCacheBudget(size_t bytes) {
+  LayoutEngine::getInstance().layoutCache.setBudget(bytes);
+}
+
 void Layout::purgeCaches() {
-  std::scoped_lock _l(gMinikinLock);
   LayoutCache& layoutCache = LayoutEngine::getInstance().layoutCache;
   layoutCache.clear();
-  purgeHbFontCacheLocked();
+  purgeHbFontCache();
 }
 
 }  // namespace minikin
@@ -46,6 +46,9 @@ struct LayoutGlyph {
 // Internal state used during layout operation
 struct LayoutContext;
 
+// A layout in the layout cache
+class LayoutPiece;
+
 enum {
   kBidi_LTR = 0,
   kBidi_RTL = 1,
@@ -117,8 +120,27 @@ class Layout {
   // Purge all caches, useful in low memory conditions
   static void purgeCaches();
 
+  // libtxt extension: statistics of the layout cache shared by all layouts.
+  struct CacheStatistics {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t entries = 0;
+    // The bytes used by the entries, including their glyphs and text.
+    size_t bytes = 0;
+    size_t budget = 0;
+  };
+
+  static CacheStatistics getCacheStatistics();
+
+  // libtxt extension: sets the number of bytes the layout cache may use.
+  // Entries are evicted right away if the cache is over the new budget.
+  static void setCacheBudget(size_t bytes);
+
+  static const size_t kDefaultCacheBudget = 2 * 1024 * 1024;
+
  private:
   friend class LayoutCacheKey;
+  friend class LayoutPiece;
 
   // Find a face in the mFaces vector, or create a new entry
   int findFace(const FakedFont& face, LayoutContext* ctx);
@@ -163,7 +185,7 @@ class Layout {
                    const std::shared_ptr<FontCollection>& collection);
 
   // Append another layout (for example, cached value) into this one
-  void appendLayout(Layout* src, size_t start, float extraAdvance);
+  void appendLayout(const LayoutPiece& src, size_t start, float extraAdvance);
 
   std::vector<LayoutGlyph> mGlyphs;
   std::vector<float> mAdvances;
@@ -20,6 +20,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <numeric>
 
 #include <log/log.h>
 
@@ -95,6 +96,8 @@ void LineBreaker::setText() {
   mLastHyphenation = HyphenEdit::NO_EDIT;
   mFirstTabIndex = INT_MAX;
   mSpaceCount = 0;
+  mMinStableWidth = std::numeric_limits<ParaWidth>::lowest();
+  mMaxStableWidth = std::numeric_limits<ParaWidth>::infinity();
 }
 
 void LineBreaker::setLineWidths(float firstWidth,
@@ -127,13 +130,38 @@ float LineBreaker::addStyleRun(MinikinPaint* paint,
                                size_t start,
                                size_t end,
                                bool isRtl) {
+  return addStyleRun(paint, typeface, style, start, end, isRtl, true);
+}
+
+float LineBreaker::addMeasuredStyleRun(
+    MinikinPaint* paint,
+    const std::shared_ptr<FontCollection>& typeface,
+    FontStyle style,
+    size_t start,
+    size_t end,
+    bool isRtl) {
+  return addStyleRun(paint, typeface, style, start, end, isRtl, false);
+}
+
+float LineBreaker::addStyleRun(MinikinPaint* paint,
+                               const std::shared_ptr<FontCollection>& typeface,
+                               FontStyle style,
+                               size_t start,
+                               size_t end,
+                               bool isRtl,
+                               bool measure) {
   float width = 0.0f;
 
   float hyphenPenalty = 0.0;
   if (paint != nullptr) {
-    width = Layout::measureText(mTextBuf.data(), start, end - start,
-                                mTextBuf.size(), isRtl, style, *paint, typeface,
-                                mCharWidths.data() + start);
+    if (measure) {
+      width = Layout::measureText(mTextBuf.data(), start, end - start,
+                                  mTextBuf.size(), isRtl, style, *paint,
+                                  typeface, mCharWidths.data() + start);
+    } else {
+      width = std::accumulate(mCharWidths.begin() + start,
+                              mCharWidths.begin() + end, 0.0f);
+    }
 
     // a heuristic that seems to perform well
     hyphenPenalty =
@@ -243,10 +271,7 @@ void LineBreaker::addWordBreak(size_t offset,
                                HyphenationType hyph) {
   Candidate cand;
   ParaWidth width = mCandidates.back().preBreak;
-  // libtxt: add a fudge factor to this comparison.  The currentLineWidth passed
-  // by the framework is based on maxIntrinsicWidth/Layout::measureText
-  // calculations that may not precisely match the postBreak width.
-  if (postBreak - width > currentLineWidth() + LIBTXT_WIDTH_ADJUST) {
+  if (isOverfull(postBreak - width)) {
     // Add desperate breaks.
     // Note: these breaks are based on the shaping of the (non-broken) original
     // text; they are imprecise especially in the presence of kerning,
@@ -311,7 +336,7 @@ void LineBreaker::addCandidate(Candidate cand) {
   // mCandidates, and mPreBreak is its preBreak value. mBestBreak is the index
   // of the best line breaking candidate we have found since then, and
   // mBestScore is its penalty.
-  if (cand.postBreak - mPreBreak > currentLineWidth() + LIBTXT_WIDTH_ADJUST) {
+  if (isOverfull(cand.postBreak - mPreBreak)) {
     // This break would create an overfull line, pick the best break and break
     // there (greedy)
     if (mBestBreak == mLastBreak) {
@@ -321,9 +346,7 @@ void LineBreaker::addCandidate(Candidate cand) {
     pushGreedyBreak();
   }
 
-  while (mLastBreak != candIndex &&
-         cand.postBreak - mPreBreak >
-             currentLineWidth() + LIBTXT_WIDTH_ADJUST) {
+  while (mLastBreak != candIndex && isOverfull(cand.postBreak - mPreBreak)) {
     // We should rarely come here. But if we are here, we have broken the line,
     // but the remaining part still doesn't fit. We now need to break at the
     // second best place after the last break, but we have not kept that
@@ -392,6 +415,21 @@ float LineBreaker::currentLineWidth() const {
   return mLineWidths.getLineWidth(mBreaks.size());
 }
 
+// libtxt: add a fudge factor to this comparison.  The currentLineWidth passed
+// by the framework is based on maxIntrinsicWidth/Layout::measureText
+// calculations that may not precisely match the postBreak width.
+bool LineBreaker::isOverfull(ParaWidth lineWidth) {
+  // The greedy breaks only depend on the line width through this comparison,
+  // so they stay the same for any line width that gives the same answers.
+  ParaWidth threshold = lineWidth - LIBTXT_WIDTH_ADJUST;
+  if (lineWidth > currentLineWidth() + LIBTXT_WIDTH_ADJUST) {
+    mMaxStableWidth = std::min(mMaxStableWidth, threshold);
+    return true;
+  }
+  mMinStableWidth = std::max(mMinStableWidth, threshold);
+  return false;
+}
+
 void LineBreaker::computeBreaksGreedy() {
   // All breaks but the last have been added in addCandidate already.
   size_t nCand = mCandidates.size();
@@ -520,6 +558,10 @@ void LineBreaker::computeBreaksOptimal(bool isRectangle) {
 }
 
 size_t LineBreaker::computeBreaks() {
+  // Only the greedy breaks at a single line width are tracked by isOverfull().
+  if (mStrategy != kBreakStrategy_Greedy || !mLineWidths.hasSingleWidth()) {
+    mMaxStableWidth = mMinStableWidth;
+  }
   if (mStrategy == kBreakStrategy_Greedy) {
     computeBreaksGreedy();
   } else {
@@ -65,6 +65,12 @@ class LineWidths {
     // actually happen
     return mRestWidth == mFirstWidth && mIndents.empty();
   }
+  // libtxt: Unlike isConstant(), also true when the first width is not used,
+  // which is how libtxt sets the line widths.
+  bool hasSingleWidth() const {
+    return (mFirstWidthLineCount == 0 || mRestWidth == mFirstWidth) &&
+           mIndents.empty();
+  }
   float getLineWidth(int line) const {
     float width = (line < mFirstWidthLineCount) ? mFirstWidth : mRestWidth;
     if (!mIndents.empty()) {
@@ -148,6 +154,17 @@ class LineBreaker {
                     size_t end,
                     bool isRtl);
 
+  // libtxt: Add a run whose char widths are already in the width buffer, for
+  // example because the same text was broken before at another width. Unlike
+  // addStyleRun with a nullptr paint, the paint is still used for the break
+  // penalties, so the breaks are the same as if the run was measured again.
+  float addMeasuredStyleRun(MinikinPaint* paint,
+                            const std::shared_ptr<FontCollection>& typeface,
+                            FontStyle style,
+                            size_t start,
+                            size_t end,
+                            bool isRtl);
+
   void addReplacement(size_t start, size_t end, float width);
 
   size_t computeBreaks();
@@ -165,6 +182,13 @@ class LineBreaker {
 
   const int* getFlags() const { return mFlags.data(); }
 
+  // libtxt: The range of line widths, from getMinStableWidth() inclusive to
+  // getMaxStableWidth() exclusive, for which computeBreaks() returns the same
+  // breaks for the text added since setText(). Only the greedy strategy with a
+  // constant line width is tracked; otherwise the range is empty.
+  double getMinStableWidth() const { return mMinStableWidth; }
+  double getMaxStableWidth() const { return mMaxStableWidth; }
+
   void finish();
 
  private:
@@ -193,6 +217,18 @@ class LineBreaker {
 
   float currentLineWidth() const;
 
+  // Returns whether a line of the given width is wider than the current line
+  // width, and narrows the range of line widths that give the same answer.
+  bool isOverfull(ParaWidth lineWidth);
+
+  float addStyleRun(MinikinPaint* paint,
+                    const std::shared_ptr<FontCollection>& typeface,
+                    FontStyle style,
+                    size_t start,
+                    size_t end,
+                    bool isRtl,
+                    bool measure);
+
   void addWordBreak(size_t offset,
                     ParaWidth preBreak,
                     ParaWidth postBreak,
@@ -247,6 +283,9 @@ class LineBreaker {
   uint32_t mLastHyphenation;  // hyphen edit of last break kept for next line
   int mFirstTabIndex;
   size_t mSpaceCount;
+
+  ParaWidth mMinStableWidth;
+  ParaWidth mMaxStableWidth;
 };
 
 }  // namespace minikin
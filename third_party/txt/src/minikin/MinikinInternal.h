@@ -19,22 +19,16 @@
 #ifndef MINIKIN_INTERNAL_H
 #define MINIKIN_INTERNAL_H
 
-#include <mutex>
-
 #include <hb.h>
 
 #include <minikin/MinikinFont.h>
 
 namespace minikin {
 
-// All external Minikin interfaces are designed to be thread-safe.
-// Presently, that's implemented by through a global lock, and having
-// all external interfaces take that lock.
-
-extern std::recursive_mutex gMinikinLock;
-
-// Aborts if gMinikinLock is not acquired. Do nothing on the release build.
-void assertMinikinLocked();
+// All external Minikin interfaces are designed to be thread-safe. Rather than
+// serializing on a global lock, each of the caches shared between threads
+// (layouts, HarfBuzz fonts and language lists) synchronizes its own accesses,
+// and HarfBuzz objects that are mutated during shaping are never shared.
 
 hb_blob_t* getFontTable(const MinikinFont* minikinFont, uint32_t tag);
 
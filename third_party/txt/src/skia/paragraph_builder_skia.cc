@@ -47,20 +47,28 @@ SkFontStyle MakeSkFontStyle(txt::FontWeight font_weight,
 ParagraphBuilderSkia::ParagraphBuilderSkia(
     const ParagraphStyle& style,
     std::shared_ptr<FontCollection> font_collection)
-    : base_style_(style.GetTextStyle()) {
-  builder_ = skt::ParagraphBuilder::make(
-      TxtToSkia(style), font_collection->CreateSktFontCollection());
+    : font_collection_(std::move(font_collection)),
+      skt_collection_(font_collection_->GetSktFontCollection()),
+      base_style_(style.GetTextStyle()) {
+  paragraph_style_ = TxtToSkia(style);
+  builder_ =
+      skt::ParagraphBuilder::make(paragraph_style_, skt_collection_->get());
 }
 
 ParagraphBuilderSkia::~ParagraphBuilderSkia() = default;
 
 void ParagraphBuilderSkia::PushStyle(const TextStyle& style) {
-  builder_->pushStyle(TxtToSkia(style));
+  skt::TextStyle skia_style = TxtToSkia(style);
+  builder_->pushStyle(skia_style);
+  ops_.push_back([skia_style](skt::ParagraphBuilder& builder) {
+    builder.pushStyle(skia_style);
+  });
   txt_style_stack_.push(style);
 }
 
 void ParagraphBuilderSkia::Pop() {
   builder_->pop();
+  ops_.push_back([](skt::ParagraphBuilder& builder) { builder.pop(); });
   txt_style_stack_.pop();
 }
 
@@ -70,6 +78,8 @@ const TextStyle& ParagraphBuilderSkia::PeekStyle() {
 
 void ParagraphBuilderSkia::AddText(const std::u16string& text) {
   builder_->addText(text);
+  ops_.push_back(
+      [text](skt::ParagraphBuilder& builder) { builder.addText(text); });
 }
 
 void ParagraphBuilderSkia::AddPlaceholder(PlaceholderRun& span) {
@@ -82,11 +92,25 @@ void ParagraphBuilderSkia::AddPlaceholder(PlaceholderRun& span) {
       static_cast<skt::PlaceholderAlignment>(span.alignment);
 
   builder_->addPlaceholder(placeholder_style);
+  ops_.push_back([placeholder_style](skt::ParagraphBuilder& builder) {
+    builder.addPlaceholder(placeholder_style);
+  });
 }
 
 std::unique_ptr<Paragraph> ParagraphBuilderSkia::Build() {
-  return std::make_unique<ParagraphSkia>(builder_->Build(),
-                                         std::move(dl_paints_));
+  ParagraphSkia::Rebuilder rebuild =
+      [style = paragraph_style_,
+       ops = std::move(ops_)](sk_sp<skt::FontCollection> collection) {
+        auto builder =
+            skt::ParagraphBuilder::make(style, std::move(collection));
+        for (const auto& op : ops) {
+          op(*builder);
+        }
+        return builder->Build();
+      };
+  return std::make_unique<ParagraphSkia>(
+      builder_->Build(), std::move(dl_paints_), font_collection_,
+      skt_collection_, std::move(rebuild));
 }
 
 skt::ParagraphPainter::PaintID ParagraphBuilderSkia::CreatePaintID(
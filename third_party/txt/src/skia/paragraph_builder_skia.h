@@ -17,6 +17,8 @@
 #ifndef LIB_TXT_SRC_PARAGRAPH_BUILDER_SKIA_H_
 #define LIB_TXT_SRC_PARAGRAPH_BUILDER_SKIA_H_
 
+#include <functional>
+
 #include "txt/paragraph_builder.h"
 
 #include "flutter/display_list/display_list_paint.h"
@@ -45,7 +47,13 @@ class ParagraphBuilderSkia : public ParagraphBuilder {
   skia::textlayout::ParagraphStyle TxtToSkia(const ParagraphStyle& txt);
   skia::textlayout::TextStyle TxtToSkia(const TextStyle& txt);
 
+  std::shared_ptr<FontCollection> font_collection_;
+  std::shared_ptr<FontCollection::SktFontCollection> skt_collection_;
+  skia::textlayout::ParagraphStyle paragraph_style_;
   std::shared_ptr<skia::textlayout::ParagraphBuilder> builder_;
+  // The calls made on |builder_|, so that the paragraph can be built again
+  // for the Skia collection of the thread that first lays it out.
+  std::vector<std::function<void(skia::textlayout::ParagraphBuilder&)>> ops_;
   TextStyle base_style_;
   std::stack<TextStyle> txt_style_stack_;
   std::vector<flutter::DlPaint> dl_paints_;
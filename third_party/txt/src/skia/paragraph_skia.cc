@@ -142,9 +142,17 @@ class DisplayListParagraphPainter : public skt::ParagraphPainter {
 
 }  // anonymous namespace
 
-ParagraphSkia::ParagraphSkia(std::unique_ptr<skt::Paragraph> paragraph,
-                             std::vector<flutter::DlPaint>&& dl_paints)
-    : paragraph_(std::move(paragraph)), dl_paints_(dl_paints) {}
+ParagraphSkia::ParagraphSkia(
+    std::unique_ptr<skt::Paragraph> paragraph,
+    std::vector<flutter::DlPaint>&& dl_paints,
+    std::shared_ptr<FontCollection> font_collection,
+    std::shared_ptr<FontCollection::SktFontCollection> skt_collection,
+    Rebuilder rebuild)
+    : paragraph_(std::move(paragraph)),
+      dl_paints_(dl_paints),
+      font_collection_(std::move(font_collection)),
+      skt_collection_(std::move(skt_collection)),
+      rebuild_(std::move(rebuild)) {}
 
 double ParagraphSkia::GetMaxWidth() {
   return SkScalarToDouble(paragraph_->getMaxWidth());
@@ -220,6 +228,18 @@ bool ParagraphSkia::DidExceedMaxLines() {
 void ParagraphSkia::Layout(double width) {
   line_metrics_.reset();
   line_metrics_styles_.clear();
+  // A paragraph that is first laid out on another thread than the one that
+  // built it, such as a worker, is built again for the Skia collection of
+  // that thread. Layouts on different threads then do not wait on each other.
+  if (rebuild_) {
+    auto skt_collection = font_collection_->GetSktFontCollection();
+    if (skt_collection != skt_collection_) {
+      paragraph_ = rebuild_(skt_collection->get());
+      skt_collection_ = std::move(skt_collection);
+    }
+    rebuild_ = nullptr;
+  }
+  auto lock = skt_collection_->Lock();
   paragraph_->layout(width);
 }
 
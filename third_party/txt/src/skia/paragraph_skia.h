@@ -17,8 +17,10 @@
 #ifndef LIB_TXT_SRC_PARAGRAPH_SKIA_H_
 #define LIB_TXT_SRC_PARAGRAPH_SKIA_H_
 
+#include <functional>
 #include <optional>
 
+#include "txt/font_collection.h"
 #include "txt/paragraph.h"
 
 #include "third_party/skia/modules/skparagraph/include/Paragraph.h"
@@ -28,8 +30,16 @@ namespace txt {
 // Implementation of Paragraph based on Skia's text layout module.
 class ParagraphSkia : public Paragraph {
  public:
-  ParagraphSkia(std::unique_ptr<skia::textlayout::Paragraph> paragraph,
-                std::vector<flutter::DlPaint>&& dl_paints);
+  // Builds the paragraph again for another Skia collection.
+  using Rebuilder = std::function<std::unique_ptr<skia::textlayout::Paragraph>(
+      sk_sp<skia::textlayout::FontCollection>)>;
+
+  ParagraphSkia(
+      std::unique_ptr<skia::textlayout::Paragraph> paragraph,
+      std::vector<flutter::DlPaint>&& dl_paints,
+      std::shared_ptr<FontCollection> font_collection,
+      std::shared_ptr<FontCollection::SktFontCollection> skt_collection,
+      Rebuilder rebuild);
 
   virtual ~ParagraphSkia() = default;
 
@@ -74,6 +84,12 @@ class ParagraphSkia : public Paragraph {
 
   std::unique_ptr<skia::textlayout::Paragraph> paragraph_;
   std::vector<flutter::DlPaint> dl_paints_;
+  std::shared_ptr<FontCollection> font_collection_;
+  // The Skia collection the paragraph was built for. It is locked while the
+  // paragraph is laid out, which may happen on a worker.
+  std::shared_ptr<FontCollection::SktFontCollection> skt_collection_;
+  // Set until the paragraph is first laid out.
+  Rebuilder rebuild_;
   std::optional<std::vector<LineMetrics>> line_metrics_;
   std::vector<TextStyle> line_metrics_styles_;
 };
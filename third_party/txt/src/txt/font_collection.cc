@@ -21,13 +21,17 @@
 #include <memory>
 #include <mutex>
 #include <set>
+#include <sstream>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 #include "flutter/fml/logging.h"
+#include "flutter/fml/mapped_hash_table.h"
 #include "flutter/fml/trace_event.h"
 #include "font_skia.h"
 #include "minikin/Layout.h"
+#include "txt/locking_font_manager.h"
 #include "txt/platform.h"
 #include "txt/text_style.h"
 
@@ -37,6 +41,37 @@ namespace {
 
 const std::shared_ptr<minikin::FontFamily> g_null_family;
 
+// The first line of the persisted fallback cache, followed by the fingerprint
+// of the font managers.
+const char kFallbackCacheHeader[] = "txt-fallback-fonts-v1 ";
+
+const char kDefaultFontManagerTag = 's';
+const char kAssetFontManagerTag = 'a';
+const char kTestFontManagerTag = 't';
+
+// Returns a hash of the families of the given tagged font managers.
+std::string ComputeFallbackCacheFingerprint(
+    const std::vector<std::pair<char, sk_sp<SkFontMgr>>>& managers) {
+  fml::FNV1aHasher hasher;
+  auto add = [&hasher](const char* data, size_t size) {
+    hasher.Update(data, size);
+    // Terminate each value so that adjacent values can not be confused.
+    const uint8_t terminator = 0xff;
+    hasher.Update(&terminator, 1);
+  };
+  for (const auto& [tag, manager] : managers) {
+    add(&tag, 1);
+    for (int i = 0; i < manager->countFamilies(); i++) {
+      SkString family_name;
+      manager->getFamilyName(i, &family_name);
+      add(family_name.c_str(), family_name.size());
+    }
+  }
+  std::stringstream stream;
+  stream << std::hex << hasher.GetHash();
+  return stream.str();
+}
+
 }  // anonymous namespace
 
 FontCollection::FamilyKey::FamilyKey(const std::vector<std::string>& families,
@@ -87,50 +122,58 @@ FontCollection::~FontCollection() {
   minikin::Layout::purgeCaches();
 
 #if FLUTTER_ENABLE_SKSHAPER
-  if (skt_collection_) {
-    skt_collection_->clearCaches();
+  // The paragraphs that use the Skia collections hold this collection, so
+  // none of them are being laid out.
+  for (const auto& [thread, collection] : skt_collections_) {
+    collection->get()->clearCaches();
   }
 #endif
 }
 
 size_t FontCollection::GetFontManagersCount() const {
+  std::scoped_lock lock(mutex_);
   return GetFontManagerOrder().size();
 }
 
 void FontCollection::SetupDefaultFontManager(
     uint32_t font_initialization_data) {
+  std::scoped_lock lock(mutex_);
   default_font_manager_ = GetDefaultFontManager(font_initialization_data);
 }
 
 void FontCollection::SetDefaultFontManager(sk_sp<SkFontMgr> font_manager) {
+  std::scoped_lock lock(mutex_);
   default_font_manager_ = font_manager;
 
 #if FLUTTER_ENABLE_SKSHAPER
-  skt_collection_.reset();
+  ResetSktFontCollectionsLocked();
 #endif
 }
 
 void FontCollection::SetAssetFontManager(sk_sp<SkFontMgr> font_manager) {
+  std::scoped_lock lock(mutex_);
   asset_font_manager_ = font_manager;
 
 #if FLUTTER_ENABLE_SKSHAPER
-  skt_collection_.reset();
+  ResetSktFontCollectionsLocked();
 #endif
 }
 
 void FontCollection::SetDynamicFontManager(sk_sp<SkFontMgr> font_manager) {
+  std::scoped_lock lock(mutex_);
   dynamic_font_manager_ = font_manager;
 
 #if FLUTTER_ENABLE_SKSHAPER
-  skt_collection_.reset();
+  ResetSktFontCollectionsLocked();
 #endif
 }
 
 void FontCollection::SetTestFontManager(sk_sp<SkFontMgr> font_manager) {
+  std::scoped_lock lock(mutex_);
   test_font_manager_ = font_manager;
 
 #if FLUTTER_ENABLE_SKSHAPER
-  skt_collection_.reset();
+  ResetSktFontCollectionsLocked();
 #endif
 }
 
@@ -149,11 +192,12 @@ std::vector<sk_sp<SkFontMgr>> FontCollection::GetFontManagerOrder() const {
 }
 
 void FontCollection::DisableFontFallback() {
+  std::scoped_lock lock(mutex_);
   enable_font_fallback_ = false;
 
 #if FLUTTER_ENABLE_SKSHAPER
-  if (skt_collection_) {
-    skt_collection_->disableFontFallback();
+  for (const auto& [thread, collection] : skt_collections_) {
+    collection->DisableFontFallback();
   }
 #endif
 }
@@ -162,6 +206,7 @@ std::shared_ptr<minikin::FontCollection>
 FontCollection::GetMinikinFontCollectionForFamilies(
     const std::vector<std::string>& font_families,
     const std::string& locale) {
+  std::scoped_lock lock(mutex_);
   // Look inside the font collections cache first.
   FamilyKey family_key(font_families, locale);
   auto cached = font_collections_cache_.find(family_key);
@@ -318,6 +363,7 @@ std::shared_ptr<minikin::FontFamily> FontCollection::CreateMinikinFontFamily(
 const std::shared_ptr<minikin::FontFamily>& FontCollection::MatchFallbackFont(
     uint32_t ch,
     std::string locale) {
+  std::scoped_lock lock(mutex_);
   // Check if the ch's matched font has been cached. We cache the results of
   // this method as repeated matchFamilyStyleCharacter calls can become
   // extremely laggy when typing a large number of complex emojis.
@@ -328,6 +374,7 @@ const std::shared_ptr<minikin::FontFamily>& FontCollection::MatchFallbackFont(
   const std::shared_ptr<minikin::FontFamily>* match =
       &DoMatchFallbackFont(ch, locale);
   fallback_match_cache_.insert(std::make_pair(ch, match));
+  StoreFallbackCacheIfDirty();
   return *match;
 }
 
@@ -345,29 +392,54 @@ const std::shared_ptr<minikin::FontFamily>& FontCollection::DoMatchFallbackFont(
 
     SkString sk_family_name;
     typeface->getFamilyName(&sk_family_name);
-    std::string family_name(sk_family_name.c_str());
-
-    if (std::find(fallback_fonts_for_locale_[locale].begin(),
-                  fallback_fonts_for_locale_[locale].end(),
-                  family_name) == fallback_fonts_for_locale_[locale].end())
-      fallback_fonts_for_locale_[locale].push_back(family_name);
-
-    return GetFallbackFontFamily(manager, family_name);
+    return AddFallbackFontFamily(manager, sk_family_name.c_str(), locale,
+                                 nullptr);
   }
   return g_null_family;
 }
 
 const std::shared_ptr<minikin::FontFamily>&
-FontCollection::GetFallbackFontFamily(const sk_sp<SkFontMgr>& manager,
-                                      const std::string& family_name) {
+FontCollection::AddFallbackFontFamily(
+    const sk_sp<SkFontMgr>& manager,
+    const std::string& family_name,
+    const std::string& locale,
+    std::shared_ptr<minikin::FontFamily> minikin_family) {
+  std::vector<std::string>& locale_families =
+      fallback_fonts_for_locale_[locale];
+  const bool is_new_for_locale =
+      std::find(locale_families.begin(), locale_families.end(),
+                family_name) == locale_families.end();
+  if (is_new_for_locale)
+    locale_families.push_back(family_name);
+
+  const std::shared_ptr<minikin::FontFamily>& family =
+      GetFallbackFontFamily(manager, family_name, std::move(minikin_family));
+
+  const char tag = GetFontManagerTag(manager);
+  if (is_new_for_locale && family && fallback_cache_storage_ && tag != 0 &&
+      locale.find_first_of("\t\n") == std::string::npos &&
+      family_name.find_first_of("\t\n") == std::string::npos) {
+    fallback_cache_entries_ +=
+        locale + '\t' + tag + '\t' + family_name + '\n';
+    fallback_cache_dirty_ = true;
+  }
+
+  return family;
+}
+
+const std::shared_ptr<minikin::FontFamily>&
+FontCollection::GetFallbackFontFamily(
+    const sk_sp<SkFontMgr>& manager,
+    const std::string& family_name,
+    std::shared_ptr<minikin::FontFamily> minikin_family) {
   TRACE_EVENT0("flutter", "FontCollection::GetFallbackFontFamily");
   auto fallback_it = fallback_fonts_.find(family_name);
   if (fallback_it != fallback_fonts_.end()) {
     return fallback_it->second;
   }
 
-  std::shared_ptr<minikin::FontFamily> minikin_family =
-      CreateMinikinFontFamily(manager, family_name);
+  if (!minikin_family)
+    minikin_family = CreateMinikinFontFamily(manager, family_name);
   if (!minikin_family)
     return g_null_family;
 
@@ -382,37 +454,298 @@ FontCollection::GetFallbackFontFamily(const sk_sp<SkFontMgr>& manager,
 }
 
 void FontCollection::ClearFontFamilyCache() {
+  std::scoped_lock lock(mutex_);
+  ClearFontFamilyCacheLocked();
+}
+
+void FontCollection::RegisterDynamicTypeface(DynamicFontManager& manager,
+                                             sk_sp<SkTypeface> typeface,
+                                             const std::string& family_name) {
+  std::scoped_lock lock(mutex_);
+  FML_DCHECK(dynamic_font_manager_.get() == &manager);
+  if (family_name.empty()) {
+    manager.font_provider().RegisterTypeface(std::move(typeface));
+  } else {
+    manager.font_provider().RegisterTypeface(std::move(typeface), family_name);
+  }
+  ClearFontFamilyCacheLocked();
+}
+
+void FontCollection::ClearFontFamilyCacheLocked() {
   font_collections_cache_.clear();
 
 #if FLUTTER_ENABLE_SKSHAPER
-  if (skt_collection_) {
-    skt_collection_->clearCaches();
+  for (const auto& [thread, collection] : skt_collections_) {
+    collection->InvalidateCaches();
   }
 #endif
 }
 
-#if FLUTTER_ENABLE_SKSHAPER
-
-sk_sp<skia::textlayout::FontCollection>
-FontCollection::CreateSktFontCollection() {
-  if (!skt_collection_) {
-    skt_collection_ = sk_make_sp<skia::textlayout::FontCollection>();
+void FontCollection::SetFallbackCacheStorage(
+    std::shared_ptr<FallbackCacheStorage> storage) {
+  std::scoped_lock lock(mutex_);
+  fallback_cache_storage_ = std::move(storage);
+  fallback_cache_entries_.clear();
+  fallback_cache_fingerprint_.clear();
+  fallback_cache_restored_ = false;
+  fallback_cache_dirty_ = false;
+}
 
-    std::vector<SkString> default_font_families;
-    for (const std::string& family : GetDefaultFontFamilies()) {
-      default_font_families.emplace_back(family);
+void FontCollection::PrewarmFallbackFonts(
+    const std::vector<std::string>& locales,
+    const std::vector<uint32_t>& code_points) {
+  TRACE_EVENT0("flutter", "FontCollection::PrewarmFallbackFonts");
+  // The storage and the platform font manager may be slow, so they are used
+  // without holding the lock. Only the results are published under it, and
+  // paragraphs laid out meanwhile do not wait on them.
+  RestoreFallbackCache();
+
+  for (const std::string& locale : locales) {
+    for (uint32_t ch : code_points) {
+      PrewarmFallbackFont(ch, locale);
     }
-    skt_collection_->setDefaultFontManager(default_font_manager_,
-                                           default_font_families);
-    skt_collection_->setAssetFontManager(asset_font_manager_);
-    skt_collection_->setDynamicFontManager(dynamic_font_manager_);
-    skt_collection_->setTestFontManager(test_font_manager_);
+  }
+
+  std::scoped_lock lock(mutex_);
+  StoreFallbackCacheIfDirty();
+}
+
+void FontCollection::PrewarmFallbackFont(uint32_t ch,
+                                         const std::string& locale) {
+  std::vector<sk_sp<SkFontMgr>> managers;
+  sk_sp<SkFontMgr> default_manager;
+  {
+    std::scoped_lock lock(mutex_);
     if (!enable_font_fallback_) {
-      skt_collection_->disableFontFallback();
+      return;
     }
+    // Skip the characters covered by the fallback fonts already added to the
+    // font collections of this locale.
+    for (const std::string& family_name : fallback_fonts_for_locale_[locale]) {
+      auto it = fallback_fonts_.find(family_name);
+      if (it != fallback_fonts_.end() && it->second->hasGlyph(ch, 0)) {
+        return;
+      }
+    }
+    managers = GetFontManagerOrder();
+    default_manager = default_font_manager_;
+  }
+
+  // Only the platform font manager matches characters, and it is thread safe.
+  // The asset and dynamic font managers load their typefaces lazily, so their
+  // families are created under the lock.
+  for (const sk_sp<SkFontMgr>& manager : managers) {
+    std::vector<const char*> bcp47;
+    if (!locale.empty())
+      bcp47.push_back(locale.c_str());
+    sk_sp<SkTypeface> typeface(manager->matchFamilyStyleCharacter(
+        0, SkFontStyle(), bcp47.data(), bcp47.size(), ch));
+    if (!typeface)
+      continue;
+
+    SkString sk_family_name;
+    typeface->getFamilyName(&sk_family_name);
+    const std::string family_name(sk_family_name.c_str());
+    std::shared_ptr<minikin::FontFamily> family;
+    if (manager == default_manager) {
+      family = CreateMinikinFontFamily(manager, family_name);
+    }
+
+    std::scoped_lock lock(mutex_);
+    const std::shared_ptr<minikin::FontFamily>* match =
+        &AddFallbackFontFamily(manager, family_name, locale, std::move(family));
+    fallback_match_cache_.insert(std::make_pair(ch, match));
+    return;
   }
 
-  return skt_collection_;
+  std::scoped_lock lock(mutex_);
+  fallback_match_cache_.insert(std::make_pair(ch, &g_null_family));
+}
+
+char FontCollection::GetFontManagerTag(const sk_sp<SkFontMgr>& manager) const {
+  // Fonts of the dynamic font manager are loaded by the app while it runs, so
+  // they can not be restored at startup.
+  if (manager == default_font_manager_)
+    return kDefaultFontManagerTag;
+  if (manager == asset_font_manager_)
+    return kAssetFontManagerTag;
+  if (manager == test_font_manager_)
+    return kTestFontManagerTag;
+  return 0;
+}
+
+sk_sp<SkFontMgr> FontCollection::GetFontManagerForTag(char tag) const {
+  switch (tag) {
+    case kDefaultFontManagerTag:
+      return default_font_manager_;
+    case kAssetFontManagerTag:
+      return asset_font_manager_;
+    case kTestFontManagerTag:
+      return test_font_manager_;
+  }
+  return nullptr;
+}
+
+void FontCollection::RestoreFallbackCache() {
+  TRACE_EVENT0("flutter", "FontCollection::RestoreFallbackCache");
+  std::shared_ptr<FallbackCacheStorage> storage;
+  std::vector<std::pair<char, sk_sp<SkFontMgr>>> managers;
+  {
+    std::scoped_lock lock(mutex_);
+    if (!enable_font_fallback_ || !fallback_cache_storage_ ||
+        fallback_cache_restored_) {
+      return;
+    }
+    storage = fallback_cache_storage_;
+    for (char tag :
+         {kDefaultFontManagerTag, kAssetFontManagerTag, kTestFontManagerTag}) {
+      sk_sp<SkFontMgr> manager = GetFontManagerForTag(tag);
+      if (manager)
+        managers.emplace_back(tag, std::move(manager));
+    }
+  }
+
+  // The families of the font managers whose fonts are known at startup do not
+  // change, so the fingerprint is computed once and stored with the families
+  // found later.
+  const std::string fingerprint = ComputeFallbackCacheFingerprint(managers);
+  const std::string data = storage->Load();
+  const std::string header = kFallbackCacheHeader + fingerprint + '\n';
+  const bool is_valid = data.compare(0, header.size(), header) == 0;
+
+  struct Entry {
+    std::string line;
+    std::string locale;
+    char tag;
+    std::string family_name;
+    std::shared_ptr<minikin::FontFamily> family;
+  };
+  std::vector<Entry> entries;
+  size_t line_start = is_valid ? header.size() : data.size();
+  while (line_start < data.size()) {
+    size_t line_end = data.find('\n', line_start);
+    if (line_end == std::string::npos)
+      break;
+    Entry entry;
+    entry.line = data.substr(line_start, line_end - line_start);
+    line_start = line_end + 1;
+
+    size_t tag_start = entry.line.find('\t');
+    if (tag_start == std::string::npos || tag_start + 3 > entry.line.size() ||
+        entry.line[tag_start + 2] != '\t')
+      continue;
+    entry.locale = entry.line.substr(0, tag_start);
+    entry.tag = entry.line[tag_start + 1];
+    entry.family_name = entry.line.substr(tag_start + 3);
+    // Only the platform font manager is thread safe, see PrewarmFallbackFont.
+    if (entry.tag == kDefaultFontManagerTag && !managers.empty() &&
+        managers.front().first == kDefaultFontManagerTag) {
+      entry.family =
+          CreateMinikinFontFamily(managers.front().second, entry.family_name);
+      if (!entry.family)
+        continue;
+    }
+    entries.push_back(std::move(entry));
+  }
+
+  std::scoped_lock lock(mutex_);
+  if (fallback_cache_storage_ != storage || fallback_cache_restored_) {
+    return;
+  }
+  fallback_cache_restored_ = true;
+  fallback_cache_fingerprint_ = fingerprint;
+  if (!is_valid) {
+    // The fonts have changed, so the persisted families may no longer be
+    // the ones the font managers would match. Start over.
+    if (!data.empty())
+      fallback_cache_dirty_ = true;
+    return;
+  }
+
+  for (Entry& entry : entries) {
+    sk_sp<SkFontMgr> manager = GetFontManagerForTag(entry.tag);
+    if (!manager ||
+        !GetFallbackFontFamily(manager, entry.family_name,
+                               std::move(entry.family)))
+      continue;
+
+    std::vector<std::string>& locale_families =
+        fallback_fonts_for_locale_[entry.locale];
+    if (std::find(locale_families.begin(), locale_families.end(),
+                  entry.family_name) != locale_families.end())
+      continue;
+    locale_families.push_back(entry.family_name);
+    fallback_cache_entries_ += entry.line + '\n';
+  }
+}
+
+void FontCollection::StoreFallbackCacheIfDirty() {
+  // Families found before the persisted ones are restored would otherwise
+  // overwrite them.
+  if (!fallback_cache_dirty_ || !fallback_cache_restored_ ||
+      !fallback_cache_storage_) {
+    return;
+  }
+  TRACE_EVENT0("flutter", "FontCollection::StoreFallbackCache");
+  fallback_cache_dirty_ = false;
+  fallback_cache_storage_->Store(kFallbackCacheHeader +
+                                 fallback_cache_fingerprint_ + '\n' +
+                                 fallback_cache_entries_);
+}
+
+#if FLUTTER_ENABLE_SKSHAPER
+
+FontCollection::SktFontCollection::SktFontCollection(
+    sk_sp<skia::textlayout::FontCollection> collection)
+    : collection_(std::move(collection)) {}
+
+std::unique_lock<std::mutex> FontCollection::SktFontCollection::Lock() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (font_fallback_disabled_.exchange(false)) {
+    collection_->disableFontFallback();
+  }
+  if (caches_invalid_.exchange(false)) {
+    collection_->clearCaches();
+  }
+  return lock;
+}
+
+std::shared_ptr<FontCollection::SktFontCollection>
+FontCollection::GetSktFontCollection() {
+  std::scoped_lock lock(mutex_);
+  std::shared_ptr<SktFontCollection>& skt_collection =
+      skt_collections_[std::this_thread::get_id()];
+  if (skt_collection) {
+    return skt_collection;
+  }
+
+  // The font managers are locked with the mutex of this collection, which is
+  // also held while fonts are registered with them.
+  auto wrap = [this](const sk_sp<SkFontMgr>& font_manager) -> sk_sp<SkFontMgr> {
+    if (!font_manager) {
+      return nullptr;
+    }
+    return sk_make_sp<LockingFontManager>(font_manager, mutex_);
+  };
+  auto collection = sk_make_sp<skia::textlayout::FontCollection>();
+  std::vector<SkString> default_font_families;
+  for (const std::string& family : GetDefaultFontFamilies()) {
+    default_font_families.emplace_back(family);
+  }
+  collection->setDefaultFontManager(wrap(default_font_manager_),
+                                    default_font_families);
+  collection->setAssetFontManager(wrap(asset_font_manager_));
+  collection->setDynamicFontManager(wrap(dynamic_font_manager_));
+  collection->setTestFontManager(wrap(test_font_manager_));
+  if (!enable_font_fallback_) {
+    collection->disableFontFallback();
+  }
+  skt_collection = std::make_shared<SktFontCollection>(std::move(collection));
+  return skt_collection;
+}
+
+void FontCollection::ResetSktFontCollectionsLocked() {
+  skt_collections_.clear();
 }
 
 #endif  // FLUTTER_ENABLE_SKSHAPER
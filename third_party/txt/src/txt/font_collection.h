@@ -17,10 +17,14 @@
 #ifndef LIB_TXT_SRC_FONT_COLLECTION_H_
 #define LIB_TXT_SRC_FONT_COLLECTION_H_
 
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "flutter/fml/macros.h"
 #include "minikin/FontCollection.h"
@@ -37,8 +41,24 @@
 
 namespace txt {
 
+// The font collection may be used by paragraphs that are laid out on several
+// threads at once. All methods are thread safe.
 class FontCollection : public std::enable_shared_from_this<FontCollection> {
  public:
+  // Keeps the fallback font families found by MatchFallbackFont across runs.
+  class FallbackCacheStorage {
+   public:
+    virtual ~FallbackCacheStorage() = default;
+
+    // Returns the data passed to the last call to Store, possibly in an
+    // earlier run, or an empty string if there is none.
+    virtual std::string Load() = 0;
+
+    // Called while the font collection is locked, so slow writes should be
+    // done on another thread.
+    virtual void Store(const std::string& data) = 0;
+  };
+
   FontCollection();
 
   ~FontCollection();
@@ -68,10 +88,69 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
   // Remove all entries in the font family cache.
   void ClearFontFamilyCache();
 
+  // Registers a typeface with |manager|, which must be the dynamic font
+  // manager of this collection, and clears the font family cache. The
+  // registration is done under the lock of the collection, as paragraphs on
+  // other threads may be matching fonts. An empty family name registers the
+  // typeface under its own family name.
+  void RegisterDynamicTypeface(DynamicFontManager& manager,
+                               sk_sp<SkTypeface> typeface,
+                               const std::string& family_name);
+
+  // Sets where the fallback font families are persisted. The families are
+  // read from the storage by the next call to PrewarmFallbackFonts, and the
+  // families found after that are written back to it.
+  void SetFallbackCacheStorage(std::shared_ptr<FallbackCacheStorage> storage);
+
+  // Finds the fallback font families for the given code points in each of the
+  // locales ahead of time, so that laying out text with them does not wait on
+  // the font managers. Restores the families persisted by earlier runs first,
+  // unless the fonts of the font managers have changed since.
+  //
+  // This may take a while and should be called on a background thread. The
+  // collection is only locked while the families found are added to it.
+  void PrewarmFallbackFonts(const std::vector<std::string>& locales,
+                            const std::vector<uint32_t>& code_points);
+
 #if FLUTTER_ENABLE_SKSHAPER
 
-  // Construct a Skia text layout FontCollection based on this collection.
-  sk_sp<skia::textlayout::FontCollection> CreateSktFontCollection();
+  // A Skia text layout FontCollection based on this collection.
+  //
+  // The Skia collection caches the typefaces it finds without synchronizing,
+  // so it must be locked while a paragraph that uses it is laid out. Each
+  // thread that lays out paragraphs gets its own, so that a layout on a
+  // worker does not hold up the layouts on the UI thread. The font managers
+  // it queries are shared, and are only locked while they are queried.
+  class SktFontCollection {
+   public:
+    explicit SktFontCollection(
+        sk_sp<skia::textlayout::FontCollection> collection);
+
+    const sk_sp<skia::textlayout::FontCollection>& get() const {
+      return collection_;
+    }
+
+    // Locks the collection while a paragraph that uses it is laid out.
+    std::unique_lock<std::mutex> Lock();
+
+    // Clears the caches of the collection before the next layout, as a layout
+    // on another thread may be using them now.
+    void InvalidateCaches() { caches_invalid_ = true; }
+
+    // Disables font fallback before the next layout.
+    void DisableFontFallback() { font_fallback_disabled_ = true; }
+
+   private:
+    const sk_sp<skia::textlayout::FontCollection> collection_;
+    std::mutex mutex_;
+    std::atomic<bool> caches_invalid_ = false;
+    std::atomic<bool> font_fallback_disabled_ = false;
+
+    FML_DISALLOW_COPY_AND_ASSIGN(SktFontCollection);
+  };
+
+  // Returns the Skia text layout FontCollection of the calling thread.
+  std::shared_ptr<SktFontCollection> GetSktFontCollection();
 
 #endif  // FLUTTER_ENABLE_SKSHAPER
 
@@ -90,6 +169,8 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
     };
   };
 
+  // Guards the font managers and the caches below.
+  mutable std::mutex mutex_;
   sk_sp<SkFontMgr> default_font_manager_;
   sk_sp<SkFontMgr> asset_font_manager_;
   sk_sp<SkFontMgr> dynamic_font_manager_;
@@ -107,10 +188,25 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
   std::unordered_map<std::string, std::vector<std::string>>
       fallback_fonts_for_locale_;
   bool enable_font_fallback_;
+  std::shared_ptr<FallbackCacheStorage> fallback_cache_storage_;
+  // The fallback font families to persist, one "locale\tmanager\tfamily" line
+  // per family.
+  std::string fallback_cache_entries_;
+  // The hash of the families of the font managers when the persisted families
+  // were restored. See ComputeFallbackCacheFingerprint.
+  std::string fallback_cache_fingerprint_;
+  bool fallback_cache_restored_ = false;
+  bool fallback_cache_dirty_ = false;
 
 #if FLUTTER_ENABLE_SKSHAPER
-  // An equivalent font collection usable by the Skia text shaper library.
-  sk_sp<skia::textlayout::FontCollection> skt_collection_;
+  // Equivalent font collections usable by the Skia text shaper library, one
+  // for each thread that lays out paragraphs.
+  std::unordered_map<std::thread::id, std::shared_ptr<SktFontCollection>>
+      skt_collections_;
+
+  // Drops the Skia collections after the font managers have changed. The
+  // paragraphs that were built with them keep using them.
+  void ResetSktFontCollectionsLocked();
 #endif
 
   // Performs the actual work of MatchFallbackFont. The result is cached in
@@ -121,6 +217,8 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
 
   std::vector<sk_sp<SkFontMgr>> GetFontManagerOrder() const;
 
+  void ClearFontFamilyCacheLocked();
+
   std::shared_ptr<minikin::FontFamily> FindFontFamilyInManagers(
       const std::string& family_name);
 
@@ -133,9 +231,40 @@ class FontCollection : public std::enable_shared_from_this<FontCollection> {
   FRIEND_TEST(FontCollectionTest, CheckSkTypefacesSorting);
   static void SortSkTypefaces(std::vector<sk_sp<SkTypeface>>& sk_typefaces);
 
+  // Returns the fallback family with the given name, adding |minikin_family|
+  // or a family created from |manager| if there is none.
   const std::shared_ptr<minikin::FontFamily>& GetFallbackFontFamily(
       const sk_sp<SkFontMgr>& manager,
-      const std::string& family_name);
+      const std::string& family_name,
+      std::shared_ptr<minikin::FontFamily> minikin_family = nullptr);
+
+  // Adds the fallback family matched by |manager| to the font collections of
+  // |locale| and to the persisted fallback families.
+  const std::shared_ptr<minikin::FontFamily>& AddFallbackFontFamily(
+      const sk_sp<SkFontMgr>& manager,
+      const std::string& family_name,
+      const std::string& locale,
+      std::shared_ptr<minikin::FontFamily> minikin_family);
+
+  // Matches the fallback family for |ch| in |locale| without holding the lock
+  // and adds it, unless a family of the locale already covers the character.
+  void PrewarmFallbackFont(uint32_t ch, const std::string& locale);
+
+  // Returns a character identifying the given font manager in the persisted
+  // fallback cache, or 0 if the font manager is not known.
+  char GetFontManagerTag(const sk_sp<SkFontMgr>& manager) const;
+
+  sk_sp<SkFontMgr> GetFontManagerForTag(char tag) const;
+
+  // Loads the persisted fallback families, unless the families of the font
+  // managers whose fonts are known at startup have changed since. Called
+  // without holding the lock.
+  void RestoreFallbackCache();
+
+  void StoreFallbackCacheIfDirty();
+
+  FRIEND_TEST(FontCollectionTest, PersistsFallbackFonts);
+  FRIEND_TEST(FontCollectionTest, RestoresFallbackFontsWithoutHoldingTheLock);
 
   FML_DISALLOW_COPY_AND_ASSIGN(FontCollection);
 };
@@ -0,0 +1,155 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "txt/locking_font_manager.h"
+
+#include "flutter/fml/logging.h"
+#include "third_party/skia/include/core/SkString.h"
+#include "third_party/skia/include/core/SkTypeface.h"
+
+namespace txt {
+
+namespace {
+
+// Forwards to a style set of a LockingFontManager while holding its mutex.
+// The style sets of the asset font managers are updated when fonts are
+// registered.
+class LockingFontStyleSet : public SkFontStyleSet {
+ public:
+  LockingFontStyleSet(sk_sp<SkFontStyleSet> style_set, std::mutex& mutex)
+      : style_set_(std::move(style_set)), mutex_(mutex) {}
+
+  ~LockingFontStyleSet() override = default;
+
+  // |SkFontStyleSet|
+  int count() override {
+    std::scoped_lock lock(mutex_);
+    return style_set_->count();
+  }
+
+  // |SkFontStyleSet|
+  void getStyle(int index, SkFontStyle* style, SkString* name) override {
+    std::scoped_lock lock(mutex_);
+    style_set_->getStyle(index, style, name);
+  }
+
+  // |SkFontStyleSet|
+  SkTypeface* createTypeface(int index) override {
+    std::scoped_lock lock(mutex_);
+    return style_set_->createTypeface(index);
+  }
+
+  // |SkFontStyleSet|
+  SkTypeface* matchStyle(const SkFontStyle& pattern) override {
+    std::scoped_lock lock(mutex_);
+    return style_set_->matchStyle(pattern);
+  }
+
+ private:
+  const sk_sp<SkFontStyleSet> style_set_;
+  std::mutex& mutex_;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(LockingFontStyleSet);
+};
+
+}  // anonymous namespace
+
+LockingFontManager::LockingFontManager(sk_sp<SkFontMgr> font_manager,
+                                       std::mutex& mutex)
+    : font_manager_(std::move(font_manager)), mutex_(mutex) {
+  FML_DCHECK(font_manager_ != nullptr);
+}
+
+LockingFontManager::~LockingFontManager() = default;
+
+SkFontStyleSet* LockingFontManager::WrapStyleSet(
+    SkFontStyleSet* style_set) const {
+  if (style_set == nullptr) {
+    return nullptr;
+  }
+  return new LockingFontStyleSet(sk_sp<SkFontStyleSet>(style_set), mutex_);
+}
+
+int LockingFontManager::onCountFamilies() const {
+  std::scoped_lock lock(mutex_);
+  return font_manager_->countFamilies();
+}
+
+void LockingFontManager::onGetFamilyName(int index,
+                                         SkString* familyName) const {
+  std::scoped_lock lock(mutex_);
+  font_manager_->getFamilyName(index, familyName);
+}
+
+SkFontStyleSet* LockingFontManager::onCreateStyleSet(int index) const {
+  SkFontStyleSet* style_set;
+  {
+    std::scoped_lock lock(mutex_);
+    style_set = font_manager_->createStyleSet(index);
+  }
+  return WrapStyleSet(style_set);
+}
+
+SkFontStyleSet* LockingFontManager::onMatchFamily(
+    const char familyName[]) const {
+  SkFontStyleSet* style_set;
+  {
+    std::scoped_lock lock(mutex_);
+    style_set = font_manager_->matchFamily(familyName);
+  }
+  return WrapStyleSet(style_set);
+}
+
+SkTypeface* LockingFontManager::onMatchFamilyStyle(
+    const char familyName[],
+    const SkFontStyle& style) const {
+  std::scoped_lock lock(mutex_);
+  return font_manager_->matchFamilyStyle(familyName, style);
+}
+
+SkTypeface* LockingFontManager::onMatchFamilyStyleCharacter(
+    const char familyName[],
+    const SkFontStyle& style,
+    const char* bcp47[],
+    int bcp47Count,
+    SkUnichar character) const {
+  std::scoped_lock lock(mutex_);
+  return font_manager_->matchFamilyStyleCharacter(familyName, style, bcp47,
+                                                  bcp47Count, character);
+}
+
+sk_sp<SkTypeface> LockingFontManager::onMakeFromData(sk_sp<SkData> data,
+                                                     int ttcIndex) const {
+  std::scoped_lock lock(mutex_);
+  return font_manager_->makeFromData(std::move(data), ttcIndex);
+}
+
+sk_sp<SkTypeface> LockingFontManager::onMakeFromStreamIndex(
+    std::unique_ptr<SkStreamAsset> stream,
+    int ttcIndex) const {
+  std::scoped_lock lock(mutex_);
+  return font_manager_->makeFromStream(std::move(stream), ttcIndex);
+}
+
+sk_sp<SkTypeface> LockingFontManager::onMakeFromStreamArgs(
+    std::unique_ptr<SkStreamAsset> stream,
+    const SkFontArguments& args) const {
+  std::scoped_lock lock(mutex_);
+  return font_manager_->makeFromStream(std::move(stream), args);
+}
+
+sk_sp<SkTypeface> LockingFontManager::onMakeFromFile(const char path[],
+                                                     int ttcIndex) const {
+  std::scoped_lock lock(mutex_);
+  return font_manager_->makeFromFile(path, ttcIndex);
+}
+
+sk_sp<SkTypeface> LockingFontManager::onLegacyMakeTypeface(
+    const char familyName[],
+    SkFontStyle style) const {
+  std::scoped_lock lock(mutex_);
+  return font_manager_->legacyMakeTypeface(familyName, style);
+}
+
+}  // namespace txt
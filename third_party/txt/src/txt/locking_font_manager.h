@@ -0,0 +1,81 @@
+// Copyright 2013 The Flutter Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef TXT_LOCKING_FONT_MANAGER_H_
+#define TXT_LOCKING_FONT_MANAGER_H_
+
+#include <mutex>
+
+#include "flutter/fml/macros.h"
+#include "third_party/skia/include/core/SkFontMgr.h"
+#include "third_party/skia/include/core/SkStream.h"
+
+namespace txt {
+
+// Forwards to a font manager while holding a mutex, so that the font manager
+// can be queried from the threads that lay out text while fonts are
+// registered with it. The style sets it returns are locked the same way.
+//
+// The mutex must outlive the font manager.
+class LockingFontManager : public SkFontMgr {
+ public:
+  LockingFontManager(sk_sp<SkFontMgr> font_manager, std::mutex& mutex);
+
+  ~LockingFontManager() override;
+
+ protected:
+  // |SkFontMgr|
+  int onCountFamilies() const override;
+
+  // |SkFontMgr|
+  void onGetFamilyName(int index, SkString* familyName) const override;
+
+  // |SkFontMgr|
+  SkFontStyleSet* onCreateStyleSet(int index) const override;
+
+  // |SkFontMgr|
+  SkFontStyleSet* onMatchFamily(const char familyName[]) const override;
+
+  // |SkFontMgr|
+  SkTypeface* onMatchFamilyStyle(const char familyName[],
+                                 const SkFontStyle&) const override;
+
+  // |SkFontMgr|
+  SkTypeface* onMatchFamilyStyleCharacter(const char familyName[],
+                                          const SkFontStyle&,
+                                          const char* bcp47[],
+                                          int bcp47Count,
+                                          SkUnichar character) const override;
+
+  // |SkFontMgr|
+  sk_sp<SkTypeface> onMakeFromData(sk_sp<SkData>, int ttcIndex) const override;
+
+  // |SkFontMgr|
+  sk_sp<SkTypeface> onMakeFromStreamIndex(std::unique_ptr<SkStreamAsset>,
+                                          int ttcIndex) const override;
+
+  // |SkFontMgr|
+  sk_sp<SkTypeface> onMakeFromStreamArgs(std::unique_ptr<SkStreamAsset>,
+                                         const SkFontArguments&) const override;
+
+  // |SkFontMgr|
+  sk_sp<SkTypeface> onMakeFromFile(const char path[],
+                                   int ttcIndex) const override;
+
+  // |SkFontMgr|
+  sk_sp<SkTypeface> onLegacyMakeTypeface(const char familyName[],
+                                         SkFontStyle) const override;
+
+ private:
+  const sk_sp<SkFontMgr> font_manager_;
+  std::mutex& mutex_;
+
+  SkFontStyleSet* WrapStyleSet(SkFontStyleSet* style_set) const;
+
+  FML_DISALLOW_COPY_AND_ASSIGN(LockingFontManager);
+};
+
+}  // namespace txt
+
+#endif  // TXT_LOCKING_FONT_MANAGER_H_
@@ -253,7 +253,16 @@ void ParagraphTxt::SetInlinePlaceholders(
 bool ParagraphTxt::ComputeLineBreaks() {
   line_metrics_.clear();
   line_widths_.clear();
-  max_intrinsic_width_ = 0;
+  min_stable_width_ = 0;
+  max_stable_width_ = 0;
+  const bool measured =
+      !text_.empty() && char_widths_.size() == text_.size();
+  if (!measured) {
+    max_intrinsic_width_ = 0;
+    char_widths_.assign(text_.size(), 0);
+  }
+  double min_stable_width = std::numeric_limits<double>::lowest();
+  double max_stable_width = std::numeric_limits<double>::infinity();
 
   std::vector<size_t> newline_positions;
   // Discover and add all hard breaks.
@@ -293,6 +302,10 @@ bool ParagraphTxt::ComputeLineBreaks() {
     memcpy(breaker_.buffer(), text_.data() + block_start,
            block_size * sizeof(text_[0]));
     breaker_.setText();
+    if (measured) {
+      memcpy(breaker_.charWidths(), char_widths_.data() + block_start,
+             block_size * sizeof(char_widths_[0]));
+    }
 
     // Add the runs that include this line to the LineBreaker.
     double block_total_width = 0;
@@ -316,6 +329,7 @@ bool ParagraphTxt::ComputeLineBreaks() {
                               ? ""
                               : run.style.font_families[0])
                       << "\".";
+        char_widths_.clear();
         return false;
       }
       size_t run_start = std::max(run.start, block_start) - block_start;
@@ -344,8 +358,11 @@ bool ParagraphTxt::ComputeLineBreaks() {
         inline_placeholder_index++;
       } else {
         // Is a regular text run.
-        double run_width = breaker_.addStyleRun(&paint, collection, font,
-                                                run_start, run_end, isRtl);
+        double run_width =
+            measured ? breaker_.addMeasuredStyleRun(&paint, collection, font,
+                                                    run_start, run_end, isRtl)
+                     : breaker_.addStyleRun(&paint, collection, font,
+                                            run_start, run_end, isRtl);
         block_total_width += run_width;
       }
 
@@ -353,10 +370,16 @@ bool ParagraphTxt::ComputeLineBreaks() {
         break;
       run_index++;
     }
-    max_intrinsic_width_ = std::max(max_intrinsic_width_, block_total_width);
+    if (!measured) {
+      max_intrinsic_width_ = std::max(max_intrinsic_width_, block_total_width);
+      memcpy(char_widths_.data() + block_start, breaker_.charWidths(),
+             block_size * sizeof(char_widths_[0]));
+    }
 
     size_t breaks_count = breaker_.computeBreaks();
     const int* breaks = breaker_.getBreaks();
+    min_stable_width = std::max(min_stable_width, breaker_.getMinStableWidth());
+    max_stable_width = std::min(max_stable_width, breaker_.getMaxStableWidth());
     for (size_t i = 0; i < breaks_count; ++i) {
       size_t break_start = (i > 0) ? breaks[i - 1] : 0;
       size_t line_start = break_start + block_start;
@@ -379,6 +402,8 @@ bool ParagraphTxt::ComputeLineBreaks() {
     breaker_.finish();
   }
 
+  min_stable_width_ = min_stable_width;
+  max_stable_width_ = max_stable_width;
   return true;
 }
 
@@ -671,11 +696,16 @@ void ParagraphTxt::Layout(double width) {
     return;
   }
 
+  // If only the width changed, the text does not need to be measured again,
+  // and the lines do not need to be broken again if the breaks can't change.
+  const bool width_changed = !needs_layout_;
+
   width_ = rounded_width;
 
   needs_layout_ = false;
 
   records_.clear();
+  paint_batches_.clear();
   glyph_lines_.clear();
   code_unit_runs_.clear();
   inline_placeholder_code_unit_runs_.clear();
@@ -683,8 +713,17 @@ void ParagraphTxt::Layout(double width) {
   min_left_ = std::numeric_limits<double>::max();
   final_line_count_ = 0;
 
-  if (!ComputeLineBreaks())
-    return;
+  if (!width_changed) {
+    char_widths_.clear();
+  }
+  if (width_changed && width_ >= min_stable_width_ &&
+      width_ < max_stable_width_) {
+    line_metrics_ = line_breaks_;
+  } else {
+    if (!ComputeLineBreaks())
+      return;
+    line_breaks_ = line_metrics_;
+  }
 
   std::vector<BidiRun> bidi_runs;
   if (!ComputeBidiRuns(&bidi_runs))
@@ -1409,31 +1448,84 @@ sk_sp<SkTypeface> ParagraphTxt::GetDefaultSkiaTypeface(const TextStyle& style) {
 // paragraph.
 void ParagraphTxt::Paint(SkCanvas* canvas, double x, double y) {
   SkPoint base_offset = SkPoint::Make(x, y);
-  SkPaint paint;
   // Paint the background first before painting any text to prevent
   // potential overlap.
   for (const PaintRecord& record : records_) {
     PaintBackground(canvas, record, base_offset);
   }
-  for (const PaintRecord& record : records_) {
+  if (paint_batches_.empty()) {
+    BuildPaintBatches();
+  }
+  std::vector<DecorationPath> decorations;
+  for (const PaintBatch& batch : paint_batches_) {
+    if (batch.text) {
+      canvas->drawTextBlob(batch.text, x, y, batch.paint);
+    } else {
+      const PaintRecord& record = records_[batch.start];
+      SkPoint offset = base_offset + record.offset();
+      if (record.GetPlaceholderRun() == nullptr) {
+        PaintShadow(canvas, record, offset);
+        canvas->drawTextBlob(record.text(), offset.x(), offset.y(),
+                             batch.paint);
+      }
+    }
+    decorations.clear();
+    for (size_t i = batch.start; i < batch.end; i++) {
+      AddDecorations(records_[i], base_offset, decorations);
+    }
+    PaintDecorations(canvas, decorations);
+  }
+}
+
+void ParagraphTxt::BuildPaintBatches() {
+  for (size_t i = 0; i < records_.size(); i++) {
+    const PaintRecord& record = records_[i];
+    SkPaint paint;
     if (record.style().has_foreground) {
       paint = record.style().foreground;
     } else {
-      paint.reset();
       paint.setColor(record.style().color);
     }
-    SkPoint offset = base_offset + record.offset();
-    if (record.GetPlaceholderRun() == nullptr) {
-      PaintShadow(canvas, record, offset);
-      canvas->drawTextBlob(record.text(), offset.x(), offset.y(), paint);
+    // Shadows are drawn below the text of their own record only.
+    const bool can_merge = record.GetPlaceholderRun() == nullptr &&
+                           record.style().text_shadows.empty();
+    if (can_merge && !paint_batches_.empty() &&
+        paint_batches_.back().can_merge &&
+        paint_batches_.back().paint == paint) {
+      paint_batches_.back().end = i + 1;
+      continue;
+    }
+    paint_batches_.push_back({i, i + 1, can_merge, std::move(paint), nullptr});
+  }
+
+  // Merge the text blobs of the batches into a blob with a run per record,
+  // positioned relative to the origin of the paragraph.
+  for (PaintBatch& batch : paint_batches_) {
+    if (batch.end - batch.start < 2) {
+      continue;
+    }
+    SkTextBlobBuilder builder;
+    for (size_t i = batch.start; i < batch.end; i++) {
+      const PaintRecord& record = records_[i];
+      SkTextBlob::Iter iter(*record.text());
+      SkTextBlob::Iter::ExperimentalRun run;
+      while (iter.experimentalNext(&run)) {
+        const SkTextBlobBuilder::RunBuffer& blob_buffer =
+            builder.allocRunPos(run.font, run.count);
+        std::copy(run.glyphs, run.glyphs + run.count, blob_buffer.glyphs);
+        SkPoint* points = blob_buffer.points();
+        for (int j = 0; j < run.count; j++) {
+          points[j] = run.positions[j] + record.offset();
+        }
+      }
     }
-    PaintDecorations(canvas, record, base_offset);
+    batch.text = builder.make();
   }
 }
 
-void ParagraphTxt::PaintDecorations(SkCanvas* canvas,
-                                    const PaintRecord& record,
-                                    SkPoint base_offset) {
+void ParagraphTxt::AddDecorations(const PaintRecord& record,
+                                  SkPoint base_offset,
+                                  std::vector<DecorationPath>& decorations) {
   if (record.style().decoration == TextDecoration::kNone)
     return;
 
@@ -1441,20 +1533,24 @@ void ParagraphTxt::PaintDecorations(SkCanvas* canvas,
     return;
 
   const SkFontMetrics& metrics = record.metrics();
-  SkPaint paint;
-  paint.setStyle(SkPaint::kStroke_Style);
-  if (record.style().decoration_color == SK_ColorTRANSPARENT) {
-    paint.setColor(record.style().color);
-  } else {
-    paint.setColor(record.style().decoration_color);
-  }
-  paint.setAntiAlias(true);
+  const SkColor color = record.style().decoration_color == SK_ColorTRANSPARENT
+                            ? record.style().color
+                            : record.style().decoration_color;
+  const TextDecorationStyle decoration_style = record.style().decoration_style;
+  // The intervals of dotted and dashed decorations are scaled by the font
+  // size. Other decorations of any font size can share a path.
+  const double font_size =
+      decoration_style == TextDecorationStyle::kDotted ||
+              decoration_style == TextDecorationStyle::kDashed
+          ? record.style().font_size
+          : 0;
 
   // This is set to 2 for the double line style
-  int decoration_count = 1;
+  int decoration_count =
+      decoration_style == TextDecorationStyle::kDouble ? 2 : 1;
 
   // Filled when drawing wavy decorations.
-  SkPath path;
+  SkPath wavy_path;
 
   double width = record.GetRunWidth();
 
@@ -1468,59 +1564,42 @@ void ParagraphTxt::PaintDecorations(SkCanvas* canvas,
     // Divide by 14pt as it is the default size.
     underline_thickness = record.style().font_size / 14.0f;
   }
-  paint.setStrokeWidth(underline_thickness *
-                       record.style().decoration_thickness_multiplier);
+  SkScalar stroke_width =
+      underline_thickness * record.style().decoration_thickness_multiplier;
 
   SkPoint record_offset = base_offset + record.offset();
   SkScalar x = record_offset.x() + record.x_start();
   SkScalar y = record_offset.y();
 
-  // Setup the decorations.
-  switch (record.style().decoration_style) {
-    case TextDecorationStyle::kSolid: {
-      break;
-    }
-    case TextDecorationStyle::kDouble: {
-      decoration_count = 2;
-      break;
-    }
-    // Note: the intervals are scaled by the thickness of the line, so it is
-    // possible to change spacing by changing the decoration_thickness
-    // property of TextStyle.
-    case TextDecorationStyle::kDotted: {
-      // Divide by 14pt as it is the default size.
-      const float scale = record.style().font_size / 14.0f;
-      const SkScalar intervals[] = {1.0f * scale, 1.5f * scale, 1.0f * scale,
-                                    1.5f * scale};
-      size_t count = sizeof(intervals) / sizeof(intervals[0]);
-      paint.setPathEffect(SkPathEffect::MakeCompose(
-          SkDashPathEffect::Make(intervals, count, 0.0f),
-          SkDiscretePathEffect::Make(0, 0)));
-      break;
-    }
-    // Note: the intervals are scaled by the thickness of the line, so it is
-    // possible to change spacing by changing the decoration_thickness
-    // property of TextStyle.
-    case TextDecorationStyle::kDashed: {
-      // Divide by 14pt as it is the default size.
-      const float scale = record.style().font_size / 14.0f;
-      const SkScalar intervals[] = {4.0f * scale, 2.0f * scale, 4.0f * scale,
-                                    2.0f * scale};
-      size_t count = sizeof(intervals) / sizeof(intervals[0]);
-      paint.setPathEffect(SkPathEffect::MakeCompose(
-          SkDashPathEffect::Make(intervals, count, 0.0f),
-          SkDiscretePathEffect::Make(0, 0)));
-      break;
+  if (decoration_style == TextDecorationStyle::kWavy) {
+    ComputeWavyDecoration(
+        wavy_path, x, y, width,
+        underline_thickness * record.style().decoration_thickness_multiplier);
+  }
+
+  // Adds a decoration line at the given offset from the baseline to the path
+  // of the decorations drawn with the same paint.
+  auto add_line = [&](double y_offset) {
+    auto it = std::find_if(decorations.begin(), decorations.end(),
+                           [&](const DecorationPath& decoration) {
+                             return decoration.color == color &&
+                                    decoration.stroke_width == stroke_width &&
+                                    decoration.style == decoration_style &&
+                                    decoration.font_size == font_size;
+                           });
+    if (it == decorations.end()) {
+      decorations.push_back(
+          {color, stroke_width, decoration_style, font_size, SkPath()});
+      it = decorations.end() - 1;
     }
-    case TextDecorationStyle::kWavy: {
-      ComputeWavyDecoration(
-          path, x, y, width,
-          underline_thickness * record.style().decoration_thickness_multiplier);
-      break;
+    if (decoration_style != TextDecorationStyle::kWavy) {
+      it->path.moveTo(x, y + y_offset);
+      it->path.lineTo(x + width, y + y_offset);
+    } else {
+      it->path.addPath(wavy_path, 0, y_offset);
     }
-  }
+  };
 
-  // Draw the decorations.
   // Use a for loop for "kDouble" decoration style
   for (int i = 0; i < decoration_count; i++) {
     double y_offset = i * underline_thickness * kDoubleDecorationSpacing;
@@ -1532,13 +1611,7 @@ void ParagraphTxt::PaintDecorations(SkCanvas* canvas,
            SkFontMetrics::FontMetricsFlags::kUnderlinePositionIsValid_Flag)
               ? metrics.fUnderlinePosition
               : underline_thickness;
-      if (record.style().decoration_style != TextDecorationStyle::kWavy) {
-        canvas->drawLine(x, y + y_offset, x + width, y + y_offset, paint);
-      } else {
-        SkPath offsetPath = path;
-        offsetPath.offset(0, y_offset);
-        canvas->drawPath(offsetPath, paint);
-      }
+      add_line(y_offset);
       y_offset = y_offset_original;
     }
     // Overline
@@ -1546,21 +1619,15 @@ void ParagraphTxt::PaintDecorations(SkCanvas* canvas,
       // We subtract fAscent here because for double overlines, we want the
       // second line to be above, not below the first.
       y_offset -= metrics.fAscent;
-      if (record.style().decoration_style != TextDecorationStyle::kWavy) {
-        canvas->drawLine(x, y - y_offset, x + width, y - y_offset, paint);
-      } else {
-        SkPath offsetPath = path;
-        offsetPath.offset(0, -y_offset);
-        canvas->drawPath(offsetPath, paint);
-      }
+      add_line(-y_offset);
       y_offset = y_offset_original;
     }
     // Strikethrough
     if (record.style().decoration & TextDecoration::kLineThrough) {
       if (metrics.fFlags &
           SkFontMetrics::FontMetricsFlags::kStrikeoutThicknessIsValid_Flag)
-        paint.setStrokeWidth(metrics.fStrikeoutThickness *
-                             record.style().decoration_thickness_multiplier);
+        stroke_width = metrics.fStrikeoutThickness *
+                       record.style().decoration_thickness_multiplier;
       // Make sure the double line is "centered" vertically.
       y_offset += (decoration_count - 1.0) * underline_thickness *
                   kDoubleDecorationSpacing / -2.0;
@@ -1571,18 +1638,49 @@ void ParagraphTxt::PaintDecorations(SkCanvas* canvas,
               // Backup value if the strikeoutposition metric is not
               // available:
               : metrics.fXHeight / -2.0;
-      if (record.style().decoration_style != TextDecorationStyle::kWavy) {
-        canvas->drawLine(x, y + y_offset, x + width, y + y_offset, paint);
-      } else {
-        SkPath offsetPath = path;
-        offsetPath.offset(0, y_offset);
-        canvas->drawPath(offsetPath, paint);
-      }
+      add_line(y_offset);
       y_offset = y_offset_original;
     }
   }
 }
 
+void ParagraphTxt::PaintDecorations(
+    SkCanvas* canvas,
+    const std::vector<DecorationPath>& decorations) {
+  for (const DecorationPath& decoration : decorations) {
+    SkPaint paint;
+    paint.setStyle(SkPaint::kStroke_Style);
+    paint.setColor(decoration.color);
+    paint.setAntiAlias(true);
+    paint.setStrokeWidth(decoration.stroke_width);
+
+    // Note: the intervals are scaled by the thickness of the line, so it is
+    // possible to change spacing by changing the decoration_thickness
+    // property of TextStyle.
+    if (decoration.style == TextDecorationStyle::kDotted) {
+      // Divide by 14pt as it is the default size.
+      const float scale = decoration.font_size / 14.0f;
+      const SkScalar intervals[] = {1.0f * scale, 1.5f * scale, 1.0f * scale,
+                                    1.5f * scale};
+      size_t count = sizeof(intervals) / sizeof(intervals[0]);
+      paint.setPathEffect(SkPathEffect::MakeCompose(
+          SkDashPathEffect::Make(intervals, count, 0.0f),
+          SkDiscretePathEffect::Make(0, 0)));
+    } else if (decoration.style == TextDecorationStyle::kDashed) {
+      // Divide by 14pt as it is the default size.
+      const float scale = decoration.font_size / 14.0f;
+      const SkScalar intervals[] = {4.0f * scale, 2.0f * scale, 4.0f * scale,
+                                    2.0f * scale};
+      size_t count = sizeof(intervals) / sizeof(intervals[0]);
+      paint.setPathEffect(SkPathEffect::MakeCompose(
+          SkDashPathEffect::Make(intervals, count, 0.0f),
+          SkDiscretePathEffect::Make(0, 0)));
+    }
+
+    canvas->drawPath(decoration.path, paint);
+  }
+}
+
 void ParagraphTxt::ComputeWavyDecoration(SkPath& path,
                                          double x,
                                          double y,
@@ -34,6 +34,8 @@
 #include "styled_runs.h"
 #include "third_party/googletest/googletest/include/gtest/gtest_prod.h"  // nogncheck
 #include "third_party/skia/include/core/SkFontMetrics.h"
+#include "third_party/skia/include/core/SkPaint.h"
+#include "third_party/skia/include/core/SkPath.h"
 #include "third_party/skia/include/core/SkRect.h"
 #include "utils/LinuxUtils.h"
 #include "utils/MacUtils.h"
@@ -169,6 +171,7 @@ class ParagraphTxt : public Paragraph {
   FRIEND_TEST(ParagraphTest, GetGlyphPositionAtCoordinateSegfault);
   FRIEND_TEST(ParagraphTest, KhmerLineBreaker);
   FRIEND_TEST(ParagraphTest, TextHeightBehaviorRectsParagraph);
+  FRIEND_TEST(ParagraphTest, PaintMergesRunsWithTheSamePaint);
 
   // Starting data to layout.
   std::vector<uint16_t> text_;
@@ -195,9 +198,35 @@ class ParagraphTxt : public Paragraph {
   size_t final_line_count_ = 0;
   std::vector<double> line_widths_;
 
+  // Kept from ComputeLineBreaks() for layouts that only change the width. The
+  // widths of the code units spare measuring the text again, and the lines
+  // are reused as they are while the width is at least min_stable_width_ and
+  // less than max_stable_width_.
+  std::vector<float> char_widths_;
+  std::vector<LineMetrics> line_breaks_;
+  double min_stable_width_ = 0;
+  double max_stable_width_ = 0;
+
   // Stores the result of Layout().
   std::vector<PaintRecord> records_;
 
+  // Consecutive paint records whose text is drawn with the same paint.
+  struct PaintBatch {
+    // The range of the records in records_.
+    size_t start;
+    size_t end;
+    // False for placeholders and records with shadows, which are drawn on
+    // their own.
+    bool can_merge;
+    SkPaint paint;
+    // The text of the records, positioned relative to the paragraph. Null if
+    // the batch has a single record, whose own blob is drawn.
+    sk_sp<SkTextBlob> text;
+  };
+
+  // Built from records_ by the first Paint() after Layout().
+  std::vector<PaintBatch> paint_batches_;
+
   bool did_exceed_max_lines_;
 
   // Strut metrics of zero will have no effect on the layout.
@@ -347,7 +376,8 @@ class ParagraphTxt : public Paragraph {
       std::vector<PlaceholderRun> inline_placeholders,
       std::unordered_set<size_t> obj_replacement_char_indexes);
 
-  // Break the text into lines.
+  // Break the text into lines. Reuses the widths of the code units measured
+  // by the previous call unless char_widths_ was cleared.
   bool ComputeLineBreaks();
 
   // Break the text into runs based on LTR/RTL text direction.
@@ -378,10 +408,27 @@ class ParagraphTxt : public Paragraph {
   // alignment.
   double GetLineXOffset(double line_total_advance, bool justify_line);
 
-  // Creates and draws the decorations onto the canvas.
+  // The decorations drawn with the same paint, merged into a single path.
+  struct DecorationPath {
+    SkColor color;
+    SkScalar stroke_width;
+    TextDecorationStyle style;
+    // Scales the intervals of dotted and dashed decorations.
+    double font_size;
+    SkPath path;
+  };
+
+  // Groups the paint records into paint_batches_ and merges their text blobs.
+  void BuildPaintBatches();
+
+  // Adds the decorations of the record to the path with their paint.
+  void AddDecorations(const PaintRecord& record,
+                      SkPoint base_offset,
+                      std::vector<DecorationPath>& decorations);
+
+  // Draws the decorations onto the canvas.
   void PaintDecorations(SkCanvas* canvas,
-                        const PaintRecord& record,
-                        SkPoint base_offset);
+                        const std::vector<DecorationPath>& decorations);
 
   // Computes the beziers for a wavy decoration. The results will be
   // applied to path.
@@ -14,12 +14,24 @@
  * limitations under the License.
  */
 
+#include <functional>
+
 #include "flutter/fml/logging.h"
+#include "flutter/fml/synchronization/waitable_event.h"
 #include "gtest/gtest.h"
 #include "third_party/skia/include/utils/SkCustomTypeface.h"
+#include "txt/asset_font_manager.h"
 #include "txt/font_collection.h"
+#include "txt/font_skia.h"
+#include "txt/typeface_font_asset_provider.h"
 #include "txt_test_utils.h"
 
+#if FLUTTER_ENABLE_SKSHAPER
+#include <thread>
+
+#include "skia/paragraph_builder_skia.h"
+#endif
+
 namespace txt {
 
 // We don't really need a fixture but a class in a namespace is needed for
@@ -63,6 +75,74 @@ void PopulateUserTypefaceBoilerplate(SkCustomTypefaceBuilder* builder) {
     builder->setGlyph(index, width / upem, path.makeTransform(scale));
   }
 }
+
+// Matches characters like a platform font manager, with the first of its
+// fonts that has a glyph for the character.
+class FallbackFontManager : public AssetFontManager {
+ public:
+  explicit FallbackFontManager(const std::vector<std::string>& font_files)
+      : AssetFontManager(MakeProvider(font_files)) {}
+
+  int GetMatchCount() const { return match_count_; }
+
+  int GetCountFamiliesCount() const { return count_families_count_; }
+
+ private:
+  mutable int match_count_ = 0;
+  mutable int count_families_count_ = 0;
+
+  static std::unique_ptr<FontAssetProvider> MakeProvider(
+      const std::vector<std::string>& font_files) {
+    auto provider = std::make_unique<TypefaceFontAssetProvider>();
+    for (const std::string& font_file : font_files) {
+      provider->RegisterTypeface(
+          SkTypeface::MakeFromFile((GetFontDir() + "/" + font_file).c_str()));
+    }
+    return provider;
+  }
+
+  // |SkFontMgr|
+  int onCountFamilies() const override {
+    count_families_count_++;
+    return AssetFontManager::onCountFamilies();
+  }
+
+  // |SkFontMgr|
+  SkTypeface* onMatchFamilyStyleCharacter(const char familyName[],
+                                          const SkFontStyle&,
+                                          const char* bcp47[],
+                                          int bcp47Count,
+                                          SkUnichar character) const override {
+    match_count_++;
+    for (int i = 0; i < AssetFontManager::onCountFamilies(); i++) {
+      sk_sp<SkFontStyleSet> style_set(createStyleSet(i));
+      sk_sp<SkTypeface> typeface(style_set->createTypeface(0));
+      if (typeface && typeface->unicharToGlyph(character) != 0) {
+        return typeface.release();
+      }
+    }
+    return nullptr;
+  }
+};
+
+class FakeFallbackCacheStorage : public FontCollection::FallbackCacheStorage {
+ public:
+  std::string Load() override {
+    if (on_load) {
+      on_load();
+    }
+    return data;
+  }
+
+  void Store(const std::string& new_data) override {
+    store_count++;
+    data = new_data;
+  }
+
+  std::string data;
+  int store_count = 0;
+  std::function<void()> on_load;
+};
 }  // namespace
 
 TEST(FontCollectionTest, CheckSkTypefacesSorting) {
@@ -138,6 +218,178 @@ TEST(FontCollectionTest, CheckSkTypefacesSorting) {
             SkFontStyle::kExpanded_Width);
 }
 
+TEST(FontCollectionTest, PersistsFallbackFonts) {
+  const std::vector<std::string> font_files = {"Roboto-Regular.ttf",
+                                               "NotoNaskhArabic-Regular.ttf"};
+  const uint32_t kArabicLetterAlef = 0x0627;
+  auto storage = std::make_shared<FakeFallbackCacheStorage>();
+
+  auto manager = sk_make_sp<FallbackFontManager>(font_files);
+  auto collection = std::make_shared<FontCollection>();
+  collection->SetDefaultFontManager(manager);
+  collection->SetFallbackCacheStorage(storage);
+  collection->PrewarmFallbackFonts({"ar"}, {kArabicLetterAlef});
+  ASSERT_EQ(manager->GetMatchCount(), 1);
+  ASSERT_EQ(collection->fallback_fonts_for_locale_["ar"].size(), 1u);
+  ASSERT_FALSE(storage->data.empty());
+
+  // The next run restores the family without matching the character again.
+  auto next_manager = sk_make_sp<FallbackFontManager>(font_files);
+  auto next_collection = std::make_shared<FontCollection>();
+  next_collection->SetDefaultFontManager(next_manager);
+  next_collection->SetFallbackCacheStorage(storage);
+  next_collection->PrewarmFallbackFonts({"ar"}, {kArabicLetterAlef});
+  ASSERT_EQ(next_manager->GetMatchCount(), 0);
+  ASSERT_EQ(next_collection->fallback_fonts_for_locale_["ar"],
+            collection->fallback_fonts_for_locale_["ar"]);
+
+  // The families are not restored if the fonts have changed.
+  auto changed_manager = sk_make_sp<FallbackFontManager>(
+      std::vector<std::string>{"Roboto-Regular.ttf"});
+  auto changed_collection = std::make_shared<FontCollection>();
+  changed_collection->SetDefaultFontManager(changed_manager);
+  changed_collection->SetFallbackCacheStorage(storage);
+  changed_collection->PrewarmFallbackFonts({"ar"}, {});
+  ASSERT_TRUE(changed_collection->fallback_fonts_for_locale_["ar"].empty());
+}
+
+TEST(FontCollectionTest, RestoresFallbackFontsWithoutHoldingTheLock) {
+  const uint32_t kArabicLetterAlef = 0x0627;
+  auto manager = sk_make_sp<FallbackFontManager>(std::vector<std::string>{
+      "Roboto-Regular.ttf", "NotoNaskhArabic-Regular.ttf"});
+  auto collection = std::make_shared<FontCollection>();
+  collection->SetDefaultFontManager(manager);
+  auto storage = std::make_shared<FakeFallbackCacheStorage>();
+  // Paragraph layouts lock the collection while they look up fonts, which
+  // would wait for the storage if it were read under the lock.
+  storage->on_load = [&collection]() { collection->ClearFontFamilyCache(); };
+  collection->SetFallbackCacheStorage(storage);
+
+  collection->PrewarmFallbackFonts({"ar"}, {kArabicLetterAlef});
+  ASSERT_EQ(collection->fallback_fonts_for_locale_["ar"].size(), 1u);
+  ASSERT_EQ(storage->store_count, 1);
+}
+
+TEST(FontCollectionTest, ComputesFallbackCacheFingerprintOnce) {
+  const uint32_t kArabicLetterAlef = 0x0627;
+  const uint32_t kLatinSmallLetterA = 0x0061;
+  auto manager = sk_make_sp<FallbackFontManager>(std::vector<std::string>{
+      "Roboto-Regular.ttf", "NotoNaskhArabic-Regular.ttf"});
+  auto collection = std::make_shared<FontCollection>();
+  collection->SetDefaultFontManager(manager);
+  auto storage = std::make_shared<FakeFallbackCacheStorage>();
+  collection->SetFallbackCacheStorage(storage);
+  collection->PrewarmFallbackFonts({}, {});
+  const int count_families_count = manager->GetCountFamiliesCount();
+
+  // Each new family is stored with the fingerprint computed when the
+  // persisted families were restored.
+  ASSERT_TRUE(collection->MatchFallbackFont(kArabicLetterAlef, "ar"));
+  ASSERT_TRUE(collection->MatchFallbackFont(kLatinSmallLetterA, "en"));
+  ASSERT_EQ(storage->store_count, 2);
+  ASSERT_EQ(manager->GetCountFamiliesCount(), count_families_count);
+}
+
+TEST(FontCollectionTest, FamiliesOfTheSameTypefaceShareCoverage) {
+  sk_sp<SkTypeface> roboto = SkTypeface::MakeFromFile(
+      (GetFontDir() + "/Roboto-Regular.ttf").c_str());
+  sk_sp<SkTypeface> arabic = SkTypeface::MakeFromFile(
+      (GetFontDir() + "/NotoNaskhArabic-Regular.ttf").c_str());
+  ASSERT_TRUE(roboto);
+  ASSERT_TRUE(arabic);
+  auto make_family = [](const sk_sp<SkTypeface>& typeface) {
+    std::vector<minikin::Font> fonts;
+    fonts.emplace_back(std::make_shared<FontSkia>(typeface),
+                       minikin::FontStyle());
+    return std::make_shared<minikin::FontFamily>(std::move(fonts));
+  };
+  const uint32_t kArabicLetterAlef = 0x0627;
+
+  auto family = make_family(roboto);
+  auto same_family = make_family(roboto);
+  auto other_family = make_family(arabic);
+  EXPECT_EQ(&family->getCoverage(), &same_family->getCoverage());
+  EXPECT_NE(&family->getCoverage(), &other_family->getCoverage());
+  EXPECT_TRUE(same_family->hasGlyph('a', 0));
+  EXPECT_FALSE(same_family->hasGlyph(kArabicLetterAlef, 0));
+  EXPECT_TRUE(other_family->hasGlyph(kArabicLetterAlef, 0));
+
+  // The coverage is computed again once no family uses it.
+  family.reset();
+  same_family.reset();
+  auto new_family = make_family(roboto);
+  EXPECT_TRUE(new_family->hasGlyph('a', 0));
+  EXPECT_FALSE(new_family->hasGlyph(kArabicLetterAlef, 0));
+}
+
+#if FLUTTER_ENABLE_SKSHAPER
+
+static std::unique_ptr<Paragraph> BuildSkiaParagraph(
+    std::shared_ptr<FontCollection> font_collection,
+    const std::u16string& text) {
+  ParagraphStyle paragraph_style;
+  ParagraphBuilderSkia builder(paragraph_style, std::move(font_collection));
+  TextStyle text_style;
+  text_style.font_families = {"Roboto"};
+  builder.PushStyle(text_style);
+  builder.AddText(text);
+  builder.Pop();
+  return builder.Build();
+}
+
+TEST(FontCollectionTest, LaysOutWhileAWorkerLaysOut) {
+  auto font_collection = GetTestFontCollection();
+  fml::AutoResetWaitableEvent worker_laying_out;
+  fml::AutoResetWaitableEvent finish_worker_layout;
+  std::thread worker([&font_collection, &worker_laying_out,
+                      &finish_worker_layout]() {
+    // Hold the Skia collection of the worker like a long layout would.
+    auto lock = font_collection->GetSktFontCollection()->Lock();
+    worker_laying_out.Signal();
+    finish_worker_layout.Wait();
+  });
+  worker_laying_out.Wait();
+
+  // Would wait for the worker if the threads shared a Skia collection.
+  auto paragraph = BuildSkiaParagraph(font_collection, u"Hello World");
+  paragraph->Layout(1000);
+  ASSERT_GT(paragraph->GetHeight(), 0);
+
+  finish_worker_layout.Signal();
+  worker.join();
+}
+
+TEST(FontCollectionTest, LaysOutParagraphsOnAWorkerAndThisThread) {
+  auto font_collection = GetTestFontCollection();
+  std::u16string long_text;
+  for (int i = 0; i < 200; i++) {
+    long_text += u"The quick brown fox jumps over the lazy dog. ";
+  }
+  auto expected = BuildSkiaParagraph(font_collection, long_text);
+  expected->Layout(300);
+
+  // Built on this thread and first laid out on the worker, like a paragraph
+  // laid out with layoutAsync.
+  auto async_paragraph = BuildSkiaParagraph(font_collection, long_text);
+  std::thread worker([&async_paragraph]() {
+    for (int i = 0; i < 10; i++) {
+      async_paragraph->Layout(300);
+    }
+  });
+  for (int i = 0; i < 10; i++) {
+    auto paragraph = BuildSkiaParagraph(font_collection, u"Hello World");
+    paragraph->Layout(1000);
+    ASSERT_GT(paragraph->GetHeight(), 0);
+  }
+  worker.join();
+
+  ASSERT_EQ(async_paragraph->GetHeight(), expected->GetHeight());
+  ASSERT_EQ(async_paragraph->GetLineMetrics().size(),
+            expected->GetLineMetrics().size());
+}
+
+#endif  // FLUTTER_ENABLE_SKSHAPER
+
 #if 0
 
 TEST(FontCollection, HasDefaultRegistrations) {
@@ -18,10 +18,12 @@
 #include <iostream>
 
 #include "flutter/fml/logging.h"
+#include "minikin/Layout.h"
 #include "render_test.h"
 #include "third_party/icu/source/common/unicode/unistr.h"
 #include "third_party/skia/include/core/SkColor.h"
 #include "third_party/skia/include/core/SkPath.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
 #include "txt/font_style.h"
 #include "txt/font_weight.h"
 #include "txt/paragraph_builder_txt.h"
@@ -7111,4 +7113,138 @@ TEST_F(ParagraphTest, MixedTextHeightBehaviorRectsParagraph) {
 
   ASSERT_TRUE(Snapshot());
 }
+
+TEST_F(ParagraphTest, WidthOnlyRelayoutMatchesFullLayout) {
+  const char* text =
+      "This is a very long sentence to test if the text will properly wrap "
+      "around and go to the next line. Sometimes, short sentence.\nLonger "
+      "sentences are okay too because they are necessary. Very short. "
+      "Supercalifragilisticexpialidocious";
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  for (auto strategy :
+       {minikin::kBreakStrategy_Greedy, minikin::kBreakStrategy_HighQuality}) {
+    auto build = [&]() {
+      txt::ParagraphStyle paragraph_style;
+      paragraph_style.break_strategy = strategy;
+      txt::ParagraphBuilderTxt builder(paragraph_style,
+                                       GetTestFontCollection());
+      txt::TextStyle text_style;
+      text_style.font_families = std::vector<std::string>(1, "Roboto");
+      builder.PushStyle(text_style);
+      builder.AddText(u16_text);
+      builder.Pop();
+      return BuildParagraph(builder);
+    };
+
+    auto relaid = build();
+    for (double width : {300.0, 200.0, 205.0, 1000.0, 900.0, 120.0, 300.0}) {
+      relaid->Layout(width);
+      auto fresh = build();
+      fresh->Layout(width);
+
+      ASSERT_EQ(relaid->GetLineCount(), fresh->GetLineCount());
+      EXPECT_EQ(relaid->GetHeight(), fresh->GetHeight());
+      EXPECT_EQ(relaid->GetLongestLine(), fresh->GetLongestLine());
+      EXPECT_EQ(relaid->GetMaxIntrinsicWidth(), fresh->GetMaxIntrinsicWidth());
+      EXPECT_EQ(relaid->GetMinIntrinsicWidth(), fresh->GetMinIntrinsicWidth());
+      auto& relaid_lines = relaid->GetLineMetrics();
+      auto& fresh_lines = fresh->GetLineMetrics();
+      for (size_t i = 0; i < fresh_lines.size(); ++i) {
+        EXPECT_EQ(relaid_lines[i].start_index, fresh_lines[i].start_index);
+        EXPECT_EQ(relaid_lines[i].end_index, fresh_lines[i].end_index);
+        EXPECT_EQ(relaid_lines[i].width, fresh_lines[i].width);
+        EXPECT_EQ(relaid_lines[i].left, fresh_lines[i].left);
+      }
+    }
+  }
+}
+
+TEST_F(ParagraphTest, LayoutCacheRespectsBudget) {
+  std::string text;
+  for (int i = 0; i < 500; i++) {
+    text += "word" + std::to_string(i) + " ";
+  }
+  auto icu_text = icu::UnicodeString::fromUTF8(text);
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+  txt::ParagraphBuilderTxt builder(paragraph_style, GetTestFontCollection());
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+  auto paragraph = BuildParagraph(builder);
+
+  minikin::Layout::purgeCaches();
+  auto before = minikin::Layout::getCacheStatistics();
+  ASSERT_EQ(before.entries, 0u);
+  ASSERT_EQ(before.bytes, 0u);
+
+  paragraph->Layout(GetTestCanvasWidth());
+  auto first = minikin::Layout::getCacheStatistics();
+  EXPECT_GT(first.misses, before.misses);
+  EXPECT_GT(first.entries, 0u);
+  EXPECT_GT(first.bytes, 0u);
+  EXPECT_LE(first.bytes, first.budget);
+
+  // Laying out the same text again is served from the cache.
+  paragraph->SetDirty();
+  paragraph->Layout(GetTestCanvasWidth());
+  auto second = minikin::Layout::getCacheStatistics();
+  EXPECT_GT(second.hits, first.hits);
+  EXPECT_EQ(second.misses, first.misses);
+
+  // Shrinking the budget evicts entries right away.
+  const size_t budget = first.bytes / 2;
+  minikin::Layout::setCacheBudget(budget);
+  auto shrunk = minikin::Layout::getCacheStatistics();
+  EXPECT_LE(shrunk.bytes, budget);
+  EXPECT_LT(shrunk.entries, first.entries);
+
+  minikin::Layout::setCacheBudget(minikin::Layout::kDefaultCacheBudget);
+}
+
+TEST_F(ParagraphTest, PaintMergesRunsWithTheSamePaint) {
+  auto icu_text = icu::UnicodeString::fromUTF8("Hello world ");
+  std::u16string u16_text(icu_text.getBuffer(),
+                          icu_text.getBuffer() + icu_text.length());
+
+  txt::ParagraphStyle paragraph_style;
+  txt::ParagraphBuilderTxt builder(paragraph_style, GetTestFontCollection());
+  txt::TextStyle text_style;
+  text_style.font_families = std::vector<std::string>(1, "Roboto");
+  text_style.color = SK_ColorBLACK;
+  text_style.decoration = TextDecoration::kUnderline;
+  // Runs of different fonts with the same color.
+  for (int i = 0; i < 10; i++) {
+    text_style.font_weight =
+        i % 2 == 0 ? txt::FontWeight::w400 : txt::FontWeight::w700;
+    builder.PushStyle(text_style);
+    builder.AddText(u16_text);
+    builder.Pop();
+  }
+  text_style.color = SK_ColorRED;
+  builder.PushStyle(text_style);
+  builder.AddText(u16_text);
+  builder.Pop();
+
+  auto paragraph = BuildParagraph(builder);
+  paragraph->Layout(GetTestCanvasWidth());
+  ASSERT_GE(paragraph->records_.size(), 11u);
+
+  SkPictureRecorder recorder;
+  paragraph->Paint(recorder.beginRecording(GetTestCanvasWidth(), 1000), 0, 0);
+  sk_sp<SkPicture> picture = recorder.finishRecordingAsPicture();
+
+  // The text and the underlines of each color are drawn at once.
+  EXPECT_EQ(picture->approximateOpCount(), 4);
+
+  paragraph->Paint(GetCanvas(), 0, 0);
+  ASSERT_TRUE(Snapshot());
+}
 }  // namespace txt